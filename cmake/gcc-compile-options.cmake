@@ -74,6 +74,13 @@ add_compile_options("-march=icelake-server")
 elseif(${ISA_SPR})
 # Compile flags / defintions for SNC (Sunny-cove) (Linux)
 add_compile_options("-march=sapphirerapids")
+elseif(${ISA_MULTI})
+# Compile flags for all ISA in one library (Linux): AVX2 baseline, the
+# *_avx512 / *_snc / *_spr files get their own target in ADD_KERNEL
+add_compile_options("-march=broadwell")
+set(ISA_MULTI_FLAGS_AVX512 "-march=skylake-avx512")
+set(ISA_MULTI_FLAGS_SNC "-march=icelake-server")
+set(ISA_MULTI_FLAGS_SPR "-march=sapphirerapids")
 endif()
 
 # linux linker flags for unittests executable
@@ -160,6 +160,13 @@ else()
   elseif(${ISA_SNC})
     # Compile flags / defintions for SNC (Sunny-cove) (Linux)
     add_compile_options("-xicelake-server")
+  elseif(${ISA_MULTI})
+    # Compile flags for all ISA in one library (Linux): AVX2 baseline, the
+    # *_avx512 / *_snc / *_spr files get their own target in ADD_KERNEL
+    add_compile_options("-march=broadwell")
+    set(ISA_MULTI_FLAGS_AVX512 "-march=skylake-avx512")
+    set(ISA_MULTI_FLAGS_SNC "-march=icelake-server")
+    set(ISA_MULTI_FLAGS_SPR "-march=sapphirerapids")
   endif()
 
   add_compile_options("-mcmodel=large")
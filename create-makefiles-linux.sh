@@ -80,7 +80,7 @@ case "$WIRELESS_SDK_TOOLCHAIN" in
 esac
 
 case "$WIRELESS_SDK_TARGET_ISA" in
-"sse4_2" | "avx2" | "avx512" | "snc" | "spr")
+"sse4_2" | "avx2" | "avx512" | "snc" | "spr" | "multi")
     echo "INFO:  Environment variable WIRELESS_SDK_TARGET_ISA=$WIRELESS_SDK_TARGET_ISA"
     ;;
 "")
@@ -105,7 +105,7 @@ case "$WIRELESS_SDK_TARGET_ISA" in
 
 *)
     echo "ERROR: Environment variable WIRELESS_SDK_TARGET_ISA not set correctly"
-    echo "       Valid settings: avx2, avx512, snc"
+    echo "       Valid settings: avx2, avx512, snc, spr, multi"
     exit 1
     ;;
 esac
@@ -165,6 +165,10 @@ then
 elif [ $WIRELESS_SDK_TARGET_ISA == "snc" ]
 then
     ISA_SELECT="-DISA_SNC=1"
+elif [ $WIRELESS_SDK_TARGET_ISA == "multi" ]
+then
+    # All variants in one build, picked from CPUID at run time (BBLIB_ISA to override)
+    ISA_SELECT="-DISA_MULTI=1"
 fi
 
 # Create clean build directory
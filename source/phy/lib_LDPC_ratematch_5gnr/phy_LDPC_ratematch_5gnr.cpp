@@ -33,6 +33,7 @@
 
 #include "phy_LDPC_ratematch_5gnr.h"
 #include "sdk_version.h"
+#include "bblib_isa.h"
 
 typedef int32_t (*LDPC_ratematch_5gnr_function)(const bblib_LDPC_ratematch_5gnr_request *request,
     bblib_LDPC_ratematch_5gnr_response *response);
@@ -41,8 +42,8 @@ struct bblib_LDPC_ratematch_5gnr_init
 {
     bblib_LDPC_ratematch_5gnr_init()
     {
-#if !defined(_BBLIB_AVX512_)
-        printf("__func__ bblib_LDPC_ratematch_5gnr_init() cannot run with this CPU type, needs AVX512\n");
+#if !defined(_BBLIB_AVX512_) && !defined(_BBLIB_AVX2_)
+        printf("__func__ bblib_LDPC_ratematch_5gnr_init() cannot run with this CPU type, needs AVX2 or AVX512\n");
 #endif
         bblib_print_LDPC_ratematch_5gnr_version();
     }
@@ -73,14 +74,25 @@ bblib_print_LDPC_ratematch_5gnr_version()
     }
 }
 
+/* Picked when the CPU, or BBLIB_ISA, has none of the compiled variants */
+static int32_t
+bblib_LDPC_ratematch_5gnr_unsupported(const struct bblib_LDPC_ratematch_5gnr_request *request, struct bblib_LDPC_ratematch_5gnr_response *response)
+{
+    printf("LDPC rate matching needs AVX2 or AVX512\n");
+    return -1;
+}
+
 static LDPC_ratematch_5gnr_function
 bblib_LDPC_ratematch_5gnr_select_on_isa() {
 #ifdef _BBLIB_AVX512_
-    return bblib_LDPC_ratematch_5gnr_avx512;
-#else
-    printf("LDPC rate matching support AVX512 only currently\n");
-    exit(-1);
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+        return bblib_LDPC_ratematch_5gnr_avx512;
+#endif
+#ifdef _BBLIB_AVX2_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX2)
+        return bblib_LDPC_ratematch_5gnr_avx2;
 #endif
+    return bblib_LDPC_ratematch_5gnr_unsupported;
 }
 
 static LDPC_ratematch_5gnr_function default_LDPC_ratematch_5gnr = bblib_LDPC_ratematch_5gnr_select_on_isa();
@@ -91,3 +103,63 @@ bblib_LDPC_ratematch_5gnr(const struct bblib_LDPC_ratematch_5gnr_request *reques
     return default_LDPC_ratematch_5gnr(request, response);
 }
 
+
+typedef int32_t (*LDPC_ratematch_5gnr_tb_function)(const bblib_LDPC_ratematch_5gnr_tb_request *request,
+    bblib_LDPC_ratematch_5gnr_tb_response *response);
+
+static int32_t
+bblib_LDPC_ratematch_5gnr_tb_unsupported(const struct bblib_LDPC_ratematch_5gnr_tb_request *request, struct bblib_LDPC_ratematch_5gnr_tb_response *response)
+{
+    printf("LDPC rate matching needs AVX2 or AVX512\n");
+    return -1;
+}
+
+static LDPC_ratematch_5gnr_tb_function
+bblib_LDPC_ratematch_5gnr_tb_select_on_isa() {
+#ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+        return bblib_LDPC_ratematch_5gnr_tb_avx512;
+#endif
+#ifdef _BBLIB_AVX2_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX2)
+        return bblib_LDPC_ratematch_5gnr_tb_avx2;
+#endif
+    return bblib_LDPC_ratematch_5gnr_tb_unsupported;
+}
+
+static LDPC_ratematch_5gnr_tb_function default_LDPC_ratematch_5gnr_tb = bblib_LDPC_ratematch_5gnr_tb_select_on_isa();
+
+int32_t
+bblib_LDPC_ratematch_5gnr_tb(const struct bblib_LDPC_ratematch_5gnr_tb_request *request, struct bblib_LDPC_ratematch_5gnr_tb_response *response)
+{
+    return default_LDPC_ratematch_5gnr_tb(request, response);
+}
+
+int32_t
+bblib_LDPC_ratematch_5gnr_cb_length(const struct bblib_LDPC_ratematch_5gnr_tb_request *request, int32_t r,
+    int32_t *E, int32_t *offset)
+{
+    const int32_t unit = request->nLayers * request->Qm;
+    if ((request->C <= 0) || (r < 0) || (r >= request->C) || (unit <= 0) || (request->G % unit))
+    {
+        printf("Wrong parameters for code block %d: C %d, G %d, nLayers %d, Qm %d\n",
+            r, request->C, request->G, request->nLayers, request->Qm);
+        return -1;
+    }
+
+    /* The first C - mod(G / (NL*Qm), C) code blocks get the rounded down length */
+    const int32_t symbols = request->G / unit;
+    const int32_t nShort = request->C - symbols % request->C;
+    const int32_t eShort = unit * (symbols / request->C);
+    if (r < nShort)
+    {
+        *E = eShort;
+        *offset = r * eShort;
+    }
+    else
+    {
+        *E = eShort + unit;
+        *offset = nShort * eShort + (r - nShort) * (eShort + unit);
+    }
+    return 0;
+}
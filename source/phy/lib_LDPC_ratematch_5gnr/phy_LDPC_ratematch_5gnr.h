@@ -50,6 +50,11 @@
 extern "C" {
 #endif
 
+/*! Options of the flags of the rate matching requests, none set keeps the plain rate matching. */
+#define BBLIB_LDPC_RATEMATCH_SCRAMBLING (1 << 0) /*!< Scramble the output with the sequence c(n) of TS 38211-5.2.1 */
+#define BBLIB_LDPC_RATEMATCH_SYMBOL_OUTPUT (1 << 1) /*!< One byte per modulation symbol holding its Qm bits, the
+    first bit of the symbol as MSB of the Qm bits, instead of packed bits. E must be a multiple of Qm. */
+
 /*!
     \struct bblib_LDPC_ratematch_5gnr_request
     \brief Structure for input parameters in API of rate matching for 5GNR.
@@ -59,13 +64,15 @@ extern "C" {
           For 16QAM, input should be aligned with 4 BITS.\n
           For 64QAM, input should be aligned with 6 BITS.\n
           For 256QAM, input should be aligned with 1 Byte.\n
+    \note The structure must be zero-initialised (e.g. = {} or memset) before its fields are set, so that
+          options it does not set, such as flags, keep their default behaviour.
 */
 struct bblib_LDPC_ratematch_5gnr_request {
     int32_t Ncb; /*!< Length of the circular buffer in bits. */
 
     int32_t Zc; /*!< Parameter defined in TS 38211-5.2.1. */
 
-    int32_t E; /*!< Length of the output buffer in bits. Currently limited to 8448*8 bits */
+    int32_t E; /*!< Length of the output buffer in bits. */
 
     int32_t Qm; /*!< Modulation type, which can be 1/2/4/6/8. */
 
@@ -78,6 +85,13 @@ struct bblib_LDPC_ratematch_5gnr_request {
     int32_t nLen; /*!< Length of null bits. 0 if no null bit */
 
     uint8_t *input; /*!< pointer to input stream. alignment depends on modulation type */
+
+    uint32_t flags; /*!< Options, BBLIB_LDPC_RATEMATCH_* bits, 0 for packed output bits without scrambling. */
+
+    uint32_t cInit; /*!< c_init of the scrambling sequence, TS 38211-7.3.1.1, with BBLIB_LDPC_RATEMATCH_SCRAMBLING */
+
+    uint32_t scramblingOffset; /*!< Index n in c(n) of the first output bit, the position of the code block in the
+        codeword, with BBLIB_LDPC_RATEMATCH_SCRAMBLING */
 };
 
 /*!
@@ -94,6 +108,61 @@ struct bblib_LDPC_ratematch_5gnr_response {
     uint8_t *output; /*!< Output buffer for data stream after rate matching. alignment depends on modulation type */
 };
 
+/*!
+    \struct bblib_LDPC_ratematch_5gnr_tb_request
+    \brief Structure for input parameters in API of transport block rate matching for 5GNR.
+    \note All code blocks share Ncb, Zc and the filler bits position. E_r of each code block is derived
+          from G as defined in TS 38212-5.4.2.1, without CBGTI so C' = C.
+    \note The structure must be zero-initialised before its fields are set, as bblib_LDPC_ratematch_5gnr_request.
+*/
+struct bblib_LDPC_ratematch_5gnr_tb_request {
+    int32_t C; /*!< Number of code blocks of the transport block. */
+
+    int32_t G; /*!< Total number of coded bits available for the transport block, multiple of nLayers * Qm. */
+
+    int32_t nLayers; /*!< Number of transmission layers N_L the transport block is mapped onto. */
+
+    int32_t cbStart; /*!< First code block to rate match, 0 for the whole transport block. */
+
+    int32_t cbNum; /*!< Number of code blocks to rate match from cbStart, 0 for all C code blocks.
+        Several calls on disjoint ranges can run in parallel when the first bit of each range is byte aligned,
+        see bblib_LDPC_ratematch_5gnr_cb_length. */
+
+    int32_t Ncb; /*!< Length of the circular buffer in bits. */
+
+    int32_t Zc; /*!< Parameter defined in TS 38211-5.2.1. */
+
+    int32_t Qm; /*!< Modulation type, which can be 1/2/4/6/8. */
+
+    int32_t rvidx; /*!< Redundancy version, which can be 0/1/2/3. */
+
+    int32_t baseGraph; /*!< Base graph, which can be 1/2. */
+
+    int32_t nullIndex; /*!< Position of starting null bits. -1 if no null bit */
+
+    int32_t nLen; /*!< Length of null bits. 0 if no null bit */
+
+    const uint8_t *input; /*!< Code words of the C code blocks, code word r starts at input + r * cbStride */
+
+    uint32_t cbStride; /*!< Distance in bytes between two code words, as bblib_ldpc_encoder_5gnr_tb_response */
+
+    uint32_t flags; /*!< Options, BBLIB_LDPC_RATEMATCH_* bits as bblib_LDPC_ratematch_5gnr_request, scrambling
+        applying to the whole sequence g. */
+
+    uint32_t cInit; /*!< c_init of the scrambling sequence, TS 38211-7.3.1.1, with BBLIB_LDPC_RATEMATCH_SCRAMBLING */
+};
+
+/*!
+    \struct bblib_LDPC_ratematch_5gnr_tb_response
+    \brief structure for outputs of transport block rate matching for 5GNR.
+ */
+struct bblib_LDPC_ratematch_5gnr_tb_response {
+    uint8_t *output; /*!< Output buffer for the G bits of the concatenated sequence g, TS 38212-5.5.
+        Code block r starts at the bit offset given by bblib_LDPC_ratematch_5gnr_cb_length, with no alignment
+        requirement. Bits outside of the code blocks rate matched by the call are left untouched.
+        With BBLIB_LDPC_RATEMATCH_SYMBOL_OUTPUT, G / Qm bytes and code block r starts at byte offset / Qm. */
+};
+
 //! @{
 /*! \brief rate matching for LDPC in 5GNR.
     \param [in] request Structure containing configuration information and input data.
@@ -104,8 +173,33 @@ struct bblib_LDPC_ratematch_5gnr_response {
 */
 int32_t bblib_LDPC_ratematch_5gnr(const struct bblib_LDPC_ratematch_5gnr_request *request, struct bblib_LDPC_ratematch_5gnr_response *response);
 int32_t bblib_LDPC_ratematch_5gnr_avx512(const struct bblib_LDPC_ratematch_5gnr_request *request, struct bblib_LDPC_ratematch_5gnr_response *response);
+int32_t bblib_LDPC_ratematch_5gnr_avx2(const struct bblib_LDPC_ratematch_5gnr_request *request, struct bblib_LDPC_ratematch_5gnr_response *response);
 //! @}
 
+//! @{
+/*! \brief rate matching of all or part of the code blocks of a transport block for LDPC in 5GNR.
+    \param [in] request Structure containing configuration information and input data.
+    \param [out] response Structure containing kernel outputs.
+    \note Equivalent to one bblib_LDPC_ratematch_5gnr call per code block with E_r followed by the code block
+          concatenation, without the per code block call overhead nor the re-packing of the outputs.
+          Scrambling and symbol output are applied in the same pass, see bblib_LDPC_ratematch_5gnr_request.
+    \return Success: return 0, else: return -1.
+*/
+int32_t bblib_LDPC_ratematch_5gnr_tb(const struct bblib_LDPC_ratematch_5gnr_tb_request *request, struct bblib_LDPC_ratematch_5gnr_tb_response *response);
+int32_t bblib_LDPC_ratematch_5gnr_tb_avx512(const struct bblib_LDPC_ratematch_5gnr_tb_request *request, struct bblib_LDPC_ratematch_5gnr_tb_response *response);
+int32_t bblib_LDPC_ratematch_5gnr_tb_avx2(const struct bblib_LDPC_ratematch_5gnr_tb_request *request, struct bblib_LDPC_ratematch_5gnr_tb_response *response);
+//! @}
+
+/*! \brief Rate matching output length E_r of code block r, TS 38212-5.4.2.1.
+    \param [in] request Transport block parameters, only C, G, nLayers and Qm are used.
+    \param [in] r Code block index.
+    \param [out] E Number of rate matched bits E_r of code block r.
+    \param [out] offset Position in bits of the first rate matched bit of code block r in the sequence g.
+    \return Success: return 0, else: return -1.
+*/
+int32_t bblib_LDPC_ratematch_5gnr_cb_length(const struct bblib_LDPC_ratematch_5gnr_tb_request *request, int32_t r,
+    int32_t *E, int32_t *offset);
+
 /*! \brief Report the version number for the rate match library.
  */
 void bblib_print_LDPC_ratematch_5gnr_version(void);
@@ -0,0 +1,327 @@
+/**********************************************************************
+ *
+*
+*  Copyright [2019 - 2023] [Intel Corporation]
+* 
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  
+*  You may obtain a copy of the License at
+*  
+*     http://www.apache.org/licenses/LICENSE-2.0 
+*  
+*  Unless required by applicable law or agreed to in writing, software 
+*  distributed under the License is distributed on an "AS IS" BASIS, 
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and 
+*  limitations under the License. 
+*  
+*  SPDX-License-Identifier: Apache-2.0 
+*  
+* 
+ *
+ **********************************************************************/
+/*
+ *  @file   phy_LDPC_ratematch_5gnr_avx2.cpp
+ *  @brief  AVX2 code for 5GNR Rate Matching functions.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <immintrin.h>  /* AVX2 */
+#include "phy_LDPC_ratematch_5gnr.h"
+#include "common_typedef_sdk.h"
+#include "pseudo_random_seq_gen_avx2.h"
+#include "phy_LDPC_ratematch_5gnr_internal.h"
+
+#ifdef _BBLIB_AVX2_
+/*
+ * Same single pass as phy_LDPC_ratematch_5gnr_avx512.cpp. Without byte transposes over 512 bits the
+ * 64QAM and 256QAM interleave deposits each byte of the streams with BMI2, and the scrambling
+ * sequence is derived 256 bits at a time.
+ */
+
+/*! \brief Bit interleave of 64 bits of each of the Qm streams into 8*Qm output bytes. */
+static inline void ldpc_ratematch_interleave(const uint64_t *w, int32_t Q, uint8_t *dst)
+{
+    /* bit t of each 64 bits output word taken from stream t % Qm */
+    static const uint64_t depositMask2[2] = {0x5555555555555555ULL, 0xAAAAAAAAAAAAAAAAULL};
+    static const uint64_t depositMask4[4] = {0x1111111111111111ULL, 0x2222222222222222ULL,
+                                             0x4444444444444444ULL, 0x8888888888888888ULL};
+    /* one bit every Qm bits, for the 8 symbols built from one byte of each stream */
+    const uint64_t depositMask6 = 0x0000041041041041ULL;
+    const uint64_t depositMask8 = 0x0101010101010101ULL;
+    uint64_t c[8];
+
+    switch (Q)
+    {
+        case 1:
+            *(uint64_t *)dst = w[0];
+            break;
+        case 2:
+            *(uint64_t *)(dst) = _pdep_u64(w[0], depositMask2[0]) | _pdep_u64(w[1], depositMask2[1]);
+            *(uint64_t *)(dst + 8) = _pdep_u64(w[0] >> 32, depositMask2[0]) | _pdep_u64(w[1] >> 32, depositMask2[1]);
+            break;
+        case 4:
+            for (int32_t m = 0; m < 4; m++)
+                *(uint64_t *)(dst + 8 * m) = _pdep_u64(w[0] >> (16 * m), depositMask4[0]) | _pdep_u64(w[1] >> (16 * m), depositMask4[1]) |
+                                             _pdep_u64(w[2] >> (16 * m), depositMask4[2]) | _pdep_u64(w[3] >> (16 * m), depositMask4[3]);
+            break;
+        case 6:
+            /* byte k of the streams gives 48 output bits, 8 chunks of 48 bits */
+            for (int32_t k = 0; k < 8; k++)
+            {
+                c[k] = 0;
+                for (int32_t i = 0; i < 6; i++)
+                    c[k] |= _pdep_u64(w[i] >> (8 * k), depositMask6 << i);
+            }
+            *(uint64_t *)(dst) = c[0] | (c[1] << 48);
+            *(uint64_t *)(dst + 8) = (c[1] >> 16) | (c[2] << 32);
+            *(uint64_t *)(dst + 16) = (c[2] >> 32) | (c[3] << 16);
+            *(uint64_t *)(dst + 24) = c[4] | (c[5] << 48);
+            *(uint64_t *)(dst + 32) = (c[5] >> 16) | (c[6] << 32);
+            *(uint64_t *)(dst + 40) = (c[6] >> 32) | (c[7] << 16);
+            break;
+        case 8:
+            /* byte k of the streams gives output bytes 8*k .. 8*k+7 */
+            for (int32_t k = 0; k < 8; k++)
+            {
+                c[k] = 0;
+                for (int32_t i = 0; i < 8; i++)
+                    c[k] |= _pdep_u64(w[i] >> (8 * k), depositMask8 << i);
+                *(uint64_t *)(dst + 8 * k) = c[k];
+            }
+            break;
+    }
+}
+
+/*! \brief One byte per modulation symbol from num (1..64) symbols of Q packed bits.
+    The first bit of each symbol goes to the MSB of its Q bits index, as in the TS38211 5.1 tables.
+*/
+static inline void ldpc_ratematch_symbols(const uint64_t *bits, int32_t Q, uint8_t *dst, int32_t num)
+{
+    static const uint64_t fieldMask[9] = {0, 0x0101010101010101ULL, 0x0303030303030303ULL, 0,
+                                          0x0F0F0F0F0F0F0F0FULL, 0, 0x3F3F3F3F3F3F3F3FULL, 0,
+                                          0xFFFFFFFFFFFFFFFFULL};
+    const __m256i vRev4 = _mm256_setr_epi8(0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15,
+                                           0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15);
+    const __m256i vLowNibble = _mm256_set1_epi8(0x0F);
+    const __m256i vSymMask = _mm256_set1_epi8((1 << Q) - 1);
+    uint64_t sym[8];
+
+    /* 8 symbols, 8*Q bits, per 64 bits word */
+    for (int32_t k = 0; k < 8; k++)
+    {
+        const int32_t pos = 8 * Q * k;
+        uint64_t v = bits[pos >> 6] >> (pos & 63);
+        if ((pos & 63) + 8 * Q > 64)
+            v |= bits[(pos >> 6) + 1] << (64 - (pos & 63));
+        sym[k] = _pdep_u64(v, fieldMask[Q]);
+    }
+
+    /* bit reverse each byte then keep the Q upper bits */
+    for (int32_t h = 0; h < 2; h++)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&sym[4 * h]);
+        __m256i lo = _mm256_shuffle_epi8(vRev4, _mm256_and_si256(v, vLowNibble));
+        __m256i hi = _mm256_shuffle_epi8(vRev4, _mm256_and_si256(_mm256_srli_epi16(v, 4), vLowNibble));
+        v = _mm256_or_si256(_mm256_slli_epi16(lo, 4), hi);
+        v = _mm256_and_si256(_mm256_srli_epi16(v, 8 - Q), vSymMask);
+        _mm256_storeu_si256((__m256i *)&sym[4 * h], v);
+    }
+    memcpy(dst, sym, num);
+}
+
+/*! \brief Rate matching of one code block of E bits, written from bit bitOff (0..7) of output.
+    \note Bits of output before bitOff and after the last bit of the code block are left untouched.
+          When gold is not NULL the output bits are scrambled with it, with symbolOutput set one byte
+          per modulation symbol is written instead of the packed bits and bitOff must be 0.
+*/
+static int32_t ldpc_ratematch_cb(const struct bblib_LDPC_ratematch_5gnr_request *request, const uint8_t *in,
+    int32_t E, uint8_t *output, int32_t bitOff, struct prbs_gold_avx2 *gold, int32_t symbolOutput)
+{
+    const int32_t cb = request->Ncb;
+    const int32_t Q = request->Qm;
+    const int32_t ni = request->nullIndex;
+    const int32_t nl = (ni < 0) ? 0 : request->nLen;
+    const int32_t inBytes = (cb + 7) >> 3;
+    int32_t pos[8];
+    uint64_t w[8];
+    uint64_t chunk[8];
+    struct prbs_gold_avx2 g;
+
+    if ((Q != 1) && (Q != 2) && (Q != 4) && (Q != 6) && (Q != 8))
+    {
+        printf("Wrong parameter for modulation type. It should be 1/2/4/6/8\n");
+        return -1;
+    }
+    const int32_t k0 = ldpc_ratematch_k0(request->baseGraph, request->rvidx, cb, request->Zc);
+    if (k0 < 0)
+        return -1;
+
+    /* Start of each stream in the circular buffer, a start inside the filler bits moves after them */
+    const int32_t bitsPerStream = E / Q;
+    pos[0] = ((k0 < ni) || (k0 > ni + nl)) ? k0 : (ni + nl);
+    for (int32_t i = 1; i < Q; i++)
+        pos[i] = ldpc_ratematch_advance(pos[i - 1], bitsPerStream, cb, ni, nl);
+
+    /* Local copy of the scrambling state, so that it is not reloaded after every store to output */
+    if (gold != NULL)
+        g = *gold;
+
+    /* Bits already in the first output byte ahead of the code block are carried through the shift */
+    uint64_t carry = output[0] & ((1u << bitOff) - 1);
+    int32_t j = 0;
+    for (; j + 64 <= bitsPerStream; j += 64)
+    {
+        for (int32_t i = 0; i < Q; i++)
+            w[i] = ldpc_ratematch_fetch(in, inBytes, cb, ni, nl, &pos[i], 64);
+        if ((bitOff == 0) && (gold == NULL) && !symbolOutput)
+        {
+            ldpc_ratematch_interleave(w, Q, output);
+            output += 8 * Q;
+            continue;
+        }
+
+        ldpc_ratematch_interleave(w, Q, (uint8_t *)chunk);
+        if (gold != NULL)
+        {
+            for (int32_t k = 0; k < Q; k++)
+                chunk[k] ^= prbs_gold_avx2_next(&g, 64);
+        }
+        if (symbolOutput)
+        {
+            ldpc_ratematch_symbols(chunk, Q, output, 64);
+            output += 64;
+        }
+        else
+        {
+            for (int32_t k = 0; k < Q; k++)
+            {
+                ((uint64_t *)output)[k] = (chunk[k] << bitOff) | carry;
+                carry = bitOff ? (chunk[k] >> (64 - bitOff)) : 0;
+            }
+            output += 8 * Q;
+        }
+    }
+
+    /* Last bits of each stream, bits after E in the last output byte are left untouched */
+    const int32_t tail = bitsPerStream - j;
+    uint64_t last[9] = {0};
+    int32_t tailBits = 0;
+    if (tail > 0)
+    {
+        for (int32_t i = 0; i < Q; i++)
+            w[i] = ldpc_ratematch_fetch(in, inBytes, cb, ni, nl, &pos[i], tail);
+        ldpc_ratematch_interleave(w, Q, (uint8_t *)last);
+        tailBits = tail * Q;
+        if (gold != NULL)
+        {
+            for (int32_t k = 0; k < tailBits; k += 64)
+                last[k >> 6] ^= prbs_gold_avx2_next(&g, (tailBits - k < 64) ? (tailBits - k) : 64);
+            *gold = g;
+        }
+        if (symbolOutput)
+            ldpc_ratematch_symbols(last, Q, output, tail);
+    }
+    else if (gold != NULL)
+    {
+        *gold = g;
+    }
+    if (symbolOutput)
+        return 0;
+    if (bitOff)
+    {
+        for (int32_t k = 8; k > 0; k--)
+            last[k] = (last[k] << bitOff) | (last[k - 1] >> (64 - bitOff));
+        last[0] = (last[0] << bitOff) | carry;
+        tailBits += bitOff;
+    }
+    memcpy(output, last, tailBits >> 3);
+    if (tailBits & 7)
+    {
+        const uint8_t keep = 0xFF << (tailBits & 7);
+        const uint8_t lastByte = ((const uint8_t *)last)[tailBits >> 3];
+        output[tailBits >> 3] = (output[tailBits >> 3] & keep) | (lastByte & ~keep);
+    }
+    return 0;
+}
+#endif
+//-------------------------------------------------------------------------------------------
+/**
+ *  @brief rate matching for LDPC in 5GNR.
+ *  @param [in] request Structure containing configuration information and input data.
+ *  @param [out] response Structure containing kernel outputs.
+ *  @return Success: return 0, else: return -1.
+**/
+
+#ifdef _BBLIB_AVX2_
+int32_t bblib_LDPC_ratematch_5gnr_avx2(const struct bblib_LDPC_ratematch_5gnr_request *request, struct bblib_LDPC_ratematch_5gnr_response *response)
+{
+    struct prbs_gold_avx2 gold;
+
+    if ((request->flags & BBLIB_LDPC_RATEMATCH_SYMBOL_OUTPUT) && (request->E % request->Qm))
+    {
+        printf("E %d is not a multiple of Qm %d for the symbol output\n", request->E, request->Qm);
+        return -1;
+    }
+    if (request->flags & BBLIB_LDPC_RATEMATCH_SCRAMBLING)
+        prbs_gold_avx2_init(&gold, request->cInit, request->scramblingOffset);
+
+    return ldpc_ratematch_cb(request, request->input, request->E, response->output, 0,
+        (request->flags & BBLIB_LDPC_RATEMATCH_SCRAMBLING) ? &gold : NULL,
+        (request->flags & BBLIB_LDPC_RATEMATCH_SYMBOL_OUTPUT) != 0);
+}
+
+//-------------------------------------------------------------------------------------------
+/**
+ *  @brief transport block rate matching for LDPC in 5GNR.
+ *  @param [in] request Structure containing configuration information and input data.
+ *  @param [out] response Structure containing kernel outputs.
+ *  @return Success: return 0, else: return -1.
+**/
+int32_t bblib_LDPC_ratematch_5gnr_tb_avx2(const struct bblib_LDPC_ratematch_5gnr_tb_request *request, struct bblib_LDPC_ratematch_5gnr_tb_response *response)
+{
+    const int32_t cbEnd = request->cbStart + ((request->cbNum > 0) ? request->cbNum : request->C);
+    struct bblib_LDPC_ratematch_5gnr_request cbRequest = {};
+    struct prbs_gold_avx2 gold;
+    const int32_t scrambling = (request->flags & BBLIB_LDPC_RATEMATCH_SCRAMBLING) != 0;
+    const int32_t symbolOutput = (request->flags & BBLIB_LDPC_RATEMATCH_SYMBOL_OUTPUT) != 0;
+    int32_t E;
+    int32_t offset;
+
+    if ((request->cbStart < 0) || (cbEnd > request->C))
+    {
+        printf("Wrong code block range %d..%d for %d code blocks\n", request->cbStart, cbEnd - 1, request->C);
+        return -1;
+    }
+
+    cbRequest.Ncb = request->Ncb;
+    cbRequest.Zc = request->Zc;
+    cbRequest.Qm = request->Qm;
+    cbRequest.rvidx = request->rvidx;
+    cbRequest.baseGraph = request->baseGraph;
+    cbRequest.nullIndex = request->nullIndex;
+    cbRequest.nLen = request->nLen;
+
+    /* The scrambling sequence runs over the whole codeword, it is carried from one code block to the next */
+    if (scrambling)
+    {
+        if (bblib_LDPC_ratematch_5gnr_cb_length(request, request->cbStart, &E, &offset) != 0)
+            return -1;
+        prbs_gold_avx2_init(&gold, request->cInit, offset);
+    }
+
+    for (int32_t r = request->cbStart; r < cbEnd; r++)
+    {
+        if (bblib_LDPC_ratematch_5gnr_cb_length(request, r, &E, &offset) != 0)
+            return -1;
+        uint8_t *output = symbolOutput ? (response->output + offset / request->Qm) : (response->output + (offset >> 3));
+        if (ldpc_ratematch_cb(&cbRequest, request->input + (size_t)r * request->cbStride, E, output,
+                symbolOutput ? 0 : (offset & 7), scrambling ? &gold : NULL, symbolOutput) != 0)
+            return -1;
+    }
+    return 0;
+}
+#endif
@@ -26,1469 +26,240 @@
  *  @brief  AVX512 code for 5GNR Rate Matching functions.
  */
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <ipp.h>
-#include <ipps.h>
 #include <immintrin.h>  /* AVX512 */
 #include "phy_LDPC_ratematch_5gnr.h"
 #include "common_typedef_sdk.h"
+#include "pseudo_random_seq_gen_avx512.h"
+#include "phy_LDPC_ratematch_5gnr_internal.h"
 
 #ifdef _BBLIB_AVX512_
-constexpr auto MAX_LENGTH=16384;
-constexpr __mmask64 tailMask[] = {
-0x0, 0x3, 0xF, 0x3F, 0xFF, 0x3FF, 0xFFF, 0x3FFF,
-0xFFFF, 0x3FFFF, 0xFFFFF, 0x3FFFFF, 0xFFFFFF, 0x3FFFFFF, 0xFFFFFFF, 0x3FFFFFFF,
-0xFFFFFFFF, 0x3FFFFFFFF, 0xFFFFFFFFF, 0x3FFFFFFFFF, 0xFFFFFFFFFF, 0x3FFFFFFFFFF, 0xFFFFFFFFFFF, 0x3FFFFFFFFFFF,
-0xFFFFFFFFFFFF, 0x3FFFFFFFFFFFF, 0xFFFFFFFFFFFFF, 0x3FFFFFFFFFFFFF, 0xFFFFFFFFFFFFFF, 0x3FFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFF, 0x3FFFFFFFFFFFFFFF};
-#endif
-
-//! @{
-/*! \brief bit select function for 5GNR LDPC rate matching.
-    \param [in] request Structure containing configuration information and input data.
-    \param [out] e Temporary pointer to the output after bit slection.
-*/
-inline void bitSelect(const struct bblib_LDPC_ratematch_5gnr_request *request, uint8_t *e)
-{
-    int32_t cb = request->Ncb;
-    int32_t zc = request->Zc;
-    int32_t E = request->E;
-    int32_t Q = request->Qm;
-    int32_t rv = request->rvidx;
-    int32_t graph = request->baseGraph;
-    int32_t ni = request->nullIndex;
-    int32_t nl = request->nLen;
-    uint8_t *in = request->input;
-
-    int32_t k0;
-    if (graph == 1)
-    {
-        switch (rv)
-        {
-            case 0:
-                k0 = 0;
-                break;
-            case 1:
-                k0 = (17 * cb) / (66 * zc) * zc;
-                break;
-            case 2:
-                k0 = (33 * cb) / (66 * zc) * zc;
-                break;
-            case 3:
-                k0 = (56 * cb) / (66 * zc) * zc;
-                break;
-            default:
-                printf("Wrong parameter for rvidx. It should be 0/1/2/3\n");
-                exit(-1);
-                break;
-        }
-    }
-    else if (graph == 2)
-    {
-        switch (rv)
-        {
-            case 0:
-                k0 = 0;
-                break;
-            case 1:
-                k0 = (13 * cb) / (50 * zc) * zc;
-                break;
-            case 2:
-                k0 = (25 * cb) / (50 * zc) * zc;
-                break;
-            case 3:
-                k0 = (43 * cb) / (50 * zc) * zc;
-                break;
-            default:
-                printf("Wrong parameter for rvidx. It should be 0/1/2/3\n");
-                exit(-1);
-                break;
-        }
-    }
-    else
-    {
-        printf("Wrong parameter for Base Graph. It should be 1/2\n");
-        exit(-1);
-    }
-
-    int32_t startBit, srcOffBit, desOffBit;
-    int32_t srcByte, srcBits, desByte, desBits;
-    int32_t bitLeft = E/Q;
-    startBit = ( (k0<ni) || (k0>ni+nl) ) ? k0 : (ni+nl);
-
-    for (int i = 0; i < Q; i++) {
-        srcOffBit = startBit;
-        desOffBit = 8 * i * ((bitLeft - 1) / 8 + 1 );
-
-        srcByte = srcOffBit >> 3;
-        srcBits = srcOffBit & 0x7;
-        desByte = desOffBit >> 3;
-        desBits = desOffBit & 0x7;
-
-        /* If data between start bit and null bit is enough for bit select, copy continuous bits to output */
-        if ((startBit < ni) && (startBit + bitLeft <= ni)) {
-            ippsCopyBE_1u( (Ipp8u*)(in + srcByte), srcBits, (Ipp8u*)(e + desByte), desBits, bitLeft );
-            srcOffBit += bitLeft;
-        }
-        /* If data between start bit and null bit is not enough for bit select, copy all bits between them and copy remain bits from end of null bits */
-        else if ((startBit < ni) && (startBit + bitLeft + nl <= cb))
-        {
-            ippsCopyBE_1u( (Ipp8u*)(in+srcByte), srcBits, (Ipp8u*)(e+desByte), desBits, ni-startBit );
-
-            desOffBit += ni - startBit;
-            desByte = desOffBit >> 3;
-            desBits = desOffBit & 0x7;
-            srcOffBit = ni + nl;
-            srcByte = srcOffBit >> 3;
-            srcBits = srcOffBit & 0x7;
-
-            ippsCopyBE_1u( (Ipp8u*)(in+srcByte), srcBits, (Ipp8u*)(e+desByte), desBits, bitLeft-ni+startBit );
-            srcOffBit += bitLeft-ni+startBit;
-        }
-        /* If data between start bit and null bit is not enough for bit select, copy all bits between them and copy remain bits from end of null bits
-           If we reach the end of input, get back to the beginning and copy all except null bits until we get enough bits */
-        else if ( startBit<ni )
-        {
-            ippsCopyBE_1u( (Ipp8u*)(in+srcByte), srcBits, (Ipp8u*)(e+desByte), desBits, ni-startBit );
-
-            desOffBit += ni - startBit;
-            desByte = desOffBit >> 3;
-            desBits = desOffBit & 0x7;
-            srcOffBit = ni+nl;
-            srcByte = srcOffBit >> 3;
-            srcBits = srcOffBit & 0x7;
-
-            ippsCopyBE_1u( (Ipp8u*)(in+srcByte), srcBits, (Ipp8u*)(e+desByte), desBits, cb-ni-nl );
-
-            desOffBit += cb - ni - nl;
-            desByte = desOffBit >> 3;
-            desBits = desOffBit & 0x7;
-            bitLeft -= cb - startBit - nl;
-
-            while (bitLeft > 0)
-            {
-                if ( bitLeft>ni )
-                {
-                    ippsCopyBE_1u( (Ipp8u*)in, 0, (Ipp8u*)(e+desByte), desBits, ni );
-                    bitLeft -= ni;
-                    desOffBit += ni;
-                    desByte = desOffBit >> 3;
-                    desBits = desOffBit & 0x7;
-                }
-                else
-                {
-                    ippsCopyBE_1u( (Ipp8u*)in, 0, (Ipp8u*)(e+desByte), desBits, bitLeft );
-                    srcOffBit = bitLeft;
-                    bitLeft = 0;
-                    break;
-                }
-
-                srcOffBit = ni + nl;
-                srcByte = srcOffBit >> 3;
-                srcBits = srcOffBit & 0x7;
-                if ( bitLeft>(cb-ni-nl) )
-                {
-                    ippsCopyBE_1u( (Ipp8u*)(in+srcByte), srcBits, (Ipp8u*)(e+desByte), desBits, cb-ni-nl );
-                    bitLeft -= cb - ni - nl;
-                    desOffBit += cb - ni - nl;
-                    desByte = desOffBit >> 3;
-                    desBits = desOffBit & 0x7;
-                }
-                else
-                {
-                    ippsCopyBE_1u( (Ipp8u*)(in+srcByte), srcBits, (Ipp8u*)(e+desByte), desBits, bitLeft );
-                    srcOffBit += bitLeft;
-                    bitLeft = 0;
-                    break;
-                }
-            }
-        }
-        /* If we start at the end of null bits, and the remaining bits is enough */
-        else if (startBit+bitLeft<=cb)
-        {
-            ippsCopyBE_1u( (Ipp8u*)(in+srcByte), srcBits, (Ipp8u*)(e+desByte), desBits, bitLeft );
-            srcOffBit += bitLeft;
-        }
-        /* If we start at the end of null bits, and the remaining bits is not enough, we get back to the beginning and copy all except null bits until we get enough bits */
-        else
-        {
-            ippsCopyBE_1u( (Ipp8u*)(in+srcByte), srcBits, (Ipp8u*)(e+desByte), desBits, cb-startBit );
-            bitLeft -= cb-startBit;
-            desOffBit += cb-startBit;
-            desByte = desOffBit >> 3;
-            desBits = desOffBit & 0x7;
-
-            while (bitLeft > 0)
-            {
-                if ( bitLeft>ni )
-                {
-                    ippsCopyBE_1u( (Ipp8u*)in, 0, (Ipp8u*)(e+desByte), desBits, ni );
-                    bitLeft -= ni;
-                    desOffBit += ni;
-                    desByte = desOffBit >> 3;
-                    desBits = desOffBit & 0x7;
-                }
-                else
-                {
-                    ippsCopyBE_1u( (Ipp8u*)in, 0, (Ipp8u*)(e+desByte), desBits, bitLeft );
-                    srcOffBit = bitLeft;
-                    bitLeft = 0;
-                    break;
-                }
-
-                srcOffBit = ni + nl;
-                srcByte = srcOffBit >> 3;
-                srcBits = srcOffBit & 0x7;
-                if ( bitLeft>(cb-ni-nl) )
-                {
-                    ippsCopyBE_1u( (Ipp8u*)(in+srcByte), srcBits, (Ipp8u*)(e+desByte), desBits, cb-ni-nl );
-                    bitLeft -= cb - ni - nl;
-                    desOffBit += cb - ni - nl;
-                    desByte = desOffBit >> 3;
-                    desBits = desOffBit & 0x7;
-                }
-                else
-                {
-                    ippsCopyBE_1u( (Ipp8u*)(in+srcByte), srcBits, (Ipp8u*)(e+desByte), desBits, bitLeft );
-                    srcOffBit += bitLeft;
-                    bitLeft = 0;
-                    break;
-                }
-            }
-        }
-        bitLeft = E/Q;
-        /* In case where are just at the boundary, skip the filler bits */
-        if (srcOffBit == ni)
-            srcOffBit += nl;
-        startBit = srcOffBit;
-    }
-}
+/*
+ * Rate matching is done in a single streaming pass. Output bit j*Qm+i is bit j of the i-th stream,
+ * stream i being the part of the circular buffer selection e starting at i*E/Qm (TS38212 5.4.2.1
+ * and 5.4.2.2). Each stream keeps its own position in the circular buffer, 64 bits are pulled
+ * from every stream and interleaved straight into the output, so e is never materialised.
+ * Bits are packed with the first bit in the LSB of each byte, as for the encoder output.
+ * Scrambling and the gathering of the bits in modulation symbols are applied to the interleaved
+ * words before they are stored, so neither needs another pass over the output.
+ */
 
-//! @{
-/*! \brief bit interleave function for 5GNR LDPC rate matching.
-    \param [in] request Structure containing configuration information.
-    \param [out] response Structure containing output pointer.
-    \param [in] e Temporary pointer to the output after bit slection, as input of bit interleave.
-*/
-#ifdef _BBLIB_AVX512_
-inline void bitInterleave_avx512(const struct bblib_LDPC_ratematch_5gnr_request *request, struct bblib_LDPC_ratematch_5gnr_response *response, uint8_t *e)
+/*! \brief Bit interleave of 64 bits of each of the Qm streams into 8*Qm output bytes. */
+static inline void ldpc_ratematch_interleave(const uint64_t *w, int32_t Q, uint8_t *dst)
 {
-    int32_t Q = request->Qm;
-    int32_t len = request->E;
-    int32_t jMax = len / Q;
-    uint8_t *output = response->output;
-    unsigned char *tmp[8];
-    int bitOffset, byteOffset, bitTail, byteTail;
-    int lenInByte = jMax>>3;
-    __m512i inter = _mm512_setzero_si512();
-    __m512i res;
-    __mmask64 val1, val2, val3, val4;
-    __mmask64 left;
-    unsigned __int64 in[8];
-    unsigned __int64 out[8];
-
-    for (int i = 0;i < Q;i++)
-    {
-        tmp[i] = e + i * ( ((len/Q-1)>>3)+1 );
-    }
-
-    __m512i tmp0_QPSK, tmp1_QPSK;
-    __m512i vidxIn1_QPSK = _mm512_set_epi16( 31, 15, 30, 14,
-                                             29, 13, 28, 12,
-                                             27, 11, 26, 10,
-                                             25, 9, 24, 8,
-                                             23, 7, 22, 6,
-                                             21, 5, 20, 4,
-                                             19, 3, 18, 2,
-                                             17, 1, 16, 0);
-    __m512i vidxIn2_QPSK = _mm512_set_epi8(15, 13, 14, 12, 11, 9, 10, 8,
-                                           7, 5, 6, 4, 3, 1, 2, 0,
-                                           15, 13, 14, 12, 11, 9, 10, 8,
-                                           7, 5, 6, 4, 3, 1, 2, 0,
-                                           15, 13, 14, 12, 11, 9, 10, 8,
-                                           7, 5, 6, 4, 3, 1, 2, 0,
-                                           15, 13, 14, 12, 11, 9, 10, 8,
-                                           7, 5, 6, 4, 3, 1, 2, 0);
-    __m512i vidxOut1_QPSK = _mm512_set_epi16(31, 27, 23, 19, 15, 11, 7, 3,
+    /* bit t of each 64 bits output word taken from stream t % Qm */
+    static const uint64_t depositMask2[2] = {0x5555555555555555ULL, 0xAAAAAAAAAAAAAAAAULL};
+    static const uint64_t depositMask4[4] = {0x1111111111111111ULL, 0x2222222222222222ULL,
+                                             0x4444444444444444ULL, 0x8888888888888888ULL};
+    /* 8x8 bytes transpose, same shuffles as the 256QAM interleave */
+    const __m512i vidxTr1 = _mm512_set_epi16(31, 27, 23, 19, 15, 11, 7, 3,
                                              30, 26, 22, 18, 14, 10, 6, 2,
                                              29, 25, 21, 17, 13, 9, 5, 1,
                                              28, 24, 20, 16, 12, 8, 4, 0);
-    __m512i vidxOut2_QPSK = _mm512_set_epi8(15, 13, 11, 9, 7, 5, 3, 1,
-                                            14, 12, 10, 8, 6, 4, 2, 0,
-                                            15, 13, 11, 9, 7, 5, 3, 1,
-                                            14, 12, 10, 8, 6, 4, 2, 0,
-                                            15, 13, 11, 9, 7, 5, 3, 1,
-                                            14, 12, 10, 8, 6, 4, 2, 0,
-                                            15, 13, 11, 9, 7, 5, 3, 1,
-                                            14, 12, 10, 8, 6, 4, 2, 0);
-
-    __m512i tmp0_16QAM, tmp1_16QAM, tmp2_16QAM, tmp3_16QAM;
-    __m512i vidxIn1_16QAM = _mm512_set_epi16( 31, 23, 15, 7,
-                                              30, 22, 14, 6,
-                                              29, 21, 13, 5,
-                                              28, 20, 12, 4,
-                                              27, 19, 11, 3,
-                                              26, 18, 10, 2,
-                                              25, 17, 9, 1,
-                                              24, 16, 8, 0);
-    __m512i vidxIn2_16QAM = _mm512_set_epi8(15, 13, 11, 9, 14, 12, 10, 8,
-                                            7, 5, 3, 1, 6, 4, 2, 0,
-                                            15, 13, 11, 9, 14, 12, 10, 8,
-                                            7, 5, 3, 1, 6, 4, 2, 0,
-                                            15, 13, 11, 9, 14, 12, 10, 8,
-                                            7, 5, 3, 1, 6, 4, 2, 0,
-                                            15, 13, 11, 9, 14, 12, 10, 8,
-                                            7, 5, 3, 1, 6, 4, 2, 0);
-    __m512i vidxOut1_16QAM = _mm512_set_epi16(31, 27, 23, 19, 15, 11, 7, 3,
-                                              30, 26, 22, 18, 14, 10, 6, 2,
-                                              29, 25, 21, 17, 13, 9, 5, 1,
-                                              28, 24, 20, 16, 12, 8, 4, 0);
-    __m512i vidxOut2_16QAM = _mm512_set_epi8(15, 13, 11, 9, 7, 5, 3, 1,
-                                             14, 12, 10, 8, 6, 4, 2, 0,
-                                             15, 13, 11, 9, 7, 5, 3, 1,
-                                             14, 12, 10, 8, 6, 4, 2, 0,
-                                             15, 13, 11, 9, 7, 5, 3, 1,
-                                             14, 12, 10, 8, 6, 4, 2, 0,
-                                             15, 13, 11, 9, 7, 5, 3, 1,
-                                             14, 12, 10, 8, 6, 4, 2, 0);
-    __m512i vidxIn1_64QAM = _mm512_set_epi16( 31, 30, 29, 28, 27, 26, 25, 24,
-                                              23, 19, 15, 11, 7, 3,
-                                              22, 18, 14, 10, 6, 2,
-                                              21, 17, 13, 9, 5, 1,
-                                              20, 16, 12, 8, 4, 0);
-    __m512i vidxIn2_64QAM = _mm512_set_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
-                                            15, 13, 11, 9, 7, 5, 14, 12, 10, 8, 6, 4, 3, 1, 2, 0,
-                                            11, 9, 15, 13, 14, 12, 10, 8, 7, 5, 3, 1, 2, 0, 6, 4,
-                                            15, 13, 14, 12, 11, 9, 7, 5, 3, 1, 10, 8, 6, 4, 2, 0);
-    __m512i vidxIn3_64QAM = _mm512_set_epi16( 31, 30, 29, 28, 27, 26, 25, 24,
-                                              23, 22, 21, 20, 19, 18, 17, 14,
-                                              15, 16, 13, 12, 11, 10, 7, 8,
-                                              9, 6, 5, 4, 3, 2, 1, 0);
-    __m512i vidxOut1_64QAM = _mm512_set_epi16(31, 27, 23, 19, 15, 11, 7, 3,
-                                              8, 9, 21, 30, 14, 26, 10, 22,
-                                              6, 29, 13, 25, 18, 2, 28, 12,
-                                              24, 5, 17, 1, 20, 4, 16, 0);
-    __m512i vidxOut2_64QAM = _mm512_set_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
-                                             15, 14, 10, 12, 11, 13, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
-                                             15, 11, 13, 9, 14, 10, 12, 8, 7, 6, 5, 4, 3, 2, 1, 0,
-                                             15, 11, 13, 9, 14, 10, 12, 8, 7, 6, 5, 4, 3, 2, 1, 0);
-    __m512i vidxOut3_64QAM = _mm512_set_epi32(15, 14, 13, 12,
-                                              7, 10, 9, 8,
-                                              3, 6, 5, 4,
-                                              11, 2, 1, 0);
-    __m512i vidxOut4_64QAM = _mm512_set_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
-                                             9, 8, 13, 7, 6, 14, 5, 4, 12, 3, 2, 10, 1, 0, 11, 15,
-                                             11, 13, 7, 6, 14, 5, 4, 12, 9, 3, 2, 10, 1, 0, 8, 15,
-                                             11, 12, 15, 14, 13, 7, 6, 9, 5, 4, 10, 3, 2, 8, 1, 0);
+    const __m512i vidxTr2 = _mm512_set_epi8(15, 13, 11, 9, 7, 5, 3, 1, 14, 12, 10, 8, 6, 4, 2, 0,
+                                            15, 13, 11, 9, 7, 5, 3, 1, 14, 12, 10, 8, 6, 4, 2, 0,
+                                            15, 13, 11, 9, 7, 5, 3, 1, 14, 12, 10, 8, 6, 4, 2, 0,
+                                            15, 13, 11, 9, 7, 5, 3, 1, 14, 12, 10, 8, 6, 4, 2, 0);
+    __m512i inter;
+    uint64_t planes[8];
 
-    __m512i vidxIn1_256QAM = _mm512_set_epi16( 31, 27, 23, 19, 15, 11, 7, 3,
-                                               30, 26, 22, 18, 14, 10, 6, 2,
-                                               29, 25, 21, 17, 13, 9, 5, 1,
-                                               28, 24, 20, 16, 12, 8, 4, 0);
-    __m512i vidxIn2_256QAM = _mm512_set_epi8(15, 13, 11, 9, 7, 5, 3, 1,
-                                             14, 12, 10, 8, 6, 4, 2, 0,
-                                             15, 13, 11, 9, 7, 5, 3, 1,
-                                             14, 12, 10, 8, 6, 4, 2, 0,
-                                             15, 13, 11, 9, 7, 5, 3, 1,
-                                             14, 12, 10, 8, 6, 4, 2, 0,
-                                             15, 13, 11, 9, 7, 5, 3, 1,
-                                             14, 12, 10, 8, 6, 4, 2, 0);
-    __m512i vidxOut1_256QAM = _mm512_set_epi16(31, 27, 23, 19, 15, 11, 7, 3,
-                                               30, 26, 22, 18, 14, 10, 6, 2,
-                                               29, 25, 21, 17, 13, 9, 5, 1,
-                                               28, 24, 20, 16, 12, 8, 4, 0);
-    __m512i vidxOut2_256QAM = _mm512_set_epi8(15, 13, 11, 9, 7, 5, 3, 1,
-                                              14, 12, 10, 8, 6, 4, 2, 0,
-                                              15, 13, 11, 9, 7, 5, 3, 1,
-                                              14, 12, 10, 8, 6, 4, 2, 0,
-                                              15, 13, 11, 9, 7, 5, 3, 1,
-                                              14, 12, 10, 8, 6, 4, 2, 0,
-                                              15, 13, 11, 9, 7, 5, 3, 1,
-                                              14, 12, 10, 8, 6, 4, 2, 0);
     switch (Q)
     {
         case 1:
-            bitTail = jMax & 0x7;
-            memcpy(output, e, lenInByte);
-            if (bitTail > 0)
-            {
-                ippsCopyBE_1u( e+lenInByte, 0, output+lenInByte, 0, bitTail );
-            }
+            *(uint64_t *)dst = w[0];
             break;
         case 2:
-            bitTail = jMax & 0x7;
-            byteTail = lenInByte & 0x3F;
-
-            for (int j = 0;j <= lenInByte-64;j+=64)
-            {
-                tmp0_QPSK = _mm512_loadu_si512((__m512i *)(tmp[0]));
-                tmp1_QPSK = _mm512_loadu_si512((__m512i *)(tmp[1]));
-                tmp[0] += 64;
-                tmp[1] += 64;
-
-                /* order in byte:
-                b0-0  b0-1  ... ... b0-15  // 256 bits
-                b1-0  b1-1  ... ... b1-15
-                */
-                inter = _mm512_shuffle_i32x4(tmp0_QPSK, tmp1_QPSK, 0x44);
-                //inter = _mm512_inserti64x4(inter, tmp1_QPSK, 1);
-
-                /* order in byte:
-                b0-0  b1-0  b0-1  b1-1  ... b0-7  b1-7  // 256 bits
-                b0-8  b1-8  b0-9  b1-9  ... b0-15 b1-15 // 256 bits
-                */
-                inter = _mm512_permutex2var_epi16(inter, vidxIn1_QPSK, inter);
-                inter = _mm512_shuffle_epi8(inter, vidxIn2_QPSK);
-
-                /* order in bit, lower bit to higher bit
-                val1:   14 15, 30 31, 46 47, 62 63, ... , 462 463, 478 479, 494 495, 510 511
-                val2:   12 13, 28 29, 44 45, 60 61, ... , 460 461, 476 477, 492 493, 508 509
-                val3:   10 11, 26 27, 42 43, 58 59, ... , 458 459, 474 475, 490 491, 506 507
-                val4:   8  9 , 24 25, 40 41, 56 57, ... , 456 457, 472 473, 488 489, 504 505
-                order in byte,
-                out[1]: 1, 9,  17, 25, 33, 41, 49, 57
-                out[3]: 3, 11, 19, 27, 35, 43, 51, 59
-                out[5]: 5, 13, 21, 29, 37, 45, 53, 61
-                out[7]: 7, 15, 23, 31, 39, 47, 55, 63
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val3 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val4 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                out[1] = (unsigned __int64)( ( (val1&0x0303030303030303)<<6 ) | ( (val2&0x0303030303030303)<<4 ) | ( (val3&0x0303030303030303)<<2) | (val4&0x0303030303030303) );
-                out[3] = (unsigned __int64)( ( (val1&0x0C0C0C0C0C0C0C0C)<<4 ) | ( (val2&0x0C0C0C0C0C0C0C0C)<<2 ) | (val3&0x0C0C0C0C0C0C0C0C) | ( (val4&0x0C0C0C0C0C0C0C0C)>>2) );
-                out[5] = (unsigned __int64)( ( (val1&0x3030303030303030)<<2 ) | (val2&0x3030303030303030) | ( (val3&0x3030303030303030)>>2 ) | ( (val4&0x3030303030303030)>>4) );
-                out[7] = (unsigned __int64)( (val1&0xC0C0C0C0C0C0C0C0) | ( (val2&0xC0C0C0C0C0C0C0C0)>>2 ) | ( (val3&0xC0C0C0C0C0C0C0C0)>>4 ) | ( (val4&0xC0C0C0C0C0C0C0C0)>>6) );
-
-                /*
-                order in byte,
-                out[0]: 0, 8,  16, 24, 32, 40, 48, 56
-                out[2]: 2, 10, 18, 26, 34, 42, 50, 58
-                out[4]: 4, 12, 20, 28, 36, 44, 52, 60
-                out[6]: 6, 14, 22, 30, 38, 46, 54, 62
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val3 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val4 = _mm512_movepi8_mask(inter);
-                out[0] = (unsigned __int64)( ( (val1&0x0303030303030303)<<6 ) | ( (val2&0x0303030303030303)<<4 ) | ( (val3&0x0303030303030303)<<2) | (val4&0x0303030303030303) );
-                out[2] = (unsigned __int64)( ( (val1&0x0C0C0C0C0C0C0C0C)<<4 ) | ( (val2&0x0C0C0C0C0C0C0C0C)<<2 ) | (val3&0x0C0C0C0C0C0C0C0C) | ( (val4&0x0C0C0C0C0C0C0C0C)>>2) );
-                out[4] = (unsigned __int64)( ( (val1&0x3030303030303030)<<2 ) | (val2&0x3030303030303030) | ( (val3&0x3030303030303030)>>2 ) | ( (val4&0x3030303030303030)>>4) );
-                out[6] = (unsigned __int64)( (val1&0xC0C0C0C0C0C0C0C0) | ( (val2&0xC0C0C0C0C0C0C0C0)>>2 ) | ( (val3&0xC0C0C0C0C0C0C0C0)>>4 ) | ( (val4&0xC0C0C0C0C0C0C0C0)>>6) );
-
-                /* Shuffle to right order */
-                res = _mm512_loadu_si512(out);
-                res = _mm512_permutex2var_epi16(res, vidxOut1_QPSK, res);
-                res = _mm512_shuffle_epi8(res, vidxOut2_QPSK);
-
-                _mm512_storeu_si512(output, res);
-                output += 64;
-
-                inter = _mm512_shuffle_i32x4(tmp0_QPSK, tmp1_QPSK, 0xEE);
-                //inter = _mm512_inserti64x4(inter, tmp1_QPSK, 1);
-
-                /* order in byte:
-                b0-0  b1-0  b0-1  b1-1  ... b0-7  b1-7  // 256 bits
-                b0-8  b1-8  b0-9  b1-9  ... b0-15 b1-15 // 256 bits
-                */
-                inter = _mm512_permutex2var_epi16(inter, vidxIn1_QPSK, inter);
-                inter = _mm512_shuffle_epi8(inter, vidxIn2_QPSK);
-
-                /* order in bit, lower bit to higher bit
-                val1:   14 15, 30 31, 46 47, 62 63, ... , 462 463, 478 479, 494 495, 510 511
-                val2:   12 13, 28 29, 44 45, 60 61, ... , 460 461, 476 477, 492 493, 508 509
-                val3:   10 11, 26 27, 42 43, 58 59, ... , 458 459, 474 475, 490 491, 506 507
-                val4:   8  9 , 24 25, 40 41, 56 57, ... , 456 457, 472 473, 488 489, 504 505
-                order in byte,
-                out[1]: 1, 9,  17, 25, 33, 41, 49, 57
-                out[3]: 3, 11, 19, 27, 35, 43, 51, 59
-                out[5]: 5, 13, 21, 29, 37, 45, 53, 61
-                out[7]: 7, 15, 23, 31, 39, 47, 55, 63
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val3 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val4 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                out[1] = (unsigned __int64)( ( (val1&0x0303030303030303)<<6 ) | ( (val2&0x0303030303030303)<<4 ) | ( (val3&0x0303030303030303)<<2) | (val4&0x0303030303030303) );
-                out[3] = (unsigned __int64)( ( (val1&0x0C0C0C0C0C0C0C0C)<<4 ) | ( (val2&0x0C0C0C0C0C0C0C0C)<<2 ) | (val3&0x0C0C0C0C0C0C0C0C) | ( (val4&0x0C0C0C0C0C0C0C0C)>>2) );
-                out[5] = (unsigned __int64)( ( (val1&0x3030303030303030)<<2 ) | (val2&0x3030303030303030) | ( (val3&0x3030303030303030)>>2 ) | ( (val4&0x3030303030303030)>>4) );
-                out[7] = (unsigned __int64)( (val1&0xC0C0C0C0C0C0C0C0) | ( (val2&0xC0C0C0C0C0C0C0C0)>>2 ) | ( (val3&0xC0C0C0C0C0C0C0C0)>>4 ) | ( (val4&0xC0C0C0C0C0C0C0C0)>>6) );
-
-                /*
-                order in byte,
-                out[0]: 0, 8,  16, 24, 32, 40, 48, 56
-                out[2]: 2, 10, 18, 26, 34, 42, 50, 58
-                out[4]: 4, 12, 20, 28, 36, 44, 52, 60
-                out[6]: 6, 14, 22, 30, 38, 46, 54, 62
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val3 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val4 = _mm512_movepi8_mask(inter);
-                out[0] = (unsigned __int64)( ( (val1&0x0303030303030303)<<6 ) | ( (val2&0x0303030303030303)<<4 ) | ( (val3&0x0303030303030303)<<2) | (val4&0x0303030303030303) );
-                out[2] = (unsigned __int64)( ( (val1&0x0C0C0C0C0C0C0C0C)<<4 ) | ( (val2&0x0C0C0C0C0C0C0C0C)<<2 ) | (val3&0x0C0C0C0C0C0C0C0C) | ( (val4&0x0C0C0C0C0C0C0C0C)>>2) );
-                out[4] = (unsigned __int64)( ( (val1&0x3030303030303030)<<2 ) | (val2&0x3030303030303030) | ( (val3&0x3030303030303030)>>2 ) | ( (val4&0x3030303030303030)>>4) );
-                out[6] = (unsigned __int64)( (val1&0xC0C0C0C0C0C0C0C0) | ( (val2&0xC0C0C0C0C0C0C0C0)>>2 ) | ( (val3&0xC0C0C0C0C0C0C0C0)>>4 ) | ( (val4&0xC0C0C0C0C0C0C0C0)>>6) );
-
-                /* Shuffle to right order */
-                res = _mm512_loadu_si512(out);
-                res = _mm512_permutex2var_epi16(res, vidxOut1_QPSK, res);
-                res = _mm512_shuffle_epi8(res, vidxOut2_QPSK);
-
-                _mm512_storeu_si512(output, res);
-                output += 64;
-            }
-
-            if (byteTail >= 32)
-            {
-                tmp0_QPSK = _mm512_loadu_si512((__m512i *)(tmp[0]));
-                tmp1_QPSK = _mm512_loadu_si512((__m512i *)(tmp[1]));
-
-                /* order in byte:
-                b0-0  b0-1  ... ... b0-15  // 256 bits
-                b1-0  b1-1  ... ... b1-15
-                */
-                inter = _mm512_shuffle_i32x4(tmp0_QPSK, tmp1_QPSK, 0x44);
-                //inter = _mm512_inserti64x4(inter, tmp1_QPSK, 1);
-
-                /* order in byte:
-                b0-0  b1-0  b0-1  b1-1  ... b0-7  b1-7  // 256 bits
-                b0-8  b1-8  b0-9  b1-9  ... b0-15 b1-15 // 256 bits
-                */
-                inter = _mm512_permutex2var_epi16(inter, vidxIn1_QPSK, inter);
-                inter = _mm512_shuffle_epi8(inter, vidxIn2_QPSK);
-
-                /* order in bit, lower bit to higher bit
-                val1:   14 15, 30 31, 46 47, 62 63, ... , 462 463, 478 479, 494 495, 510 511
-                val2:   12 13, 28 29, 44 45, 60 61, ... , 460 461, 476 477, 492 493, 508 509
-                val3:   10 11, 26 27, 42 43, 58 59, ... , 458 459, 474 475, 490 491, 506 507
-                val4:   8  9 , 24 25, 40 41, 56 57, ... , 456 457, 472 473, 488 489, 504 505
-                order in byte,
-                out[1]: 1, 9,  17, 25, 33, 41, 49, 57
-                out[3]: 3, 11, 19, 27, 35, 43, 51, 59
-                out[5]: 5, 13, 21, 29, 37, 45, 53, 61
-                out[7]: 7, 15, 23, 31, 39, 47, 55, 63
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val3 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val4 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                out[1] = (unsigned __int64)( ( (val1&0x0303030303030303)<<6 ) | ( (val2&0x0303030303030303)<<4 ) | ( (val3&0x0303030303030303)<<2) | (val4&0x0303030303030303) );
-                out[3] = (unsigned __int64)( ( (val1&0x0C0C0C0C0C0C0C0C)<<4 ) | ( (val2&0x0C0C0C0C0C0C0C0C)<<2 ) | (val3&0x0C0C0C0C0C0C0C0C) | ( (val4&0x0C0C0C0C0C0C0C0C)>>2) );
-                out[5] = (unsigned __int64)( ( (val1&0x3030303030303030)<<2 ) | (val2&0x3030303030303030) | ( (val3&0x3030303030303030)>>2 ) | ( (val4&0x3030303030303030)>>4) );
-                out[7] = (unsigned __int64)( (val1&0xC0C0C0C0C0C0C0C0) | ( (val2&0xC0C0C0C0C0C0C0C0)>>2 ) | ( (val3&0xC0C0C0C0C0C0C0C0)>>4 ) | ( (val4&0xC0C0C0C0C0C0C0C0)>>6) );
-
-                /*
-                order in byte,
-                out[0]: 0, 8,  16, 24, 32, 40, 48, 56
-                out[2]: 2, 10, 18, 26, 34, 42, 50, 58
-                out[4]: 4, 12, 20, 28, 36, 44, 52, 60
-                out[6]: 6, 14, 22, 30, 38, 46, 54, 62
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val3 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val4 = _mm512_movepi8_mask(inter);
-                out[0] = (unsigned __int64)( ( (val1&0x0303030303030303)<<6 ) | ( (val2&0x0303030303030303)<<4 ) | ( (val3&0x0303030303030303)<<2) | (val4&0x0303030303030303) );
-                out[2] = (unsigned __int64)( ( (val1&0x0C0C0C0C0C0C0C0C)<<4 ) | ( (val2&0x0C0C0C0C0C0C0C0C)<<2 ) | (val3&0x0C0C0C0C0C0C0C0C) | ( (val4&0x0C0C0C0C0C0C0C0C)>>2) );
-                out[4] = (unsigned __int64)( ( (val1&0x3030303030303030)<<2 ) | (val2&0x3030303030303030) | ( (val3&0x3030303030303030)>>2 ) | ( (val4&0x3030303030303030)>>4) );
-                out[6] = (unsigned __int64)( (val1&0xC0C0C0C0C0C0C0C0) | ( (val2&0xC0C0C0C0C0C0C0C0)>>2 ) | ( (val3&0xC0C0C0C0C0C0C0C0)>>4 ) | ( (val4&0xC0C0C0C0C0C0C0C0)>>6) );
-
-                /* Shuffle to right order */
-                res = _mm512_loadu_si512(out);
-                res = _mm512_permutex2var_epi16(res, vidxOut1_QPSK, res);
-                res = _mm512_shuffle_epi8(res, vidxOut2_QPSK);
-
-                _mm512_storeu_si512(output, res);
-
-                tmp[0] += 32;
-                tmp[1] += 32;
-                output += 64;
-                byteTail -= 32;
-            }
-
-            if (byteTail > 0)
-            {
-                tmp0_QPSK = _mm512_loadu_si512((__m512i *)(tmp[0]));
-                tmp1_QPSK = _mm512_loadu_si512((__m512i *)(tmp[1]));
-
-                /* order in byte:
-                b0-0  b0-1  ... ... b0-15  // 256 bits
-                b1-0  b1-1  ... ... b1-15
-                */
-                inter = _mm512_shuffle_i32x4(tmp0_QPSK, tmp1_QPSK, 0x44);
-                //inter = _mm512_inserti64x4(inter, tmp1_QPSK, 1);
-
-                /* order in byte:
-                b0-0  b1-0  b0-1  b1-1  ... b0-7  b1-7  // 256 bits
-                b0-8  b1-8  b0-9  b1-9  ... b0-15 b1-15 // 256 bits
-                */
-                inter = _mm512_permutex2var_epi16(inter, vidxIn1_QPSK, inter);
-                inter = _mm512_shuffle_epi8(inter, vidxIn2_QPSK);
-
-                /* order in bit, lower bit to higher bit
-                val1:   14 15, 30 31, 46 47, 62 63, ... , 462 463, 478 479, 494 495, 510 511
-                val2:   12 13, 28 29, 44 45, 60 61, ... , 460 461, 476 477, 492 493, 508 509
-                val3:   10 11, 26 27, 42 43, 58 59, ... , 458 459, 474 475, 490 491, 506 507
-                val4:   8  9 , 24 25, 40 41, 56 57, ... , 456 457, 472 473, 488 489, 504 505
-                order in byte,
-                out[1]: 1, 9,  17, 25, 33, 41, 49, 57
-                out[3]: 3, 11, 19, 27, 35, 43, 51, 59
-                out[5]: 5, 13, 21, 29, 37, 45, 53, 61
-                out[7]: 7, 15, 23, 31, 39, 47, 55, 63
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val3 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val4 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                out[1] = (unsigned __int64)( ( (val1&0x0303030303030303)<<6 ) | ( (val2&0x0303030303030303)<<4 ) | ( (val3&0x0303030303030303)<<2) | (val4&0x0303030303030303) );
-                out[3] = (unsigned __int64)( ( (val1&0x0C0C0C0C0C0C0C0C)<<4 ) | ( (val2&0x0C0C0C0C0C0C0C0C)<<2 ) | (val3&0x0C0C0C0C0C0C0C0C) | ( (val4&0x0C0C0C0C0C0C0C0C)>>2) );
-                out[5] = (unsigned __int64)( ( (val1&0x3030303030303030)<<2 ) | (val2&0x3030303030303030) | ( (val3&0x3030303030303030)>>2 ) | ( (val4&0x3030303030303030)>>4) );
-                out[7] = (unsigned __int64)( (val1&0xC0C0C0C0C0C0C0C0) | ( (val2&0xC0C0C0C0C0C0C0C0)>>2 ) | ( (val3&0xC0C0C0C0C0C0C0C0)>>4 ) | ( (val4&0xC0C0C0C0C0C0C0C0)>>6) );
-
-                /*
-                order in byte,
-                out[0]: 0, 8,  16, 24, 32, 40, 48, 56
-                out[2]: 2, 10, 18, 26, 34, 42, 50, 58
-                out[4]: 4, 12, 20, 28, 36, 44, 52, 60
-                out[6]: 6, 14, 22, 30, 38, 46, 54, 62
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val3 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val4 = _mm512_movepi8_mask(inter);
-                out[0] = (unsigned __int64)( ( (val1&0x0303030303030303)<<6 ) | ( (val2&0x0303030303030303)<<4 ) | ( (val3&0x0303030303030303)<<2) | (val4&0x0303030303030303) );
-                out[2] = (unsigned __int64)( ( (val1&0x0C0C0C0C0C0C0C0C)<<4 ) | ( (val2&0x0C0C0C0C0C0C0C0C)<<2 ) | (val3&0x0C0C0C0C0C0C0C0C) | ( (val4&0x0C0C0C0C0C0C0C0C)>>2) );
-                out[4] = (unsigned __int64)( ( (val1&0x3030303030303030)<<2 ) | (val2&0x3030303030303030) | ( (val3&0x3030303030303030)>>2 ) | ( (val4&0x3030303030303030)>>4) );
-                out[6] = (unsigned __int64)( (val1&0xC0C0C0C0C0C0C0C0) | ( (val2&0xC0C0C0C0C0C0C0C0)>>2 ) | ( (val3&0xC0C0C0C0C0C0C0C0)>>4 ) | ( (val4&0xC0C0C0C0C0C0C0C0)>>6) );
-
-                /* Shuffle to right order */
-                res = _mm512_loadu_si512(out);
-                res = _mm512_permutex2var_epi16(res, vidxOut1_QPSK, res);
-                res = _mm512_shuffle_epi8(res, vidxOut2_QPSK);
-
-                left = (__mmask64)(tailMask[byteTail]);
-                _mm512_mask_storeu_epi8(output, left, res);
-
-                tmp[0] += byteTail;
-                tmp[1] += byteTail;
-                output += byteTail * 2;
-            }
-
-            byteOffset = 0;
-            bitOffset = 0;
-            for (int i=0;i < bitTail;i++)
-            {
-                ippsCopyBE_1u( (Ipp8u*)tmp[0], i, output+byteOffset, bitOffset+0, 1 );
-                ippsCopyBE_1u( (Ipp8u*)tmp[1], i, output+byteOffset, bitOffset+1, 1 );
-                bitOffset += 2;
-                byteOffset += bitOffset >> 3;
-                bitOffset = bitOffset & 0x7;
-            }
+            *(uint64_t *)(dst) = _pdep_u64(w[0], depositMask2[0]) | _pdep_u64(w[1], depositMask2[1]);
+            *(uint64_t *)(dst + 8) = _pdep_u64(w[0] >> 32, depositMask2[0]) | _pdep_u64(w[1] >> 32, depositMask2[1]);
             break;
         case 4:
-            bitTail = jMax & 0x7;
-            byteTail = lenInByte & 0x3F;
-
-            for (int j = 0;j <= lenInByte-64;j+=64)
-            {
-                tmp0_16QAM = _mm512_loadu_si512((__m512i *)(tmp[0]));
-                tmp1_16QAM = _mm512_loadu_si512((__m512i *)(tmp[1]));
-                tmp2_16QAM = _mm512_loadu_si512((__m512i *)(tmp[2]));
-                tmp3_16QAM = _mm512_loadu_si512((__m512i *)(tmp[3]));
-                tmp[0] += 64;
-                tmp[1] += 64;
-                tmp[2] += 64;
-                tmp[3] += 64;
-
-                /* order in byte:
-                b0-0  b0-1  ... ... b0-16  // 128bits
-                b1-0  b1-1  ... ... b1-16
-                b2-0  b2-1  ... ... b2-16
-                b3-0  b3-1  ... ... b3-16
-                */
-                inter = _mm512_mask_shuffle_i64x2(inter, 0x33, tmp0_16QAM, tmp2_16QAM, 0x0);
-                inter = _mm512_mask_shuffle_i64x2(inter, 0xCC, tmp1_16QAM, tmp3_16QAM, 0x0);
-
-                /* order in byte:
-                b0-0  b1-0  b2-0  b3-0  b0-1  b1-1  b2-1  b3-1  ... b0-3  b1-3  b2-3  b3-3  // 128bits
-                b0-4  b1-4  b2-4  b3-4  b0-5  b1-5  b2-5  b3-5  ... b0-7  b1-7  b2-7  b3-7  // 128bits
-                b0-8  b1-8  b2-8  b3-8  b0-9  b1-9  b2-9  b3-9  ... b0-11 b1-11 b2-11 b3-11 // 128bits
-                b0-12 b1-12 b2-12 b3-12 b0-13 b1-13 b2-13 b3-13 ... b0-15 b1-15 b2-15 b3-15 // 128bits
-                */
-                inter = _mm512_permutex2var_epi16(inter, vidxIn1_16QAM, inter);
-                inter = _mm512_shuffle_epi8(inter, vidxIn2_16QAM);
-
-                /* order in bit, lower bit to higher bit
-                val1:   28 29 30 31, 60 61 62 63, ... , 476 477 478 479, 508 509 510 511
-                val2:   24 25 26 27, 56 57 58 59, ... , 472 473 474 475, 504 505 506 507
-                out[3]: 24 24 26 27, 28 29 30 31, ... , 472 473 474 475, 476 477 478 479
-                out[7]: 56 57 58 59, 60 61 62 63, ... , 504 505 506 507, 508 509 510 511
-                order in byte,
-                out[3]: 3, 11, 19, 27, 35, 43, 51, 59
-                out[7]: 7, 15, 23, 31, 39, 47, 55, 63
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                out[3] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[7] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /*
-                order in byte,
-                out[2]: 2, 10, 18, 26, 34, 42, 50, 58
-                out[6]: 6, 14, 22, 30, 38, 46, 54, 62
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                out[2] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[6] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /*
-                order in byte,
-                out[1]: 1, 9,  17, 25, 33, 41, 49, 57
-                out[5]: 5, 13, 21, 29, 37, 45, 53, 61
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                out[1] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[5] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /*
-                order in byte,
-                out[0]: 0, 8,  16, 24, 32, 40, 48, 56
-                out[4]: 4, 12, 20, 28, 36, 44, 52, 60
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                out[0] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[4] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /* Shuffle to right order */
-                res = _mm512_loadu_si512(out);
-                res = _mm512_permutex2var_epi16(res, vidxOut1_16QAM, res);
-                res = _mm512_shuffle_epi8(res, vidxOut2_16QAM);
-
-                _mm512_storeu_si512(output, res);
-                output += 64;
-
-                inter = _mm512_mask_shuffle_i64x2(inter, 0x33, tmp0_16QAM, tmp2_16QAM, 0x55);
-                inter = _mm512_mask_shuffle_i64x2(inter, 0xCC, tmp1_16QAM, tmp3_16QAM, 0x55);
-
-                /* order in byte:
-                b0-0  b1-0  b2-0  b3-0  b0-1  b1-1  b2-1  b3-1  ... b0-3  b1-3  b2-3  b3-3  // 128bits
-                b0-4  b1-4  b2-4  b3-4  b0-5  b1-5  b2-5  b3-5  ... b0-7  b1-7  b2-7  b3-7  // 128bits
-                b0-8  b1-8  b2-8  b3-8  b0-9  b1-9  b2-9  b3-9  ... b0-11 b1-11 b2-11 b3-11 // 128bits
-                b0-12 b1-12 b2-12 b3-12 b0-13 b1-13 b2-13 b3-13 ... b0-15 b1-15 b2-15 b3-15 // 128bits
-                */
-                inter = _mm512_permutex2var_epi16(inter, vidxIn1_16QAM, inter);
-                inter = _mm512_shuffle_epi8(inter, vidxIn2_16QAM);
-
-                /* order in bit, lower bit to higher bit
-                val1:   28 29 30 31, 60 61 62 63, ... , 476 477 478 479, 508 509 510 511
-                val2:   24 25 26 27, 56 57 58 59, ... , 472 473 474 475, 504 505 506 507
-                out[3]: 24 24 26 27, 28 29 30 31, ... , 472 473 474 475, 476 477 478 479
-                out[7]: 56 57 58 59, 60 61 62 63, ... , 504 505 506 507, 508 509 510 511
-                order in byte,
-                out[3]: 3, 11, 19, 27, 35, 43, 51, 59
-                out[7]: 7, 15, 23, 31, 39, 47, 55, 63
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                out[3] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[7] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /*
-                order in byte,
-                out[2]: 2, 10, 18, 26, 34, 42, 50, 58
-                out[6]: 6, 14, 22, 30, 38, 46, 54, 62
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                out[2] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[6] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /*
-                order in byte,
-                out[1]: 1, 9,  17, 25, 33, 41, 49, 57
-                out[5]: 5, 13, 21, 29, 37, 45, 53, 61
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                out[1] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[5] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /*
-                order in byte,
-                out[0]: 0, 8,  16, 24, 32, 40, 48, 56
-                out[4]: 4, 12, 20, 28, 36, 44, 52, 60
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                out[0] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[4] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /* Shuffle to right order */
-                res = _mm512_loadu_si512(out);
-                res = _mm512_permutex2var_epi16(res, vidxOut1_16QAM, res);
-                res = _mm512_shuffle_epi8(res, vidxOut2_16QAM);
-
-                _mm512_storeu_si512(output, res);
-                output += 64;
-
-                inter = _mm512_mask_shuffle_i64x2(inter, 0x33, tmp0_16QAM, tmp2_16QAM, 0xAA);
-                inter = _mm512_mask_shuffle_i64x2(inter, 0xCC, tmp1_16QAM, tmp3_16QAM, 0xAA);
-
-                /* order in byte:
-                b0-0  b1-0  b2-0  b3-0  b0-1  b1-1  b2-1  b3-1  ... b0-3  b1-3  b2-3  b3-3  // 128bits
-                b0-4  b1-4  b2-4  b3-4  b0-5  b1-5  b2-5  b3-5  ... b0-7  b1-7  b2-7  b3-7  // 128bits
-                b0-8  b1-8  b2-8  b3-8  b0-9  b1-9  b2-9  b3-9  ... b0-11 b1-11 b2-11 b3-11 // 128bits
-                b0-12 b1-12 b2-12 b3-12 b0-13 b1-13 b2-13 b3-13 ... b0-15 b1-15 b2-15 b3-15 // 128bits
-                */
-                inter = _mm512_permutex2var_epi16(inter, vidxIn1_16QAM, inter);
-                inter = _mm512_shuffle_epi8(inter, vidxIn2_16QAM);
-
-                /* order in bit, lower bit to higher bit
-                val1:   28 29 30 31, 60 61 62 63, ... , 476 477 478 479, 508 509 510 511
-                val2:   24 25 26 27, 56 57 58 59, ... , 472 473 474 475, 504 505 506 507
-                out[3]: 24 24 26 27, 28 29 30 31, ... , 472 473 474 475, 476 477 478 479
-                out[7]: 56 57 58 59, 60 61 62 63, ... , 504 505 506 507, 508 509 510 511
-                order in byte,
-                out[3]: 3, 11, 19, 27, 35, 43, 51, 59
-                out[7]: 7, 15, 23, 31, 39, 47, 55, 63
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                out[3] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[7] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /*
-                order in byte,
-                out[2]: 2, 10, 18, 26, 34, 42, 50, 58
-                out[6]: 6, 14, 22, 30, 38, 46, 54, 62
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                out[2] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[6] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /*
-                order in byte,
-                out[1]: 1, 9,  17, 25, 33, 41, 49, 57
-                out[5]: 5, 13, 21, 29, 37, 45, 53, 61
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                out[1] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[5] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /*
-                order in byte,
-                out[0]: 0, 8,  16, 24, 32, 40, 48, 56
-                out[4]: 4, 12, 20, 28, 36, 44, 52, 60
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                out[0] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[4] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /* Shuffle to right order */
-                res = _mm512_loadu_si512(out);
-                res = _mm512_permutex2var_epi16(res, vidxOut1_16QAM, res);
-                res = _mm512_shuffle_epi8(res, vidxOut2_16QAM);
-
-                _mm512_storeu_si512(output, res);
-                output += 64;
-
-                inter = _mm512_mask_shuffle_i64x2(inter, 0x33, tmp0_16QAM, tmp2_16QAM, 0xFF);
-                inter = _mm512_mask_shuffle_i64x2(inter, 0xCC, tmp1_16QAM, tmp3_16QAM, 0xFF);
-
-                /* order in byte:
-                b0-0  b1-0  b2-0  b3-0  b0-1  b1-1  b2-1  b3-1  ... b0-3  b1-3  b2-3  b3-3  // 128bits
-                b0-4  b1-4  b2-4  b3-4  b0-5  b1-5  b2-5  b3-5  ... b0-7  b1-7  b2-7  b3-7  // 128bits
-                b0-8  b1-8  b2-8  b3-8  b0-9  b1-9  b2-9  b3-9  ... b0-11 b1-11 b2-11 b3-11 // 128bits
-                b0-12 b1-12 b2-12 b3-12 b0-13 b1-13 b2-13 b3-13 ... b0-15 b1-15 b2-15 b3-15 // 128bits
-                */
-                inter = _mm512_permutex2var_epi16(inter, vidxIn1_16QAM, inter);
-                inter = _mm512_shuffle_epi8(inter, vidxIn2_16QAM);
-
-                /* order in bit, lower bit to higher bit
-                val1:   28 29 30 31, 60 61 62 63, ... , 476 477 478 479, 508 509 510 511
-                val2:   24 25 26 27, 56 57 58 59, ... , 472 473 474 475, 504 505 506 507
-                out[3]: 24 24 26 27, 28 29 30 31, ... , 472 473 474 475, 476 477 478 479
-                out[7]: 56 57 58 59, 60 61 62 63, ... , 504 505 506 507, 508 509 510 511
-                order in byte,
-                out[3]: 3, 11, 19, 27, 35, 43, 51, 59
-                out[7]: 7, 15, 23, 31, 39, 47, 55, 63
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                out[3] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[7] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /*
-                order in byte,
-                out[2]: 2, 10, 18, 26, 34, 42, 50, 58
-                out[6]: 6, 14, 22, 30, 38, 46, 54, 62
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                out[2] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[6] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /*
-                order in byte,
-                out[1]: 1, 9,  17, 25, 33, 41, 49, 57
-                out[5]: 5, 13, 21, 29, 37, 45, 53, 61
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                out[1] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[5] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /*
-                order in byte,
-                out[0]: 0, 8,  16, 24, 32, 40, 48, 56
-                out[4]: 4, 12, 20, 28, 36, 44, 52, 60
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                out[0] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[4] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /* Shuffle to right order */
-                res = _mm512_loadu_si512(out);
-                res = _mm512_permutex2var_epi16(res, vidxOut1_16QAM, res);
-                res = _mm512_shuffle_epi8(res, vidxOut2_16QAM);
-
-                _mm512_storeu_si512(output, res);
-                output += 64;
-            }
-
-            while (byteTail >= 16)
-            {
-                tmp0_16QAM = _mm512_loadu_si512((__m512i *)(tmp[0]));
-                tmp1_16QAM = _mm512_loadu_si512((__m512i *)(tmp[1]));
-                tmp2_16QAM = _mm512_loadu_si512((__m512i *)(tmp[2]));
-                tmp3_16QAM = _mm512_loadu_si512((__m512i *)(tmp[3]));
-
-                /* order in byte:
-                b0-0  b0-1  ... ... b0-16  // 128bits
-                b1-0  b1-1  ... ... b1-16
-                b2-0  b2-1  ... ... b2-16
-                b3-0  b3-1  ... ... b3-16
-                */
-                inter = _mm512_mask_shuffle_i64x2(inter, 0x33, tmp0_16QAM, tmp2_16QAM, 0x0);
-                inter = _mm512_mask_shuffle_i64x2(inter, 0xCC, tmp1_16QAM, tmp3_16QAM, 0x0);
-
-                /* order in byte:
-                b0-0  b1-0  b2-0  b3-0  b0-1  b1-1  b2-1  b3-1  ... b0-3  b1-3  b2-3  b3-3  // 128bits
-                b0-4  b1-4  b2-4  b3-4  b0-5  b1-5  b2-5  b3-5  ... b0-7  b1-7  b2-7  b3-7  // 128bits
-                b0-8  b1-8  b2-8  b3-8  b0-9  b1-9  b2-9  b3-9  ... b0-11 b1-11 b2-11 b3-11 // 128bits
-                b0-12 b1-12 b2-12 b3-12 b0-13 b1-13 b2-13 b3-13 ... b0-15 b1-15 b2-15 b3-15 // 128bits
-                */
-                inter = _mm512_permutex2var_epi16(inter, vidxIn1_16QAM, inter);
-                inter = _mm512_shuffle_epi8(inter, vidxIn2_16QAM);
-
-                /* order in bit, lower bit to higher bit
-                val1:   28 29 30 31, 60 61 62 63, ... , 476 477 478 479, 508 509 510 511
-                val2:   24 25 26 27, 56 57 58 59, ... , 472 473 474 475, 504 505 506 507
-                out[3]: 24 24 26 27, 28 29 30 31, ... , 472 473 474 475, 476 477 478 479
-                out[7]: 56 57 58 59, 60 61 62 63, ... , 504 505 506 507, 508 509 510 511
-                order in byte,
-                out[3]: 3, 11, 19, 27, 35, 43, 51, 59
-                out[7]: 7, 15, 23, 31, 39, 47, 55, 63
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                out[3] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[7] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /*
-                order in byte,
-                out[2]: 2, 10, 18, 26, 34, 42, 50, 58
-                out[6]: 6, 14, 22, 30, 38, 46, 54, 62
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                out[2] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[6] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /*
-                order in byte,
-                out[1]: 1, 9,  17, 25, 33, 41, 49, 57
-                out[5]: 5, 13, 21, 29, 37, 45, 53, 61
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                out[1] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[5] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /*
-                order in byte,
-                out[0]: 0, 8,  16, 24, 32, 40, 48, 56
-                out[4]: 4, 12, 20, 28, 36, 44, 52, 60
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                out[0] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[4] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /* Shuffle to right order */
-                res = _mm512_loadu_si512(out);
-                res = _mm512_permutex2var_epi16(res, vidxOut1_16QAM, res);
-                res = _mm512_shuffle_epi8(res, vidxOut2_16QAM);
-
-                _mm512_storeu_si512(output, res);
-
-                tmp[0] += 16;
-                tmp[1] += 16;
-                tmp[2] += 16;
-                tmp[3] += 16;
-                output += 64;
-                byteTail -= 16;
-            }
-
-            if (byteTail > 0)
-            {
-                tmp0_16QAM = _mm512_loadu_si512((__m512i *)(tmp[0]));
-                tmp1_16QAM = _mm512_loadu_si512((__m512i *)(tmp[1]));
-                tmp2_16QAM = _mm512_loadu_si512((__m512i *)(tmp[2]));
-                tmp3_16QAM = _mm512_loadu_si512((__m512i *)(tmp[3]));
-
-                /* order in byte:
-                b0-0  b0-1  ... ... b0-16  // 128bits
-                b1-0  b1-1  ... ... b1-16
-                b2-0  b2-1  ... ... b2-16
-                b3-0  b3-1  ... ... b3-16
-                */
-                inter = _mm512_mask_shuffle_i64x2(inter, 0x33, tmp0_16QAM, tmp2_16QAM, 0x0);
-                inter = _mm512_mask_shuffle_i64x2(inter, 0xCC, tmp1_16QAM, tmp3_16QAM, 0x0);
-
-                /* order in byte:
-                b0-0  b1-0  b2-0  b3-0  b0-1  b1-1  b2-1  b3-1  ... b0-3  b1-3  b2-3  b3-3  // 128bits
-                b0-4  b1-4  b2-4  b3-4  b0-5  b1-5  b2-5  b3-5  ... b0-7  b1-7  b2-7  b3-7  // 128bits
-                b0-8  b1-8  b2-8  b3-8  b0-9  b1-9  b2-9  b3-9  ... b0-11 b1-11 b2-11 b3-11 // 128bits
-                b0-12 b1-12 b2-12 b3-12 b0-13 b1-13 b2-13 b3-13 ... b0-15 b1-15 b2-15 b3-15 // 128bits
-                */
-                inter = _mm512_permutex2var_epi16(inter, vidxIn1_16QAM, inter);
-                inter = _mm512_shuffle_epi8(inter, vidxIn2_16QAM);
-
-                /* order in bit, lower bit to higher bit
-                val1:   28 29 30 31, 60 61 62 63, ... , 476 477 478 479, 508 509 510 511
-                val2:   24 25 26 27, 56 57 58 59, ... , 472 473 474 475, 504 505 506 507
-                out[3]: 24 24 26 27, 28 29 30 31, ... , 472 473 474 475, 476 477 478 479
-                out[7]: 56 57 58 59, 60 61 62 63, ... , 504 505 506 507, 508 509 510 511
-                order in byte,
-                out[3]: 3, 11, 19, 27, 35, 43, 51, 59
-                out[7]: 7, 15, 23, 31, 39, 47, 55, 63
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                out[3] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[7] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /*
-                order in byte,
-                out[2]: 2, 10, 18, 26, 34, 42, 50, 58
-                out[6]: 6, 14, 22, 30, 38, 46, 54, 62
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                out[2] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[6] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /*
-                order in byte,
-                out[1]: 1, 9,  17, 25, 33, 41, 49, 57
-                out[5]: 5, 13, 21, 29, 37, 45, 53, 61
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                out[1] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[5] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /*
-                order in byte,
-                out[0]: 0, 8,  16, 24, 32, 40, 48, 56
-                out[4]: 4, 12, 20, 28, 36, 44, 52, 60
-                */
-                val1 = _mm512_movepi8_mask(inter);
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = _mm512_movepi8_mask(inter);
-                out[0] = (unsigned __int64)( ( (val1 & 0x0F0F0F0F0F0F0F0F)<<4 ) | ( val2 & 0x0F0F0F0F0F0F0F0F ) );
-                out[4] = (unsigned __int64)( ( val1 & 0xF0F0F0F0F0F0F0F0 ) | ( (val2 & 0xF0F0F0F0F0F0F0F0)>>4 ) );
-
-                /* Shuffle to right order */
-                res = _mm512_loadu_si512(out);
-                res = _mm512_permutex2var_epi16(res, vidxOut1_16QAM, res);
-                res = _mm512_shuffle_epi8(res, vidxOut2_16QAM);
-
-                left = (__mmask64)(tailMask[byteTail*2]);
-                _mm512_mask_storeu_epi8(output, left, res);
-
-                tmp[0] += byteTail;
-                tmp[1] += byteTail;
-                tmp[2] += byteTail;
-                tmp[3] += byteTail;
-                output += byteTail * 4;
-            }
-
-            byteOffset = 0;
-            bitOffset = 0;
-            for (int i=0;i < bitTail;i++)
-            {
-                ippsCopyBE_1u( (Ipp8u*)tmp[0], i, output+byteOffset, bitOffset+0, 1 );
-                ippsCopyBE_1u( (Ipp8u*)tmp[1], i, output+byteOffset, bitOffset+1, 1 );
-                ippsCopyBE_1u( (Ipp8u*)tmp[2], i, output+byteOffset, bitOffset+2, 1 );
-                ippsCopyBE_1u( (Ipp8u*)tmp[3], i, output+byteOffset, bitOffset+3, 1 );
-                bitOffset += 4;
-                byteOffset += bitOffset >> 3;
-                bitOffset = bitOffset & 0x7;
-            }
+            for (int32_t m = 0; m < 4; m++)
+                *(uint64_t *)(dst + 8 * m) = _pdep_u64(w[0] >> (16 * m), depositMask4[0]) | _pdep_u64(w[1] >> (16 * m), depositMask4[1]) |
+                                             _pdep_u64(w[2] >> (16 * m), depositMask4[2]) | _pdep_u64(w[3] >> (16 * m), depositMask4[3]);
             break;
         case 6:
-            bitTail = jMax & 7;
-            byteTail = lenInByte & 7;
-
-            in[6] = 0;
-            in[7] = 0;
-
-            for (int j = 0;j <= lenInByte-8;j+=8)
+        case 8:
+            /* byte k of stream i to byte 8*k+i, streams 6 and 7 are zero for 64QAM */
+            inter = _mm512_maskz_loadu_epi64((__mmask8)((1 << Q) - 1), w);
+            inter = _mm512_permutexvar_epi16(vidxTr1, inter);
+            inter = _mm512_shuffle_epi8(inter, vidxTr2);
+            /* byte k of planes[b] is the output byte 8*k+b */
+            for (int32_t b = 7; b >= 0; b--)
             {
-                in[0] = *(unsigned __int64 *)(tmp[0]);
-                in[1] = *(unsigned __int64 *)(tmp[1]);
-                in[2] = *(unsigned __int64 *)(tmp[2]);
-                in[3] = *(unsigned __int64 *)(tmp[3]);
-                in[4] = *(unsigned __int64 *)(tmp[4]);
-                in[5] = *(unsigned __int64 *)(tmp[5]);
-
-                inter = _mm512_loadu_si512(in);
-
-                inter = _mm512_permutex2var_epi16(inter, vidxIn1_64QAM, inter);
-                inter = _mm512_shuffle_epi8(inter, vidxIn2_64QAM);
-                inter = _mm512_permutex2var_epi16(inter, vidxIn3_64QAM, inter);
-
-                val1 = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = (unsigned __int64)(_mm512_movepi8_mask(inter));
+                planes[b] = (uint64_t)_mm512_movepi8_mask(inter);
                 inter = _mm512_slli_epi64(inter, 1);
-                val3 = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                val4 = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-
-                out[4] = (val4&0x00003F00003F) | ( (val3&0x00003F00003F)<<6  ) | ( (val2&0x00003F00003F)<<12 ) | ( (val1&0x00003F00003F)<<18 );
-                out[5] = ( (val4&0x000FC0000FC0)>>6  ) | (val3&0x000FC0000FC0) | ( (val2&0x000FC0000FC0)<<6  ) | ( (val1&0x000FC0000FC0)<<12 );
-                out[6] = ( (val4&0x03F00003F000)>>12 ) | ( (val3&0x03F00003F000)>>6  ) | (val2&0x03F00003F000) | ( (val1&0x03F00003F000)<<6  );
-                out[7] = ( (val4&0xFC0000FC0000)>>18 ) | ( (val3&0xFC0000FC0000)>>12 ) | ( (val2&0xFC0000FC0000)>>6  ) | (val1&0xFC0000FC0000);
-
-                val1 = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                val3 = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                val4 = (unsigned __int64)(_mm512_movepi8_mask(inter));
-
-                out[0] = (val4&0x00003F00003F) | ( (val3&0x00003F00003F)<<6  ) | ( (val2&0x00003F00003F)<<12 ) | ( (val1&0x00003F00003F)<<18 );
-                out[1] = ( (val4&0x000FC0000FC0)>>6  ) | (val3&0x000FC0000FC0) | ( (val2&0x000FC0000FC0)<<6  ) | ( (val1&0x000FC0000FC0)<<12 );
-                out[2] = ( (val4&0x03F00003F000)>>12 ) | ( (val3&0x03F00003F000)>>6  ) | (val2&0x03F00003F000) | ( (val1&0x03F00003F000)<<6  );
-                out[3] = ( (val4&0xFC0000FC0000)>>18 ) | ( (val3&0xFC0000FC0000)>>12 ) | ( (val2&0xFC0000FC0000)>>6  ) | (val1&0xFC0000FC0000);
-
-                res = _mm512_loadu_si512(out);
-
-                res = _mm512_permutex2var_epi16(res, vidxOut1_64QAM, res);
-                res = _mm512_shuffle_epi8(res, vidxOut2_64QAM);
-                res = _mm512_permutex2var_epi32(res, vidxOut3_64QAM, res);
-                res = _mm512_shuffle_epi8(res, vidxOut4_64QAM);
-                /* Shuffle to right order */
-
-                _mm512_storeu_si512(output, res);
-
-                tmp[0] += 8;
-                tmp[1] += 8;
-                tmp[2] += 8;
-                tmp[3] += 8;
-                tmp[4] += 8;
-                tmp[5] += 8;
-                output += 48;
             }
-
-            if (byteTail > 0)
+            inter = _mm512_loadu_si512(planes);
+            inter = _mm512_permutexvar_epi16(vidxTr1, inter);
+            inter = _mm512_shuffle_epi8(inter, vidxTr2);
+            if (Q == 8)
             {
-                in[0] = *(unsigned __int64 *)(tmp[0]);
-                in[1] = *(unsigned __int64 *)(tmp[1]);
-                in[2] = *(unsigned __int64 *)(tmp[2]);
-                in[3] = *(unsigned __int64 *)(tmp[3]);
-                in[4] = *(unsigned __int64 *)(tmp[4]);
-                in[5] = *(unsigned __int64 *)(tmp[5]);
-
-                inter = _mm512_loadu_si512(in);
-
-                inter = _mm512_permutex2var_epi16(inter, vidxIn1_64QAM, inter);
-                inter = _mm512_shuffle_epi8(inter, vidxIn2_64QAM);
-                inter = _mm512_permutex2var_epi16(inter, vidxIn3_64QAM, inter);
-
-                val1 = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                val3 = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                val4 = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-
-                out[4] = (val4&0x00003F00003F) | ( (val3&0x00003F00003F)<<6  ) | ( (val2&0x00003F00003F)<<12 ) | ( (val1&0x00003F00003F)<<18 );
-                out[5] = ( (val4&0x000FC0000FC0)>>6  ) | (val3&0x000FC0000FC0) | ( (val2&0x000FC0000FC0)<<6  ) | ( (val1&0x000FC0000FC0)<<12 );
-                out[6] = ( (val4&0x03F00003F000)>>12 ) | ( (val3&0x03F00003F000)>>6  ) | (val2&0x03F00003F000) | ( (val1&0x03F00003F000)<<6  );
-                out[7] = ( (val4&0xFC0000FC0000)>>18 ) | ( (val3&0xFC0000FC0000)>>12 ) | ( (val2&0xFC0000FC0000)>>6  ) | (val1&0xFC0000FC0000);
-
-                val1 = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                val2 = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                val3 = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                val4 = (unsigned __int64)(_mm512_movepi8_mask(inter));
-
-                out[0] = (val4&0x00003F00003F) | ( (val3&0x00003F00003F)<<6  ) | ( (val2&0x00003F00003F)<<12 ) | ( (val1&0x00003F00003F)<<18 );
-                out[1] = ( (val4&0x000FC0000FC0)>>6  ) | (val3&0x000FC0000FC0) | ( (val2&0x000FC0000FC0)<<6  ) | ( (val1&0x000FC0000FC0)<<12 );
-                out[2] = ( (val4&0x03F00003F000)>>12 ) | ( (val3&0x03F00003F000)>>6  ) | (val2&0x03F00003F000) | ( (val1&0x03F00003F000)<<6  );
-                out[3] = ( (val4&0xFC0000FC0000)>>18 ) | ( (val3&0xFC0000FC0000)>>12 ) | ( (val2&0xFC0000FC0000)>>6  ) | (val1&0xFC0000FC0000);
-
-                res = _mm512_loadu_si512(out);
-
-                res = _mm512_permutex2var_epi16(res, vidxOut1_64QAM, res);
-                res = _mm512_shuffle_epi8(res, vidxOut2_64QAM);
-                res = _mm512_permutex2var_epi32(res, vidxOut3_64QAM, res);
-                res = _mm512_shuffle_epi8(res, vidxOut4_64QAM);
-                /* Shuffle to right order */
-
-                left = (__mmask64)(tailMask[byteTail*3]);
-                _mm512_mask_storeu_epi8(output, left, res);
-
-                tmp[0] += byteTail;
-                tmp[1] += byteTail;
-                tmp[2] += byteTail;
-                tmp[3] += byteTail;
-                tmp[4] += byteTail;
-                tmp[5] += byteTail;
-                output += byteTail * 6;
+                _mm512_storeu_si512(dst, inter);
             }
-
-            byteOffset = 0;
-            bitOffset = 0;
-            for (int i=0;i < bitTail;i++)
+            else
             {
-                ippsCopyBE_1u( (Ipp8u*)tmp[0], i, output+byteOffset, bitOffset+0, 1 );
-                ippsCopyBE_1u( (Ipp8u*)tmp[1], i, output+byteOffset, bitOffset+1, 1 );
-                bitOffset += 2;
-                byteOffset += bitOffset >> 3;
-                bitOffset = bitOffset & 0x7;
-                ippsCopyBE_1u( (Ipp8u*)tmp[2], i, output+byteOffset, bitOffset+0, 1 );
-                ippsCopyBE_1u( (Ipp8u*)tmp[3], i, output+byteOffset, bitOffset+1, 1 );
-                bitOffset += 2;
-                byteOffset += bitOffset >> 3;
-                bitOffset = bitOffset & 0x7;
-                ippsCopyBE_1u( (Ipp8u*)tmp[4], i, output+byteOffset, bitOffset+0, 1 );
-                ippsCopyBE_1u( (Ipp8u*)tmp[5], i, output+byteOffset, bitOffset+1, 1 );
-                bitOffset += 2;
-                byteOffset += bitOffset >> 3;
-                bitOffset = bitOffset & 0x7;
+                /* drop the 2 unused bits of each byte, 8 chunks of 48 bits */
+                uint64_t c[8];
+                _mm512_storeu_si512(planes, inter);
+                for (int32_t k = 0; k < 8; k++)
+                    c[k] = _pext_u64(planes[k], 0x3F3F3F3F3F3F3F3FULL);
+                *(uint64_t *)(dst) = c[0] | (c[1] << 48);
+                *(uint64_t *)(dst + 8) = (c[1] >> 16) | (c[2] << 32);
+                *(uint64_t *)(dst + 16) = (c[2] >> 32) | (c[3] << 16);
+                *(uint64_t *)(dst + 24) = c[4] | (c[5] << 48);
+                *(uint64_t *)(dst + 32) = (c[5] >> 16) | (c[6] << 32);
+                *(uint64_t *)(dst + 40) = (c[6] >> 32) | (c[7] << 16);
             }
             break;
-        case 8:
-            bitTail = jMax & 0x7;
-            byteTail = lenInByte & 0x7;
-
-            for (int j = 0;j <= lenInByte-8;j+=8)
-            {
-                in[0] = *(unsigned __int64 *)(tmp[0]);
-                in[1] = *(unsigned __int64 *)(tmp[1]);
-                in[2] = *(unsigned __int64 *)(tmp[2]);
-                in[3] = *(unsigned __int64 *)(tmp[3]);
-                in[4] = *(unsigned __int64 *)(tmp[4]);
-                in[5] = *(unsigned __int64 *)(tmp[5]);
-                in[6] = *(unsigned __int64 *)(tmp[6]);
-                in[7] = *(unsigned __int64 *)(tmp[7]);
-
-                inter = _mm512_loadu_si512(in);
-
-                inter = _mm512_permutex2var_epi16(inter, vidxIn1_256QAM, inter);
-                inter = _mm512_shuffle_epi8(inter, vidxIn2_256QAM);
-
-                out[7] = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                out[6] = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                out[5] = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                out[4] = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                out[3] = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                out[2] = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                out[1] = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                out[0] = (unsigned __int64)(_mm512_movepi8_mask(inter));
+    }
+}
 
-                res = _mm512_loadu_si512(out);
-                res = _mm512_permutex2var_epi16(res, vidxOut1_256QAM, res);
-                res = _mm512_shuffle_epi8(res, vidxOut2_256QAM);
-                /* Shuffle to right order */
+/*! \brief One byte per modulation symbol from num (1..64) symbols of Q packed bits.
+    The first bit of each symbol goes to the MSB of its Q bits index, as in the TS38211 5.1 tables.
+*/
+static inline void ldpc_ratematch_symbols(const uint64_t *bits, int32_t Q, uint8_t *dst, int32_t num)
+{
+    static const uint64_t fieldMask[9] = {0, 0x0101010101010101ULL, 0x0303030303030303ULL, 0,
+                                          0x0F0F0F0F0F0F0F0FULL, 0, 0x3F3F3F3F3F3F3F3FULL, 0,
+                                          0xFFFFFFFFFFFFFFFFULL};
+    const __m512i vRev4 = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15));
+    const __m512i vLowNibble = _mm512_set1_epi8(0x0F);
+    uint64_t sym[8];
+
+    /* 8 symbols, 8*Q bits, per 64 bits word */
+    for (int32_t k = 0; k < 8; k++)
+    {
+        const int32_t pos = 8 * Q * k;
+        uint64_t v = bits[pos >> 6] >> (pos & 63);
+        if ((pos & 63) + 8 * Q > 64)
+            v |= bits[(pos >> 6) + 1] << (64 - (pos & 63));
+        sym[k] = _pdep_u64(v, fieldMask[Q]);
+    }
 
-                _mm512_storeu_si512(output, res);
+    /* bit reverse each byte then keep the Q upper bits */
+    __m512i v = _mm512_loadu_si512(sym);
+    __m512i lo = _mm512_shuffle_epi8(vRev4, _mm512_and_si512(v, vLowNibble));
+    __m512i hi = _mm512_shuffle_epi8(vRev4, _mm512_and_si512(_mm512_srli_epi16(v, 4), vLowNibble));
+    v = _mm512_or_si512(_mm512_slli_epi16(lo, 4), hi);
+    v = _mm512_and_si512(_mm512_srli_epi16(v, 8 - Q), _mm512_set1_epi8((1 << Q) - 1));
+    _mm512_mask_storeu_epi8(dst, (__mmask64)_bzhi_u64(~0ULL, num), v);
+}
 
-                tmp[0] += 8;
-                tmp[1] += 8;
-                tmp[2] += 8;
-                tmp[3] += 8;
-                tmp[4] += 8;
-                tmp[5] += 8;
-                tmp[6] += 8;
-                tmp[7] += 8;
-                output += 64;
-            }
+/*! \brief Rate matching of one code block of E bits, written from bit bitOff (0..7) of output.
+    \note Bits of output before bitOff and after the last bit of the code block are left untouched.
+          When gold is not NULL the output bits are scrambled with it, with symbolOutput set one byte
+          per modulation symbol is written instead of the packed bits and bitOff must be 0.
+*/
+static int32_t ldpc_ratematch_cb(const struct bblib_LDPC_ratematch_5gnr_request *request, const uint8_t *in,
+    int32_t E, uint8_t *output, int32_t bitOff, struct prbs_gold_avx512 *gold, int32_t symbolOutput)
+{
+    const int32_t cb = request->Ncb;
+    const int32_t Q = request->Qm;
+    const int32_t ni = request->nullIndex;
+    const int32_t nl = (ni < 0) ? 0 : request->nLen;
+    const int32_t inBytes = (cb + 7) >> 3;
+    int32_t pos[8];
+    uint64_t w[8];
+    uint64_t chunk[8];
+    struct prbs_gold_avx512 g;
+
+    if ((Q != 1) && (Q != 2) && (Q != 4) && (Q != 6) && (Q != 8))
+    {
+        printf("Wrong parameter for modulation type. It should be 1/2/4/6/8\n");
+        return -1;
+    }
+    const int32_t k0 = ldpc_ratematch_k0(request->baseGraph, request->rvidx, cb, request->Zc);
+    if (k0 < 0)
+        return -1;
+
+    /* Start of each stream in the circular buffer, a start inside the filler bits moves after them */
+    const int32_t bitsPerStream = E / Q;
+    pos[0] = ((k0 < ni) || (k0 > ni + nl)) ? k0 : (ni + nl);
+    for (int32_t i = 1; i < Q; i++)
+        pos[i] = ldpc_ratematch_advance(pos[i - 1], bitsPerStream, cb, ni, nl);
+
+    /* Local copy of the scrambling state, so that it is not reloaded after every store to output */
+    if (gold != NULL)
+        g = *gold;
+
+    /* Bits already in the first output byte ahead of the code block are carried through the shift */
+    uint64_t carry = output[0] & ((1u << bitOff) - 1);
+    int32_t j = 0;
+    for (; j + 64 <= bitsPerStream; j += 64)
+    {
+        for (int32_t i = 0; i < Q; i++)
+            w[i] = ldpc_ratematch_fetch(in, inBytes, cb, ni, nl, &pos[i], 64);
+        if ((bitOff == 0) && (gold == NULL) && !symbolOutput)
+        {
+            ldpc_ratematch_interleave(w, Q, output);
+            output += 8 * Q;
+            continue;
+        }
 
-            if (byteTail > 0)
+        ldpc_ratematch_interleave(w, Q, (uint8_t *)chunk);
+        if (gold != NULL)
+        {
+            for (int32_t k = 0; k < Q; k++)
+                chunk[k] ^= prbs_gold_avx512_next(&g, 64);
+        }
+        if (symbolOutput)
+        {
+            ldpc_ratematch_symbols(chunk, Q, output, 64);
+            output += 64;
+        }
+        else
+        {
+            for (int32_t k = 0; k < Q; k++)
             {
-                in[0] = *(unsigned __int64 *)(tmp[0]);
-                in[1] = *(unsigned __int64 *)(tmp[1]);
-                in[2] = *(unsigned __int64 *)(tmp[2]);
-                in[3] = *(unsigned __int64 *)(tmp[3]);
-                in[4] = *(unsigned __int64 *)(tmp[4]);
-                in[5] = *(unsigned __int64 *)(tmp[5]);
-                in[6] = *(unsigned __int64 *)(tmp[6]);
-                in[7] = *(unsigned __int64 *)(tmp[7]);
-
-                inter = _mm512_loadu_si512(in);
-
-                inter = _mm512_permutex2var_epi16(inter, vidxIn1_256QAM, inter);
-                inter = _mm512_shuffle_epi8(inter, vidxIn2_256QAM);
-
-                out[7] = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                out[6] = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                out[5] = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                out[4] = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                out[3] = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                out[2] = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                out[1] = (unsigned __int64)(_mm512_movepi8_mask(inter));
-                inter = _mm512_slli_epi64(inter, 1);
-                out[0] = (unsigned __int64)(_mm512_movepi8_mask(inter));
-
-                res = _mm512_loadu_si512(out);
-                res = _mm512_permutex2var_epi16(res, vidxOut1_256QAM, res);
-                res = _mm512_shuffle_epi8(res, vidxOut2_256QAM);
-                /* Shuffle to right order */
-
-                left = (__mmask64)(tailMask[byteTail*4]);
-                _mm512_mask_storeu_epi8(output, left, res);
-
-                tmp[0] += byteTail;
-                tmp[1] += byteTail;
-                tmp[2] += byteTail;
-                tmp[3] += byteTail;
-                tmp[4] += byteTail;
-                tmp[5] += byteTail;
-                tmp[6] += byteTail;
-                tmp[7] += byteTail;
-                output += byteTail * 8;
+                ((uint64_t *)output)[k] = (chunk[k] << bitOff) | carry;
+                carry = bitOff ? (chunk[k] >> (64 - bitOff)) : 0;
             }
+            output += 8 * Q;
+        }
+    }
 
-            for (int i=0;i < bitTail;i++)
-            {
-                ippsCopyBE_1u( (Ipp8u*)tmp[0], i, output, 0, 1 );
-                ippsCopyBE_1u( (Ipp8u*)tmp[1], i, output, 1, 1 );
-                ippsCopyBE_1u( (Ipp8u*)tmp[2], i, output, 2, 1 );
-                ippsCopyBE_1u( (Ipp8u*)tmp[3], i, output, 3, 1 );
-                ippsCopyBE_1u( (Ipp8u*)tmp[4], i, output, 4, 1 );
-                ippsCopyBE_1u( (Ipp8u*)tmp[5], i, output, 5, 1 );
-                ippsCopyBE_1u( (Ipp8u*)tmp[6], i, output, 6, 1 );
-                ippsCopyBE_1u( (Ipp8u*)tmp[7], i, output, 7, 1 );
-                output++;
-            }
-            break;
-        default:
-            printf("Wrong parameter for modulation type. It should be 1/2/4/6/8\n");
-            exit(-1);
-            break;
+    /* Last bits of each stream, bits after E in the last output byte are left untouched */
+    const int32_t tail = bitsPerStream - j;
+    uint64_t last[9] = {0};
+    int32_t tailBits = 0;
+    if (tail > 0)
+    {
+        for (int32_t i = 0; i < Q; i++)
+            w[i] = ldpc_ratematch_fetch(in, inBytes, cb, ni, nl, &pos[i], tail);
+        ldpc_ratematch_interleave(w, Q, (uint8_t *)last);
+        tailBits = tail * Q;
+        if (gold != NULL)
+        {
+            for (int32_t k = 0; k < tailBits; k += 64)
+                last[k >> 6] ^= prbs_gold_avx512_next(&g, (tailBits - k < 64) ? (tailBits - k) : 64);
+            *gold = g;
+        }
+        if (symbolOutput)
+            ldpc_ratematch_symbols(last, Q, output, tail);
+    }
+    else if (gold != NULL)
+    {
+        *gold = g;
     }
+    if (symbolOutput)
+        return 0;
+    if (bitOff)
+    {
+        for (int32_t k = 8; k > 0; k--)
+            last[k] = (last[k] << bitOff) | (last[k - 1] >> (64 - bitOff));
+        last[0] = (last[0] << bitOff) | carry;
+        tailBits += bitOff;
+    }
+    memcpy(output, last, tailBits >> 3);
+    if (tailBits & 7)
+    {
+        const uint8_t keep = 0xFF << (tailBits & 7);
+        const uint8_t lastByte = ((const uint8_t *)last)[tailBits >> 3];
+        output[tailBits >> 3] = (output[tailBits >> 3] & keep) | (lastByte & ~keep);
+    }
+    return 0;
 }
 #endif
 //-------------------------------------------------------------------------------------------
@@ -1502,12 +273,69 @@ inline void bitInterleave_avx512(const struct bblib_LDPC_ratematch_5gnr_request
 #ifdef _BBLIB_AVX512_
 int32_t bblib_LDPC_ratematch_5gnr_avx512(const struct bblib_LDPC_ratematch_5gnr_request *request, struct bblib_LDPC_ratematch_5gnr_response *response)
 {
-    uint8_t e[MAX_LENGTH];
-    memset(e, 0, MAX_LENGTH);
+    struct prbs_gold_avx512 gold;
 
-    bitSelect(request, e);
+    if ((request->flags & BBLIB_LDPC_RATEMATCH_SYMBOL_OUTPUT) && (request->E % request->Qm))
+    {
+        printf("E %d is not a multiple of Qm %d for the symbol output\n", request->E, request->Qm);
+        return -1;
+    }
+    if (request->flags & BBLIB_LDPC_RATEMATCH_SCRAMBLING)
+        prbs_gold_avx512_init(&gold, request->cInit, request->scramblingOffset);
+
+    return ldpc_ratematch_cb(request, request->input, request->E, response->output, 0,
+        (request->flags & BBLIB_LDPC_RATEMATCH_SCRAMBLING) ? &gold : NULL,
+        (request->flags & BBLIB_LDPC_RATEMATCH_SYMBOL_OUTPUT) != 0);
+}
 
-    bitInterleave_avx512(request, response, e);
+//-------------------------------------------------------------------------------------------
+/**
+ *  @brief transport block rate matching for LDPC in 5GNR.
+ *  @param [in] request Structure containing configuration information and input data.
+ *  @param [out] response Structure containing kernel outputs.
+ *  @return Success: return 0, else: return -1.
+**/
+int32_t bblib_LDPC_ratematch_5gnr_tb_avx512(const struct bblib_LDPC_ratematch_5gnr_tb_request *request, struct bblib_LDPC_ratematch_5gnr_tb_response *response)
+{
+    const int32_t cbEnd = request->cbStart + ((request->cbNum > 0) ? request->cbNum : request->C);
+    struct bblib_LDPC_ratematch_5gnr_request cbRequest = {};
+    struct prbs_gold_avx512 gold;
+    const int32_t scrambling = (request->flags & BBLIB_LDPC_RATEMATCH_SCRAMBLING) != 0;
+    const int32_t symbolOutput = (request->flags & BBLIB_LDPC_RATEMATCH_SYMBOL_OUTPUT) != 0;
+    int32_t E;
+    int32_t offset;
+
+    if ((request->cbStart < 0) || (cbEnd > request->C))
+    {
+        printf("Wrong code block range %d..%d for %d code blocks\n", request->cbStart, cbEnd - 1, request->C);
+        return -1;
+    }
+
+    cbRequest.Ncb = request->Ncb;
+    cbRequest.Zc = request->Zc;
+    cbRequest.Qm = request->Qm;
+    cbRequest.rvidx = request->rvidx;
+    cbRequest.baseGraph = request->baseGraph;
+    cbRequest.nullIndex = request->nullIndex;
+    cbRequest.nLen = request->nLen;
+
+    /* The scrambling sequence runs over the whole codeword, it is carried from one code block to the next */
+    if (scrambling)
+    {
+        if (bblib_LDPC_ratematch_5gnr_cb_length(request, request->cbStart, &E, &offset) != 0)
+            return -1;
+        prbs_gold_avx512_init(&gold, request->cInit, offset);
+    }
+
+    for (int32_t r = request->cbStart; r < cbEnd; r++)
+    {
+        if (bblib_LDPC_ratematch_5gnr_cb_length(request, r, &E, &offset) != 0)
+            return -1;
+        uint8_t *output = symbolOutput ? (response->output + offset / request->Qm) : (response->output + (offset >> 3));
+        if (ldpc_ratematch_cb(&cbRequest, request->input + (size_t)r * request->cbStride, E, output,
+                symbolOutput ? 0 : (offset & 7), scrambling ? &gold : NULL, symbolOutput) != 0)
+            return -1;
+    }
     return 0;
 }
-#endif
\ No newline at end of file
+#endif
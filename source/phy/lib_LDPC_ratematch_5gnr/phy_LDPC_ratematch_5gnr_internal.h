@@ -0,0 +1,117 @@
+/**********************************************************************
+ *
+*
+*  Copyright [2019 - 2023] [Intel Corporation]
+* 
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  
+*  You may obtain a copy of the License at
+*  
+*     http://www.apache.org/licenses/LICENSE-2.0 
+*  
+*  Unless required by applicable law or agreed to in writing, software 
+*  distributed under the License is distributed on an "AS IS" BASIS, 
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and 
+*  limitations under the License. 
+*  
+*  SPDX-License-Identifier: Apache-2.0 
+*  
+* 
+ *
+ **********************************************************************/
+/*
+ *  @file   phy_LDPC_ratematch_5gnr_internal.h
+ *  @brief  Circular buffer helpers shared by the 5GNR Rate Matching ISA implementations.
+ */
+
+#ifndef _PHY_LDPC_RATEMATCH_5GNR_INTERNAL_H_
+#define _PHY_LDPC_RATEMATCH_5GNR_INTERNAL_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <immintrin.h>
+
+/*! \brief Starting position k0 of the redundancy version, TS38212 Table 5.4.2.1-2.
+    \return k0, or -1 for invalid base graph or rvidx.
+*/
+static inline int32_t ldpc_ratematch_k0(int32_t graph, int32_t rv, int32_t cb, int32_t zc)
+{
+    static const int32_t k0Num[2][4] = {{0, 17, 33, 56}, {0, 13, 25, 43}};
+    if ((graph != 1) && (graph != 2))
+    {
+        printf("Wrong parameter for Base Graph. It should be 1/2\n");
+        return -1;
+    }
+    if ((rv < 0) || (rv > 3))
+    {
+        printf("Wrong parameter for rvidx. It should be 0/1/2/3\n");
+        return -1;
+    }
+    const int32_t den = (graph == 1) ? 66 : 50;
+    return (k0Num[graph - 1][rv] * cb) / (den * zc) * zc;
+}
+
+/*! \brief Circular buffer position after skipping num bits, filler bits excluded. */
+static inline int32_t ldpc_ratematch_advance(int32_t pos, int32_t num, int32_t cb, int32_t ni, int32_t nl)
+{
+    int32_t v = (pos < ni) ? pos : (pos - nl);
+    v = (v + num) % (cb - nl);
+    return (v < ni) ? v : (v + nl);
+}
+
+/*! \brief Read 64 bits starting at bit pos, first bit in the LSB, never reads beyond inBytes. */
+static inline uint64_t ldpc_ratematch_load64(const uint8_t *in, int32_t inBytes, int32_t pos)
+{
+    const int32_t byte = pos >> 3;
+    const int32_t bit = pos & 7;
+    uint64_t v;
+    if (byte + 9 <= inBytes)
+    {
+        v = *(const uint64_t *)(in + byte) >> bit;
+        if (bit)
+            v |= (uint64_t)in[byte + 8] << (64 - bit);
+    }
+    else
+    {
+        v = 0;
+        for (int32_t k = 7; k >= 0; k--)
+            v = (v << 8) | ((byte + k < inBytes) ? in[byte + k] : 0);
+        v >>= bit;
+        if (bit && (byte + 8 < inBytes))
+            v |= (uint64_t)in[byte + 8] << (64 - bit);
+    }
+    return v;
+}
+
+/*! \brief Pull the next num (1..64) bits of a stream, skipping filler bits and wrapping around Ncb. */
+static inline uint64_t ldpc_ratematch_fetch(const uint8_t *in, int32_t inBytes, int32_t cb, int32_t ni, int32_t nl,
+    int32_t *pPos, int32_t num)
+{
+    int32_t pos = *pPos;
+    uint64_t bits = 0;
+    int32_t got = 0;
+    /* most fetches stay within one run of the circular buffer */
+    if (pos + num < ((pos < ni) ? ni : cb))
+    {
+        *pPos = pos + num;
+        return _bzhi_u64(ldpc_ratematch_load64(in, inBytes, pos), num);
+    }
+    while (got < num)
+    {
+        const int32_t end = (pos < ni) ? ni : cb;
+        const int32_t take = (num - got < end - pos) ? (num - got) : (end - pos);
+        bits |= _bzhi_u64(ldpc_ratematch_load64(in, inBytes, pos), take) << got;
+        got += take;
+        pos += take;
+        if (pos == ni)
+            pos += nl;
+        if (pos >= cb)
+            pos = (ni == 0) ? nl : 0;
+    }
+    *pPos = pos;
+    return bits;
+}
+
+#endif
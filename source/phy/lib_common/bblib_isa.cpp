@@ -0,0 +1,146 @@
+/**********************************************************************
+*
+*
+*  Copyright [2019 - 2023] [Intel Corporation]
+* 
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  
+*  You may obtain a copy of the License at
+*  
+*     http://www.apache.org/licenses/LICENSE-2.0 
+*  
+*  Unless required by applicable law or agreed to in writing, software 
+*  distributed under the License is distributed on an "AS IS" BASIS, 
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and 
+*  limitations under the License. 
+*  
+*  SPDX-License-Identifier: Apache-2.0 
+*  
+* 
+*
+**********************************************************************/
+
+/*
+ * @file   bblib_isa.cpp
+ * @brief  CPUID based detection of the instruction set used by the kernel dispatchers.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN64
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+#include "bblib_isa.h"
+
+struct cpuid_regs {
+    uint32_t eax, ebx, ecx, edx;
+};
+
+static struct cpuid_regs
+cpuid(uint32_t leaf, uint32_t subleaf)
+{
+    struct cpuid_regs r = {0, 0, 0, 0};
+#ifdef _WIN64
+    int regs[4];
+    __cpuidex(regs, leaf, subleaf);
+    r.eax = regs[0]; r.ebx = regs[1]; r.ecx = regs[2]; r.edx = regs[3];
+#else
+    __cpuid_count(leaf, subleaf, r.eax, r.ebx, r.ecx, r.edx);
+#endif
+    return r;
+}
+
+/* Register state the OS saves on context switches (XCR0) */
+static uint64_t
+xgetbv0()
+{
+#ifdef _WIN64
+    return _xgetbv(0);
+#else
+    uint32_t lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((uint64_t)hi << 32) | lo;
+#endif
+}
+
+static bool
+has_bits(uint32_t reg, uint32_t bits)
+{
+    return (reg & bits) == bits;
+}
+
+static enum bblib_isa
+detect_isa()
+{
+    const uint32_t max_leaf = cpuid(0, 0).eax;
+    const struct cpuid_regs l1 = cpuid(1, 0);
+
+    /* SSE4.2 is the minimum the libraries are built for. OSXSAVE, AVX, XMM and YMM state enabled by the OS */
+    if (max_leaf < 7 || !has_bits(l1.ecx, (1u << 27) | (1u << 28)) || (xgetbv0() & 0x6) != 0x6)
+        return BBLIB_ISA_SSE4_2;
+
+    const struct cpuid_regs l7 = cpuid(7, 0);
+    /* FMA, MOVBE, F16C; BMI1, AVX2, BMI2 */
+    if (!has_bits(l1.ecx, (1u << 12) | (1u << 22) | (1u << 29)) ||
+        !has_bits(l7.ebx, (1u << 3) | (1u << 5) | (1u << 8)))
+        return BBLIB_ISA_SSE4_2;
+
+    /* AVX512F, DQ, CD, BW, VL and the opmask / ZMM state enabled by the OS */
+    if (!has_bits(l7.ebx, (1u << 16) | (1u << 17) | (1u << 28) | (1u << 30) | (1u << 31)) ||
+        (xgetbv0() & 0xe6) != 0xe6)
+        return BBLIB_ISA_AVX2;
+
+    /* IFMA; VBMI, VBMI2, GFNI, VAES, VPCLMULQDQ, VNNI, BITALG, VPOPCNTDQ */
+    if (!has_bits(l7.ebx, 1u << 21) ||
+        !has_bits(l7.ecx, (1u << 1) | (1u << 6) | (1u << 8) | (1u << 9) | (1u << 10) | (1u << 11) |
+                          (1u << 12) | (1u << 14)))
+        return BBLIB_ISA_AVX512;
+
+    /* AVX512-FP16; AVX512-BF16 */
+    if (!has_bits(l7.edx, 1u << 23) || l7.eax < 1 || !has_bits(cpuid(7, 1).eax, 1u << 5))
+        return BBLIB_ISA_SNC;
+
+    return BBLIB_ISA_SPR;
+}
+
+static enum bblib_isa
+select_isa()
+{
+    static const char *names[] = {"sse4_2", "avx2", "avx512", "snc", "spr"};
+    const enum bblib_isa host = detect_isa();
+
+    const char *env = getenv("BBLIB_ISA");
+    if (env == NULL || env[0] == '\0')
+        return host;
+
+    for (int32_t i = BBLIB_ISA_SSE4_2; i <= BBLIB_ISA_SPR; i++)
+    {
+        if (strcmp(env, names[i]) != 0)
+            continue;
+        if (i > host)
+        {
+            printf("BBLIB_ISA=%s is not supported by this CPU, using %s\n", env, names[host]);
+            return host;
+        }
+        return (enum bblib_isa)i;
+    }
+
+    printf("BBLIB_ISA=%s is unknown (sse4_2, avx2, avx512, snc or spr), using %s\n", env, names[host]);
+    return host;
+}
+
+enum bblib_isa
+bblib_get_isa(void)
+{
+    /* Kernel libraries call this from their static initialisers, hence the function local cache */
+    static const enum bblib_isa isa = select_isa();
+    return isa;
+}
@@ -0,0 +1,59 @@
+/*******************************************************************************
+*
+*
+*  Copyright [2019 - 2023] [Intel Corporation]
+* 
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  
+*  You may obtain a copy of the License at
+*  
+*     http://www.apache.org/licenses/LICENSE-2.0 
+*  
+*  Unless required by applicable law or agreed to in writing, software 
+*  distributed under the License is distributed on an "AS IS" BASIS, 
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and 
+*  limitations under the License. 
+*  
+*  SPDX-License-Identifier: Apache-2.0 
+*  
+* 
+*
+*******************************************************************************/
+/*! \file   bblib_isa.h
+    \brief  Run time detection of the instruction set used to pick kernel variants.
+*/
+
+#ifndef _BBLIB_ISA_H_
+#define _BBLIB_ISA_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \enum bblib_isa
+    \brief Instruction set levels of the kernel variants, each one a superset of the previous.
+*/
+enum bblib_isa {
+    BBLIB_ISA_SSE4_2 = 0, /*!< SSE4.2 and PCLMULQDQ */
+    BBLIB_ISA_AVX2,       /*!< Broadwell: AVX2, FMA, BMI1/2 */
+    BBLIB_ISA_AVX512,     /*!< Skylake server: AVX512F/CD/BW/DQ/VL */
+    BBLIB_ISA_SNC,        /*!< Sunny Cove: adds VBMI/VBMI2, VNNI, BITALG, GFNI, VAES, VPCLMULQDQ */
+    BBLIB_ISA_SPR         /*!< Sapphire Rapids: adds AVX512-FP16 and AVX512-BF16 */
+};
+
+/*! \brief Highest instruction set level the CPU and the OS support.
+
+    The CPUID result is cached on the first call. Setting the environment variable BBLIB_ISA to
+    sse4_2, avx2, avx512, snc or spr caps the level, so the kernel variants of one build can be
+    compared on the same host. A level above what the host supports is ignored.
+    \return Instruction set level used by the *_select_on_isa() dispatchers.
+*/
+enum bblib_isa bblib_get_isa(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* #ifndef _BBLIB_ISA_H_ */
@@ -33,20 +33,27 @@
 #include <malloc.h>
 
 #include "common_typedef_sdk.h"
+#include "bblib_isa.h"
 #include "bit_reverse.h"
 
 
 int16_t bblib_bit_reverse(int8_t* output, int32_t num_data)
 {
 #if defined(_BBLIB_AVX512_)
-    bblib_bit_reverse_avx512(output, num_data);
-    return 0;
-#elif defined(_BBLIB_AVX2_)
-    bblib_bit_reverse_avx2(output, num_data);
-    return 0;
-#else
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+    {
+        bblib_bit_reverse_avx512(output, num_data);
+        return 0;
+    }
+#endif
+#if defined(_BBLIB_AVX2_)
+    if (bblib_get_isa() >= BBLIB_ISA_AVX2)
+    {
+        bblib_bit_reverse_avx2(output, num_data);
+        return 0;
+    }
+#endif
     bblib_bit_reverse_c(output, num_data);
     return 0;
-#endif
 }
 
@@ -33,21 +33,28 @@
 #include <malloc.h>
 
 #include "common_typedef_sdk.h"
+#include "bblib_isa.h"
 #include "float_int16_convert_agc.h"
 
 
 int16_t bblib_float_to_int16_agc( int16_t* output, float* input, int32_t num_data, float gain )
 {
 #if defined(_BBLIB_AVX512_)
-    bblib_float_to_int16_agc_avx512( output, input, num_data, gain );
-    return 0;
-#elif defined(_BBLIB_AVX2_)
-    bblib_float_to_int16_agc_avx2( output, input, num_data, gain );
-    return 0;
-#else
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+    {
+        bblib_float_to_int16_agc_avx512( output, input, num_data, gain );
+        return 0;
+    }
+#endif
+#if defined(_BBLIB_AVX2_)
+    if (bblib_get_isa() >= BBLIB_ISA_AVX2)
+    {
+        bblib_float_to_int16_agc_avx2( output, input, num_data, gain );
+        return 0;
+    }
+#endif
     bblib_float_to_int16_agc_c( output, input, num_data, gain );
     return 0;
-#endif
 }
 
 
@@ -55,52 +62,68 @@ int16_t bblib_float_to_int16_agc_threshold( int16_t* output, float* input, int32
         float gain, int16_t threshold )
 {
 #if defined(_BBLIB_AVX512_)
-    return bblib_float_to_int16_agc_threshold_avx512( output, input, num_data, gain, threshold );
-#elif defined(_BBLIB_AVX2_)
-    return bblib_float_to_int16_agc_threshold_avx2( output, input, num_data, gain, threshold );
-#else
-    return bblib_float_to_int16_agc_threshold_c( output, input, num_data, gain, threshold );
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+        return bblib_float_to_int16_agc_threshold_avx512( output, input, num_data, gain, threshold );
 #endif
+#if defined(_BBLIB_AVX2_)
+    if (bblib_get_isa() >= BBLIB_ISA_AVX2)
+        return bblib_float_to_int16_agc_threshold_avx2( output, input, num_data, gain, threshold );
+#endif
+    return bblib_float_to_int16_agc_threshold_c( output, input, num_data, gain, threshold );
 }
 
 
 int16_t bblib_int16_to_float_agc( float* output, int16_t* input, int32_t num_data, float gain )
 {
 #if defined(_BBLIB_AVX512_)
-    bblib_int16_to_float_agc_avx512( output, input, num_data, gain );
-    return 0;
-#elif defined(_BBLIB_AVX2_)
-    bblib_int16_to_float_agc_avx2( output, input, num_data, gain );
-    return 0;
-#else
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+    {
+        bblib_int16_to_float_agc_avx512( output, input, num_data, gain );
+        return 0;
+    }
+#endif
+#if defined(_BBLIB_AVX2_)
+    if (bblib_get_isa() >= BBLIB_ISA_AVX2)
+    {
+        bblib_int16_to_float_agc_avx2( output, input, num_data, gain );
+        return 0;
+    }
+#endif
     bblib_int16_to_float_agc_c( output, input, num_data, gain );
     return 0;
-#endif
 }
 
 
 int16_t bblib_int16_to_int16_agc(int16_t* output, int16_t* input, int32_t num_data, float gain)
 {
 #if defined(_BBLIB_AVX512_)
-    bblib_int16_to_int16_agc_avx512( output, input, num_data, gain );
-    return 0;
-#elif defined(_BBLIB_AVX2_)
-    bblib_int16_to_int16_agc_avx2( output, input, num_data, gain );
-    return 0;
-#else
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+    {
+        bblib_int16_to_int16_agc_avx512( output, input, num_data, gain );
+        return 0;
+    }
+#endif
+#if defined(_BBLIB_AVX2_)
+    if (bblib_get_isa() >= BBLIB_ISA_AVX2)
+    {
+        bblib_int16_to_int16_agc_avx2( output, input, num_data, gain );
+        return 0;
+    }
+#endif
     bblib_int16_to_int16_agc_c( output, input, num_data, gain );
     return 0;
-#endif
 }
 
 int16_t bblib_int16_to_int16_fxp_scale(int16_t *scaleOut, int16_t *scaleIn, int32_t num_samples, int16_t scale16)
 {
 #if defined(_BBLIB_AVX512_)
-    bblib_int16_to_int16_fxp_scale_avx512( scaleOut, scaleIn, num_samples, scale16 );
-    return 0;
-#else
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+    {
+        bblib_int16_to_int16_fxp_scale_avx512( scaleOut, scaleIn, num_samples, scale16 );
+        return 0;
+    }
+#endif
     bblib_int16_to_int16_fxp_scale_c( scaleOut, scaleIn, num_samples, scale16 );
     return 0;
-#endif
 }
 
@@ -0,0 +1,154 @@
+/**********************************************************************
+*
+*
+*  Copyright [2019 - 2023] [Intel Corporation]
+* 
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  
+*  You may obtain a copy of the License at
+*  
+*     http://www.apache.org/licenses/LICENSE-2.0 
+*  
+*  Unless required by applicable law or agreed to in writing, software 
+*  distributed under the License is distributed on an "AS IS" BASIS, 
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and 
+*  limitations under the License. 
+*  
+*  SPDX-License-Identifier: Apache-2.0 
+*  
+* 
+*
+**********************************************************************/
+/*!
+    \file   pseudo_random_seq_gen_avx2.h
+    \brief  Inline AVX2 generator of the pseudo-random sequence defined in TS38.211 section 5.2,
+            for kernels applying it on the fly.
+*/
+
+#ifndef _PSEUDO_RANDOM_SEQ_GEN_AVX2_
+#define _PSEUDO_RANDOM_SEQ_GEN_AVX2_
+
+#include <stdint.h>
+#include <immintrin.h>
+
+/*! \brief Words 0 .. 40 of the m-sequences x1 and x2 for cInit, Nc = 1600 is word 25. */
+static inline void prbs_gold_window(uint32_t cInit, uint64_t *x1, uint64_t *x2)
+{
+    /* x1(0) = 1 and x2(0..30) = cInit */
+    for (int32_t k = 0; k < 41; k++)
+        x1[k] = x2[k] = 0;
+    x1[0] = 1;
+    x2[0] = cInit & 0x7FFFFFFF;
+    for (int32_t m = 31; m < 128; m += 28)
+    {
+        /* 28 bits at a time from x(m-31) .. x(m-1) as in bblib_prbs_basic */
+        const int32_t p = m - 31;
+        const uint64_t v1 = (x1[p >> 6] >> (p & 63)) | ((p & 63) ? (x1[(p >> 6) + 1] << (64 - (p & 63))) : 0);
+        const uint64_t v2 = (x2[p >> 6] >> (p & 63)) | ((p & 63) ? (x2[(p >> 6) + 1] << (64 - (p & 63))) : 0);
+        const uint64_t new1 = (v1 ^ (v1 >> 3)) & 0x0FFFFFFF;
+        const uint64_t new2 = (v2 ^ (v2 >> 1) ^ (v2 >> 2) ^ (v2 >> 3)) & 0x0FFFFFFF;
+        x1[m >> 6] |= new1 << (m & 63);
+        x2[m >> 6] |= new2 << (m & 63);
+        if ((m & 63) > 36)
+        {
+            x1[(m >> 6) + 1] |= new1 >> (64 - (m & 63));
+            x2[(m >> 6) + 1] |= new2 >> (64 - (m & 63));
+        }
+    }
+    /* 64 bits at a time with the polynomials to the 4th power, x1(m) = x1(m-112) + x1(m-124) etc. */
+    for (int32_t k = 2; k < 41; k++)
+    {
+#define GOLD_WINDOW(w, s) (((w)[k - 2] >> (s)) | ((w)[k - 1] << (64 - (s))))
+        x1[k] = GOLD_WINDOW(x1, 4) ^ GOLD_WINDOW(x1, 16);
+        x2[k] = GOLD_WINDOW(x2, 4) ^ GOLD_WINDOW(x2, 8) ^ GOLD_WINDOW(x2, 12) ^ GOLD_WINDOW(x2, 16);
+#undef GOLD_WINDOW
+    }
+}
+
+/*
+ * Same generator as pseudo_random_seq_gen_avx512.h with 256 bits registers, the 1024 bits windows of the
+ * m-sequences are held in four registers and 256 new bits are derived at once.
+ */
+struct prbs_gold_avx2 {
+    __m256i x1[4];  /* x1(n) .. x1(n+1023), x1(n) in the LSB of x1[0] */
+    __m256i x2[4];  /* x2(n) .. x2(n+1023) */
+    uint64_t c[5];  /* c(n-256) .. c(n-1), handed out LSB first, c[4] is 0 */
+    int32_t used;   /* bits of c already consumed */
+};
+
+/*! \brief Move the m-sequences windows 256 bits forward. */
+static inline void prbs_gold_avx2_advance(struct prbs_gold_avx2 *g)
+{
+    /* bits m-992, m-960, m-928 and m-896 are 4, 8, 12 and 16 bytes in the window */
+    const __m256i x1Mid = _mm256_permute2x128_si256(g->x1[0], g->x1[1], 0x21);
+    const __m256i x2Mid = _mm256_permute2x128_si256(g->x2[0], g->x2[1], 0x21);
+    const __m256i new1 = _mm256_xor_si256(_mm256_alignr_epi8(x1Mid, g->x1[0], 4), x1Mid);
+    const __m256i new2 = _mm256_xor_si256(_mm256_xor_si256(_mm256_alignr_epi8(x2Mid, g->x2[0], 4),
+                                                           _mm256_alignr_epi8(x2Mid, g->x2[0], 8)),
+                                          _mm256_xor_si256(_mm256_alignr_epi8(x2Mid, g->x2[0], 12), x2Mid));
+    for (int32_t k = 0; k < 3; k++)
+    {
+        g->x1[k] = g->x1[k + 1];
+        g->x2[k] = g->x2[k + 1];
+    }
+    g->x1[3] = new1;
+    g->x2[3] = new2;
+}
+
+/*! \brief Next 256 bits of c(n). */
+static inline void prbs_gold_avx2_refill(struct prbs_gold_avx2 *g)
+{
+    _mm256_storeu_si256((__m256i *) g->c, _mm256_xor_si256(g->x1[0], g->x2[0]));
+    prbs_gold_avx2_advance(g);
+    g->used = 0;
+}
+
+/*! \brief Bits pos .. pos+63 of c, pos <= 256. */
+static inline uint64_t prbs_gold_avx2_read(const struct prbs_gold_avx2 *g, int32_t pos)
+{
+    const int32_t bit = pos & 63;
+    uint64_t v = g->c[pos >> 6];
+    if (bit)
+        v = (v >> bit) | (g->c[(pos >> 6) + 1] << (64 - bit));
+    return v;
+}
+
+/*! \brief Next num (0..64) bits of c(n). */
+static inline uint64_t prbs_gold_avx2_next(struct prbs_gold_avx2 *g, int32_t num)
+{
+    if (g->used + num <= 256)
+    {
+        const uint64_t c = _bzhi_u64(prbs_gold_avx2_read(g, g->used), num);
+        g->used += num;
+        return c;
+    }
+    const int32_t first = 256 - g->used;
+    const uint64_t lo = _bzhi_u64(prbs_gold_avx2_read(g, g->used), first);
+    prbs_gold_avx2_refill(g);
+    g->used = num - first;
+    return lo | (_bzhi_u64(g->c[0], num - first) << first);
+}
+
+/*! \brief Scrambling sequence c(n) for cInit, positioned at n = offset. */
+static inline void prbs_gold_avx2_init(struct prbs_gold_avx2 *g, uint32_t cInit, uint32_t offset)
+{
+    uint64_t x1[41];
+    uint64_t x2[41];
+
+    prbs_gold_window(cInit, x1, x2);
+    for (int32_t k = 0; k < 4; k++)
+    {
+        g->x1[k] = _mm256_loadu_si256((const __m256i *) &x1[25 + 4 * k]);
+        g->x2[k] = _mm256_loadu_si256((const __m256i *) &x2[25 + 4 * k]);
+    }
+    g->c[4] = 0;
+
+    for (; offset >= 256; offset -= 256)
+        prbs_gold_avx2_advance(g);
+    prbs_gold_avx2_refill(g);
+    g->used = offset;
+}
+
+#endif // _PSEUDO_RANDOM_SEQ_GEN_AVX2_
@@ -0,0 +1,120 @@
+/**********************************************************************
+*
+*
+*  Copyright [2019 - 2023] [Intel Corporation]
+* 
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  
+*  You may obtain a copy of the License at
+*  
+*     http://www.apache.org/licenses/LICENSE-2.0 
+*  
+*  Unless required by applicable law or agreed to in writing, software 
+*  distributed under the License is distributed on an "AS IS" BASIS, 
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and 
+*  limitations under the License. 
+*  
+*  SPDX-License-Identifier: Apache-2.0 
+*  
+* 
+*
+**********************************************************************/
+/*!
+    \file   pseudo_random_seq_gen_avx512.h
+    \brief  Inline AVX512 generator of the pseudo-random sequence defined in TS38.211 section 5.2,
+            for kernels applying it on the fly.
+*/
+
+#ifndef _PSEUDO_RANDOM_SEQ_GEN_AVX512_
+#define _PSEUDO_RANDOM_SEQ_GEN_AVX512_
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#include "pseudo_random_seq_gen_avx2.h"
+
+/*
+ * Scrambling sequence c(n) = x1(n + Nc) + x2(n + Nc) of TS38211 5.2.1. Raising the generator polynomials
+ * to the 32nd power gives x1(m) = x1(m-896) + x1(m-992) and x2(m) = x2(m-896) + x2(m-928) + x2(m-960) + x2(m-992),
+ * so 512 new bits of each m-sequence are derived at once from a 1024 bits window held in two registers.
+ */
+struct prbs_gold_avx512 {
+    __m512i x1[2];  /* x1(n) .. x1(n+1023), x1(n) in the LSB of x1[0] */
+    __m512i x2[2];  /* x2(n) .. x2(n+1023) */
+    uint64_t c[9];  /* c(n-512) .. c(n-1), handed out LSB first, c[8] is 0 */
+    int32_t used;   /* bits of c already consumed */
+};
+
+/*! \brief Move the m-sequences windows 512 bits forward. */
+static inline void prbs_gold_avx512_advance(struct prbs_gold_avx512 *g)
+{
+    /* bits m-992, m-960, m-928 and m-896 are 4, 8, 12 and 16 bytes in the window */
+    const __m512i new1 = _mm512_xor_si512(_mm512_alignr_epi32(g->x1[1], g->x1[0], 1),
+                                          _mm512_alignr_epi32(g->x1[1], g->x1[0], 4));
+    const __m512i new2 = _mm512_ternarylogic_epi32(_mm512_alignr_epi32(g->x2[1], g->x2[0], 1),
+                                                   _mm512_alignr_epi32(g->x2[1], g->x2[0], 2),
+                                                   _mm512_xor_si512(_mm512_alignr_epi32(g->x2[1], g->x2[0], 3),
+                                                                    _mm512_alignr_epi32(g->x2[1], g->x2[0], 4)), 0x96);
+    g->x1[0] = g->x1[1];
+    g->x1[1] = new1;
+    g->x2[0] = g->x2[1];
+    g->x2[1] = new2;
+}
+
+/*! \brief Next 512 bits of c(n). */
+static inline void prbs_gold_avx512_refill(struct prbs_gold_avx512 *g)
+{
+    _mm512_storeu_si512(g->c, _mm512_xor_si512(g->x1[0], g->x2[0]));
+    prbs_gold_avx512_advance(g);
+    g->used = 0;
+}
+
+/*! \brief Bits pos .. pos+63 of c, pos <= 512. */
+static inline uint64_t prbs_gold_avx512_read(const struct prbs_gold_avx512 *g, int32_t pos)
+{
+    const int32_t bit = pos & 63;
+    uint64_t v = g->c[pos >> 6];
+    if (bit)
+        v = (v >> bit) | (g->c[(pos >> 6) + 1] << (64 - bit));
+    return v;
+}
+
+/*! \brief Next num (0..64) bits of c(n). */
+static inline uint64_t prbs_gold_avx512_next(struct prbs_gold_avx512 *g, int32_t num)
+{
+    if (g->used + num <= 512)
+    {
+        const uint64_t c = _bzhi_u64(prbs_gold_avx512_read(g, g->used), num);
+        g->used += num;
+        return c;
+    }
+    const int32_t first = 512 - g->used;
+    const uint64_t lo = _bzhi_u64(prbs_gold_avx512_read(g, g->used), first);
+    prbs_gold_avx512_refill(g);
+    g->used = num - first;
+    return lo | (_bzhi_u64(g->c[0], num - first) << first);
+}
+
+/*! \brief Scrambling sequence c(n) for cInit, positioned at n = offset. */
+static inline void prbs_gold_avx512_init(struct prbs_gold_avx512 *g, uint32_t cInit, uint32_t offset)
+{
+    uint64_t x1[41];
+    uint64_t x2[41];
+
+    prbs_gold_window(cInit, x1, x2);
+    /* Nc = 1600 is word 25 */
+    g->x1[0] = _mm512_loadu_si512(&x1[25]);
+    g->x1[1] = _mm512_loadu_si512(&x1[33]);
+    g->x2[0] = _mm512_loadu_si512(&x2[25]);
+    g->x2[1] = _mm512_loadu_si512(&x2[33]);
+    g->c[8] = 0;
+
+    for (; offset >= 512; offset -= 512)
+        prbs_gold_avx512_advance(g);
+    prbs_gold_avx512_refill(g);
+    g->used = offset;
+}
+
+#endif // _PSEUDO_RANDOM_SEQ_GEN_AVX512_
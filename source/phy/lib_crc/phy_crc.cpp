@@ -30,12 +30,15 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
 #include <cstdlib>
+#include <immintrin.h>
 #include <functional>
 
 #include "phy_crc.h"
 #include "phy_crc_internal.h"
 #include "sdk_version.h"
+#include "bblib_isa.h"
 
 typedef void (*crc_function)(bblib_crc_request *request, bblib_crc_response *response);
 
@@ -79,14 +82,14 @@ bblib_lte_crc_version(char *version, int buffer_size)
 static crc_function
 bblib_crc24a_gen_select_on_isa() {
 #ifdef _BBLIB_SNC_
-    return bblib_lte_crc24a_gen_snc;
-#else
-    #ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_SNC)
+        return bblib_lte_crc24a_gen_snc;
+#endif
+#ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
         return bblib_lte_crc24a_gen_avx512;
-    #else
-        return bblib_lte_crc24a_gen_sse;
-    #endif
 #endif
+    return bblib_lte_crc24a_gen_sse;
 }
 
 static crc_function default_crc24a_gen = bblib_crc24a_gen_select_on_isa();
@@ -100,14 +103,14 @@ void bblib_lte_crc24a_gen(struct bblib_crc_request *request, struct bblib_crc_re
 static crc_function
 bblib_crc24a_check_select_on_isa() {
 #ifdef _BBLIB_SNC_
-    return bblib_lte_crc24a_check_snc;
-#else
-    #ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_SNC)
+        return bblib_lte_crc24a_check_snc;
+#endif
+#ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
         return bblib_lte_crc24a_check_avx512;
-    #else
-        return bblib_lte_crc24a_check_sse;
-    #endif
 #endif
+    return bblib_lte_crc24a_check_sse;
 }
 
 static crc_function default_crc24a_check = bblib_crc24a_check_select_on_isa();
@@ -121,14 +124,14 @@ void bblib_lte_crc24a_check(struct bblib_crc_request *request, struct bblib_crc_
 static crc_function
 bblib_crc24b_gen_select_on_isa() {
 #ifdef _BBLIB_SNC_
-    return bblib_lte_crc24b_gen_snc;
-#else
-    #ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_SNC)
+        return bblib_lte_crc24b_gen_snc;
+#endif
+#ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
         return bblib_lte_crc24b_gen_avx512;
-    #else
-        return bblib_lte_crc24b_gen_sse;
-    #endif
 #endif
+    return bblib_lte_crc24b_gen_sse;
 }
 
 static crc_function default_crc24b_gen = bblib_crc24b_gen_select_on_isa();
@@ -142,14 +145,14 @@ void bblib_lte_crc24b_gen(struct bblib_crc_request *request, struct bblib_crc_re
 static crc_function
 bblib_crc24b_check_select_on_isa() {
 #ifdef _BBLIB_SNC_
-    return bblib_lte_crc24b_check_snc;
-#else
-    #ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_SNC)
+        return bblib_lte_crc24b_check_snc;
+#endif
+#ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
         return bblib_lte_crc24b_check_avx512;
-    #else
-        return bblib_lte_crc24b_check_sse;
-    #endif
 #endif
+    return bblib_lte_crc24b_check_sse;
 }
 
 static crc_function default_crc24b_check = bblib_crc24b_check_select_on_isa();
@@ -160,13 +163,40 @@ void bblib_lte_crc24b_check(struct bblib_crc_request *request, struct bblib_crc_
 }
 
 
+typedef uint32_t (*crc_multi_function)(const struct bblib_crc_request *request, int32_t num);
+
+static crc_multi_function
+bblib_crc24b_check_multi_select_on_isa() {
+#ifdef _BBLIB_SNC_
+    if (bblib_get_isa() >= BBLIB_ISA_SNC)
+        return bblib_lte_crc24b_check_multi_snc;
+#endif
+#ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+        return bblib_lte_crc24b_check_multi_avx512;
+#endif
+    return bblib_lte_crc24b_check_multi_sse;
+}
+
+static crc_multi_function default_crc24b_check_multi = bblib_crc24b_check_multi_select_on_isa();
+
+uint32_t bblib_lte_crc24b_check_multi(const struct bblib_crc_request *request, int32_t num)
+{
+    return default_crc24b_check_multi(request, num);
+}
+
+
 static crc_function
 bblib_crc24c_gen_select_on_isa() {
 #ifdef _BBLIB_SNC_
-    return bblib_lte_crc24c_gen_snc;
-#else
-    return bblib_lte_crc24c_gen_avx512;
+    if (bblib_get_isa() >= BBLIB_ISA_SNC)
+        return bblib_lte_crc24c_gen_snc;
 #endif
+#ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+        return bblib_lte_crc24c_gen_avx512;
+#endif
+    return bblib_lte_crc24c_gen_sse;
 }
 
 static crc_function default_crc24c_gen = bblib_crc24c_gen_select_on_isa();
@@ -180,10 +210,14 @@ void bblib_lte_crc24c_gen(struct bblib_crc_request *request, struct bblib_crc_re
 static crc_function
 bblib_crc24c_check_select_on_isa() {
 #ifdef _BBLIB_SNC_
-    return bblib_lte_crc24c_check_snc;
-#else
-    return bblib_lte_crc24c_check_avx512;
+    if (bblib_get_isa() >= BBLIB_ISA_SNC)
+        return bblib_lte_crc24c_check_snc;
+#endif
+#ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+        return bblib_lte_crc24c_check_avx512;
 #endif
+    return bblib_lte_crc24c_check_sse;
 }
 
 static crc_function default_crc24c_check = bblib_crc24c_check_select_on_isa();
@@ -196,7 +230,11 @@ void bblib_lte_crc24c_check(struct bblib_crc_request *request, struct bblib_crc_
 
 static crc_function
 bblib_crc24c_1_gen_select_on_isa() {
-    return bblib_lte_crc24c_1_gen_avx512;
+#ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+        return bblib_lte_crc24c_1_gen_avx512;
+#endif
+    return bblib_lte_crc24c_1_gen_sse;
 }
 
 static crc_function default_crc24c_1_gen = bblib_crc24c_1_gen_select_on_isa();
@@ -209,7 +247,11 @@ void bblib_lte_crc24c_1_gen(struct bblib_crc_request *request, struct bblib_crc_
 
 static crc_function
 bblib_crc24c_1_check_select_on_isa() {
-    return bblib_lte_crc24c_1_check_avx512;
+#ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+        return bblib_lte_crc24c_1_check_avx512;
+#endif
+    return bblib_lte_crc24c_1_check_sse;
 }
 
 static crc_function default_crc24c_1_check = bblib_crc24c_1_check_select_on_isa();
@@ -223,14 +265,14 @@ void bblib_lte_crc24c_1_check(struct bblib_crc_request *request, struct bblib_cr
 static crc_function
 bblib_crc16_gen_select_on_isa() {
 #ifdef _BBLIB_SNC_
-    return bblib_lte_crc16_gen_snc;
-#else
-    #ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_SNC)
+        return bblib_lte_crc16_gen_snc;
+#endif
+#ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
         return bblib_lte_crc16_gen_avx512;
-    #else
-        return bblib_lte_crc16_gen_sse;
-    #endif
 #endif
+    return bblib_lte_crc16_gen_sse;
 }
 
 static crc_function default_crc16_gen = bblib_crc16_gen_select_on_isa();
@@ -244,14 +286,14 @@ void bblib_lte_crc16_gen(struct bblib_crc_request *request, struct bblib_crc_res
 static crc_function
 bblib_crc16_check_select_on_isa() {
 #ifdef _BBLIB_SNC_
-    return bblib_lte_crc16_check_snc;
-#else
-    #ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_SNC)
+        return bblib_lte_crc16_check_snc;
+#endif
+#ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
         return bblib_lte_crc16_check_avx512;
-    #else
-        return bblib_lte_crc16_check_sse;
-    #endif
 #endif
+    return bblib_lte_crc16_check_sse;
 }
 
 static crc_function default_crc16_check = bblib_crc16_check_select_on_isa();
@@ -265,14 +307,14 @@ void bblib_lte_crc16_check(struct bblib_crc_request *request, struct bblib_crc_r
 static crc_function
 bblib_crc11_gen_select_on_isa() {
 #ifdef _BBLIB_SNC_
-    return bblib_lte_crc11_gen_snc;
-#else
-    #ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_SNC)
+        return bblib_lte_crc11_gen_snc;
+#endif
+#ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
         return bblib_lte_crc11_gen_avx512;
-    #else
-        return bblib_lte_crc11_gen_sse;
-    #endif
 #endif
+    return bblib_lte_crc11_gen_sse;
 }
 
 static crc_function default_crc11_gen = bblib_crc11_gen_select_on_isa();
@@ -286,14 +328,14 @@ void bblib_lte_crc11_gen(struct bblib_crc_request *request, struct bblib_crc_res
 static crc_function
 bblib_crc11_check_select_on_isa() {
 #ifdef _BBLIB_SNC_
-    return bblib_lte_crc11_check_snc;
-#else
-    #ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_SNC)
+        return bblib_lte_crc11_check_snc;
+#endif
+#ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
         return bblib_lte_crc11_check_avx512;
-    #else
-        return bblib_lte_crc11_check_sse;
-    #endif
 #endif
+    return bblib_lte_crc11_check_sse;
 }
 
 static crc_function default_crc11_check = bblib_crc11_check_select_on_isa();
@@ -307,14 +349,14 @@ void bblib_lte_crc11_check(struct bblib_crc_request *request, struct bblib_crc_r
 static crc_function
 bblib_crc6_gen_select_on_isa() {
 #ifdef _BBLIB_SNC_
-    return bblib_lte_crc6_gen_snc;
-#else
-    #ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_SNC)
+        return bblib_lte_crc6_gen_snc;
+#endif
+#ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
         return bblib_lte_crc6_gen_avx512;
-    #else
-        return bblib_lte_crc6_gen_sse;
-    #endif
 #endif
+    return bblib_lte_crc6_gen_sse;
 }
 
 static crc_function default_crc6_gen = bblib_crc6_gen_select_on_isa();
@@ -328,14 +370,14 @@ void bblib_lte_crc6_gen(struct bblib_crc_request *request, struct bblib_crc_resp
 static crc_function
 bblib_crc6_check_select_on_isa() {
 #ifdef _BBLIB_SNC_
-    return bblib_lte_crc6_check_snc;
-#else
-    #ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_SNC)
+        return bblib_lte_crc6_check_snc;
+#endif
+#ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
         return bblib_lte_crc6_check_avx512;
-    #else
-        return bblib_lte_crc6_check_sse;
-    #endif
 #endif
+    return bblib_lte_crc6_check_sse;
 }
 
 static crc_function default_crc6_check = bblib_crc6_check_select_on_isa();
@@ -344,3 +386,257 @@ void bblib_lte_crc6_check(struct bblib_crc_request *request, struct bblib_crc_re
 {
     default_crc6_check(request, response);
 }
+
+
+/* Same constants as the *_precompute structures of phy_crc_avx512.cpp, indexed by bblib_crc_type */
+static const struct crc_stream_params crc_stream_params_table[] = {
+    {0x864CFB00, 0x8a322000, 0x2e6a9100, 0x1f428700, 0x467d2400, 0x2c8c9d00, 0x64e4d700, 0xfd7e0c00, 0xd9fe8c00, 0x1f845fe24, 24, 0},   // CRC24A
+    {0x80006300, 0x78202200, 0x016d3800, 0xb5015b00, 0xa0660100, 0x42000100, 0x80140500, 0x09000200, 0x90042100, 0x1ffff83ff, 24, 0},   // CRC24B
+    {0xB2B11700, 0x92ee6700, 0x35dc8c00, 0x1c70ec00, 0x74665600, 0x8cfa5500, 0x6ccc8e00, 0x13979900, 0x74809300, 0x1c52cdcad, 24, 0},   // CRC24C
+    {0xB2B11700, 0x92ee6700, 0x35dc8c00, 0x1c70ec00, 0x74665600, 0x8cfa5500, 0x6ccc8e00, 0x13979900, 0x74809300, 0x1c52cdcad, 24, 24},  // CRC24C_1
+    {0x10210000, 0x18d30000, 0xb5b70000, 0x60190000, 0x59b00000, 0xd5f60000, 0x45630000, 0xeb230000, 0xaa510000, 0x111303471, 16, 0},   // CRC16
+    {0xC4200000, 0xeda00000, 0x66200000, 0x9b800000, 0x9d000000, 0x8ea00000, 0x47600000, 0x5e600000, 0xc9000000, 0x1b3fa1f48, 11, 0},   // CRC11
+    {0x84000000, 0x28000000, 0x14000000, 0xac000000, 0x94000000, 0x38000000, 0x1c000000, 0x8c000000, 0xcc000000, 0x1fab37693, 6, 0}     // CRC6
+};
+
+const struct crc_stream_params *
+crc_stream_get_params(enum bblib_crc_type type)
+{
+    if ((type < BBLIB_CRC24A) || (type > BBLIB_CRC6))
+    {
+        printf("bblib_crc: unsupported CRC type %d\n", type);
+        return NULL;
+    }
+    return &crc_stream_params_table[type];
+}
+
+void
+crc_stream_update(struct bblib_crc_state *state, const uint8_t *data, uint32_t len, crc_stream_fold_function fold)
+{
+    const uint32_t shift = state->num_pending & 7;
+    const uint32_t tail = len & 7;
+    uint32_t bytes = len >> 3;
+
+    state->len += len;
+    if (shift == 0)
+    {
+        fold(state, data, bytes);
+        if (tail)
+        {
+            state->pending[state->num_pending >> 3] = data[bytes] & (uint8_t)(0xFF << (8 - tail));
+            state->num_pending += tail;
+        }
+        return;
+    }
+
+    /* The chunk continues a partial pending byte, its bytes are realigned 64 bits at a time */
+    uint8_t buffer[256];
+    uint8_t carry = state->pending[state->num_pending >> 3];
+    state->num_pending -= shift;
+    while (bytes > 0)
+    {
+        const uint32_t num = (bytes < sizeof(buffer)) ? bytes : sizeof(buffer);
+        uint32_t i = 0;
+        for (; i + 8 <= num; i += 8)
+        {
+            uint64_t word;
+            memcpy(&word, data + i, 8);
+            word = _bswap64(word);
+            const uint64_t out = _bswap64(((uint64_t)carry << 56) | (word >> shift));
+            carry = (uint8_t)(word << (8 - shift));
+            memcpy(buffer + i, &out, 8);
+        }
+        for (; i < num; i++)
+        {
+            buffer[i] = carry | (data[i] >> shift);
+            carry = (uint8_t)(data[i] << (8 - shift));
+        }
+        fold(state, buffer, num);
+        data += num;
+        bytes -= num;
+    }
+
+    /* shift bits of carry followed by the tail bits of the chunk */
+    uint8_t last[2] = {carry, 0};
+    uint32_t num_bits = shift;
+    if (tail)
+    {
+        const uint8_t byte = data[0] & (uint8_t)(0xFF << (8 - tail));
+        last[0] |= byte >> shift;
+        last[1] = (uint8_t)(byte << (8 - shift));
+        num_bits += tail;
+    }
+    if (num_bits >= 8)
+    {
+        fold(state, last, 1);
+        last[0] = last[1];
+        num_bits -= 8;
+    }
+    state->pending[state->num_pending >> 3] = last[0];
+    state->num_pending += num_bits;
+}
+
+uint32_t
+crc_stream_final_bits(const struct crc_stream_params *params, uint32_t remainder, uint8_t bits, uint32_t num_bits)
+{
+    /* bit by bit division for the bits which do not make a whole byte */
+    for (uint32_t k = 0; k < num_bits; k++)
+    {
+        const uint32_t top = (remainder >> 31) ^ ((bits >> (7 - k)) & 1);
+        remainder <<= 1;
+        if (top)
+            remainder ^= params->shifted_poly;
+    }
+    return remainder >> (32 - params->crc_bits);
+}
+
+uint32_t
+crc24b_check_stream(const struct bblib_crc_request *request, int32_t num, uint32_t mask,
+    void (*update)(struct bblib_crc_state *, const uint8_t *, uint32_t),
+    uint32_t (*finalize)(const struct bblib_crc_state *))
+{
+    uint32_t passed = 0;
+
+    for (int32_t i = 0; i < num; i++)
+    {
+        if (((mask >> i) & 1) == 0)
+            continue;
+        if (request[i].data == NULL)
+        {
+            printf("bblib_lte_crc24b_check_multi input address error for code block %d\n", i);
+            continue;
+        }
+        /* the CRC of the data followed by its CRC is 0 */
+        struct bblib_crc_state state;
+        bblib_crc_init(&state, BBLIB_CRC24B);
+        update(&state, request[i].data, request[i].len + 24);
+        if (finalize(&state) == 0)
+            passed |= 1u << i;
+    }
+    return passed;
+}
+
+void bblib_crc_init(struct bblib_crc_state *state, enum bblib_crc_type type)
+{
+    const struct crc_stream_params *params = crc_stream_get_params(type);
+
+    memset(state, 0, sizeof(*state));
+    state->type = type;
+    /* 1s prepended to the data for CRC24C initialised with 1s */
+    if ((params != NULL) && params->init_bits)
+        state->fold[0] = (1ULL << params->init_bits) - 1;
+}
+
+
+typedef void (*crc_update_function)(struct bblib_crc_state *state, const uint8_t *data, uint32_t len);
+
+static crc_update_function
+bblib_crc_update_select_on_isa() {
+#ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+        return bblib_crc_update_avx512;
+#endif
+    return bblib_crc_update_sse;
+}
+
+static crc_update_function default_crc_update = bblib_crc_update_select_on_isa();
+
+void bblib_crc_update(struct bblib_crc_state *state, const uint8_t *data, uint32_t len)
+{
+    default_crc_update(state, data, len);
+}
+
+void bblib_crc_update_chunks(struct bblib_crc_state *state, const struct bblib_crc_chunk *chunks, int32_t num)
+{
+    for (int32_t i = 0; i < num; i++)
+        default_crc_update(state, chunks[i].data, chunks[i].len);
+}
+
+
+typedef uint32_t (*crc_finalize_function)(const struct bblib_crc_state *state);
+
+static crc_finalize_function
+bblib_crc_finalize_select_on_isa() {
+#ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+        return bblib_crc_finalize_avx512;
+#endif
+    return bblib_crc_finalize_sse;
+}
+
+static crc_finalize_function default_crc_finalize = bblib_crc_finalize_select_on_isa();
+
+uint32_t bblib_crc_finalize(const struct bblib_crc_state *state)
+{
+    return default_crc_finalize(state);
+}
+
+
+/* x^(2^k) mod P of each CRC type, for the multiplication of a CRC by x^len in bblib_crc_combine */
+struct crc_combine_table {
+    uint64_t poly;      /* P with its x^crc_bits term */
+    uint64_t mu;        /* floor(x^(2 * crc_bits) / P) */
+    uint32_t x2k[32];   /* x^(2^k) mod P */
+};
+
+static struct crc_combine_table crc_combine_tables[BBLIB_CRC6 + 1];
+
+/* a * b mod P, a and b of degree < crc_bits, with a Barrett reduction of the 2 * crc_bits bits product */
+static inline uint32_t
+crc_mulmod(const struct crc_combine_table *table, uint32_t bits, uint32_t a, uint32_t b)
+{
+    const uint64_t product = _mm_cvtsi128_si64(_mm_clmulepi64_si128(_mm_cvtsi32_si128(a), _mm_cvtsi32_si128(b), 0x00));
+    const uint64_t q = _mm_cvtsi128_si64(_mm_clmulepi64_si128(_mm_cvtsi64_si128(product >> bits),
+                                                              _mm_cvtsi64_si128(table->mu), 0x00)) >> bits;
+    const uint64_t r = product ^ _mm_cvtsi128_si64(_mm_clmulepi64_si128(_mm_cvtsi64_si128(q),
+                                                                        _mm_cvtsi64_si128(table->poly), 0x00));
+    return (uint32_t)(r & ((1ULL << bits) - 1));
+}
+
+struct crc_combine_init
+{
+    crc_combine_init()
+    {
+        for (int32_t type = BBLIB_CRC24A; type <= BBLIB_CRC6; type++)
+        {
+            const struct crc_stream_params *params = crc_stream_get_params((enum bblib_crc_type)type);
+            struct crc_combine_table *table = &crc_combine_tables[type];
+            const uint32_t bits = params->crc_bits;
+
+            table->poly = (1ULL << bits) | (params->shifted_poly >> (32 - bits));
+
+            /* long division of x^(2 * bits) by P */
+            uint64_t remainder = 1ULL << (2 * bits);
+            table->mu = 0;
+            for (int32_t k = bits; k >= 0; k--)
+            {
+                if ((remainder >> (k + bits)) & 1)
+                {
+                    table->mu |= 1ULL << k;
+                    remainder ^= table->poly << k;
+                }
+            }
+
+            table->x2k[0] = 2;
+            for (int32_t k = 1; k < 32; k++)
+                table->x2k[k] = crc_mulmod(table, bits, table->x2k[k - 1], table->x2k[k - 1]);
+        }
+    }
+};
+
+static crc_combine_init do_constructor_crc_combine;
+
+uint32_t bblib_crc_combine(enum bblib_crc_type type, uint32_t crc_a, uint32_t crc_b, uint32_t len_b)
+{
+    const struct crc_stream_params *params = crc_stream_get_params(type);
+    if (params == NULL)
+        return 0;
+    const struct crc_combine_table *table = &crc_combine_tables[type];
+
+    /* crc(A, B) = crc(A) * x^len_b + crc(B), the CRC being linear once the initial value is in crc(A) */
+    uint32_t crc = crc_a;
+    for (uint32_t len = len_b; len != 0; len &= len - 1)
+        crc = crc_mulmod(table, params->crc_bits, crc, table->x2k[_tzcnt_u32(len)]);
+    return crc ^ crc_b;
+}
+
@@ -179,6 +179,24 @@ void bblib_lte_crc24b_check_snc(struct bblib_crc_request *request, struct bblib_
 void bblib_lte_crc24b_check_sse(struct bblib_crc_request *request, struct bblib_crc_response *response);
 //! @}
 
+//! @{
+/*!
+    \brief Performs CRC24B validate of several independent code blocks in one call.
+    \param [in] request Array of num requests, as bblib_lte_crc24b_check: data points to the code block with its
+           CRC appended and len is the length of the code block without the CRC, in bits.
+    \param [in] num Number of code blocks, 0 to 32.
+    \return Bitmap of the code blocks which passed the CRC check, bit i set when code block i passed.
+    \note  Unlike bblib_lte_crc24b_check the data is only read. With VPCLMULQDQ (_snc) the code blocks are folded
+     together, one per 128-bit lane, 8 code blocks at a time.
+*/
+uint32_t bblib_lte_crc24b_check_multi(const struct bblib_crc_request *request, int32_t num);
+
+uint32_t bblib_lte_crc24b_check_multi_avx512(const struct bblib_crc_request *request, int32_t num);
+uint32_t bblib_lte_crc24b_check_multi_snc(const struct bblib_crc_request *request, int32_t num);
+
+uint32_t bblib_lte_crc24b_check_multi_sse(const struct bblib_crc_request *request, int32_t num);
+//! @}
+
 //! @{
 /*! \brief Performs CRC24C generate, calculating the CRC value and appending to the data.
     \param [in] request structure containing pointer to input data and data length.
@@ -192,6 +210,7 @@ void bblib_lte_crc24b_check_sse(struct bblib_crc_request *request, struct bblib_
 */
 void bblib_lte_crc24c_gen(struct bblib_crc_request *request, struct bblib_crc_response *response);
 
+void bblib_lte_crc24c_gen_sse(struct bblib_crc_request *request, struct bblib_crc_response *response);
 void bblib_lte_crc24c_gen_avx512(struct bblib_crc_request *request, struct bblib_crc_response *response);
 void bblib_lte_crc24c_gen_snc(struct bblib_crc_request *request, struct bblib_crc_response *response);
 
@@ -212,6 +231,7 @@ void bblib_lte_crc24c_gen_snc(struct bblib_crc_request *request, struct bblib_cr
 */
 void bblib_lte_crc24c_check(struct bblib_crc_request *request, struct bblib_crc_response *response);
 
+void bblib_lte_crc24c_check_sse(struct bblib_crc_request *request, struct bblib_crc_response *response);
 void bblib_lte_crc24c_check_avx512(struct bblib_crc_request *request, struct bblib_crc_response *response);
 void bblib_lte_crc24c_check_snc(struct bblib_crc_request *request, struct bblib_crc_response *response);
 
@@ -230,6 +250,7 @@ void bblib_lte_crc24c_check_snc(struct bblib_crc_request *request, struct bblib_
 */
 void bblib_lte_crc24c_1_gen(struct bblib_crc_request *request, struct bblib_crc_response *response);
 
+void bblib_lte_crc24c_1_gen_sse(struct bblib_crc_request *request, struct bblib_crc_response *response);
 void bblib_lte_crc24c_1_gen_avx512(struct bblib_crc_request *request, struct bblib_crc_response *response);
 
 //! @}
@@ -249,6 +270,7 @@ void bblib_lte_crc24c_1_gen_avx512(struct bblib_crc_request *request, struct bbl
 */
 void bblib_lte_crc24c_1_check(struct bblib_crc_request *request, struct bblib_crc_response *response);
 
+void bblib_lte_crc24c_1_check_sse(struct bblib_crc_request *request, struct bblib_crc_response *response);
 void bblib_lte_crc24c_1_check_avx512(struct bblib_crc_request *request, struct bblib_crc_response *response);
 
 //! @}
@@ -375,6 +397,94 @@ void bblib_lte_crc6_check_sse(struct bblib_crc_request *request, struct bblib_cr
 
 
 
+/*!
+    \enum bblib_crc_type
+    \brief CRC algorithms of the streaming CRC functions.
+*/
+enum bblib_crc_type {
+    BBLIB_CRC24A = 0, /*!< CRC24A */
+    BBLIB_CRC24B,     /*!< CRC24B */
+    BBLIB_CRC24C,     /*!< CRC24C */
+    BBLIB_CRC24C_1,   /*!< CRC24C initialised with 1s */
+    BBLIB_CRC16,      /*!< CRC16 */
+    BBLIB_CRC11,      /*!< CRC11 */
+    BBLIB_CRC6        /*!< CRC6 */
+};
+
+/*!
+    \struct bblib_crc_state
+    \brief State of a CRC computed over a sequence of chunks, see bblib_crc_init.
+    \note The fields are internal to the library, the state can be copied to fork the computation.
+*/
+struct bblib_crc_state {
+    uint64_t fold[2];       /*!< 128 bits folded so far, congruent to the data before pending modulo the polynomial. */
+    uint8_t pending[16];    /*!< Data bits not folded yet, MSB first. */
+    uint32_t num_pending;   /*!< Number of bits in pending, 0 to 127. */
+    uint32_t len;           /*!< Total number of data bits added to the state. */
+    enum bblib_crc_type type; /*!< CRC algorithm. */
+};
+
+/*!
+    \struct bblib_crc_chunk
+    \brief One chunk of data for bblib_crc_update_chunks, as an iovec entry.
+*/
+struct bblib_crc_chunk {
+    const uint8_t *data; /*!< Chunk data, MSB first as bblib_crc_request.data, no alignment requirement. */
+    uint32_t len;        /*!< Length of the chunk in bits. */
+};
+
+/*! \brief Starts a CRC computation over a sequence of chunks.
+    \param [out] state CRC state to initialise.
+    \param [in] type CRC algorithm.
+*/
+void bblib_crc_init(struct bblib_crc_state *state, enum bblib_crc_type type);
+
+//! @{
+/*! \brief Adds a chunk of data to a CRC computation.
+    \param [in,out] state CRC state from bblib_crc_init.
+    \param [in] data Chunk data, MSB first as bblib_crc_request.data.
+    \param [in] len Length of the chunk in bits, the chunk does not need to end or start on a byte boundary
+           of the whole data. The first len bits of data are read, never beyond.
+    \note Data is folded 128 bits at a time as it arrives, so that e.g. a TB CRC can be computed as each
+           code block is decoded, without first gathering the code blocks in a single buffer.
+*/
+void bblib_crc_update(struct bblib_crc_state *state, const uint8_t *data, uint32_t len);
+
+void bblib_crc_update_avx512(struct bblib_crc_state *state, const uint8_t *data, uint32_t len);
+
+void bblib_crc_update_sse(struct bblib_crc_state *state, const uint8_t *data, uint32_t len);
+//! @}
+
+/*! \brief Adds num chunks of data to a CRC computation, as num calls to bblib_crc_update.
+    \param [in,out] state CRC state from bblib_crc_init.
+    \param [in] chunks Array of num chunks.
+    \param [in] num Number of chunks.
+*/
+void bblib_crc_update_chunks(struct bblib_crc_state *state, const struct bblib_crc_chunk *chunks, int32_t num);
+
+//! @{
+/*! \brief CRC value of all the data added to a CRC computation.
+    \param [in] state CRC state, not modified so that more data can still be added.
+    \return CRC value, as bblib_crc_response.crc_value from the single buffer functions.
+*/
+uint32_t bblib_crc_finalize(const struct bblib_crc_state *state);
+
+uint32_t bblib_crc_finalize_avx512(const struct bblib_crc_state *state);
+
+uint32_t bblib_crc_finalize_sse(const struct bblib_crc_state *state);
+//! @}
+
+/*! \brief CRC of the concatenation A followed by B of two data sequences, from the CRC of each of them.
+    \param [in] type CRC algorithm.
+    \param [in] crc_a CRC of A, as crc_value or bblib_crc_finalize.
+    \param [in] crc_b CRC of B alone, initialised with zeros: for BBLIB_CRC24C_1 this is the BBLIB_CRC24C value of B.
+    \param [in] len_b Length of B in bits.
+    \return CRC of A followed by B, computed in O(log len_b) carry-less multiplications, so that e.g. the TB CRC
+            can be derived from the CRCs of code block payloads computed in parallel.
+*/
+uint32_t bblib_crc_combine(enum bblib_crc_type type, uint32_t crc_a, uint32_t crc_b, uint32_t len_b);
+
+
 #ifdef __cplusplus
 }
 #endif
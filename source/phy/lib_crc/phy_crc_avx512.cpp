@@ -38,6 +38,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 #include <functional>
 
 #include "phy_crc.h"
@@ -86,6 +87,10 @@ struct crc24a_precompute
     static constexpr uint64_t k_CRCPOLY = 0x1864CFB;      //CRC24A polynomial
     //Shift CRCPOLY by 32 minus 24bits since using a 24bit polynomial
     static constexpr uint64_t k_crc_shifted_poly = k_CRCPOLY << 8;
+    static constexpr uint32_t k_t1088 = 0x8a322000;       // t=1024+64, x^1088 mod crc_shifted_poly
+    static constexpr uint32_t k_t1024 = 0x2e6a9100;       // t=1024, x^1024 mod crc_shifted_poly
+    static constexpr uint32_t k_t576 = 0x1f428700;        // t=512+64, x^576 mod crc_shifted_poly
+    static constexpr uint32_t k_t512 = 0x467d2400;        // t=512, x^512 mod crc_shifted_poly
     static constexpr uint32_t k_t192 = 0x2c8c9d00;        // t=128+64, x^192 mod crc_shifted_poly
     static constexpr uint32_t k_t128 = 0x64e4d700;        // t=128, x^128 mod crc_shifted_poly
     static constexpr uint32_t k_t96 = 0xfd7e0c00;         // t=96, x^96 mod crc_shifted_poly
@@ -103,6 +108,10 @@ struct crc24b_precompute
     static constexpr uint64_t k_CRCPOLY = 0x1800063;      //CRC24B polynomial
     //Shift CRCPOLY by 32 minus 24bits since using a 24bit polynomial
     static constexpr uint64_t k_crc_shifted_poly = k_CRCPOLY << 8;
+    static constexpr uint32_t k_t1088 = 0x78202200;       // t=1024+64, x^1088 mod crc_shifted_poly
+    static constexpr uint32_t k_t1024 = 0x016d3800;       // t=1024, x^1024 mod crc_shifted_poly
+    static constexpr uint32_t k_t576 = 0xb5015b00;        // t=512+64, x^576 mod crc_shifted_poly
+    static constexpr uint32_t k_t512 = 0xa0660100;        // t=512, x^512 mod crc_shifted_poly
     static constexpr uint32_t k_t192 = 0x42000100;        // t=128+64, x^192 mod crc_shifted_poly
     static constexpr uint32_t k_t128 = 0x80140500;        // t=128, x^128 mod crc_shifted_poly
     static constexpr uint32_t k_t96 = 0x09000200;         // t=96, x^96 mod crc_shifted_poly
@@ -120,6 +129,10 @@ struct crc24c_precompute
     static constexpr uint64_t k_CRCPOLY = 0x1B2B117;      //CRC24C polynomial
     //Shift CRCPOLY by 32 minus 24bits since using a 24bit polynomial
     static constexpr uint64_t k_crc_shifted_poly = k_CRCPOLY << 8;
+    static constexpr uint32_t k_t1088 = 0x92ee6700;       // t=1024+64, x^1088 mod crc_shifted_poly
+    static constexpr uint32_t k_t1024 = 0x35dc8c00;       // t=1024, x^1024 mod crc_shifted_poly
+    static constexpr uint32_t k_t576 = 0x1c70ec00;        // t=512+64, x^576 mod crc_shifted_poly
+    static constexpr uint32_t k_t512 = 0x74665600;        // t=512, x^512 mod crc_shifted_poly
     static constexpr uint32_t k_t192 = 0x8cfa5500;        // t=128+64, x^192 mod crc_shifted_poly
     static constexpr uint32_t k_t128 = 0x6ccc8e00;        // t=128, x^128 mod crc_shifted_poly
     static constexpr uint32_t k_t96 = 0x13979900;         // t=96, x^96 mod crc_shifted_poly
@@ -141,6 +154,10 @@ struct crc24c_1_precompute
     static constexpr uint64_t k_CRCPOLY = crc24c_precompute::k_CRCPOLY;
     //Shift CRCPOLY by 32 minus 24bits since using a 24bit polynomial
     static constexpr uint64_t k_crc_shifted_poly = k_CRCPOLY << 8;
+    static constexpr uint32_t k_t1088 = crc24c_precompute::k_t1088;
+    static constexpr uint32_t k_t1024 = crc24c_precompute::k_t1024;
+    static constexpr uint32_t k_t576 = crc24c_precompute::k_t576;
+    static constexpr uint32_t k_t512 = crc24c_precompute::k_t512;
     static constexpr uint32_t k_t192 = crc24c_precompute::k_t192;
     static constexpr uint32_t k_t128 = crc24c_precompute::k_t128;
     static constexpr uint32_t k_t96 = crc24c_precompute::k_t96;
@@ -158,6 +175,10 @@ struct crc16_precompute
     static constexpr uint64_t k_CRCPOLY = 0x11021;        //CRC16 polynomial
     //Shift CRCPOLY by 32 minus 16bits since using a 16bit polynomial
     static constexpr uint64_t k_crc_shifted_poly = k_CRCPOLY << 16;
+    static constexpr uint32_t k_t1088 = 0x18d30000;       // t=1024+64, x^1088 mod crc_shifted_poly
+    static constexpr uint32_t k_t1024 = 0xb5b70000;       // t=1024, x^1024 mod crc_shifted_poly
+    static constexpr uint32_t k_t576 = 0x60190000;        // t=512+64, x^576 mod crc_shifted_poly
+    static constexpr uint32_t k_t512 = 0x59b00000;        // t=512, x^512 mod crc_shifted_poly
     static constexpr uint32_t k_t192 = 0xd5f60000;        // t=128+64, x^192 mod crc_shifted_poly
     static constexpr uint32_t k_t128 = 0x45630000;        // t=128, x^128 mod crc_shifted_poly
     static constexpr uint32_t k_t96 = 0xeb230000;         // t=96, x^96 mod crc_shifted_poly
@@ -175,6 +196,10 @@ struct crc11_precompute
     static constexpr uint64_t k_CRCPOLY = 0xe21;        //CRC11 polynomial
     //Shift CRCPOLY by 32 minus 11bits since using an 11bit polynomial
     static constexpr uint64_t k_crc_shifted_poly = k_CRCPOLY << 21;
+    static constexpr uint32_t k_t1088 = 0xeda00000;       // t=1024+64, x^1088 mod crc_shifted_poly
+    static constexpr uint32_t k_t1024 = 0x66200000;       // t=1024, x^1024 mod crc_shifted_poly
+    static constexpr uint32_t k_t576 = 0x9b800000;        // t=512+64, x^576 mod crc_shifted_poly
+    static constexpr uint32_t k_t512 = 0x9d000000;        // t=512, x^512 mod crc_shifted_poly
     static constexpr uint32_t k_t192 = 0x8ea00000;        // t=128+64, x^192 mod crc_shifted_poly
     static constexpr uint32_t k_t128 = 0x47600000;        // t=128, x^128 mod crc_shifted_poly
     static constexpr uint32_t k_t96 = 0x5e600000;         // t=96, x^96 mod crc_shifted_poly
@@ -192,6 +217,10 @@ struct crc6_precompute
     static constexpr uint64_t k_CRCPOLY = 0x61;        //CRC6 polynomial
     //Shift CRCPOLY by 32 minus 6bits since using a 6bit polynomial
     static constexpr uint64_t k_crc_shifted_poly = k_CRCPOLY << 26;
+    static constexpr uint32_t k_t1088 = 0x28000000;       // t=1024+64, x^1088 mod crc_shifted_poly
+    static constexpr uint32_t k_t1024 = 0x14000000;       // t=1024, x^1024 mod crc_shifted_poly
+    static constexpr uint32_t k_t576 = 0xac000000;        // t=512+64, x^576 mod crc_shifted_poly
+    static constexpr uint32_t k_t512 = 0x94000000;        // t=512, x^512 mod crc_shifted_poly
     static constexpr uint32_t k_t192 = 0x38000000;        // t=128+64, x^192 mod crc_shifted_poly
     static constexpr uint32_t k_t128 = 0x1c000000;        // t=128, x^128 mod crc_shifted_poly
     static constexpr uint32_t k_t96 = 0x8c000000;         // t=96, x^96 mod crc_shifted_poly
@@ -248,6 +277,55 @@ __m128i shift_right_256(__m128i data, __m128i next_data, __m128i count)
 }
 
 
+#if defined(_BBLIB_SNC_) && defined(__VPCLMULQDQ__)
+// Wide CRC Fold Function, with VPCLMULQDQ
+// Folds 8 blocks of 128bits per step in two 512bit registers, then reduces them to the 128bit
+// fold of the streaming CRC. Only when the file itself targets VPCLMULQDQ: ISA_MULTI builds
+// compile it for Skylake. The CRC generation of Sunny Cove hosts is in phy_crc_snc.cpp.
+// Params: fold       - 128bit fold of the data preceding data_in
+//         data_in    - data bytes, num_blocks blocks of 128bits, num_blocks multiple of 8
+//         k_set1     - x^192 / x^128 constants of the 128bit fold
+//         k1088k1024 - x^1088 / x^1024 constants, folding by 8 blocks
+//         k576k512   - x^576 / x^512 constants, folding by 4 blocks
+// Return: folded data result
+static inline __m128i fold_8x128(__m128i fold, const uint8_t *data_in, uint32_t num_blocks,
+                                 __m128i k_set1, __m128i k1088k1024, __m128i k576k512)
+{
+    const auto k_shuf512 = _mm512_broadcast_i32x4(k_endian_shuf_mask128);
+    const auto k_set8 = _mm512_broadcast_i32x4(k1088k1024);
+    const auto k_set4 = _mm512_broadcast_i32x4(k576k512);
+
+    // Preceding fold is folded once and added to the first block
+    const auto fold_prev = _mm_xor_si128(_mm_clmulepi64_si128(fold, k_set1, 0x00), _mm_clmulepi64_si128(fold, k_set1, 0x11));
+    auto fold0 = _mm512_shuffle_epi8(_mm512_loadu_si512(data_in), k_shuf512);
+    auto fold1 = _mm512_shuffle_epi8(_mm512_loadu_si512(data_in + 64), k_shuf512);
+    fold0 = _mm512_xor_si512(fold0, _mm512_zextsi128_si512(fold_prev));
+
+    for (uint32_t i = 8; i < num_blocks; i += 8)
+    {
+        const auto next0 = _mm512_shuffle_epi8(_mm512_loadu_si512(data_in + 16 * i), k_shuf512);
+        const auto next1 = _mm512_shuffle_epi8(_mm512_loadu_si512(data_in + 16 * i + 64), k_shuf512);
+        fold0 = _mm512_ternarylogic_epi32(_mm512_clmulepi64_epi128(fold0, k_set8, 0x00),
+                                          _mm512_clmulepi64_epi128(fold0, k_set8, 0x11), next0, 0x96);
+        fold1 = _mm512_ternarylogic_epi32(_mm512_clmulepi64_epi128(fold1, k_set8, 0x00),
+                                          _mm512_clmulepi64_epi128(fold1, k_set8, 0x11), next1, 0x96);
+    }
+
+    // fold0 is 4 blocks ahead of fold1, then the 4 blocks of fold1 are folded into one
+    fold1 = _mm512_ternarylogic_epi32(_mm512_clmulepi64_epi128(fold0, k_set4, 0x00),
+                                      _mm512_clmulepi64_epi128(fold0, k_set4, 0x11), fold1, 0x96);
+    auto result = _mm512_castsi512_si128(fold1);
+    result = _mm_ternarylogic_epi32(_mm_clmulepi64_si128(result, k_set1, 0x00), _mm_clmulepi64_si128(result, k_set1, 0x11),
+                                    _mm512_extracti32x4_epi32(fold1, 1), 0x96);
+    result = _mm_ternarylogic_epi32(_mm_clmulepi64_si128(result, k_set1, 0x00), _mm_clmulepi64_si128(result, k_set1, 0x11),
+                                    _mm512_extracti32x4_epi32(fold1, 2), 0x96);
+    result = _mm_ternarylogic_epi32(_mm_clmulepi64_si128(result, k_set1, 0x00), _mm_clmulepi64_si128(result, k_set1, 0x11),
+                                    _mm512_extracti32x4_epi32(fold1, 3), 0x96);
+    return result;
+}
+#endif
+
+
 // CRC Fold Data Function
 // Templates: PARAMS     - set of constant values for each CRC type
 //            IS_ALIGNED - Indicates if data is byte aligned (ie. multiple of 8 bits)
@@ -481,16 +559,18 @@ void crc_generate(bblib_crc_request *request, bblib_crc_response *response)
 
     // Load last byte of data (endian swapped), using mask to ensure rest of data is zeroed
     // then pad data to RHS of 32bit word ready to be merged with CRC
-    const auto end_data_es = _mm_maskz_shuffle_epi8(0x8000, *(__m128i*)(request->data+end_data_idx), k_endian_shuf_mask128);
+    const auto end_data_es = _mm_maskz_shuffle_epi8(0x8000, _mm_loadu_si128((__m128i*)(request->data+end_data_idx)), k_endian_shuf_mask128);
     const auto pad_end_data = _mm_srl_epi32(end_data_es, pad_size_r);
 
     // Merge data with CRC value (br_result) and shift back
     const auto merged_crc = _mm_mask_shuffle_epi8 (pad_end_data, 0x0f00, br_result, k_shuf_mask);
     const auto appended_data = _mm_sll_epi64(merged_crc, pad_size_r);
 
-    // Write CRC appended data to memory (needs an endian swap)
+    // Write CRC appended data to memory (needs an endian swap), only the bytes holding the last
+    // data bits and the CRC, so nothing is written past the end of the CRC appended data
     const auto appended_data_es = _mm_shuffle_epi8(appended_data, k_endian_shuf_mask128);
-    _mm_mask_storeu_epi8 (dataOut+end_data_idx, 0xffff, appended_data_es);
+    const int appended_bytes = (request->len - end_data_idx*8 + PARAMS::k_crc_bits + 7)/8;
+    _mm_mask_storeu_epi8 (dataOut+end_data_idx, (__mmask16)((1 << appended_bytes) - 1), appended_data_es);
 
     // Update length of CRC appended data
     response->len = request->len + PARAMS::k_crc_bits;
@@ -515,7 +595,7 @@ void crc_check(bblib_crc_request *request, bblib_crc_response *response)
 
     // Extract CRC which may include some bits from the end of data
     // Load last bytes of data + CRC (endian swapped), masking out rest of data.
-    const auto crc_end_data = _mm_maskz_shuffle_epi8 (0x000f, *(__m128i*)(request->data+load_idx), k_endian_shuf_mask32);
+    const auto crc_end_data = _mm_maskz_shuffle_epi8 (0x000f, _mm_loadu_si128((__m128i*)(request->data+load_idx)), k_endian_shuf_mask32);
 
     // Bit left align CRC to remove remaining bits of data
     const auto crc_no_data = _mm_sll_epi32(crc_end_data, align_shift_r);
@@ -700,3 +780,103 @@ void bblib_lte_crc6_check_avx512(bblib_crc_request *request, bblib_crc_response
     }
 }
 
+
+/* Streaming CRC, 128 bits folded per step as in fold_4stage */
+static void crc_stream_fold_avx512(struct bblib_crc_state *state, const uint8_t *data, uint32_t num_bytes)
+{
+    const struct crc_stream_params *params = crc_stream_get_params(state->type);
+    const __m128i k = _mm_set_epi64x(params->t192, params->t128);
+    __m128i fold = _mm_loadu_si128((const __m128i *)state->fold);
+    uint32_t num_pending = state->num_pending >> 3;
+
+    /* complete the pending bytes first */
+    if (num_pending)
+    {
+        const uint32_t num = (num_bytes < 16 - num_pending) ? num_bytes : (16 - num_pending);
+        const __mmask16 mask = (__mmask16)(((1u << num) - 1) << num_pending);
+        __m128i pending = _mm_loadu_si128((const __m128i *)state->pending);
+        pending = _mm_mask_loadu_epi8(pending, mask, data - num_pending);
+        num_pending += num;
+        data += num;
+        num_bytes -= num;
+        if (num_pending < 16)
+        {
+            _mm_storeu_si128((__m128i *)state->pending, pending);
+            state->num_pending = 8 * num_pending;
+            return;
+        }
+        fold = _mm_ternarylogic_epi32(_mm_clmulepi64_si128(fold, k, 0x00), _mm_clmulepi64_si128(fold, k, 0x11),
+                                      _mm_shuffle_epi8(pending, k_endian_shuf_mask128), 0x96);
+    }
+
+#if defined(_BBLIB_SNC_) && defined(__VPCLMULQDQ__)
+    if (num_bytes >= 256)
+    {
+        const uint32_t num_blocks = (num_bytes / 16) & ~7;
+        fold = fold_8x128(fold, data, num_blocks, k, _mm_set_epi64x(params->t1088, params->t1024),
+                          _mm_set_epi64x(params->t576, params->t512));
+        data += 16 * num_blocks;
+        num_bytes -= 16 * num_blocks;
+    }
+#endif
+    for (; num_bytes >= 16; num_bytes -= 16, data += 16)
+    {
+        const __m128i next = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data), k_endian_shuf_mask128);
+        fold = _mm_ternarylogic_epi32(_mm_clmulepi64_si128(fold, k, 0x00), _mm_clmulepi64_si128(fold, k, 0x11), next, 0x96);
+    }
+
+    _mm_mask_storeu_epi8(state->pending, (__mmask16)((1u << num_bytes) - 1), _mm_maskz_loadu_epi8((__mmask16)((1u << num_bytes) - 1), data));
+    state->num_pending = 8 * num_bytes;
+    _mm_storeu_si128((__m128i *)state->fold, fold);
+}
+
+void bblib_crc_update_avx512(struct bblib_crc_state *state, const uint8_t *data, uint32_t len)
+{
+    if (crc_stream_get_params(state->type) == NULL)
+        return;
+    crc_stream_update(state, data, len, crc_stream_fold_avx512);
+}
+
+uint32_t bblib_crc_finalize_avx512(const struct bblib_crc_state *state)
+{
+    const struct crc_stream_params *params = crc_stream_get_params(state->type);
+    if (params == NULL)
+        return 0;
+    const __m128i k = _mm_set_epi64x(params->t192, params->t128);
+    const uint32_t num_bytes = state->num_pending >> 3;
+    __m128i fold = _mm_loadu_si128((const __m128i *)state->fold);
+
+    /* 1. fold and the pending bytes right aligned in 256 bits, then folded once to 128 bits */
+    if (num_bytes)
+    {
+        uint8_t buffer[32] = {0};
+        _mm_storeu_si128((__m128i *)(buffer + 16 - num_bytes), _mm_shuffle_epi8(fold, k_endian_shuf_mask128));
+        memcpy(buffer + 32 - num_bytes, state->pending, num_bytes);
+        const __m128i high = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)buffer), k_endian_shuf_mask128);
+        const __m128i low = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(buffer + 16)), k_endian_shuf_mask128);
+        fold = _mm_ternarylogic_epi32(_mm_clmulepi64_si128(high, k, 0x00), _mm_clmulepi64_si128(high, k, 0x11), low, 0x96);
+    }
+
+    /* 2. apply 64 bits fold to 64 bits + 32 bits crc(32 bits zero), then 32 bits fold */
+    const __m128i k2 = _mm_set_epi64x(params->t64, params->t96);
+    const __m128i fold64 = _mm_xor_si128(_mm_clmulepi64_si128(fold, k2, 0x01), _mm_srli_si128(_mm_slli_si128(fold, 8), 4));
+    const __m128i fold32 = _mm_xor_si128(_mm_clmulepi64_si128(fold64, k2, 0x11), _mm_srli_si128(_mm_slli_si128(fold64, 8), 8));
+
+    /* 3. Barrett reduction */
+    const __m128i kbr = _mm_set_epi32(1, params->shifted_poly, 1, (uint32_t)params->u);
+    __m128i t = _mm_clmulepi64_si128(kbr, _mm_srli_si128(fold32, 4), 0x00);
+    t = _mm_clmulepi64_si128(kbr, _mm_srli_si128(t, 4), 0x01);
+    const uint32_t remainder = (uint32_t)_mm_cvtsi128_si32(_mm_xor_si128(fold32, t));
+
+    return crc_stream_final_bits(params, remainder, state->pending[num_bytes], state->num_pending & 7);
+}
+
+uint32_t bblib_lte_crc24b_check_multi_avx512(const struct bblib_crc_request *request, int32_t num)
+{
+    if ((request == NULL) || (num < 0) || (num > 32))
+    {
+        printf("bblib_lte_crc24b_check_multi: invalid request or number of code blocks %d\n", num);
+        return 0;
+    }
+    return crc24b_check_stream(request, num, 0xFFFFFFFF, bblib_crc_update_avx512, bblib_crc_finalize_avx512);
+}
@@ -33,6 +33,10 @@
 #define WIRELESS_SDK_PHY_CRC_INTERNAL_H
 
 
+#include <stdint.h>
+
+#include "phy_crc.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -40,6 +44,38 @@ extern "C" {
 
 void bblib_print_crc_version();
 
+/* Folding and Barrett reduction constants of one CRC type, as the *_precompute structures */
+struct crc_stream_params {
+    uint32_t shifted_poly;  /* polynomial shifted to 32 bits, x^32 term removed */
+    uint32_t t1088;         /* x^1088 mod shifted_poly */
+    uint32_t t1024;         /* x^1024 mod shifted_poly */
+    uint32_t t576;          /* x^576 mod shifted_poly */
+    uint32_t t512;          /* x^512 mod shifted_poly */
+    uint32_t t192;          /* x^192 mod shifted_poly */
+    uint32_t t128;          /* x^128 mod shifted_poly */
+    uint32_t t96;           /* x^96 mod shifted_poly */
+    uint32_t t64;           /* x^64 mod shifted_poly */
+    uint64_t u;             /* floor(x^64 / shifted_poly) */
+    uint32_t crc_bits;      /* crc size in bits */
+    uint32_t init_bits;     /* number of 1s prepended to the data */
+};
+
+const struct crc_stream_params *crc_stream_get_params(enum bblib_crc_type type);
+
+/* Appends num_bytes bytes to a state with a whole number of pending bytes, ISA specific */
+typedef void (*crc_stream_fold_function)(struct bblib_crc_state *state, const uint8_t *data, uint32_t num_bytes);
+
+/* Appends len bits to a state, the bits are realigned to the pending data and given to fold as bytes */
+void crc_stream_update(struct bblib_crc_state *state, const uint8_t *data, uint32_t len, crc_stream_fold_function fold);
+
+/* CRC value from the 32 bits remainder of the folded data and the last num_bits (0..7) pending bits */
+uint32_t crc_stream_final_bits(const struct crc_stream_params *params, uint32_t remainder, uint8_t bits, uint32_t num_bits);
+
+/* CRC24B check of the code blocks selected by mask one at a time, with the streaming functions of one ISA */
+uint32_t crc24b_check_stream(const struct bblib_crc_request *request, int32_t num, uint32_t mask,
+    void (*update)(struct bblib_crc_state *, const uint8_t *, uint32_t),
+    uint32_t (*finalize)(const struct bblib_crc_state *));
+
 
 
 #ifdef __cplusplus
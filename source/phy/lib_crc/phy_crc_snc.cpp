@@ -57,6 +57,36 @@ struct init_crc_snc
 
 init_crc_snc do_constructor_crc_snc;
 
+// Two accumulator 512bit fold
+// Folds the 512bit blocks in pairs, two VPCLMULQDQ chains 1024bits apart so that each hides the latency
+// of the other, then merges them into the single accumulator the 4x128bit fold loop continues with.
+// Params: kmm0       - first block, endian swapped
+//         data       - pointer to the next block, moved past the blocks folded
+//         num_fold4  - number of 512bit folds left, the blocks folded are removed
+//         k576k512   - x^576 / x^512 constants, folding by 512bits
+//         k1088k1024 - x^1088 / x^1024 constants, folding by 1024bits
+// Return: fold of the first block and the blocks folded
+static inline __m512i fold_2x512(__m512i kmm0, uint8_t **data, int32_t *num_fold4, __m512i k576k512,
+                                 __m512i k1088k1024, __m512i endian_shuf_mask)
+{
+    const int32_t num_pairs = (*num_fold4 + 1) >> 1;
+    __m512i kmm1 = _mm512_shuffle_epi8(_mm512_load_si512((void const*)*data), endian_shuf_mask);
+    *data += 64;
+    for (int32_t i = 1; i < num_pairs; i++)
+    {
+        const __m512i next0 = _mm512_shuffle_epi8(_mm512_load_si512((void const*)*data), endian_shuf_mask);
+        const __m512i next1 = _mm512_shuffle_epi8(_mm512_load_si512((void const*)(*data + 64)), endian_shuf_mask);
+        *data += 128;
+        kmm0 = _mm512_ternarylogic_epi32(_mm512_clmulepi64_epi128(kmm0, k1088k1024, 0x00),
+                                         _mm512_clmulepi64_epi128(kmm0, k1088k1024, 0x11), next0, 0x96);
+        kmm1 = _mm512_ternarylogic_epi32(_mm512_clmulepi64_epi128(kmm1, k1088k1024, 0x00),
+                                         _mm512_clmulepi64_epi128(kmm1, k1088k1024, 0x11), next1, 0x96);
+    }
+    *num_fold4 -= 2 * num_pairs - 1;
+    return _mm512_ternarylogic_epi32(_mm512_clmulepi64_epi128(kmm0, k576k512, 0x00),
+                                     _mm512_clmulepi64_epi128(kmm0, k576k512, 0x11), kmm1, 0x96);
+}
+
 // Main CRC Generate Function
 // Calculates CRC based on CRC type and message data
 // Templates: PARAMS     - set of constant values for each CRC type
@@ -87,6 +117,8 @@ void crc24a_gen_snc(bblib_crc_request *request, bblib_crc_response *response)
 
     /* some pre-computed key constants */
     const static uint32_t k576   = 0x1F428700;   //t=512+64, x^578 mod CRC24APLUS8, verified
+    const static uint32_t k1088  = 0x8A322000;   //t=1024+64, x^1088 mod CRC24APLUS8
+    const static uint32_t k1024  = 0x2E6A9100;   //t=1024, x^1024 mod CRC24APLUS8
     const static uint32_t k512   = 0x467D2400;   //t=512, x^512 mod CRC24APLUS8, verified
     const static uint32_t k448   = 0x6C1C3500;
     const static uint32_t k384   = 0x5B703800;
@@ -129,6 +161,10 @@ void crc24a_gen_snc(bblib_crc_request *request, bblib_crc_response *response)
         kmm0 = _mm512_load_si512((void const*)data);
         data += 64;
         kmm0 = _mm512_shuffle_epi8(kmm0, ENDIA_SHUF_MASK_512bit);
+        if (num_fold4 >= 8)
+            kmm0 = fold_2x512(kmm0, &data, &num_fold4, k576k512,
+                              _mm512_set_epi32(0, k1088, 0, k1024, 0, k1088, 0, k1024, 0, k1088, 0, k1024, 0, k1088, 0, k1024),
+                              ENDIA_SHUF_MASK_512bit);
         for (i=0; i<num_fold4; i++)
         {
             kmm2 = _mm512_load_si512((void const*)data);
@@ -266,6 +302,8 @@ void crc24b_gen_snc(bblib_crc_request *request, bblib_crc_response *response)
 
     /* some pre-computed key constants */
     const static uint32_t k576   = 0xB5015B00;   //t=512+64, x^578 mod CRC24APLUS8, verified
+    const static uint32_t k1088  = 0x78202200;   //t=1024+64, x^1088 mod CRC24APLUS8
+    const static uint32_t k1024  = 0x016D3800;   //t=1024, x^1024 mod CRC24APLUS8
     const static uint32_t k512   = 0xA0660100;   //t=512, x^512 mod CRC24APLUS8, verified
     const static uint32_t k192   = 0x42000100;   //t=128+64, x^192 mod CRC24APLUS8, verified
     const static uint32_t k128   = 0x80140500;   //t=128, x^128 mod CRC24APLUS8, verified
@@ -303,6 +341,10 @@ void crc24b_gen_snc(bblib_crc_request *request, bblib_crc_response *response)
         kmm0 = _mm512_load_si512((void const*)data);
         data += 64;
         kmm0 = _mm512_shuffle_epi8(kmm0, ENDIA_SHUF_MASK_512bit);
+        if (num_fold4 >= 8)
+            kmm0 = fold_2x512(kmm0, &data, &num_fold4, k576k512,
+                              _mm512_set_epi32(0, k1088, 0, k1024, 0, k1088, 0, k1024, 0, k1088, 0, k1024, 0, k1088, 0, k1024),
+                              ENDIA_SHUF_MASK_512bit);
         for (i=0; i<num_fold4; i++)
         {
             kmm2 = _mm512_load_si512((void const*)data);
@@ -440,6 +482,8 @@ void crc24c_gen_snc(bblib_crc_request *request, bblib_crc_response *response)
 
     /* some pre-computed key constants */
     const static uint32_t k576   = 0x1C70EC00;   //t=512+64, x^578 mod CRC24APLUS8, verified
+    const static uint32_t k1088  = 0x92EE6700;   //t=1024+64, x^1088 mod CRC24APLUS8
+    const static uint32_t k1024  = 0x35DC8C00;   //t=1024, x^1024 mod CRC24APLUS8
     const static uint32_t k512   = 0x74665600;   //t=512, x^512 mod CRC24APLUS8, verified
     const static uint32_t k192   = 0x8cfa5500;   //t=128+64, x^192 mod CRC24APLUS8, verified
     const static uint32_t k128   = 0x6ccc8e00;   //t=128, x^128 mod CRC24APLUS8, verified
@@ -477,6 +521,10 @@ void crc24c_gen_snc(bblib_crc_request *request, bblib_crc_response *response)
         kmm0 = _mm512_load_si512((void const*)data);
         data += 64;
         kmm0 = _mm512_shuffle_epi8(kmm0, ENDIA_SHUF_MASK_512bit);
+        if (num_fold4 >= 8)
+            kmm0 = fold_2x512(kmm0, &data, &num_fold4, k576k512,
+                              _mm512_set_epi32(0, k1088, 0, k1024, 0, k1088, 0, k1024, 0, k1088, 0, k1024, 0, k1088, 0, k1024),
+                              ENDIA_SHUF_MASK_512bit);
         for (i=0; i<num_fold4; i++)
         {
             kmm2 = _mm512_load_si512((void const*)data);
@@ -613,6 +661,8 @@ void crc16_gen_snc(bblib_crc_request *request, bblib_crc_response *response)
 
     /* some pre-computed key constants */
     const static uint32_t k576   = 0x60190000;   //t=512+64, x^578 mod CRC24APLUS8, verified
+    const static uint32_t k1088  = 0x18D30000;   //t=1024+64, x^1088 mod CRC24APLUS8
+    const static uint32_t k1024  = 0xB5B70000;   //t=1024, x^1024 mod CRC24APLUS8
     const static uint32_t k512   = 0x59B00000;   //t=512, x^512 mod CRC24APLUS8, verified
     const static uint32_t k192   = 0xD5F60000;   //t=128+64, x^192 mod CRC24APLUS8, verified
     const static uint32_t k128   = 0x45630000;   //t=128, x^128 mod CRC24APLUS8, verified
@@ -650,6 +700,10 @@ void crc16_gen_snc(bblib_crc_request *request, bblib_crc_response *response)
         kmm0 = _mm512_load_si512((void const*)data);
         data += 64;
         kmm0 = _mm512_shuffle_epi8(kmm0, ENDIA_SHUF_MASK_512bit);
+        if (num_fold4 >= 8)
+            kmm0 = fold_2x512(kmm0, &data, &num_fold4, k576k512,
+                              _mm512_set_epi32(0, k1088, 0, k1024, 0, k1088, 0, k1024, 0, k1088, 0, k1024, 0, k1088, 0, k1024),
+                              ENDIA_SHUF_MASK_512bit);
         for (i=0; i<num_fold4; i++)
         {
             kmm2 = _mm512_load_si512((void const*)data);
@@ -785,6 +839,8 @@ void crc11_gen_snc(bblib_crc_request *request, bblib_crc_response *response)
 
     /* some pre-computed key constants */
     const static uint32_t k576   = 0x9B800000;   //t=512+64, x^578 mod CRC24APLUS8, verified
+    const static uint32_t k1088  = 0xEDA00000;   //t=1024+64, x^1088 mod CRC24APLUS8
+    const static uint32_t k1024  = 0x66200000;   //t=1024, x^1024 mod CRC24APLUS8
     const static uint32_t k512   = 0x9D000000;   //t=512, x^512 mod CRC24APLUS8, verified
     const static uint32_t k192   = 0x8ea00000;   //t=128+64, x^192 mod CRC24APLUS8, verified
     const static uint32_t k128   = 0x47600000;   //t=128, x^128 mod CRC24APLUS8, verified
@@ -822,6 +878,10 @@ void crc11_gen_snc(bblib_crc_request *request, bblib_crc_response *response)
         kmm0 = _mm512_load_si512((void const*)data);
         data += 64;
         kmm0 = _mm512_shuffle_epi8(kmm0, ENDIA_SHUF_MASK_512bit);
+        if (num_fold4 >= 8)
+            kmm0 = fold_2x512(kmm0, &data, &num_fold4, k576k512,
+                              _mm512_set_epi32(0, k1088, 0, k1024, 0, k1088, 0, k1024, 0, k1088, 0, k1024, 0, k1088, 0, k1024),
+                              ENDIA_SHUF_MASK_512bit);
         for (i=0; i<num_fold4; i++)
         {
             kmm2 = _mm512_load_si512((void const*)data);
@@ -958,6 +1018,8 @@ void crc6_gen_snc(bblib_crc_request *request, bblib_crc_response *response)
 
     /* some pre-computed key constants */
     const static uint32_t k576   = 0xAC000000;   //t=512+64, x^578 mod CRC24APLUS8, verified
+    const static uint32_t k1088  = 0x28000000;   //t=1024+64, x^1088 mod CRC24APLUS8
+    const static uint32_t k1024  = 0x14000000;   //t=1024, x^1024 mod CRC24APLUS8
     const static uint32_t k512   = 0x94000000;   //t=512, x^512 mod CRC24APLUS8, verified
     const static uint32_t k192   = 0x38000000;   //t=128+64, x^192 mod CRC24APLUS8, verified
     const static uint32_t k128   = 0x1c000000;   //t=128, x^128 mod CRC24APLUS8, verified
@@ -995,6 +1057,10 @@ void crc6_gen_snc(bblib_crc_request *request, bblib_crc_response *response)
         kmm0 = _mm512_load_si512((void const*)data);
         data += 64;
         kmm0 = _mm512_shuffle_epi8(kmm0, ENDIA_SHUF_MASK_512bit);
+        if (num_fold4 >= 8)
+            kmm0 = fold_2x512(kmm0, &data, &num_fold4, k576k512,
+                              _mm512_set_epi32(0, k1088, 0, k1024, 0, k1088, 0, k1024, 0, k1088, 0, k1024, 0, k1088, 0, k1024),
+                              ENDIA_SHUF_MASK_512bit);
         for (i=0; i<num_fold4; i++)
         {
             kmm2 = _mm512_load_si512((void const*)data);
@@ -1351,5 +1417,134 @@ void bblib_lte_crc6_check_snc(struct bblib_crc_request *request, struct bblib_cr
         crc6_check_snc(request, response);
 }
 
+
+/* 128-bit block of a code block preceded by pad zero bytes */
+static inline __m128i crc_lane_block(const uint8_t *data, int32_t pad, int32_t block)
+{
+    const int32_t offset = block * 16 - pad;
+    if (offset >= 0)
+        return _mm_loadu_si128((const __m128i *)(data + offset));
+    if (offset <= -16)
+        return _mm_setzero_si128();
+    return _mm_maskz_loadu_epi8((__mmask16)(0xFFFF << (-offset)), data + offset);
+}
+
+/* CRC24B check of up to 8 byte aligned code blocks, two registers of 4 code blocks folded together.
+   Leading zeros do not change a CRC initialised with zeros, so each code block is padded at the front
+   up to the number of 128-bit blocks of the longest one and all lanes fold in step. */
+static uint32_t crc24b_check_lanes_snc(const struct bblib_crc_request *request, uint32_t mask)
+{
+    const static uint32_t k192 = 0x42000100;
+    const static uint32_t k128 = 0x80140500;
+    const static uint32_t k96 = 0x09000200;
+    const static uint32_t k64 = 0x90042100;
+    const static uint32_t u = 0xffff83ff;
+    const static uint32_t poly = 0x80006300;
+    const __m512i ENDIA_SHUF_MASK = _mm512_broadcast_i32x4(_mm_set_epi8(0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                                                                        0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F));
+    const __m512i k192k128 = _mm512_broadcast_i32x4(_mm_set_epi32(0, k192, 0, k128));
+    const __m512i k64k96 = _mm512_broadcast_i32x4(_mm_set_epi32(0, k64, 0, k96));
+    const __m512i kbr = _mm512_broadcast_i32x4(_mm_set_epi32(1, poly, 1, u));
+    const uint8_t *data[8];
+    int32_t pad[8];
+    int32_t num_blocks = 0;
+    int32_t head_blocks = 0;
+
+    if (mask == 0)
+        return 0;
+
+    /* lanes without a code block repeat the first one, their result is masked out */
+    const int32_t first = _tzcnt_u32(mask);
+    for (int32_t i = 0; i < 8; i++)
+    {
+        const int32_t lane = ((mask >> i) & 1) ? i : first;
+        data[i] = request[lane].data;
+        pad[i] = request[lane].len / 8 + 3;
+        if (num_blocks < (pad[i] + 15) / 16)
+            num_blocks = (pad[i] + 15) / 16;
+    }
+    for (int32_t i = 0; i < 8; i++)
+    {
+        pad[i] = num_blocks * 16 - pad[i];
+        if (head_blocks < (pad[i] + 15) / 16)
+            head_blocks = (pad[i] + 15) / 16;
+    }
+
+    /* 1. fold 128 bits per code block and step, the first blocks hold the zero padding of some lanes */
+    __m512i fold[2] = {_mm512_setzero_si512(), _mm512_setzero_si512()};
+    for (int32_t block = 0; block < head_blocks; block++)
+    {
+        for (int32_t r = 0; r < 2; r++)
+        {
+            __m512i next = _mm512_castsi128_si512(crc_lane_block(data[4 * r], pad[4 * r], block));
+            next = _mm512_inserti32x4(next, crc_lane_block(data[4 * r + 1], pad[4 * r + 1], block), 1);
+            next = _mm512_inserti32x4(next, crc_lane_block(data[4 * r + 2], pad[4 * r + 2], block), 2);
+            next = _mm512_inserti32x4(next, crc_lane_block(data[4 * r + 3], pad[4 * r + 3], block), 3);
+            fold[r] = _mm512_ternarylogic_epi32(_mm512_clmulepi64_epi128(fold[r], k192k128, 0x00),
+                                                _mm512_clmulepi64_epi128(fold[r], k192k128, 0x11),
+                                                _mm512_shuffle_epi8(next, ENDIA_SHUF_MASK), 0x96);
+        }
+    }
+
+    const uint8_t *p[8];
+    for (int32_t i = 0; i < 8; i++)
+        p[i] = data[i] + head_blocks * 16 - pad[i];
+    for (int32_t block = head_blocks; block < num_blocks; block++)
+    {
+        for (int32_t r = 0; r < 2; r++)
+        {
+            const __m256i low = _mm256_loadu2_m128i((const __m128i *)p[4 * r + 1], (const __m128i *)p[4 * r]);
+            const __m256i high = _mm256_loadu2_m128i((const __m128i *)p[4 * r + 3], (const __m128i *)p[4 * r + 2]);
+            const __m512i next = _mm512_inserti64x4(_mm512_castsi256_si512(low), high, 1);
+            fold[r] = _mm512_ternarylogic_epi32(_mm512_clmulepi64_epi128(fold[r], k192k128, 0x00),
+                                                _mm512_clmulepi64_epi128(fold[r], k192k128, 0x11),
+                                                _mm512_shuffle_epi8(next, ENDIA_SHUF_MASK), 0x96);
+        }
+        for (int32_t i = 0; i < 8; i++)
+            p[i] += 16;
+    }
+
+    /* 2. 64 bits and 32 bits folds, then Barrett reduction, in each lane */
+    uint32_t passed = 0;
+    for (int32_t r = 0; r < 2; r++)
+    {
+        const __m512i f = fold[r];
+        const __m512i f64 = _mm512_xor_si512(_mm512_clmulepi64_epi128(f, k64k96, 0x01),
+                                             _mm512_bsrli_epi128(_mm512_bslli_epi128(f, 8), 4));
+        const __m512i f32 = _mm512_xor_si512(_mm512_clmulepi64_epi128(f64, k64k96, 0x11),
+                                             _mm512_bsrli_epi128(_mm512_bslli_epi128(f64, 8), 8));
+        __m512i t = _mm512_clmulepi64_epi128(kbr, _mm512_bsrli_epi128(f32, 4), 0x00);
+        t = _mm512_clmulepi64_epi128(kbr, _mm512_bsrli_epi128(t, 4), 0x01);
+        /* the 24 bits CRC of the data followed by its CRC is 0 */
+        const __mmask16 zero = _mm512_mask_testn_epi32_mask(0x1111, _mm512_xor_si512(f32, t), _mm512_set1_epi32(0xFFFFFF00));
+        passed |= _pext_u32(zero, 0x1111) << (4 * r);
+    }
+    return passed & mask;
+}
+
+uint32_t bblib_lte_crc24b_check_multi_snc(const struct bblib_crc_request *request, int32_t num)
+{
+    if ((request == NULL) || (num < 0) || (num > 32))
+    {
+        printf("bblib_lte_crc24b_check_multi: invalid request or number of code blocks %d\n", num);
+        return 0;
+    }
+
+    uint32_t passed = 0;
+    for (int32_t first = 0; first < num; first += 8)
+    {
+        const int32_t lanes = (num - first < 8) ? (num - first) : 8;
+        uint32_t mask = 0;
+        for (int32_t i = 0; i < lanes; i++)
+            if ((request[first + i].data != NULL) && ((request[first + i].len & 0x7) == 0))
+                mask |= 1u << i;
+
+        passed |= crc24b_check_lanes_snc(request + first, mask) << first;
+        /* code blocks not byte aligned are checked one by one */
+        passed |= crc24b_check_stream(request + first, lanes, ~mask, bblib_crc_update_avx512, bblib_crc_finalize_avx512) << first;
+    }
+    return passed;
+}
+
 #endif  /* #ifdef _BBLIB_SNC_ */
 
@@ -36,6 +36,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "phy_crc_internal.h"
 #include "phy_crc.h"
@@ -731,6 +732,159 @@ void bblib_lte_crc6_check_sse(struct bblib_crc_request *request, struct bblib_cr
 }
 
 
+/* Streaming CRC, the folding of the single buffer functions applied 128 bits at a time as the data arrives */
+static void crc_stream_fold_sse(struct bblib_crc_state *state, const uint8_t *data, uint32_t num_bytes)
+{
+    const struct crc_stream_params *params = crc_stream_get_params(state->type);
+    const __m128i ENDIA_SHUF_MASK = _mm_set_epi8(0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                                                 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F);
+    const __m128i k = _mm_set_epi64x(params->t192, params->t128);
+    __m128i fold = _mm_loadu_si128((const __m128i *)state->fold);
+    __m128i next;
+    uint32_t num_pending = state->num_pending >> 3;
+
+    /* complete the pending bytes first */
+    if (num_pending)
+    {
+        const uint32_t num = (num_bytes < 16 - num_pending) ? num_bytes : (16 - num_pending);
+        memcpy(state->pending + num_pending, data, num);
+        num_pending += num;
+        data += num;
+        num_bytes -= num;
+        if (num_pending < 16)
+        {
+            state->num_pending = 8 * num_pending;
+            return;
+        }
+        next = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)state->pending), ENDIA_SHUF_MASK);
+        fold = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(fold, k, 0x00), _mm_clmulepi64_si128(fold, k, 0x11)), next);
+    }
+
+    for (; num_bytes >= 16; num_bytes -= 16, data += 16)
+    {
+        next = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data), ENDIA_SHUF_MASK);
+        fold = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(fold, k, 0x00), _mm_clmulepi64_si128(fold, k, 0x11)), next);
+    }
+
+    memcpy(state->pending, data, num_bytes);
+    state->num_pending = 8 * num_bytes;
+    _mm_storeu_si128((__m128i *)state->fold, fold);
+}
+
+void bblib_crc_update_sse(struct bblib_crc_state *state, const uint8_t *data, uint32_t len)
+{
+    if (crc_stream_get_params(state->type) == NULL)
+        return;
+    crc_stream_update(state, data, len, crc_stream_fold_sse);
+}
+
+uint32_t bblib_crc_finalize_sse(const struct bblib_crc_state *state)
+{
+    const struct crc_stream_params *params = crc_stream_get_params(state->type);
+    if (params == NULL)
+        return 0;
+    const __m128i ENDIA_SHUF_MASK = _mm_set_epi8(0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                                                 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F);
+    const __m128i k = _mm_set_epi64x(params->t192, params->t128);
+    const uint32_t num_bytes = state->num_pending >> 3;
+    __m128i fold = _mm_loadu_si128((const __m128i *)state->fold);
+
+    /* 1. fold and the pending bytes right aligned in 256 bits, then folded once to 128 bits */
+    if (num_bytes)
+    {
+        uint8_t buffer[32] = {0};
+        _mm_storeu_si128((__m128i *)(buffer + 16 - num_bytes), _mm_shuffle_epi8(fold, ENDIA_SHUF_MASK));
+        memcpy(buffer + 32 - num_bytes, state->pending, num_bytes);
+        const __m128i high = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)buffer), ENDIA_SHUF_MASK);
+        const __m128i low = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(buffer + 16)), ENDIA_SHUF_MASK);
+        fold = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(high, k, 0x00), _mm_clmulepi64_si128(high, k, 0x11)), low);
+    }
+
+    /* 2. apply 64 bits fold to 64 bits + 32 bits crc(32 bits zero), then 32 bits fold */
+    const __m128i k2 = _mm_set_epi64x(params->t64, params->t96);
+    const __m128i fold64 = _mm_xor_si128(_mm_clmulepi64_si128(fold, k2, 0x01), _mm_srli_si128(_mm_slli_si128(fold, 8), 4));
+    const __m128i fold32 = _mm_xor_si128(_mm_clmulepi64_si128(fold64, k2, 0x11), _mm_srli_si128(_mm_slli_si128(fold64, 8), 8));
+
+    /* 3. Barrett reduction */
+    const __m128i kbr = _mm_set_epi32(1, params->shifted_poly, 1, (uint32_t)params->u);
+    __m128i t = _mm_clmulepi64_si128(kbr, _mm_srli_si128(fold32, 4), 0x00);
+    t = _mm_clmulepi64_si128(kbr, _mm_srli_si128(t, 4), 0x01);
+    const uint32_t remainder = (uint32_t)_mm_cvtsi128_si32(_mm_xor_si128(fold32, t));
+
+    return crc_stream_final_bits(params, remainder, state->pending[num_bytes], state->num_pending & 7);
+}
+
+
+/* CRC24C computed with the streaming CRC, then appended after the len bits of data */
+static void crc24c_gen_stream_sse(enum bblib_crc_type type, struct bblib_crc_request *request,
+    struct bblib_crc_response *response)
+{
+    struct bblib_crc_state state;
+    const uint32_t byte = request->len >> 3;
+    const uint32_t shift = request->len & 7;
+
+    bblib_crc_init(&state, type);
+    bblib_crc_update_sse(&state, request->data, request->len);
+    const uint32_t crc = bblib_crc_finalize_sse(&state);
+
+    /* last data bits followed by the 24 CRC bits, MSB first */
+    uint32_t word = crc << (8 - shift);
+    if (shift)
+        word |= (uint32_t)(request->data[byte] & (0xFF << (8 - shift))) << 24;
+    for (uint32_t i = 0; i < (shift + 24 + 7) / 8; i++)
+        response->data[byte + i] = (uint8_t)(word >> (24 - 8 * i));
+
+    response->crc_value = crc;
+    response->len = request->len + 24;
+}
+
+/* CRC24C of the request compared with the 24 bits following the len bits of data */
+static void crc24c_check_stream_sse(enum bblib_crc_type type, struct bblib_crc_request *request,
+    struct bblib_crc_response *response)
+{
+    const uint32_t byte = request->len >> 3;
+    const uint32_t shift = request->len & 7;
+    uint32_t word = 0;
+
+    for (uint32_t i = 0; i < (shift + 24 + 7) / 8; i++)
+        word |= (uint32_t)request->data[byte + i] << (24 - 8 * i);
+    const uint32_t CRC_orig = (word >> (8 - shift)) & 0xFFFFFF;
+
+    crc24c_gen_stream_sse(type, request, response);
+    response->check_passed = (response->crc_value == CRC_orig);
+}
+
+void bblib_lte_crc24c_gen_sse(struct bblib_crc_request *request, struct bblib_crc_response *response)
+{
+    crc24c_gen_stream_sse(BBLIB_CRC24C, request, response);
+}
+
+void bblib_lte_crc24c_check_sse(struct bblib_crc_request *request, struct bblib_crc_response *response)
+{
+    crc24c_check_stream_sse(BBLIB_CRC24C, request, response);
+}
+
+void bblib_lte_crc24c_1_gen_sse(struct bblib_crc_request *request, struct bblib_crc_response *response)
+{
+    crc24c_gen_stream_sse(BBLIB_CRC24C_1, request, response);
+}
+
+void bblib_lte_crc24c_1_check_sse(struct bblib_crc_request *request, struct bblib_crc_response *response)
+{
+    crc24c_check_stream_sse(BBLIB_CRC24C_1, request, response);
+}
+
+
+uint32_t bblib_lte_crc24b_check_multi_sse(const struct bblib_crc_request *request, int32_t num)
+{
+    if ((request == NULL) || (num < 0) || (num > 32))
+    {
+        printf("bblib_lte_crc24b_check_multi: invalid request or number of code blocks %d\n", num);
+        return 0;
+    }
+    return crc24b_check_stream(request, num, 0xFFFFFFFF, bblib_crc_update_sse, bblib_crc_finalize_sse);
+}
+
 
 #else
 void bblib_lte_crc24a_gen_sse(struct bblib_crc_request *request, struct bblib_crc_response *response){
@@ -781,4 +935,39 @@ void bblib_lte_crc6_check_sse(struct bblib_crc_request *request, struct bblib_cr
     printf("bblib_crc requires at least SSE4.2 ISA support to run\n");
     exit(-1);
 }
+void bblib_crc_update_sse(struct bblib_crc_state *state, const uint8_t *data, uint32_t len)
+{
+    printf("bblib_crc requires at least SSE4.2 ISA support to run\n");
+    exit(-1);
+}
+uint32_t bblib_crc_finalize_sse(const struct bblib_crc_state *state)
+{
+    printf("bblib_crc requires at least SSE4.2 ISA support to run\n");
+    exit(-1);
+}
+void bblib_lte_crc24c_gen_sse(struct bblib_crc_request *request, struct bblib_crc_response *response)
+{
+    printf("bblib_crc requires at least SSE4.2 ISA support to run\n");
+    exit(-1);
+}
+void bblib_lte_crc24c_check_sse(struct bblib_crc_request *request, struct bblib_crc_response *response)
+{
+    printf("bblib_crc requires at least SSE4.2 ISA support to run\n");
+    exit(-1);
+}
+void bblib_lte_crc24c_1_gen_sse(struct bblib_crc_request *request, struct bblib_crc_response *response)
+{
+    printf("bblib_crc requires at least SSE4.2 ISA support to run\n");
+    exit(-1);
+}
+void bblib_lte_crc24c_1_check_sse(struct bblib_crc_request *request, struct bblib_crc_response *response)
+{
+    printf("bblib_crc requires at least SSE4.2 ISA support to run\n");
+    exit(-1);
+}
+uint32_t bblib_lte_crc24b_check_multi_sse(const struct bblib_crc_request *request, int32_t num)
+{
+    printf("bblib_crc requires at least SSE4.2 ISA support to run\n");
+    exit(-1);
+}
 #endif
@@ -237,4 +237,9 @@ namespace SimdLdpc
   template<typename SIMD>
   void LdpcAlignedRestore(LayerParamsInt16& request, DecoderResponseInt16& response);
 
+  /// Fill the internal decoder parameters (base graph circulants, row weights) from the request.
+  /// \param [out] decoderRequest structure
+  /// \param [in] request structure
+  void LdpcSetupInternalRequest(DecoderParamsInt16 *decoderRequest, const Request* request);
+
 }
@@ -22,10 +22,8 @@
 *
 **********************************************************************/
 
-#include "InternalApi.hpp"
-
+#include "LdpcDecoderTop.hpp"
 #include "Tables.hpp"
-#include "LayerUtilities.hpp"
 
 #include <algorithm>
 #include <stdexcept>
@@ -35,25 +33,6 @@
 // are static the compiler will complain
 #pragma warning(disable:177)
 
-// Compact the final messages into contiguous bytes (rather than a sequence of int16_t APP LLRs)
-// These are "reversed" because bit#0 of byte#0 maps to the MSB of byte#0 (3GPP ordering)
-template<typename SIMD>
-static inline void CompactReverseMessages(const int16_t* varNodes, int numMessageBits, uint8_t* compactMessage)
-{
-  // MSG_TYPE will be the same as the return type of GetNegativeMask(SIMD)
-  using MSG_TYPE = decltype(GetNegativeMask(std::declval<SIMD>()));
-
-  const SIMD* appLLrs = (const SIMD*)varNodes;
-  MSG_TYPE *compactMessagePtr = (MSG_TYPE*)compactMessage;
-
-  // On each step of the conversion, a block of bits of type MSG_TYPE
-  // is generated. The number of steps is rounded up to the nearest whole set.
-  constexpr int k_numBitsPerStep = sizeof(MSG_TYPE) * 8;
-  unsigned numSteps = RoundUpDiv(numMessageBits , k_numBitsPerStep);
-  for (int n = 0; n != numSteps; ++n)
-    compactMessagePtr[n] = GetNegativeMask(appLLrs[n]);
-}
-
 // Select the a-value for the basegraph: each Z-value = a*2^[0...N-1]
 // If-else needs to be in this order as, for example, 30 % 15 = 0, but so is 30 % 5 = 0
 static int ZvalueToIndex(int z)
@@ -79,8 +58,8 @@ static int ZvalueToIndex(int z)
 }
 
 // Setup an internal request containg some extra information
-static void LdpcSetupInternalRequest(SimdLdpc::DecoderParamsInt16 *decoderRequest,
-                                     const SimdLdpc::Request* request)
+void SimdLdpc::LdpcSetupInternalRequest(SimdLdpc::DecoderParamsInt16 *decoderRequest,
+                                        const SimdLdpc::Request* request)
 {
   decoderRequest->varNodes = request->varNodes;
 
@@ -140,36 +119,7 @@ static void LdpcSetupInternalRequest(SimdLdpc::DecoderParamsInt16 *decoderReques
   decoderRequest->nCols = int16_t(nSystematicCols + request->nRows);
 }
 
-template<typename SIMD>
-static void LdpcDecoderTop(const SimdLdpc::Request* request,
-                           SimdLdpc::Response *response)
-{
-  SimdLdpc::DecoderParamsInt16 decoderRequest;
-  LdpcSetupInternalRequest(&decoderRequest, request);
-
-  SimdLdpc::DecoderResponseInt16 decoderResponse;
-  decoderResponse.varNodes = response->varNodes;
-
-  //Call the decoder
-  SimdLdpc::LdpcLayeredDecoderAlignedInt16<SIMD>(decoderRequest, decoderResponse);
-
-  //Outputs
-  response->iterationAtTermination = decoderResponse.iter;
-  response->numMsgBits = decoderResponse.numMsgBits;
-  response->parityPassedAtTermination = (decoderResponse.parityErrorCount == 0);
-
-  CompactReverseMessages<SIMD>(decoderResponse.varNodes, decoderResponse.numMsgBits,
-                               response->compactedMessageBytes);
-}
-
 void SimdLdpc::DecodeAvx2(const SimdLdpc::Request* request, SimdLdpc::Response* response)
 {
   LdpcDecoderTop<Is16vec16>(request, response);
 }
-
-#ifdef _BBLIB_AVX512_
-void SimdLdpc::DecodeAvx512(const SimdLdpc::Request* request, SimdLdpc::Response *response)
-{
-  LdpcDecoderTop<Is16vec32>(request, response);
-}
-#endif
\ No newline at end of file
@@ -0,0 +1,74 @@
+/**********************************************************************
+*
+*
+*  Copyright [2019 - 2023] [Intel Corporation]
+* 
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  
+*  You may obtain a copy of the License at
+*  
+*     http://www.apache.org/licenses/LICENSE-2.0 
+*  
+*  Unless required by applicable law or agreed to in writing, software 
+*  distributed under the License is distributed on an "AS IS" BASIS, 
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and 
+*  limitations under the License. 
+*  
+*  SPDX-License-Identifier: Apache-2.0 
+*  
+* 
+*
+**********************************************************************/
+
+#pragma once
+
+/// Top level of the decoder, instantiated for Is16vec16 in LdpcDecoderTop.cpp and for Is16vec32
+/// in LdpcDecoderTop_avx512.cpp
+
+#include "InternalApi.hpp"
+#include "LayerUtilities.hpp"
+
+#include <utility>
+
+// Compact the final messages into contiguous bytes (rather than a sequence of int16_t APP LLRs)
+// These are "reversed" because bit#0 of byte#0 maps to the MSB of byte#0 (3GPP ordering)
+template<typename SIMD>
+static inline void CompactReverseMessages(const int16_t* varNodes, int numMessageBits, uint8_t* compactMessage)
+{
+  // MSG_TYPE will be the same as the return type of GetNegativeMask(SIMD)
+  using MSG_TYPE = decltype(GetNegativeMask(std::declval<SIMD>()));
+
+  const SIMD* appLLrs = (const SIMD*)varNodes;
+  MSG_TYPE *compactMessagePtr = (MSG_TYPE*)compactMessage;
+
+  // On each step of the conversion, a block of bits of type MSG_TYPE
+  // is generated. The number of steps is rounded up to the nearest whole set.
+  constexpr int k_numBitsPerStep = sizeof(MSG_TYPE) * 8;
+  unsigned numSteps = RoundUpDiv(numMessageBits , k_numBitsPerStep);
+  for (int n = 0; n != numSteps; ++n)
+    compactMessagePtr[n] = GetNegativeMask(appLLrs[n]);
+}
+
+template<typename SIMD>
+static void LdpcDecoderTop(const SimdLdpc::Request* request,
+                           SimdLdpc::Response *response)
+{
+  SimdLdpc::DecoderParamsInt16 decoderRequest;
+  SimdLdpc::LdpcSetupInternalRequest(&decoderRequest, request);
+
+  SimdLdpc::DecoderResponseInt16 decoderResponse;
+  decoderResponse.varNodes = response->varNodes;
+
+  //Call the decoder
+  SimdLdpc::LdpcLayeredDecoderAlignedInt16<SIMD>(decoderRequest, decoderResponse);
+
+  //Outputs
+  response->iterationAtTermination = decoderResponse.iter;
+  response->numMsgBits = decoderResponse.numMsgBits;
+  response->parityPassedAtTermination = (decoderResponse.parityErrorCount == 0);
+
+  CompactReverseMessages<SIMD>(decoderResponse.varNodes, decoderResponse.numMsgBits,
+                               response->compactedMessageBytes);
+}
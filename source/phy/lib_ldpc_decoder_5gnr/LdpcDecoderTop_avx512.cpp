@@ -0,0 +1,47 @@
+/**********************************************************************
+*
+*
+*  Copyright [2019 - 2023] [Intel Corporation]
+* 
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  
+*  You may obtain a copy of the License at
+*  
+*     http://www.apache.org/licenses/LICENSE-2.0 
+*  
+*  Unless required by applicable law or agreed to in writing, software 
+*  distributed under the License is distributed on an "AS IS" BASIS, 
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and 
+*  limitations under the License. 
+*  
+*  SPDX-License-Identifier: Apache-2.0 
+*  
+* 
+*
+**********************************************************************/
+
+/// AVX512 decoder. The layer templates are instantiated for Is16vec32 here so that ISA_MULTI
+/// builds compile them, like the rest of this file, for the AVX512 target.
+
+#include "LdpcDecoderTop.hpp"
+#include "LdpcLayeredDecoderInt16.hpp"
+#include "LdpcLayerAlignedInt16.hpp"
+
+#ifdef _BBLIB_AVX512_
+template void
+SimdLdpc::LdpcAlignedRestore<Is16vec32>(LayerParamsInt16& request, DecoderResponseInt16& response);
+
+template void
+SimdLdpc::LdpcLayerAlignedInt16<Is16vec32>(LayerParamsInt16& request, LayerOutputsInt16& response);
+
+template void
+SimdLdpc::LdpcLayeredDecoderAlignedInt16<Is16vec32>(SimdLdpc::DecoderParamsInt16& request,
+                                                    SimdLdpc::DecoderResponseInt16& response);
+
+void SimdLdpc::DecodeAvx512(const SimdLdpc::Request* request, SimdLdpc::Response *response)
+{
+  LdpcDecoderTop<Is16vec32>(request, response);
+}
+#endif
@@ -34,6 +34,7 @@
 #include "phy_ldpc_decoder_5gnr.h"
 #include "phy_ldpc_decoder_5gnr_internal.h"
 #include "sdk_version.h"
+#include "bblib_isa.h"
 
 typedef int32_t (*ldpc_decoder_5gnr_function)(bblib_ldpc_decoder_5gnr_request *request,
     bblib_ldpc_decoder_5gnr_response *response);
@@ -75,16 +76,25 @@ bblib_print_ldpc_decoder_5gnr_version()
     }
 }
 
+/* Picked when the CPU, or BBLIB_ISA, has none of the compiled variants */
+static int32_t
+bblib_ldpc_decoder_5gnr_unsupported(struct bblib_ldpc_decoder_5gnr_request *request, struct bblib_ldpc_decoder_5gnr_response *response)
+{
+    printf("LDPC support AVX2/512 only currently\n");
+    return -1;
+}
+
 static ldpc_decoder_5gnr_function
 bblib_ldpc_decoder_5gnr_select_on_isa() {
 #ifdef _BBLIB_AVX512_
-    return bblib_ldpc_decoder_5gnr_avx512;
-#elif defined _BBLIB_AVX2_
-    return bblib_ldpc_decoder_5gnr_avx2;
-#else
-    printf("LDPC support AVX2/512 only currently\n");
-    exit(-1);
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+        return bblib_ldpc_decoder_5gnr_avx512;
+#endif
+#ifdef _BBLIB_AVX2_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX2)
+        return bblib_ldpc_decoder_5gnr_avx2;
 #endif
+    return bblib_ldpc_decoder_5gnr_unsupported;
 }
 
 static ldpc_decoder_5gnr_function default_ldpc_decoder_5gnr = bblib_ldpc_decoder_5gnr_select_on_isa();
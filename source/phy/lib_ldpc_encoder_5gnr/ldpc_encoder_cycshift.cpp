@@ -103,7 +103,6 @@ inline __m512i cycle_bit_left_shift_special(__m512i data, int16_t cycLeftShift,
     return x1;
 }
 
-
 CYCLE_BIT_LEFT_SHIFT ldpc_select_left_shift_func(int16_t zcSize)
 {
     if (zcSize >= 288)
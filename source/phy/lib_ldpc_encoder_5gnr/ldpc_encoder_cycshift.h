@@ -26,7 +26,15 @@ extern inline __m512i cycle_bit_left_shift_from144to256(__m512i data, int16_t cy
 extern inline __m512i cycle_bit_left_shift_from72to128(__m512i data, int16_t cycLeftShift, int16_t zcSize, int8_t zcIndex_, __m512i swapIdx0_);
 extern inline __m512i cycle_bit_left_shift_less_than_64(__m512i data, int16_t cycLeftShift, int16_t zcSize, int8_t zcIndex_, __m512i swapIdx0_);
 extern inline __m512i cycle_bit_left_shift_special(__m512i data, int16_t cycLeftShift, int16_t zcSize, int8_t zcIndex_, __m512i swapIdx0_);
+#ifdef _BBLIB_SNC_
+extern inline __m512i cycle_bit_left_shift_from288to384_snc(__m512i data, int16_t cycLeftShift, int16_t zcSize, int8_t zcIndex_, __m512i swapIdx0_);
+extern inline __m512i cycle_bit_left_shift_from144to256_snc(__m512i data, int16_t cycLeftShift, int16_t zcSize, int8_t zcIndex_, __m512i swapIdx0_);
+extern inline __m512i cycle_bit_left_shift_special_snc(__m512i data, int16_t cycLeftShift, int16_t zcSize, int8_t zcIndex_, __m512i swapIdx0_);
+#endif
 
 typedef __m512i (* CYCLE_BIT_LEFT_SHIFT)(__m512i, int16_t, int16_t, int8_t, __m512i);
 CYCLE_BIT_LEFT_SHIFT ldpc_select_left_shift_func(int16_t zcSize);
+#ifdef _BBLIB_SNC_
+CYCLE_BIT_LEFT_SHIFT ldpc_select_left_shift_func_snc(int16_t zcSize);
+#endif
 #endif
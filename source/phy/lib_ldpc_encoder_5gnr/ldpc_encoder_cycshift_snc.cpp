@@ -0,0 +1,92 @@
+#include "ldpc_encoder_cycshift.h"
+
+#ifdef _BBLIB_SNC_
+/* VBMI2 version of cycle_bit_left_shift_from288to384, the funnel shift replaces the two shifts and the OR */
+inline __m512i cycle_bit_left_shift_from288to384_snc(__m512i data, int16_t cycLeftShift, int16_t zcSize, int8_t zcIndex, __m512i swapIdx0)
+{
+    __m512i x1,x2;
+    int16_t cycleLeftShift1 = cycLeftShift >> 5;
+    int32_t cycleLeftShift2 = cycLeftShift & 0x1f;
+    __m512i swapIdx1 = _mm512_loadu_si512 ((void const*)(permuteTableFrom288to384[zcIndex] + cycleLeftShift1));
+    //left shift cycleLeftShift1
+    x1 = _mm512_permutex2var_epi32 (data, swapIdx1, data);
+    x2 = _mm512_permutex2var_epi32 (x1, swapIdx0, x1);
+    //bits of x2 fill the top of x1
+    return _mm512_shrdv_epi32 (x1, x2, _mm512_set1_epi32(cycleLeftShift2));
+}
+
+/* VBMI2 version of cycle_bit_left_shift_from144to256 */
+inline __m512i cycle_bit_left_shift_from144to256_snc(__m512i data, int16_t cycLeftShift, int16_t zcSize, int8_t zcIndex, __m512i swapIdx0)
+{
+    __m512i x1,x2;
+    int16_t cycleLeftShift1;
+    int16_t cycleLeftShift2;
+    __m256i swapIdx11;
+    __m512i swapIdx1;
+
+    // Reduce the circular shift from H_BG(I_LS) based on actual Lifting factor
+    while (cycLeftShift > zcSize)
+        cycLeftShift -= zcSize; // cycLeftShift % zcSize
+    cycleLeftShift1 = cycLeftShift >> 4;
+    cycleLeftShift2 = cycLeftShift & 0xf;
+
+    if (zcSize > 128)
+        swapIdx11 = _mm256_loadu_si256 ((__m256i const*)(permuteTableFrom144to256[zcIndex] + cycleLeftShift1));
+    else
+        swapIdx11 = _mm256_loadu_si256 ((__m256i const*)(permuteTabUpto128[zcIndex] + cycleLeftShift1));
+    swapIdx1 = _mm512_broadcast_i32x8 (swapIdx11);
+    swapIdx1 = _mm512_mask_add_epi16 (swapIdx1, 0xffff0000, swapIdx1, _mm512_set1_epi16(16));
+    //left shift cycleLeftShift1
+    x1 = _mm512_permutex2var_epi16 (data, swapIdx1, data);
+    x2 = _mm512_permutex2var_epi16 (x1, swapIdx0, x1);
+    //bits of x2 fill the top of x1
+    return _mm512_shrdv_epi16 (x1, x2, _mm512_set1_epi16(cycleLeftShift2));
+}
+
+/* Shift the 512 bits vector towards bit 0 (right) or towards bit 511 (left) by numBits,
+   qword permutation followed by a VBMI2 funnel shift across neighbouring qwords */
+static inline __m512i bit_right_shift_512_snc(__m512i data, int32_t numBits)
+{
+    const __m512i qwordIdx = _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+    __m512i idxLow = _mm512_add_epi64(qwordIdx, _mm512_set1_epi64(numBits >> 6));
+    __m512i idxHigh = _mm512_add_epi64(idxLow, _mm512_set1_epi64(1));
+    __m512i x1 = _mm512_maskz_permutexvar_epi64(_mm512_cmplt_epi64_mask(idxLow, _mm512_set1_epi64(8)), idxLow, data);
+    __m512i x2 = _mm512_maskz_permutexvar_epi64(_mm512_cmplt_epi64_mask(idxHigh, _mm512_set1_epi64(8)), idxHigh, data);
+    return _mm512_shrdv_epi64(x1, x2, _mm512_set1_epi64(numBits & 0x3f));
+}
+
+static inline __m512i bit_left_shift_512_snc(__m512i data, int32_t numBits)
+{
+    const __m512i qwordIdx = _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+    __m512i idxHigh = _mm512_sub_epi64(qwordIdx, _mm512_set1_epi64(numBits >> 6));
+    __m512i idxLow = _mm512_sub_epi64(idxHigh, _mm512_set1_epi64(1));
+    __m512i x1 = _mm512_maskz_permutexvar_epi64(_mm512_cmpge_epi64_mask(idxHigh, _mm512_setzero_si512()), idxHigh, data);
+    __m512i x2 = _mm512_maskz_permutexvar_epi64(_mm512_cmpge_epi64_mask(idxLow, _mm512_setzero_si512()), idxLow, data);
+    return _mm512_shldv_epi64(x1, x2, _mm512_set1_epi64(numBits & 0x3f));
+}
+
+/* VBMI2 version of cycle_bit_left_shift_special (64 < Zc < 128), the Zc bits are duplicated above
+   themselves so the rotation becomes a single wide right shift, no scalar byte loop */
+inline __m512i cycle_bit_left_shift_special_snc(__m512i data, int16_t cycLeftShift, int16_t zcSize, int8_t zcIndex_, __m512i swapIdx0_)
+{
+    __m512i x1, bitMask;
+    cycLeftShift = cycLeftShift % zcSize;
+    bitMask = _mm512_set_epi64(0, 0, 0, 0, 0, 0, (1ULL << (zcSize - 64)) - 1, -1);
+    data = _mm512_and_si512 (data, bitMask);
+    x1 = _mm512_or_si512 (data, bit_left_shift_512_snc(data, zcSize));
+    x1 = bit_right_shift_512_snc(x1, cycLeftShift);
+    return _mm512_and_si512 (x1, bitMask);
+}
+
+CYCLE_BIT_LEFT_SHIFT ldpc_select_left_shift_func_snc(int16_t zcSize)
+{
+    if (zcSize >= 288)
+        return cycle_bit_left_shift_from288to384_snc;
+    else if (zcSize < 64)
+        return ldpc_select_left_shift_func(zcSize);
+    else if (zcSize == 72 || zcSize == 88 || zcSize == 104 || zcSize == 120)
+        return cycle_bit_left_shift_special_snc;
+    else
+        return cycle_bit_left_shift_from144to256_snc;
+}
+#endif
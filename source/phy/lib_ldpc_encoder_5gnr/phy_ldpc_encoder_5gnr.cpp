@@ -33,6 +33,7 @@
 
 #include "phy_ldpc_encoder_5gnr.h"
 #include "sdk_version.h"
+#include "bblib_isa.h"
 
 typedef int32_t (*ldpc_encoder_5gnr_function)(bblib_ldpc_encoder_5gnr_request *request,
     bblib_ldpc_encoder_5gnr_response *response);
@@ -73,14 +74,25 @@ bblib_print_ldpc_encoder_5gnr_version()
     }
 }
 
+/* Picked when the CPU, or BBLIB_ISA, has none of the compiled variants */
+static int32_t
+bblib_ldpc_encoder_5gnr_unsupported(struct bblib_ldpc_encoder_5gnr_request *request, struct bblib_ldpc_encoder_5gnr_response *response)
+{
+    printf("LDPC support AVX512 only currently\n");
+    return -1;
+}
+
 static ldpc_encoder_5gnr_function
 bblib_ldpc_encoder_5gnr_select_on_isa() {
-#ifdef _BBLIB_AVX512_
-    return bblib_ldpc_encoder_5gnr_avx512;
-#else
-    printf("LDPC support AVX512 only currently\n");
-    exit(-1);
+#if defined(_BBLIB_SNC_)
+    if (bblib_get_isa() >= BBLIB_ISA_SNC)
+        return bblib_ldpc_encoder_5gnr_snc;
+#endif
+#if defined(_BBLIB_AVX512_)
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+        return bblib_ldpc_encoder_5gnr_avx512;
 #endif
+    return bblib_ldpc_encoder_5gnr_unsupported;
 }
 
 static ldpc_encoder_5gnr_function default_ldpc_encoder_5gnr = bblib_ldpc_encoder_5gnr_select_on_isa();
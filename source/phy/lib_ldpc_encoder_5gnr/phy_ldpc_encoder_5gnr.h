@@ -88,6 +88,51 @@ struct bblib_ldpc_encoder_5gnr_response {
         The actual length is limited to the number of rows requested.  */
 };
 
+/*!
+    \struct bblib_ldpc_5gnr_segmentation
+    \brief Code block segmentation parameters of a transport block as defined in TS38212-5.2.2.
+*/
+struct bblib_ldpc_5gnr_segmentation {
+    uint16_t C;      /*!< Number of code blocks. */
+    uint16_t L;      /*!< Length of the code block CRC in bits, 0 when C is 1. */
+    uint16_t Zc;     /*!< Lifting factor selected for the code blocks. */
+    uint16_t K;      /*!< Number of bits per code block including filler bits (22*Zc or 10*Zc). */
+    uint16_t Kprime; /*!< Number of bits per code block excluding filler bits, K' in TS38212-5.2.2. */
+    uint16_t F;      /*!< Number of filler bits per code block (K - K'). */
+};
+
+/*!
+    \struct bblib_ldpc_encoder_5gnr_tb_request
+    \brief Structure for input parameters in API of transport block LDPC Encoder for 5GNR.
+*/
+struct bblib_ldpc_encoder_5gnr_tb_request {
+    uint8_t *input; /*!< Pointer to the transport block bit sequence b_k, including the TB CRC,
+        as defined in TS38212-5.2.2. Bits are packed MSB first as for the CRC functions. */
+
+    uint32_t tbSize; /*!< Length B of the input in bits, including the TB CRC. */
+
+    int32_t baseGraph; /*!< LDPC Base graph, which can be 1 or 2  as defined in TS38212-5.2.1. */
+
+    int32_t nRows; /*!< Number of parity rows to compute for each code block - Minimum 4 */
+};
+
+/*!
+    \struct bblib_ldpc_encoder_5gnr_tb_response
+    \brief structure for outputs of transport block LDPC encoder for 5GNR.
+*/
+struct bblib_ldpc_encoder_5gnr_tb_response {
+    uint8_t *output; /*!<
+        Output buffer, 64 bytes aligned, for the C code words d_r as defined in TS38.212-5.3.2, packed
+        LSB first as the encoder output and ready for bblib_LDPC_ratematch_5gnr.
+        Code word r starts at output + r * cbStride, filler bits are set to 0 and start at bit K' - 2*Zc. */
+
+    uint32_t cbEncLen; /*!< Number of bits per code word, K - 2*Zc + nRows*Zc. */
+
+    uint32_t cbStride; /*!< Distance in bytes between two code words, multiple of 64. */
+
+    struct bblib_ldpc_5gnr_segmentation seg; /*!< Segmentation used for the transport block. */
+};
+
 //! @{
 /*! \brief Encoder for LDPC in 5GNR.
     \param [in] request Structure containing configuration information and input data.
@@ -98,8 +143,27 @@ struct bblib_ldpc_encoder_5gnr_response {
 */
 int32_t bblib_ldpc_encoder_5gnr(struct bblib_ldpc_encoder_5gnr_request *request, struct bblib_ldpc_encoder_5gnr_response *response);
 int32_t bblib_ldpc_encoder_5gnr_avx512( struct bblib_ldpc_encoder_5gnr_request *request, struct bblib_ldpc_encoder_5gnr_response *response);
+int32_t bblib_ldpc_encoder_5gnr_snc(struct bblib_ldpc_encoder_5gnr_request *request, struct bblib_ldpc_encoder_5gnr_response *response);
 //! @}
 
+/*! \brief Code block segmentation for LDPC in 5GNR as defined in TS38212-5.2.2.
+    \param [in] tbSize Length B of the transport block in bits, including the TB CRC.
+    \param [in] baseGraph LDPC Base graph, which can be 1 or 2.
+    \param [out] seg Segmentation parameters.
+    \return Success: return 0, else: return -1.
+*/
+int32_t bblib_ldpc_5gnr_segmentation(uint32_t tbSize, int32_t baseGraph, struct bblib_ldpc_5gnr_segmentation *seg);
+
+/*! \brief Transport block encoder for LDPC in 5GNR.
+    \param [in] request Structure containing configuration information and input data.
+    \param [out] response Structure containing kernel outputs.
+    \note Performs the code block segmentation, the CRC24B attachment to each code block, the filler bits
+          insertion and the LDPC encoding of all code blocks with bblib_ldpc_encoder_5gnr.
+          The output buffer must hold C * cbStride bytes, which is C * ceil(cbEncLen / 512) * 64.
+    \return Success: return 0, else: return -1.
+*/
+int32_t bblib_ldpc_encoder_5gnr_tb(struct bblib_ldpc_encoder_5gnr_tb_request *request, struct bblib_ldpc_encoder_5gnr_tb_response *response);
+
 /*! \brief Report the version number for the encoder library.
  */
 void bblib_print_ldpc_encoder_5gnr_version(void);
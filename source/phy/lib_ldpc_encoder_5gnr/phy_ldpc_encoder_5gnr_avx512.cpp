@@ -229,7 +229,10 @@ void adapter_2ways_from144to256(int8_t **pbuff0, int8_t *pbuff1, uint16_t zcSize
         swapIdx1 = _mm512_mask_loadu_epi16(swapIdx1, mask2,
             ((void const*)(adapterPermuteTableShort + 48 - shortNum)));
 
-        for (int16_t i = 0; i <= cbLen; i = i + zcSize) {
+        for (int16_t i = 0; i < cbLen; i = i + zcSizeMul2) {
+            /* Last odd row only carries one Zc chunk per way, do not write past cbLen */
+            if ((cbLen - i) < zcSizeMul2)
+                mask0 = ((__mmask64)1 << (zc2WayByteNum >> 1)) - 1;
             x0 = _mm512_loadu_si512(pBuff1Offset);
             pBuff1Offset = pBuff1Offset + PROC_BYTES;
             x1 = _mm512_loadu_si512(pBuff1Offset);
@@ -266,10 +269,11 @@ LDPC_ADAPTER_P ldpc_select_adapter_func(uint16_t zcSize, uint8_t num_ways)
 *  @param [out] output data before adapter
 *  @param [in] Matrix const LUTs structure
 *  @param [in] zcSize Lifting factor size
+*  @param [in] cycle_bit_left_shift_p Cyclic shift function selected for zcSize
 *  @return void
 **/
 void ldpc_encoder_bg1(int8_t *pDataIn, int8_t *pDataOut,
-    const int16_t *pShiftMatrix, int16_t zcSize, uint8_t i_LS)
+    const int16_t *pShiftMatrix, int16_t zcSize, uint8_t i_LS, CYCLE_BIT_LEFT_SHIFT cycle_bit_left_shift_p)
 {
     const int16_t *pTempAddr, *pTempMatrix;
     int8_t *pTempIn, *pTempOut;
@@ -278,7 +282,6 @@ void ldpc_encoder_bg1(int8_t *pDataIn, int8_t *pDataOut,
     __m512i x1, x2, x3, x4, x5, x6, x7, x8, x9;
     __m512i swapIdx0;
     __m256i swapIdx00;
-    CYCLE_BIT_LEFT_SHIFT cycle_bit_left_shift_p = ldpc_select_left_shift_func(zcSize);
 
     for (int32_t j = 0; j < BG1_ROW_TOTAL; j++)
         _mm512_storeu_si512(pDataOut + PROC_BYTES*j, _mm512_set1_epi8(0));
@@ -381,10 +384,11 @@ void ldpc_encoder_bg1(int8_t *pDataIn, int8_t *pDataOut,
 *  @param [out] output data before adapter
 *  @param [in] Matrix const LUTs structure
 *  @param [in] zcSize Lifting factor size
+*  @param [in] cycle_bit_left_shift_p Cyclic shift function selected for zcSize
 *  @return void
 **/
 void ldpc_encoder_bg2(int8_t *pDataIn, int8_t *pDataOut,
-    const int16_t *pShiftMatrix, int16_t zcSize, uint8_t i_LS)
+    const int16_t *pShiftMatrix, int16_t zcSize, uint8_t i_LS, CYCLE_BIT_LEFT_SHIFT cycle_bit_left_shift_p)
 {
     const int16_t *pTempAddr, *pTempMatrix;
     int8_t *pTempIn, *pTempOut;
@@ -393,7 +397,6 @@ void ldpc_encoder_bg2(int8_t *pDataIn, int8_t *pDataOut,
     __m512i x1, x2, x3, x4, x5, x6, x7, x8, x9;
     __m512i swapIdx0;
     __m256i swapIdx00;
-    CYCLE_BIT_LEFT_SHIFT cycle_bit_left_shift_p = ldpc_select_left_shift_func(zcSize);
 
     for (int32_t j = 0; j < BG2_ROW_TOTAL; j++)
         _mm512_storeu_si512(pDataOut + PROC_BYTES * j, _mm512_set1_epi8(0));
@@ -499,15 +502,17 @@ void ldpc_encoder_bg2(int8_t *pDataIn, int8_t *pDataOut,
 
 //-------------------------------------------------------------------------------------------
 /**
-*  @brief Encoding for LDPC in 5GNR.
+*  @brief Encoding for LDPC in 5GNR, shared by the ISA specific versions.
 *  @param [in] request Structure containing configuration information and input data.
 *  @param [out] response Structure containing kernel outputs.
+*  @param [in] select_left_shift_func Selection of the cyclic shift function for the ISA
 *  @return Success: return 0, else: return -1.
 **/
-int32_t bblib_ldpc_encoder_5gnr_avx512(struct bblib_ldpc_encoder_5gnr_request *request, struct bblib_ldpc_encoder_5gnr_response *response)
+static int32_t ldpc_encoder_5gnr_process(struct bblib_ldpc_encoder_5gnr_request *request, struct bblib_ldpc_encoder_5gnr_response *response,
+    CYCLE_BIT_LEFT_SHIFT (*select_left_shift_func)(int16_t))
 {
     if ((request->numberCodeblocks > 2) || ((request->numberCodeblocks == 2) && ((request->Zc > 256) || (request->Zc <= 128)))) {
-        printf("bblib_ldpc_encoder_5gnr_avx512 Number of code blocks invalid \n");
+        printf("bblib_ldpc_encoder_5gnr Number of code blocks invalid \n");
         return(-1);
     }
     /* internal processing buffer allocated internally */
@@ -515,6 +520,7 @@ int32_t bblib_ldpc_encoder_5gnr_avx512(struct bblib_ldpc_encoder_5gnr_request *r
     __align(64) int8_t internalBuffer1[BG1_ROW_TOTAL * PROC_BYTES];
     const int16_t *pShiftMatrix;
     LDPC_ADAPTER_P ldpc_adapter_func;
+    CYCLE_BIT_LEFT_SHIFT cycle_bit_left_shift_p = select_left_shift_func((int16_t)request->Zc);
     uint32_t cbEncLen, cbLen;
 
     /* Find i_Ls based on lifting factor size as defined in 38.212 Table 5.3.2-1*/
@@ -550,15 +556,28 @@ int32_t bblib_ldpc_encoder_5gnr_avx512(struct bblib_ldpc_encoder_5gnr_request *r
     ldpc_adapter_func(request->input, internalBuffer0, request->Zc, cbLen, 1);
     /* Actual processing */
     if (request->baseGraph == 1)
-        ldpc_encoder_bg1(internalBuffer0, internalBuffer1, pShiftMatrix, (int16_t)request->Zc, i_LS);
+        ldpc_encoder_bg1(internalBuffer0, internalBuffer1, pShiftMatrix, (int16_t)request->Zc, i_LS, cycle_bit_left_shift_p);
     else
-        ldpc_encoder_bg2(internalBuffer0, internalBuffer1, pShiftMatrix, (int16_t)request->Zc, i_LS);
+        ldpc_encoder_bg2(internalBuffer0, internalBuffer1, pShiftMatrix, (int16_t)request->Zc, i_LS, cycle_bit_left_shift_p);
     /* Adapter function to gather back the data */
     ldpc_adapter_func(response->output, internalBuffer1, request->Zc, cbEncLen, 0);
 
     return 0;
 }
 
+int32_t bblib_ldpc_encoder_5gnr_avx512(struct bblib_ldpc_encoder_5gnr_request *request, struct bblib_ldpc_encoder_5gnr_response *response)
+{
+    return ldpc_encoder_5gnr_process(request, response, ldpc_select_left_shift_func);
+}
+
+#ifdef _BBLIB_SNC_
+/* Same encoder with the VBMI2 cyclic shifts */
+int32_t bblib_ldpc_encoder_5gnr_snc(struct bblib_ldpc_encoder_5gnr_request *request, struct bblib_ldpc_encoder_5gnr_response *response)
+{
+    return ldpc_encoder_5gnr_process(request, response, ldpc_select_left_shift_func_snc);
+}
+#endif
+
 /* Table generated for BG1 from H Matrix in Table 5.3.2-3 in 38.212 */
 /* Number of non-null elements per columns in BG1 */
 int16_t Bg1MatrixNumPerCol[BG1_COL_TOTAL] =
@@ -0,0 +1,256 @@
+/**********************************************************************
+*
+*
+*  Copyright [2019 - 2023] [Intel Corporation]
+* 
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  
+*  You may obtain a copy of the License at
+*  
+*     http://www.apache.org/licenses/LICENSE-2.0 
+*  
+*  Unless required by applicable law or agreed to in writing, software 
+*  distributed under the License is distributed on an "AS IS" BASIS, 
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and 
+*  limitations under the License. 
+*  
+*  SPDX-License-Identifier: Apache-2.0 
+*  
+* 
+*
+**********************************************************************/
+
+/*
+ * @file   phy_ldpc_encoder_5gnr_tb.cpp
+ * @brief  Transport block level 5GNR LDPC encoding, code block segmentation and CB CRC attachment.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "phy_ldpc_encoder_5gnr.h"
+#include "phy_ldpc_encoder_5gnr_internal.h"
+#include "phy_crc.h"
+#include "bit_reverse.h"
+
+#include "common_typedef_sdk.h"
+
+#define BG1_KCB (8448)
+#define BG2_KCB (3840)
+#define CB_CRC_LEN (24)
+/* Maximum K (22*384 bits) plus room for the 16 bytes CRC store, multiple of 64 bytes */
+#define TB_CB_BUF_BYTES (1152)
+/* Parity buffer used when Zc is not a multiple of 8 (Zc < 64) */
+#define TB_PARITY_BUF_BYTES (BG1_ROW_TOTAL * 64 / 8 + 64)
+
+/* Lifting sizes Zc from Table 5.3.2-1 in 38.212, sorted */
+static constexpr uint16_t k_lifting_sizes[] = {
+    2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 18, 20, 22, 24, 26, 28, 30, 32, 36, 40, 44,
+    48, 52, 56, 60, 64, 72, 80, 88, 96, 104, 112, 120, 128, 144, 160, 176, 192, 208, 224, 240, 256,
+    288, 320, 352, 384
+};
+
+/* Minimum lifting size Zc >= n, for n up to ZC_MAX, built at compile time */
+struct zc_lookup_table
+{
+    uint16_t zc[ZC_MAX + 1];
+
+    constexpr zc_lookup_table() : zc()
+    {
+        int32_t j = 0;
+        for (int32_t n = 0; n <= ZC_MAX; n++) {
+            while (k_lifting_sizes[j] < n)
+                j++;
+            zc[n] = k_lifting_sizes[j];
+        }
+    }
+};
+
+static constexpr zc_lookup_table k_zc_lookup{};
+
+/**
+*  @brief Code block segmentation as defined in 38.212 5.2.2.
+*  @param [in] tbSize transport block size B including TB CRC
+*  @param [in] baseGraph LDPC base graph
+*  @param [out] seg segmentation parameters
+*  @return Success: return 0, else: return -1.
+**/
+int32_t bblib_ldpc_5gnr_segmentation(uint32_t tbSize, int32_t baseGraph, struct bblib_ldpc_5gnr_segmentation *seg)
+{
+    uint32_t kcb, bPrime, c, l, kPrime, kb;
+
+    if ((baseGraph != 1) && (baseGraph != 2)) {
+        printf("bblib_ldpc_5gnr_segmentation Wrong parameter for Base Graph. It should be 1/2\n");
+        return(-1);
+    }
+    if (tbSize == 0) {
+        printf("bblib_ldpc_5gnr_segmentation Transport block size invalid\n");
+        return(-1);
+    }
+
+    kcb = (baseGraph == 1) ? BG1_KCB : BG2_KCB;
+    if (tbSize <= kcb) {
+        l = 0;
+        c = 1;
+        bPrime = tbSize;
+    }
+    else {
+        l = CB_CRC_LEN;
+        c = (tbSize + (kcb - l) - 1) / (kcb - l);
+        bPrime = tbSize + c * l;
+    }
+    if (bPrime % c) {
+        printf("bblib_ldpc_5gnr_segmentation B' is not a multiple of C\n");
+        return(-1);
+    }
+    kPrime = bPrime / c;
+
+    if (baseGraph == 1)
+        kb = BG1_COL_INF_NUM;
+    else if (tbSize > 640)
+        kb = 10;
+    else if (tbSize > 560)
+        kb = 9;
+    else if (tbSize > 192)
+        kb = 8;
+    else
+        kb = 6;
+
+    seg->C = (uint16_t)c;
+    seg->L = (uint16_t)l;
+    seg->Kprime = (uint16_t)kPrime;
+    seg->Zc = k_zc_lookup.zc[(kPrime + kb - 1) / kb];
+    seg->K = ((baseGraph == 1) ? BG1_COL_INF_NUM : BG2_COL_INF_NUM) * seg->Zc;
+    seg->F = seg->K - seg->Kprime;
+
+    return 0;
+}
+
+/**
+*  @brief Bit copy with LSB first bit order, used for lifting sizes which are not a multiple of 8.
+*  @param [out] dst destination buffer
+*  @param [in] dstBit bit offset in destination buffer
+*  @param [in] src source buffer
+*  @param [in] srcBit bit offset in source buffer
+*  @param [in] nBits number of bits to copy
+*  @return void
+**/
+static void ldpc_tb_copy_bits(uint8_t *dst, uint32_t dstBit, const uint8_t *src, uint32_t srcBit, uint32_t nBits)
+{
+    for (uint32_t i = 0; i < nBits; i++, dstBit++, srcBit++) {
+        const uint8_t bit = (src[srcBit >> 3] >> (srcBit & 7)) & 1;
+        dst[dstBit >> 3] = (dst[dstBit >> 3] & ~(1 << (dstBit & 7))) | (bit << (dstBit & 7));
+    }
+}
+
+/**
+*  @brief Build code block c_r as defined in 38.212 5.2.2, in the LSB first layout used by the encoder.
+*  @param [in] tb transport block, MSB first
+*  @param [in] r code block index
+*  @param [in] seg segmentation parameters
+*  @param [out] cb code block buffer, TB_CB_BUF_BYTES long and 64 bytes aligned
+*  @return void
+**/
+static void ldpc_tb_build_cb(const uint8_t *tb, uint32_t r, const struct bblib_ldpc_5gnr_segmentation *seg, int8_t *cb)
+{
+    const uint32_t payloadLen = seg->Kprime - seg->L;
+    const uint32_t payloadBytes = (payloadLen + 7) >> 3;
+
+    memcpy(cb, tb + ((r * payloadLen) >> 3), payloadBytes);
+    memset(cb + payloadBytes, 0, TB_CB_BUF_BYTES - payloadBytes);
+    /* Filler bits are encoded as 0 */
+    if (payloadLen & 7)
+        cb[payloadBytes - 1] &= (int8_t)(0xFF << (8 - (payloadLen & 7)));
+
+    if (seg->L) {
+        struct bblib_crc_request crcRequest;
+        struct bblib_crc_response crcResponse;
+        crcRequest.data = (uint8_t *)cb;
+        crcRequest.len = payloadLen;
+        crcResponse.data = (uint8_t *)cb;
+        bblib_lte_crc24b_gen(&crcRequest, &crcResponse);
+    }
+
+    bblib_bit_reverse(cb, seg->K);
+}
+
+/**
+*  @brief Transport block encoding for LDPC in 5GNR.
+*  @param [in] request Structure containing configuration information and input data.
+*  @param [out] response Structure containing kernel outputs.
+*  @return Success: return 0, else: return -1.
+**/
+int32_t bblib_ldpc_encoder_5gnr_tb(struct bblib_ldpc_encoder_5gnr_tb_request *request, struct bblib_ldpc_encoder_5gnr_tb_response *response)
+{
+    struct bblib_ldpc_5gnr_segmentation *seg = &response->seg;
+    struct bblib_ldpc_encoder_5gnr_request cbRequest;
+    struct bblib_ldpc_encoder_5gnr_response cbResponse;
+    __align(64) int8_t cbBuffer[WAYS_144to256][TB_CB_BUF_BYTES];
+    __align(64) int8_t parityBuffer[WAYS_144to256][TB_PARITY_BUF_BYTES];
+    uint32_t sysLen, parityLen, numWays;
+    bool zcByteAligned;
+
+    if (bblib_ldpc_5gnr_segmentation(request->tbSize, request->baseGraph, seg) != 0)
+        return(-1);
+
+    if ((request->nRows < 4) ||
+        (request->nRows > ((request->baseGraph == 1) ? BG1_ROW_TOTAL : BG2_ROW_TOTAL))) {
+        printf("bblib_ldpc_encoder_5gnr_tb Number of rows invalid\n");
+        return(-1);
+    }
+    if (((uintptr_t)response->output & 63) != 0) {
+        printf("bblib_ldpc_encoder_5gnr_tb Output buffer should be 64 bytes aligned\n");
+        return(-1);
+    }
+    if ((seg->C > 1) && ((seg->Kprime - seg->L) & 7)) {
+        printf("bblib_ldpc_encoder_5gnr_tb Code block payload is not byte aligned\n");
+        return(-1);
+    }
+
+    sysLen = seg->K - 2 * seg->Zc;
+    parityLen = request->nRows * seg->Zc;
+    response->cbEncLen = sysLen + parityLen;
+    response->cbStride = ((response->cbEncLen + 511) >> 9) << 6;
+
+    /* Parity is written by the encoder straight into the code word when it starts on a byte boundary */
+    zcByteAligned = ((seg->Zc & 7) == 0);
+    /* Small code blocks are encoded two at a time through the 2 ways adapter */
+    numWays = ((seg->Zc > 128) && (seg->Zc <= 256)) ? WAYS_144to256 : 1;
+
+    cbRequest.Zc = seg->Zc;
+    cbRequest.baseGraph = request->baseGraph;
+    cbRequest.nRows = request->nRows;
+
+    for (uint32_t r = 0; r < seg->C; r += numWays) {
+        const uint32_t numCb = ((seg->C - r) < numWays) ? (seg->C - r) : numWays;
+
+        for (uint32_t j = 0; j < numCb; j++) {
+            ldpc_tb_build_cb(request->input, r + j, seg, cbBuffer[j]);
+            cbRequest.input[j] = cbBuffer[j];
+            if (zcByteAligned)
+                cbResponse.output[j] = (int8_t *)(response->output + (r + j) * response->cbStride + (sysLen >> 3));
+            else
+                cbResponse.output[j] = parityBuffer[j];
+        }
+        cbRequest.numberCodeblocks = (int8_t)numCb;
+
+        if (bblib_ldpc_encoder_5gnr(&cbRequest, &cbResponse) != 0)
+            return(-1);
+
+        /* Code word d_r is c_r without the first 2*Zc bits followed by the parity bits w_r */
+        for (uint32_t j = 0; j < numCb; j++) {
+            uint8_t *pCodeword = response->output + (r + j) * response->cbStride;
+            if (zcByteAligned) {
+                memcpy(pCodeword, cbBuffer[j] + (seg->Zc >> 2), sysLen >> 3);
+            }
+            else {
+                ldpc_tb_copy_bits(pCodeword, 0, (uint8_t *)cbBuffer[j], 2 * seg->Zc, sysLen);
+                ldpc_tb_copy_bits(pCodeword, sysLen, (uint8_t *)parityBuffer[j], 0, parityLen);
+            }
+        }
+    }
+
+    return 0;
+}
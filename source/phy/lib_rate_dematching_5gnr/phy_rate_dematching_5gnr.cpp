@@ -32,6 +32,7 @@
 
 #include "phy_rate_dematching_5gnr.h"
 #include "sdk_version.h"
+#include "bblib_isa.h"
 
 typedef void (*rate_dematching_5gnr_function)(struct bblib_rate_dematching_5gnr_request *request,
                                             struct bblib_rate_dematching_5gnr_response *response);
@@ -61,10 +62,14 @@ bblib_rate_dematching_5gnr_init do_constructor_rate_dematching_5gnr;
 static rate_dematching_5gnr_function bblib_rate_dematching_5gnr_select_on_isa() {
 
 #ifdef _BBLIB_AVX512_
-    return bblib_rate_dematching_5gnr_avx512;
-#else
-    return bblib_rate_dematching_5gnr_c;
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+        return bblib_rate_dematching_5gnr_avx512;
+#endif
+#ifdef _BBLIB_AVX2_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX2)
+        return bblib_rate_dematching_5gnr_avx2;
 #endif
+    return bblib_rate_dematching_5gnr_c;
 
 }
 
@@ -75,6 +80,88 @@ void bblib_rate_dematching_5gnr(struct bblib_rate_dematching_5gnr_request *reque
     return default_rate_dematching_5gnr(request, response);
 }
 
+typedef int32_t (*rate_dematching_5gnr_multi_function)(struct bblib_rate_dematching_5gnr_multi_request *request,
+                                                      struct bblib_rate_dematching_5gnr_response *response);
+
+/** Return a pointer-to-function for a specific implementation */
+static rate_dematching_5gnr_multi_function bblib_rate_dematching_5gnr_multi_select_on_isa() {
+
+#ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+        return bblib_rate_dematching_5gnr_multi_avx512;
+#endif
+#ifdef _BBLIB_AVX2_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX2)
+        return bblib_rate_dematching_5gnr_multi_avx2;
+#endif
+    return bblib_rate_dematching_5gnr_multi_c;
+
+}
+
+static rate_dematching_5gnr_multi_function default_rate_dematching_5gnr_multi =
+    bblib_rate_dematching_5gnr_multi_select_on_isa();
+
+int32_t bblib_rate_dematching_5gnr_multi(struct bblib_rate_dematching_5gnr_multi_request *request,
+        struct bblib_rate_dematching_5gnr_response *response) {
+    return default_rate_dematching_5gnr_multi(request, response);
+}
+
+typedef int32_t (*rate_dematching_5gnr_harq_pack_function)(const int8_t *p_in, int8_t *p_harq, int32_t ncb,
+                                                          enum bblib_harq_format format);
+
+/** Return a pointer-to-function for a specific implementation */
+static rate_dematching_5gnr_harq_pack_function bblib_rate_dematching_5gnr_harq_pack_select_on_isa() {
+
+#ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+        return bblib_rate_dematching_5gnr_harq_pack_avx512;
+#endif
+    return bblib_rate_dematching_5gnr_harq_pack_c;
+
+}
+
+static rate_dematching_5gnr_harq_pack_function default_rate_dematching_5gnr_harq_pack =
+    bblib_rate_dematching_5gnr_harq_pack_select_on_isa();
+
+int32_t bblib_rate_dematching_5gnr_harq_pack(const int8_t *p_in, int8_t *p_harq, int32_t ncb,
+        enum bblib_harq_format format) {
+    return default_rate_dematching_5gnr_harq_pack(p_in, p_harq, ncb, format);
+}
+
+/** Return a pointer-to-function for a specific implementation */
+static rate_dematching_5gnr_harq_pack_function bblib_rate_dematching_5gnr_harq_unpack_select_on_isa() {
+
+#ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+        return bblib_rate_dematching_5gnr_harq_unpack_avx512;
+#endif
+    return bblib_rate_dematching_5gnr_harq_unpack_c;
+
+}
+
+static rate_dematching_5gnr_harq_pack_function default_rate_dematching_5gnr_harq_unpack =
+    bblib_rate_dematching_5gnr_harq_unpack_select_on_isa();
+
+int32_t bblib_rate_dematching_5gnr_harq_unpack(const int8_t *p_harq, int8_t *p_out, int32_t ncb,
+        enum bblib_harq_format format) {
+    return default_rate_dematching_5gnr_harq_unpack(p_harq, p_out, ncb, format);
+}
+
+int32_t bblib_rate_dematching_5gnr_harq_size(int32_t ncb, enum bblib_harq_format format) {
+    const int32_t nBlock = (ncb + BBLIB_HARQ_BLOCK_SIZE - 1) / BBLIB_HARQ_BLOCK_SIZE;
+
+    switch (format) {
+        case BBLIB_HARQ_INT8:
+            return ncb;
+        case BBLIB_HARQ_4BIT:
+        case BBLIB_HARQ_6BIT:
+            return nBlock * (format * BBLIB_HARQ_BLOCK_SIZE / 8 + 1);
+        default:
+            printf("bblib_rate_dematching_5gnr_harq_size: unsupported format %d\n", format);
+            return -1;
+    }
+}
+
 int16_t bblib_rate_dematching_5gnr_version(char *version, int buffer_size) {
     /* The version string will be updated before the build process starts  by the
      *       jobs building the library and/or preparing the release packages.
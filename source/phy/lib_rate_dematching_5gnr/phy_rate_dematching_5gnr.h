@@ -52,9 +52,28 @@ extern "C" {
 #define MAX_LLR (LLR_VAL)
 #define MIN_LLR (-LLR_VAL)
 
+#define BBLIB_HARQ_BLOCK_SIZE (64) /*!< Number of LLRs sharing a scale in a compressed HARQ buffer */
+
+/*!
+    \enum bblib_harq_format
+    \brief Storage format of the LLRs in the HARQ buffer.
+*/
+enum bblib_harq_format
+{
+    BBLIB_HARQ_INT8 = 0, /*!< One int8 LLR per byte */
+    BBLIB_HARQ_4BIT = 4, /*!< 4 bits saturated LLRs with a scale per block of BBLIB_HARQ_BLOCK_SIZE LLRs */
+    BBLIB_HARQ_6BIT = 6  /*!< 6 bits saturated LLRs with a scale per block of BBLIB_HARQ_BLOCK_SIZE LLRs */
+};
+
+/*! Options of the flags of the rate dematching requests, none set keeps the plain rate dematching. */
+#define BBLIB_RATE_DEMATCHING_DESCRAMBLING (1 << 0) /*!< Descramble the input LLRs first, negated where the
+    scrambling sequence c(n) of TS38211-6.3.1.1 is 1 */
+
 /*!
     \struct bblib_rate_dematching_5gnr_request
     \brief Request structure providing the inputs and configuration to the rate dematching.
+    \note The structure must be zero-initialised (e.g. = {} or memset) before its fields are set, so that
+          options it does not set, such as harq_format and flags, keep their default behaviour.
 */
 struct bblib_rate_dematching_5gnr_request {
     int8_t *p_in; /*!< the pointer of rate dematching input, non cache alignment requirement, the input symbol size is 8bits */
@@ -83,6 +102,22 @@ struct bblib_rate_dematching_5gnr_request {
     int32_t base_graph; /*!< LDPC Base graph, which can be 1 or 2  as defined in TS38212-5.2.1. */
 
     int32_t isretx; /*!<  flag of retransmission, 0: no retransmission, clear HARQ buffer, 1: retransmission */
+
+    enum bblib_harq_format harq_format; /*!<
+    Format of p_harq, BBLIB_HARQ_INT8 by default. A compressed buffer holds bblib_rate_dematching_5gnr_harq_size
+    bytes, is unpacked, combined and packed again, and must be unpacked with bblib_rate_dematching_5gnr_harq_unpack
+    before the decoder. */
+
+    uint32_t flags; /*!< Options, BBLIB_RATE_DEMATCHING_* bits, 0 when the input is already descrambled */
+
+    uint32_t c_init; /*!< c_init of the scrambling sequence, with BBLIB_RATE_DEMATCHING_DESCRAMBLING when
+    p_scrambling is NULL */
+
+    uint32_t scrambling_offset; /*!< position n in the scrambling sequence of the first input LLR, used with c_init */
+
+    const uint8_t *p_scrambling; /*!< optional pre-generated scrambling sequence, as from bblib_prbs_basic,
+    bit k (LSB first) applying to input LLR k, with BBLIB_RATE_DEMATCHING_DESCRAMBLING. NULL to generate it
+    from c_init. */
 };
 
 /*!
@@ -93,6 +128,59 @@ struct bblib_rate_dematching_5gnr_response {
     uint32_t dummy;  /*!<  dummy variable */
 };
 
+#define BBLIB_RATE_DEMATCHING_MAX_TX (16) /*!< Maximum number of transmissions combined in one call */
+
+/*!
+    \struct bblib_rate_dematching_5gnr_transmission
+    \brief One received transmission of a code block, e.g. one PUSCH repetition.
+*/
+struct bblib_rate_dematching_5gnr_transmission {
+    int8_t *p_in; /*!< the pointer of rate dematching input for this transmission */
+
+    int32_t rvid; /*!< redundancy version id as defined in TS38212-5.4.2.1. */
+
+    int32_t e; /*!< E The number of post rate-matched output LLR values as defined in TS38212-5.4.2.1.*/
+
+    uint32_t scrambling_offset; /*!< position n in the scrambling sequence of the first input LLR, used with c_init */
+
+    const uint8_t *p_scrambling; /*!< optional pre-generated scrambling sequence, NULL to generate it from c_init */
+};
+
+/*!
+    \struct bblib_rate_dematching_5gnr_multi_request
+    \brief Request structure for the combining of several transmissions of a code block into one HARQ buffer.
+    \note The fields are those of bblib_rate_dematching_5gnr_request, with the per transmission ones in tx.
+          The structure must be zero-initialised as bblib_rate_dematching_5gnr_request.
+*/
+struct bblib_rate_dematching_5gnr_multi_request {
+    int8_t *p_harq; /*!< The pointer of HARQ buffer for both input/output, assumed to be 64B cache aligned. */
+
+    int32_t ncb; /*!<  Ncb the length of the circular buffer (including null bits) as defined in TS38212-5.4.2.1. */
+
+    int32_t start_null_index; /*!< the start null bit position in Ncb */
+
+    int32_t num_of_null; /*!< F The number of filler bits used in the encoding */
+
+    int32_t zc;  /*!< Lifting factor Zc as defined in TS38212-5.2.1. */
+
+    enum bblib_modulation_order modulation_order; /*!< modulation, the allowed values: 1, 2, 4, 6, or 8 */
+
+    int32_t base_graph; /*!< LDPC Base graph, which can be 1 or 2  as defined in TS38212-5.2.1. */
+
+    int32_t isretx; /*!< 0: the first transmission clears the HARQ buffer, 1: all transmissions are combined into it */
+
+    enum bblib_harq_format harq_format; /*!< Format of p_harq, BBLIB_HARQ_INT8 by default. */
+
+    uint32_t flags; /*!< Options, BBLIB_RATE_DEMATCHING_* bits as bblib_rate_dematching_5gnr_request */
+
+    uint32_t c_init; /*!< c_init of the scrambling sequence */
+
+    int32_t num_tx; /*!< Number of transmissions, 1 to BBLIB_RATE_DEMATCHING_MAX_TX */
+
+    struct bblib_rate_dematching_5gnr_transmission tx[BBLIB_RATE_DEMATCHING_MAX_TX]; /*!< Transmissions in the
+    order they are combined */
+};
+
 //! @{
 /*! \brief Implements rate dematching
     \param [in] request Structure containing the configuration, input data
@@ -103,10 +191,74 @@ void bblib_rate_dematching_5gnr(struct bblib_rate_dematching_5gnr_request *reque
 
 void bblib_rate_dematching_5gnr_c(struct bblib_rate_dematching_5gnr_request *req,
 struct bblib_rate_dematching_5gnr_response *resp);
+void bblib_rate_dematching_5gnr_avx2(struct bblib_rate_dematching_5gnr_request *req,
+struct bblib_rate_dematching_5gnr_response *resp);
 void bblib_rate_dematching_5gnr_avx512(struct bblib_rate_dematching_5gnr_request *req,
 struct bblib_rate_dematching_5gnr_response *resp);
 //! @}
 
+//! @{
+/*! \brief Combines several transmissions of a code block into the HARQ buffer.
+    \param [in] request Structure containing the configuration, input data
+    \param [out] response Structure containing the output data.
+    \note The transmissions are combined back to back while the buffer is in cache, in the same order and with
+           the same saturations as one bblib_rate_dematching_5gnr call per transmission. A compressed HARQ buffer
+           is unpacked and packed once, so the LLRs are quantized once instead of after each transmission.
+    \return Success: return 0, else: return -1.
+*/
+int32_t bblib_rate_dematching_5gnr_multi(struct bblib_rate_dematching_5gnr_multi_request *request,
+    struct bblib_rate_dematching_5gnr_response *response);
+int32_t bblib_rate_dematching_5gnr_multi_c(struct bblib_rate_dematching_5gnr_multi_request *request,
+    struct bblib_rate_dematching_5gnr_response *response);
+int32_t bblib_rate_dematching_5gnr_multi_avx2(struct bblib_rate_dematching_5gnr_multi_request *request,
+    struct bblib_rate_dematching_5gnr_response *response);
+int32_t bblib_rate_dematching_5gnr_multi_avx512(struct bblib_rate_dematching_5gnr_multi_request *request,
+    struct bblib_rate_dematching_5gnr_response *response);
+//! @}
+
+/*! \brief Size in bytes of a HARQ buffer holding ncb LLRs.
+    \param [in] ncb Number of LLRs.
+    \param [in] format Storage format of the LLRs.
+    \note A compressed buffer holds the packed LLRs of each block of BBLIB_HARQ_BLOCK_SIZE LLRs, format * 8 bytes
+           per block, followed by one scale byte per block.
+    \return Success: the size in bytes, else: return -1.
+*/
+int32_t bblib_rate_dematching_5gnr_harq_size(int32_t ncb, enum bblib_harq_format format);
+
+//! @{
+/*! \brief Compress ncb int8 LLRs into a HARQ buffer.
+    \param [in] p_in Input int8 LLRs.
+    \param [out] p_harq Compressed HARQ buffer of bblib_rate_dematching_5gnr_harq_size bytes.
+    \param [in] ncb Number of LLRs.
+    \param [in] format Storage format of p_harq.
+    \note The LLRs of a block are shifted right with rounding by the smallest scale keeping the largest one in
+           range, then saturated.
+    \return Success: return 0, else: return -1.
+*/
+int32_t bblib_rate_dematching_5gnr_harq_pack(const int8_t *p_in, int8_t *p_harq, int32_t ncb,
+    enum bblib_harq_format format);
+int32_t bblib_rate_dematching_5gnr_harq_pack_c(const int8_t *p_in, int8_t *p_harq, int32_t ncb,
+    enum bblib_harq_format format);
+int32_t bblib_rate_dematching_5gnr_harq_pack_avx512(const int8_t *p_in, int8_t *p_harq, int32_t ncb,
+    enum bblib_harq_format format);
+//! @}
+
+//! @{
+/*! \brief Expand a compressed HARQ buffer into ncb int8 LLRs, e.g. for the decoder input.
+    \param [in] p_harq Compressed HARQ buffer.
+    \param [out] p_out Output int8 LLRs.
+    \param [in] ncb Number of LLRs.
+    \param [in] format Storage format of p_harq.
+    \return Success: return 0, else: return -1.
+*/
+int32_t bblib_rate_dematching_5gnr_harq_unpack(const int8_t *p_harq, int8_t *p_out, int32_t ncb,
+    enum bblib_harq_format format);
+int32_t bblib_rate_dematching_5gnr_harq_unpack_c(const int8_t *p_harq, int8_t *p_out, int32_t ncb,
+    enum bblib_harq_format format);
+int32_t bblib_rate_dematching_5gnr_harq_unpack_avx512(const int8_t *p_harq, int8_t *p_out, int32_t ncb,
+    enum bblib_harq_format format);
+//! @}
+
 //! @{
 /*! \brief Report the version number for the bblib_rate_dematching_5gnr library.
     \param [in] version Pointer to a char buffer where the version string should be copied.
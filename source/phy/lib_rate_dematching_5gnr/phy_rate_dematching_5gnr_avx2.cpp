@@ -0,0 +1,315 @@
+/**********************************************************************
+ *
+*
+*  Copyright [2019 - 2023] [Intel Corporation]
+* 
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  
+*  You may obtain a copy of the License at
+*  
+*     http://www.apache.org/licenses/LICENSE-2.0 
+*  
+*  Unless required by applicable law or agreed to in writing, software 
+*  distributed under the License is distributed on an "AS IS" BASIS, 
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and 
+*  limitations under the License. 
+*  
+*  SPDX-License-Identifier: Apache-2.0 
+*  
+* 
+ *
+ **********************************************************************/
+
+/*
+ * @file phy_rate_dematching_5gnr_avx2.cpp
+ * @brief  Implementation for rate dematching functions with AVX2
+ */
+#ifdef _BBLIB_AVX2_
+#include "phy_rate_dematching_5gnr_internal.h"
+#include "pseudo_random_seq_gen_avx2.h"
+
+#include <string.h>
+#include <stdio.h>
+#include <immintrin.h> // AVX
+
+/*
+ * Same single pass as phy_rate_dematching_5gnr_avx512.cpp, 32 symbols at a time. Without byte masked
+ * loads and stores, the last symbols and the descrambled symbols go through a local copy of the input,
+ * and the HARQ buffer lanes at the edges of a round or around the wrap of the circular buffer are
+ * combined one at a time. Compressed HARQ buffers are packed and unpacked with the C functions.
+ */
+
+/*! \brief Negate the 32 LLRs of pLlr where the 32 descrambling bits flip are set. */
+static inline void rdm_descramble_32(int8_t *pLlr, uint32_t flip)
+{
+    const __m256i vByte = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                           2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+    const __m256i vBit = _mm256_set1_epi64x(0x8040201008040201LL);
+    const __m256i vFlip = _mm256_shuffle_epi8(_mm256_set1_epi32((int32_t) flip), vByte);
+    /* 0xFF where the bit is set, then x ^ m - m negates those LLRs */
+    const __m256i m = _mm256_cmpeq_epi8(_mm256_and_si256(vFlip, vBit), vBit);
+    const __m256i x = _mm256_loadu_si256((const __m256i *) pLlr);
+
+    _mm256_storeu_si256((__m256i *) pLlr, _mm256_sub_epi8(_mm256_xor_si256(x, m), m));
+}
+
+/*! \brief Two 16 bytes chunks of pIn, from bytes lo and hi, as the two lanes of a register. */
+static inline __m256i rdm_load_lanes(const int8_t *pIn, int32_t lo, int32_t hi)
+{
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) (pIn + lo))),
+        _mm_loadu_si128((const __m128i *) (pIn + hi)), 1);
+}
+
+/*! \brief Split 32 symbols of modQ LLRs into modQ vectors of 32 LLRs, one per stream.
+    For 64QAM, 4 bytes after the 32 symbols are read.
+*/
+static inline void rdm_deinterleave_32(const int8_t *pIn, int32_t modQ, __m256i *pStream)
+{
+    /* the LLRs of each stream gathered in words, dwords or qwords of each lane */
+    const __m256i idxTr2 = _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15,
+                                            0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+    const __m256i idxTr4 = _mm256_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15,
+                                            0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    const __m256i idxTr6 = _mm256_setr_epi8(0, 6, 1, 7, 2, 8, 3, 9, 4, 10, 5, 11, -1, -1, -1, -1,
+                                            0, 6, 1, 7, 2, 8, 3, 9, 4, 10, 5, 11, -1, -1, -1, -1);
+    const __m256i idxTr8 = _mm256_setr_epi8(0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15,
+                                            0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15);
+    __m256i x[8], t[8];
+
+    switch (modQ)
+    {
+        case BBLIB_QPSK:
+            /* lane 0 of x[k] holds symbols 8k .. 8k+7, lane 1 symbols 16+8k .. 16+8k+7 */
+            for (int32_t k = 0; k < 2; k++)
+                x[k] = _mm256_shuffle_epi8(rdm_load_lanes(pIn, 16 * k, 32 + 16 * k), idxTr2);
+            pStream[0] = _mm256_unpacklo_epi64(x[0], x[1]);
+            pStream[1] = _mm256_unpackhi_epi64(x[0], x[1]);
+            break;
+        case BBLIB_QAM16:
+            /* lane 0 of x[k] holds symbols 4k .. 4k+3, lane 1 symbols 16+4k .. 16+4k+3 */
+            for (int32_t k = 0; k < 4; k++)
+                x[k] = _mm256_shuffle_epi8(rdm_load_lanes(pIn, 16 * k, 64 + 16 * k), idxTr4);
+            t[0] = _mm256_unpacklo_epi32(x[0], x[1]);
+            t[1] = _mm256_unpackhi_epi32(x[0], x[1]);
+            t[2] = _mm256_unpacklo_epi32(x[2], x[3]);
+            t[3] = _mm256_unpackhi_epi32(x[2], x[3]);
+            pStream[0] = _mm256_unpacklo_epi64(t[0], t[2]);
+            pStream[1] = _mm256_unpackhi_epi64(t[0], t[2]);
+            pStream[2] = _mm256_unpacklo_epi64(t[1], t[3]);
+            pStream[3] = _mm256_unpackhi_epi64(t[1], t[3]);
+            break;
+        case BBLIB_QAM64:
+        case BBLIB_QAM256:
+            /* lane 0 of x[k] holds symbols 2k, 2k+1, lane 1 symbols 16+2k, 16+2k+1, then 8x8 words transpose */
+            for (int32_t k = 0; k < 8; k++)
+                x[k] = _mm256_shuffle_epi8(rdm_load_lanes(pIn, 2 * modQ * k, 2 * modQ * (8 + k)),
+                    (modQ == BBLIB_QAM64) ? idxTr6 : idxTr8);
+            for (int32_t k = 0; k < 8; k += 2)
+            {
+                t[k] = _mm256_unpacklo_epi16(x[k], x[k + 1]);
+                t[k + 1] = _mm256_unpackhi_epi16(x[k], x[k + 1]);
+            }
+            for (int32_t k = 0; k < 8; k += 4)
+            {
+                x[k] = _mm256_unpacklo_epi32(t[k], t[k + 2]);
+                x[k + 1] = _mm256_unpackhi_epi32(t[k], t[k + 2]);
+                x[k + 2] = _mm256_unpacklo_epi32(t[k + 1], t[k + 3]);
+                x[k + 3] = _mm256_unpackhi_epi32(t[k + 1], t[k + 3]);
+            }
+            for (int32_t k = 0; k < 4; k++)
+            {
+                t[2 * k] = _mm256_unpacklo_epi64(x[k], x[k + 4]);
+                t[2 * k + 1] = _mm256_unpackhi_epi64(x[k], x[k + 4]);
+            }
+            for (int32_t i = 0; i < modQ; i++)
+                pStream[i] = t[i];
+            break;
+        default:
+            /* No need to interleave for pi/2 BPSK */
+            pStream[0] = _mm256_loadu_si256((const __m256i *) pIn);
+            break;
+    }
+}
+
+/*! \brief Combine lanes lo .. hi-1 of llr into the HARQ buffer, lane k going to pBase[k] or, past
+    nFirst lanes, to pBase[k - ncb] at the start of the circular buffer. Values are saturated to MAX_LLR.
+*/
+static inline void rdm_harq_update(int8_t *pBase, int32_t nFirst, int32_t ncb, int32_t lo, int32_t hi,
+    __m256i llr, int32_t write)
+{
+    const __m256i vMax = _mm256_set1_epi8(MAX_LLR);
+    const __m256i vMin = _mm256_set1_epi8(MIN_LLR);
+    __align(32) int8_t lane[32];
+
+    if (lo == 0 && hi == 32 && nFirst >= 32)
+    {
+        if (!write)
+            llr = _mm256_adds_epi8(llr, _mm256_loadu_si256((const __m256i *) pBase));
+        llr = _mm256_min_epi8(vMax, _mm256_max_epi8(vMin, llr));
+        _mm256_storeu_si256((__m256i *) pBase, llr);
+        return;
+    }
+
+    _mm256_store_si256((__m256i *) lane, llr);
+    for (int32_t k = lo; k < hi; k++)
+    {
+        int8_t *p = (k < nFirst) ? (pBase + k) : (pBase + k - ncb);
+        int32_t v = lane[k] + (write ? 0 : *p);
+        /* same result as the saturated int8 addition followed by the clamp */
+        *p = (int8_t) MIN(MAX_LLR, MAX(MIN_LLR, v));
+    }
+}
+
+/*! \brief Deinterleave and combine the input into an int8 HARQ buffer. */
+static void rdm_combine(struct bblib_rate_dematching_5gnr_request *req, int8_t *pHarq)
+{
+    const int32_t modQ = req->modulation_order;
+    const int32_t eQ = req->e / modQ;
+    const int32_t e = eQ * modQ;
+    const int32_t ncb = req->ncb - req->num_of_null;
+    const int8_t *pIn = req->p_in;
+    const int32_t descrambling = (req->flags & BBLIB_RATE_DEMATCHING_DESCRAMBLING) != 0;
+    __m256i stream[8];
+    int32_t bStart[8], bEnd[8], pos[8];
+    __align(32) int8_t chunk[8 * 32 + 32];
+    uint64_t flip[4] = {0};
+    struct prbs_gold_avx2 gold = {};
+
+    get_k0(req);
+    /* k0 within the filler bits starts at the first LLR after them */
+    int32_t start = req->k0;
+    if (start > req->start_null_index)
+        start = MAX(start - req->num_of_null, req->start_null_index);
+
+    /* first transmission, only the part of the HARQ buffer which is not written below is cleared */
+    if (req->isretx == 0)
+    {
+        if (e < ncb)
+        {
+            const int32_t gap = (start + e) % ncb;
+            const int32_t len = MIN(ncb - e, ncb - gap);
+            memset(pHarq + gap, 0, len);
+            memset(pHarq, 0, ncb - e - len);
+        }
+        memset(pHarq + ncb, 0, req->num_of_null);
+    }
+
+    for (int32_t jRound = 0; jRound < e; jRound += ncb)
+    {
+        const int32_t jEnd = MIN(e, jRound + ncb);
+        const int32_t write = (req->isretx == 0) && (jRound == 0);
+        int32_t bLo = eQ, bHi = 0;
+
+        /* part of each stream in this round */
+        for (int32_t i = 0; i < modQ; i++)
+        {
+            bStart[i] = MIN(MAX(jRound - i * eQ, 0), eQ);
+            bEnd[i] = MIN(MAX(jEnd - i * eQ, 0), eQ);
+            if (bStart[i] < bEnd[i])
+            {
+                bLo = MIN(bLo, bStart[i]);
+                bHi = MAX(bHi, bEnd[i]);
+            }
+        }
+        for (int32_t i = 0; i < modQ; i++)
+            pos[i] = (start + i * eQ + bLo) % ncb;
+        if (descrambling && req->p_scrambling == NULL)
+            prbs_gold_avx2_init(&gold, req->c_init, req->scrambling_offset + modQ * bLo);
+
+        for (int32_t b = bLo; b < bHi; b += 32)
+        {
+            const int32_t nSym = MIN(32, eQ - b);
+            const int8_t *pSym = pIn + modQ * b;
+            /* the last symbols of the input and descrambled symbols are copied first */
+            if (descrambling || b + 32 >= eQ)
+            {
+                const int32_t nByte = modQ * nSym;
+                memcpy(chunk, pSym, nByte);
+                memset(chunk + nByte, 0, sizeof(chunk) - nByte);
+                if (descrambling)
+                {
+                    for (int32_t k = 0; k < nByte; k += 64)
+                    {
+                        const int32_t num = MIN(64, nByte - k);
+                        flip[k >> 6] = (req->p_scrambling == NULL) ? prbs_gold_avx2_next(&gold, num) :
+                            rdm_bitmap_read(req->p_scrambling, modQ * b + k, num);
+                    }
+                    for (int32_t k = 0; k < nByte; k += 32)
+                        rdm_descramble_32(chunk + k, (uint32_t) (flip[k >> 6] >> (k & 32)));
+                }
+                pSym = chunk;
+            }
+            rdm_deinterleave_32(pSym, modQ, stream);
+            for (int32_t i = 0; i < modQ; i++)
+            {
+                const int32_t lo = MAX(bStart[i] - b, 0);
+                const int32_t hi = MIN(bEnd[i] - b, 32);
+                if (lo < hi)
+                {
+                    /* position of the first selected lane */
+                    int32_t p = pos[i] + lo;
+                    while (p >= ncb)
+                        p -= ncb;
+                    rdm_harq_update(pHarq + p - lo, ncb - p + lo, ncb, lo, hi, stream[i], write);
+                }
+                pos[i] += 32;
+                while (pos[i] >= ncb)
+                    pos[i] -= ncb;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Implements rate dematching with AVX2
+ * @param [in] request Structure containing the configuration, input data
+ * @param [out] response Structure containing the output data.
+**/
+void bblib_rate_dematching_5gnr_avx2(struct bblib_rate_dematching_5gnr_request *req,
+struct bblib_rate_dematching_5gnr_response *resp)
+{
+    if (req->harq_format == BBLIB_HARQ_INT8) {
+        rdm_combine(req, req->p_harq);
+        return;
+    }
+
+    /* compressed HARQ buffer, combined on an unpacked copy which stays in cache */
+    __align(64) int8_t harqBuffer[MAX_NCB];
+    if (req->ncb > MAX_NCB) {
+        printf("bblib_rate_dematching_5gnr_avx2: ncb %d exceeds %d with a compressed HARQ buffer\n", req->ncb, MAX_NCB);
+        return;
+    }
+    if (req->isretx && bblib_rate_dematching_5gnr_harq_unpack_c(req->p_harq, harqBuffer, req->ncb, req->harq_format))
+        return;
+    rdm_combine(req, harqBuffer);
+    bblib_rate_dematching_5gnr_harq_pack_c(harqBuffer, req->p_harq, req->ncb, req->harq_format);
+}
+
+/**
+ * @brief Implements the combining of several transmissions of a code block with AVX2
+ * @param [in] request Structure containing the configuration, input data
+ * @param [out] response Structure containing the output data.
+**/
+int32_t bblib_rate_dematching_5gnr_multi_avx2(struct bblib_rate_dematching_5gnr_multi_request *request,
+    struct bblib_rate_dematching_5gnr_response *response)
+{
+    __align(64) int8_t harqBuffer[MAX_NCB];
+    struct bblib_rate_dematching_5gnr_request req;
+    int8_t *pHarq = rate_dematching_multi_buffer(request, harqBuffer, "bblib_rate_dematching_5gnr_multi_avx2");
+
+    if (pHarq == NULL)
+        return -1;
+    /* a compressed buffer is unpacked and packed once for all transmissions */
+    if (pHarq != request->p_harq && request->isretx && bblib_rate_dematching_5gnr_harq_unpack_c(request->p_harq, pHarq, request->ncb, request->harq_format))
+        return -1;
+    for (int32_t tx = 0; tx < request->num_tx; tx++) {
+        rate_dematching_tx_request(request, tx, pHarq, &req);
+        rdm_combine(&req, pHarq);
+    }
+    if (pHarq != request->p_harq)
+        return bblib_rate_dematching_5gnr_harq_pack_c(pHarq, request->p_harq, request->ncb, request->harq_format);
+    return 0;
+}
+#endif
@@ -29,15 +29,38 @@
 
 #include "phy_rate_dematching_5gnr_internal.h"
 #include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 
-/* Bit interleaving as per 3GPP 38.212 5.4.2.2 */
+/* One step of the m-sequences of TS38211 5.2.1, x(n) in the LSB, returns c(n) */
+static int32_t gold_step(uint32_t *x1, uint32_t *x2) {
+    const int32_t c = (*x1 ^ *x2) & 1;
+    *x1 = (*x1 >> 1) | (((*x1 ^ (*x1 >> 3)) & 1) << 30);
+    *x2 = (*x2 >> 1) | (((*x2 ^ (*x2 >> 1) ^ (*x2 >> 2) ^ (*x2 >> 3)) & 1) << 30);
+    return c;
+}
+
+/* Bit interleaving as per 3GPP 38.212 5.4.2.2, with the descrambling of the input as per 38.211 6.3.1.1 */
 void deInterleave(int8_t *pCbIn, int8_t *pDeInterleave, bblib_rate_dematching_5gnr_request *pRM) {
     int32_t byte, mod, intl_size = pRM->e / pRM->modulation_order;
+    const int32_t descrambling = (pRM->flags & BBLIB_RATE_DEMATCHING_DESCRAMBLING) != 0;
+    uint32_t x1 = 1, x2 = pRM->c_init & 0x7FFFFFFF, n;
+    if (descrambling && pRM->p_scrambling == NULL)
+        for (n = 0; n < 1600 + pRM->scrambling_offset; n++)
+            gold_step(&x1, &x2);
     for (byte = 0; byte < intl_size; byte++)
-        for (mod =0; mod < pRM->modulation_order; mod++)
-            pDeInterleave[byte + mod * intl_size] =
-                    pCbIn[pRM->modulation_order * byte + mod];
+        for (mod =0; mod < pRM->modulation_order; mod++) {
+            const int32_t k = pRM->modulation_order * byte + mod;
+            int8_t llr = pCbIn[k];
+            if (descrambling) {
+                const int32_t c = (pRM->p_scrambling != NULL) ? ((pRM->p_scrambling[k >> 3] >> (k & 7)) & 1) :
+                    gold_step(&x1, &x2);
+                if (c)
+                    llr = (int8_t) -llr;
+            }
+            pDeInterleave[byte + mod * intl_size] = llr;
+        }
 }
 
 /* Adds and saturate to MAX_LLR the 2 LLR streams */
@@ -58,8 +81,9 @@ void harq_combine(struct bblib_rate_dematching_5gnr_request *request,
     get_k0(request);
     int32_t ncb_, length, offset_e=0, offset_ncb=request->k0;
     ncb_ = request->ncb - request->num_of_null;
+    /* The HARQ buffer holds no filler bits, a k0 inside them starts at the first bit after */
     if (offset_ncb > request->start_null_index)
-        offset_ncb -= request->num_of_null;
+        offset_ncb = MAX(offset_ncb - request->num_of_null, request->start_null_index);
 
     while (offset_e < request->e) {
         length = MIN(request->e - offset_e, ncb_ - offset_ncb);
@@ -72,7 +96,7 @@ void harq_combine(struct bblib_rate_dematching_5gnr_request *request,
 }
 
 /**
- * @brief Implements rate dematching with AVX512
+ * @brief Implements rate dematching in C
  * @param [in] request Structure containing the configuration, input data
  * @param [out] response Structure containing the output data.
 **/
@@ -81,5 +105,123 @@ struct bblib_rate_dematching_5gnr_response *resp)
 {
     __align(64) int8_t internalBuffer[128 * 1024];
     deInterleave(req->p_in, internalBuffer, req);
-    harq_combine(req,resp,internalBuffer);
+
+    if (req->harq_format == BBLIB_HARQ_INT8) {
+        harq_combine(req,resp,internalBuffer);
+        return;
+    }
+
+    /* compressed HARQ buffer, combined on an unpacked copy */
+    __align(64) int8_t harqBuffer[MAX_NCB];
+    struct bblib_rate_dematching_5gnr_request reqUnpacked = *req;
+    if (req->ncb > MAX_NCB) {
+        printf("bblib_rate_dematching_5gnr_c: ncb %d exceeds %d with a compressed HARQ buffer\n", req->ncb, MAX_NCB);
+        return;
+    }
+    reqUnpacked.p_harq = harqBuffer;
+    reqUnpacked.harq_format = BBLIB_HARQ_INT8;
+    if (req->isretx && bblib_rate_dematching_5gnr_harq_unpack_c(req->p_harq, harqBuffer, req->ncb, req->harq_format))
+        return;
+    harq_combine(&reqUnpacked,resp,internalBuffer);
+    req->k0 = reqUnpacked.k0;
+    bblib_rate_dematching_5gnr_harq_pack_c(harqBuffer, req->p_harq, req->ncb, req->harq_format);
+}
+
+/* Packs or unpacks the LLRs of one block, format bits per LLR little endian */
+static void harq_block_bits(uint8_t *pPacked, int8_t *pLlr, int32_t format, int32_t pack)
+{
+    const int32_t mask = (1 << format) - 1;
+    for (int32_t i = 0; i < BBLIB_HARQ_BLOCK_SIZE; i++) {
+        const int32_t bit = i * format;
+        if (pack) {
+            const uint32_t field = ((uint32_t) pLlr[i] & mask) << (bit % 8);
+            pPacked[bit / 8] |= (uint8_t) field;
+            if ((bit % 8) + format > 8)
+                pPacked[bit / 8 + 1] |= (uint8_t) (field >> 8);
+        } else {
+            uint32_t field = pPacked[bit / 8] >> (bit % 8);
+            if ((bit % 8) + format > 8)
+                field |= (uint32_t) pPacked[bit / 8 + 1] << (8 - (bit % 8));
+            field &= mask;
+            /* sign extension */
+            pLlr[i] = (int8_t) ((int32_t) (field ^ (1 << (format - 1))) - (1 << (format - 1)));
+        }
+    }
+}
+
+int32_t bblib_rate_dematching_5gnr_harq_pack_c(const int8_t *p_in, int8_t *p_harq, int32_t ncb,
+    enum bblib_harq_format format)
+{
+    if (format != BBLIB_HARQ_4BIT && format != BBLIB_HARQ_6BIT) {
+        printf("bblib_rate_dematching_5gnr_harq_pack_c: unsupported format %d\n", format);
+        return -1;
+    }
+    const int32_t qMax = (1 << (format - 1)) - 1;
+    const int32_t blockBytes = format * BBLIB_HARQ_BLOCK_SIZE / 8;
+    const int32_t nBlock = (ncb + BBLIB_HARQ_BLOCK_SIZE - 1) / BBLIB_HARQ_BLOCK_SIZE;
+    uint8_t *pScale = (uint8_t *) p_harq + nBlock * blockBytes;
+
+    for (int32_t block = 0; block < nBlock; block++) {
+        int8_t llr[BBLIB_HARQ_BLOCK_SIZE] = {0};
+        const int32_t n = MIN(BBLIB_HARQ_BLOCK_SIZE, ncb - block * BBLIB_HARQ_BLOCK_SIZE);
+        int32_t maxAbs = 0, i;
+        for (i = 0; i < n; i++)
+            maxAbs = MAX(maxAbs, abs(p_in[block * BBLIB_HARQ_BLOCK_SIZE + i]));
+        const int32_t scale = harq_block_scale(maxAbs, format);
+        for (i = 0; i < n; i++) {
+            const int32_t q = (p_in[block * BBLIB_HARQ_BLOCK_SIZE + i] + ((1 << scale) >> 1)) >> scale;
+            llr[i] = (int8_t) MIN(qMax, MAX(q, -qMax));
+        }
+        memset(p_harq + block * blockBytes, 0, blockBytes);
+        harq_block_bits((uint8_t *) p_harq + block * blockBytes, llr, format, 1);
+        pScale[block] = (uint8_t) scale;
+    }
+    return 0;
+}
+
+int32_t bblib_rate_dematching_5gnr_harq_unpack_c(const int8_t *p_harq, int8_t *p_out, int32_t ncb,
+    enum bblib_harq_format format)
+{
+    if (format != BBLIB_HARQ_4BIT && format != BBLIB_HARQ_6BIT) {
+        printf("bblib_rate_dematching_5gnr_harq_unpack_c: unsupported format %d\n", format);
+        return -1;
+    }
+    const int32_t blockBytes = format * BBLIB_HARQ_BLOCK_SIZE / 8;
+    const int32_t nBlock = (ncb + BBLIB_HARQ_BLOCK_SIZE - 1) / BBLIB_HARQ_BLOCK_SIZE;
+    const uint8_t *pScale = (const uint8_t *) p_harq + nBlock * blockBytes;
+
+    for (int32_t block = 0; block < nBlock; block++) {
+        int8_t llr[BBLIB_HARQ_BLOCK_SIZE];
+        const int32_t n = MIN(BBLIB_HARQ_BLOCK_SIZE, ncb - block * BBLIB_HARQ_BLOCK_SIZE);
+        harq_block_bits((uint8_t *) p_harq + block * blockBytes, llr, format, 0);
+        for (int32_t i = 0; i < n; i++)
+            p_out[block * BBLIB_HARQ_BLOCK_SIZE + i] = (int8_t) (llr[i] * (1 << pScale[block]));
+    }
+    return 0;
+}
+
+/**
+ * @brief Implements the combining of several transmissions of a code block in C
+ * @param [in] request Structure containing the configuration, input data
+ * @param [out] response Structure containing the output data.
+**/
+int32_t bblib_rate_dematching_5gnr_multi_c(struct bblib_rate_dematching_5gnr_multi_request *request,
+    struct bblib_rate_dematching_5gnr_response *response)
+{
+    __align(64) int8_t harqBuffer[MAX_NCB];
+    struct bblib_rate_dematching_5gnr_request req;
+    int8_t *pHarq = rate_dematching_multi_buffer(request, harqBuffer, "bblib_rate_dematching_5gnr_multi_c");
+
+    if (pHarq == NULL)
+        return -1;
+    /* a compressed buffer is unpacked and packed once for all transmissions */
+    if (pHarq != request->p_harq && request->isretx && bblib_rate_dematching_5gnr_harq_unpack_c(request->p_harq, pHarq, request->ncb, request->harq_format))
+        return -1;
+    for (int32_t tx = 0; tx < request->num_tx; tx++) {
+        rate_dematching_tx_request(request, tx, pHarq, &req);
+        bblib_rate_dematching_5gnr_c(&req, response);
+    }
+    if (pHarq != request->p_harq)
+        return bblib_rate_dematching_5gnr_harq_pack_c(pHarq, request->p_harq, request->ncb, request->harq_format);
+    return 0;
 }
@@ -29,6 +29,9 @@
 
 #include "phy_rate_dematching_5gnr_internal.h"
 
+#include <stdio.h>
+#include <string.h>
+
 
 /**
  * @brief This function implements k0 calculation
@@ -67,3 +70,76 @@ void get_k0(struct bblib_rate_dematching_5gnr_request *pRM)
     }
     pRM->k0 = k0;
 }
+
+/**
+ * @brief This function implements the scale of a block of compressed HARQ LLRs
+ * @param[in] maxAbs largest absolute LLR of the block
+ * @param[in] format storage format of the HARQ buffer
+ *
+ */
+int32_t harq_block_scale(int32_t maxAbs, enum bblib_harq_format format)
+{
+    const int32_t qRange = 1 << (format - 1);
+    const int32_t maxScale = (format == BBLIB_HARQ_4BIT) ? 4 : 2;
+    int32_t scale = 0;
+
+    /* the largest LLR 127 fits once shifted by maxScale, larger values saturate */
+    while (scale < maxScale && maxAbs > (qRange << scale) - 1)
+        scale++;
+    return scale;
+}
+
+/**
+ * @brief This function builds the single transmission request of a multi transmission request
+ * @param[in] pMulti multi transmission request
+ * @param[in] tx index of the transmission
+ * @param[in] pHarq int8 HARQ buffer to combine into
+ * @param[out] pReq single transmission request
+ *
+ */
+void rate_dematching_tx_request(const struct bblib_rate_dematching_5gnr_multi_request *pMulti, int32_t tx,
+    int8_t *pHarq, struct bblib_rate_dematching_5gnr_request *pReq)
+{
+    memset(pReq, 0, sizeof(*pReq));
+    pReq->p_in = pMulti->tx[tx].p_in;
+    pReq->p_harq = pHarq;
+    pReq->ncb = pMulti->ncb;
+    pReq->start_null_index = pMulti->start_null_index;
+    pReq->num_of_null = pMulti->num_of_null;
+    pReq->e = pMulti->tx[tx].e;
+    pReq->rvid = pMulti->tx[tx].rvid;
+    pReq->zc = pMulti->zc;
+    pReq->modulation_order = pMulti->modulation_order;
+    pReq->base_graph = pMulti->base_graph;
+    /* only the first transmission may clear the buffer */
+    pReq->isretx = (tx > 0) ? 1 : pMulti->isretx;
+    pReq->harq_format = BBLIB_HARQ_INT8;
+    pReq->flags = pMulti->flags;
+    pReq->c_init = pMulti->c_init;
+    pReq->scrambling_offset = pMulti->tx[tx].scrambling_offset;
+    pReq->p_scrambling = pMulti->tx[tx].p_scrambling;
+}
+
+/**
+ * @brief This function checks a multi transmission request and selects the buffer the transmissions are combined into
+ * @param[in] pMulti multi transmission request
+ * @param[in] pHarqBuffer buffer of MAX_NCB bytes for the unpacked copy of a compressed HARQ buffer
+ * @param[in] pName name of the calling function for the error messages
+ * @return p_harq for the int8 format, pHarqBuffer for a compressed format, NULL when the request is invalid
+ *
+ */
+int8_t *rate_dematching_multi_buffer(const struct bblib_rate_dematching_5gnr_multi_request *pMulti,
+    int8_t *pHarqBuffer, const char *pName)
+{
+    if (pMulti->num_tx < 1 || pMulti->num_tx > BBLIB_RATE_DEMATCHING_MAX_TX) {
+        printf("%s: num_tx %d out of range 1..%d\n", pName, pMulti->num_tx, BBLIB_RATE_DEMATCHING_MAX_TX);
+        return NULL;
+    }
+    if (pMulti->harq_format == BBLIB_HARQ_INT8)
+        return pMulti->p_harq;
+    if (pMulti->ncb > MAX_NCB) {
+        printf("%s: ncb %d exceeds %d with a compressed HARQ buffer\n", pName, pMulti->ncb, MAX_NCB);
+        return NULL;
+    }
+    return pHarqBuffer;
+}
@@ -29,6 +29,7 @@
 #ifndef _PHY_RATE_DEMATCHING_5GNR_INTERNAL_H_
 #define _PHY_RATE_DEMATCHING_5GNR_INTERNAL_H_
 
+#include <string.h>
 #include <immintrin.h> // AVX
 
 #include "phy_rate_dematching_5gnr.h"
@@ -38,12 +39,45 @@
 #define MIN(a,b) (((a) < (b)) ? (a) : (b))
 #define MAX(a,b) (((a) > (b)) ? (a) : (b))
 
+#if defined(_BBLIB_AVX2_) || defined(_BBLIB_AVX512_)
+/*! \brief num (1..64) bits of the bitmap pBits from bit pos, LSB first. */
+static inline uint64_t rdm_bitmap_read(const uint8_t *pBits, int32_t pos, int32_t num)
+{
+    const uint8_t *p = pBits + (pos >> 3);
+    const int32_t shift = pos & 7;
+    const int32_t nByte = (shift + num + 7) >> 3;
+    uint64_t v = 0;
+
+    if (shift == 0 && num == 64)
+        return *(const uint64_t *) p;
+    memcpy(&v, p, MIN(nByte, 8));
+    v >>= shift;
+    if (nByte > 8)
+        v |= (uint64_t) p[8] << (64 - shift);
+    return _bzhi_u64(v, num);
+}
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Largest Ncb, 66 * 384, for the unpacked copy of a compressed HARQ buffer */
+#define MAX_NCB (25344)
+
 void get_k0(struct bblib_rate_dematching_5gnr_request *pRM);
 
+/* Scale of a block of compressed LLRs, the smallest right shift bringing maxAbs within the format range */
+int32_t harq_block_scale(int32_t maxAbs, enum bblib_harq_format format);
+
+/* Single transmission request for transmission tx of a multi request, combined into an int8 HARQ buffer */
+void rate_dematching_tx_request(const struct bblib_rate_dematching_5gnr_multi_request *pMulti, int32_t tx,
+    int8_t *pHarq, struct bblib_rate_dematching_5gnr_request *pReq);
+
+/* Checks a multi request and returns the int8 buffer to combine into, pHarqBuffer for a compressed format */
+int8_t *rate_dematching_multi_buffer(const struct bblib_rate_dematching_5gnr_multi_request *pMulti,
+    int8_t *pHarqBuffer, const char *pName);
+
 #ifdef __cplusplus
 }
 #endif
@@ -35,6 +35,7 @@
 #include "phy_rate_match.h"
 #include "phy_rate_match_internal.h"
 #include "sdk_version.h"
+#include "bblib_isa.h"
 
 typedef int32_t (*rate_match_dl_func)(const struct bblib_rate_match_dl_request *request,
     struct bblib_rate_match_dl_response *response);
@@ -86,10 +87,10 @@ static rate_match_dl_func bblib_rate_match_dl_select_on_isa() {
 /** Return a pointer-to-function for a specific implementation */
 static rate_match_ul_func bblib_rate_match_ul_select_on_isa() {
 #ifdef _BBLIB_AVX512_
-    return bblib_rate_match_ul_avx512;
-#else
-    return bblib_rate_match_ul_avx2;
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+        return bblib_rate_match_ul_avx512;
 #endif
+    return bblib_rate_match_ul_avx2;
 }
 
 /** Return a pointer-to-function for a specific implementation */
@@ -105,19 +106,19 @@ static harq_combine_ul_func bblib_harq_combine_ul_select_on_isa() {
 /** Return a pointer-to-function for a specific implementation */
 static deinterleave_ul_func bblib_deinterleave_ul_select_on_isa() {
 #ifdef _BBLIB_AVX512_
-    return bblib_deinterleave_ul_avx512;
-#else
-    return bblib_deinterleave_ul_avx2;
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+        return bblib_deinterleave_ul_avx512;
 #endif
+    return bblib_deinterleave_ul_avx2;
 }
 
 /** Return a pointer-to-function for a specific implementation */
 static turbo_adapter_ul_func bblib_turbo_adapter_ul_select_on_isa() {
 #ifdef _BBLIB_AVX512_
-    return bblib_turbo_adapter_ul_avx512;
-#else
-    return bblib_turbo_adapter_ul_avx2;
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+        return bblib_turbo_adapter_ul_avx512;
 #endif
+    return bblib_turbo_adapter_ul_avx2;
 }
 
 static rate_match_dl_func default_dl_func = bblib_rate_match_dl_select_on_isa();
@@ -73,6 +73,28 @@ struct bblib_rate_match_dl_response {
                              matching before this code block. */
 };
 
+/**
+    \struct bblib_turbo_rate_match_dl_request
+    \brief Structure for input parameters of the fused turbo encoding and rate matching for LTE DL.
+    \note The code block is turbo encoded and rate matched in one call, without the three turbo
+          encoder output streams of bblib_turbo_encoder and bblib_rate_match_dl.
+*/
+struct bblib_turbo_rate_match_dl_request {
+    int32_t r; /*!< index of current code block in all code blocks. */
+    int32_t C; /*!< Total number of code blocks. */
+    int32_t Nsoft; /*!< Total number of soft bits according to UE categories. */
+    int32_t KMIMO; /*!< 2, which is related to MIMO type. */
+    int32_t MDL_HARQ; /*!< Maximum number of DL HARQ. */
+    int32_t G; /*!< length of bits before modulation for 1 UE in 1 subframe. */
+    int32_t NL; /*!< Number of layer. */
+    int32_t Qm; /*!< Modulation type, which can be 2/4/6. */
+    int32_t rvidx; /*!< Redundancy version, which can be 0/1/2/3. */
+    int8_t bypass_rvidx; /*!< If set rvidx is ignored and k0 set to 0 */
+    int32_t Kidx; /*!< Position in turbo code internal interleave table,
+                       Kidx=i-1 in TS 136.212 table 5.1.3-3. */
+    uint8_t *input; /*!< Information and CRC bits of the code block, K/8 bytes. */
+};
+
 /*!
     \struct bblib_rate_match_ul_request
     \brief Structure for parameters in API of HARQ, deinterleaver (rate dematching) for LTE.
@@ -189,6 +211,19 @@ int32_t bblib_rate_match_dl_avx2(const struct bblib_rate_match_dl_request *reque
     struct bblib_rate_match_dl_response *response);
 //! @}
 
+/*! \brief Turbo encoding and downlink rate matching of one code block for LTE.
+    Writes the e bits of the code block straight to the output, MSB first, from the K bits of the
+    input, the same as bblib_turbo_encoder followed by bblib_rate_match_dl with direction 1.
+    \param [in] request Structure containing configuration information and input data.
+    \param [out] response Structure containing kernel outputs.
+    \note Runs the turbo encoder of lib_turbo, which librate_matching links and its pkg-config file
+          requires.
+    \return Success: return 0, else: return -1.
+*/
+int32_t
+bblib_turbo_rate_match_dl(const struct bblib_turbo_rate_match_dl_request *request,
+    struct bblib_rate_match_dl_response *response);
+
 //! @{
 /*! \brief Uplink rate matching for LTE.
 
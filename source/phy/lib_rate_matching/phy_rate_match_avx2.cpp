@@ -2885,26 +2885,14 @@ bit_selection_complete_avx2(int32_t E, int32_t k0, int32_t Ncb,int32_t Kidx, int
 {
     /* Kidx is the type of codeblock length in 188 selection */
     int32_t k0_m;
-    int32_t Num_NULL = totalNullBits;//g_nNum_NULL[Kidx];
-    int32_t ni, nj;
     k0_m = k0 % Ncb;
-    for (ni = 0; ni < Num_NULL; ni++)
-    {
-        if (g_nIndex_NULL[Kidx][ni] > k0_m)
-            break;
-    }
+    int32_t ni = rate_match_null_bits(Kidx, k0_m);
     int32_t k0_n = k0_m - ni;
 
     if(Ncb != Kw)
     {
-        /* nj stands for the NULL number between 1 ~ Ncb  */
-        for (nj=Num_NULL-1; nj>0; nj--)
-        {
-            if (g_nIndex_NULL[Kidx][nj] < Ncb)
-                break;
-        }
-        /* update real total number of null bits */
-        totalNullBits = nj + 1;
+        /* update real total number of null bits, those before bit Ncb - 1 */
+        totalNullBits = rate_match_null_bits(Kidx, Ncb - 1);
     }
 
     int32_t Ncb_n = Ncb - totalNullBits;
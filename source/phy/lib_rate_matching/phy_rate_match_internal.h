@@ -31,6 +31,7 @@
 #define _PHY_RATE_MATCH_INTERNAL_H_
 
 #include <cstdint>
+#include <nmmintrin.h> /* SSE 4.2, popcnt */
 
 #include "divide.h"
 
@@ -54,16 +55,66 @@
 #define MAX_CODE_BLOCK_IN_ONE_TB (25)
 
 
-extern int32_t g_nNum_NULL[188];
-extern int32_t g_nIndex_NULL[188][84];
-/* rate matching table */
-extern int32_t g_ratetable[188][18444];
+/**
+ * @brief Code block size K of position Kidx in TS 136.212 table 5.1.3-3
+ * @param[in] Kidx Position in turbo code internal interleave table
+ * @return K
+ */
+static inline int32_t rate_match_kidx_to_k(int32_t Kidx)
+{
+    if (Kidx < 59)
+        return 40 + 8 * Kidx;
+    if (Kidx < 91)
+        return 512 + 16 * (Kidx - 59);
+    if (Kidx < 123)
+        return 1024 + 32 * (Kidx - 91);
+    return 2048 + 64 * (Kidx - 123);
+}
+
+/* TS 136.212 table 5.1.4-1, inter-column permutation pattern for sub-block interleaver */
+extern const int32_t g_SubblockColumnPerm[32];
+
+/* For each number of NULL bits ND, bit c set when column c of the sub-block interleaver output starts with a NULL
+   bit, g_SubblockColumnPerm[c] < ND */
+extern uint32_t g_SubblockNullColumns[32];
+
+/* the columns before column m of the sub-block interleaver output, as a mask */
+static inline uint32_t rate_match_columns_before(int32_t m)
+{
+    if (m <= 0)
+        return 0;
+    return (m >= 32) ? 0xFFFFFFFF : ((1u << m) - 1);
+}
+
+/**
+ * @brief Number of NULL bits in the first n bits of the circular buffer of TS 136.212 section 5.1.4.1.2
+ *        for code block size index Kidx. The ND NULL bits lead y(0), y(1) and y(2), so they are row 0 of the
+ *        columns permuted from j < ND, and for v(2), permuted from j + 1 < ND, plus its last bit y(2) 0.
+ * @param[in] Kidx Position in turbo code internal interleave table
+ * @param[in] n Number of bits from the start of the circular buffer, 0..3 * Kpi
+ * @return number of NULL bits
+ */
+static inline int32_t rate_match_null_bits(int32_t Kidx, int32_t n)
+{
+    const int32_t D = rate_match_kidx_to_k(Kidx) + 4;
+    const int32_t nRow = (D + 31) / 32;
+    const int32_t Kpi = 32 * nRow;
+    const int32_t ND = Kpi - D;
+    const uint32_t null0 = g_SubblockNullColumns[ND];
+    const uint32_t null2 = (ND > 0) ? g_SubblockNullColumns[ND - 1] : 0;
+
+    /* v(0) column c starts at bit c * nRow, the v(1) and v(2) bits of column c at Kpi + 2 * c * nRow */
+    int32_t nNull = _mm_popcnt_u32(null0 & rate_match_columns_before((n + nRow - 1) / nRow));
+    nNull += _mm_popcnt_u32(null0 & rate_match_columns_before((n - Kpi + 2 * nRow - 1) / (2 * nRow)));
+    nNull += _mm_popcnt_u32(null2 & rate_match_columns_before((n - Kpi - 1 + 2 * nRow - 1) / (2 * nRow)));
+    return nNull + ((ND > 0) && (3 * Kpi - 1 < n));
+}
 
 /* Rate matching bit to byte table */
 __align(64) extern uint8_t g_BitToByteTABLE[8192];
 
 /**
- * @brief Initialize LTE rate matching with SSE instructions, read some files into global tables.
+ * @brief Initialize LTE rate matching with SSE instructions, build the global tables.
  * @return 0: init success, -1: init error.
  */
 int32_t init_rate_matching_lte_sse();
@@ -37,14 +37,12 @@
 #include "phy_rate_match.h"
 #include "phy_rate_match_internal.h"
 #if defined(_BBLIB_SSE4_2_) || defined(_BBLIB_AVX2_) || defined(_BBLIB_AVX512_)
-int32_t g_nNum_NULL[188];
-int32_t g_nIndex_NULL[188][84];
-/* rate matching table */
-int32_t g_ratetable[188][18444];
-
 /* Rate matching bit to byte table */
 __align(64) uint8_t g_BitToByteTABLE[8192];
 
+/* Sub-block interleaver columns starting with a NULL bit, for each number of NULL bits */
+uint32_t g_SubblockNullColumns[32];
+
 
 struct bblib_rate_match_init_sse
 {
@@ -103,146 +101,39 @@ void MakeBitToByteTable(uint8_t* pTable)
     }
 }
 
+/* TS 136.212 table 5.1.4-1, inter-column permutation pattern for sub-block interleaver */
+const int32_t g_SubblockColumnPerm[32] = {
+    0, 16, 8, 24, 4, 20, 12, 28, 2, 18, 10, 26, 6, 22, 14, 30,
+    1, 17, 9, 25, 5, 21, 13, 29, 3, 19, 11, 27, 7, 23, 15, 31};
+
 /**
- * @brief Initialize LTE rate matching with SSE instructions, read some files into global tables.
- * @return 0: init success, -1: init error.
+ * @brief Sub-block interleaver NULL columns table generation
+ * @param[out] pTable for each number of NULL bits ND, bit c set when g_SubblockColumnPerm[c] < ND
+ * @return void
  */
-int32_t init_rate_matching_lte_sse()
+static void MakeSubblockNullColumns(uint32_t *pTable)
 {
-    /* Buffer for whole file name, including root folder of SDK */
-    char file_name[1024] = {0};
-    /* File name, under SDK folder */
-    char file_nNum_NULL[100] = "/source/phy/lib_rate_matching/phy_rate_match_nnum_null.bin";
-    char file_nIndex_NULL[100] = "/source/phy/lib_rate_matching/phy_rate_match_nindex_null.bin";
-    char file_ratetable[100] = "/source/phy/lib_rate_matching/phy_rate_match_ratetable.bin";
-    char *pCheckPath1 = NULL, *pCheckPath2 = NULL, *pCheckPath3 = NULL;
-
-    uint8_t *pBitToByte = &g_BitToByteTABLE[0];
-    FILE* stream;
-    uint32_t len_read, path_len, str_offset;
-
-    /* Get SDK root folder from environment variable */
-    char* dir_sdk = getenv( "DIR_WIRELESS_SDK" );
-    if( dir_sdk == NULL )
-    {
-        printf("Need to setup environment variable 'DIR_WIRELESS_SDK' for rate matching, pls set it up to folder where SDK is stored, with 'export DIR_WIRELESS_SDK=......'\n");
-        exit(-1);
-    }
-
-    path_len = strlen(dir_sdk);
-
-    //check to see if string has necessary characters
-#ifdef WIN32
-    pCheckPath1 = strstr(dir_sdk, "sdk");
-
-    if ((pCheckPath1 == NULL) && (pCheckPath2 == NULL))
-    {
-        printf("%s is not valid!!!  DIR_WIRELESS_SDK must include\n", dir_sdk);
-        printf("sdk somewhere in path\n");
-        exit(1);
-    }
-#else
-    pCheckPath1 = strstr(dir_sdk, "sdk/build-avx");
-    pCheckPath2 = strstr(dir_sdk, "sdk/build-snc");
-    pCheckPath3 = strstr(dir_sdk, "sdk/build-spr");
-
-    if ((pCheckPath1 == NULL) && (pCheckPath2 == NULL) && (pCheckPath3 == NULL))
-    {
-        printf("%s is not valid!!!  DIR_WIRELESS_SDK must include\n", dir_sdk);
-        printf("sdk/build-avx or sdk/build-snc or sdk/build-spr somewhere in path\n");
-        exit(-1);
-    }
-#endif
-
-    //check to see if string has characters trying to access
-    //files in other directories
-#ifdef WIN32
-    pCheckPath1 = strstr(dir_sdk, "../");
-#else
-    pCheckPath1 = strstr(dir_sdk, "..\\");
-#endif
-    if (pCheckPath1 != NULL)
-    {
-        printf("Trying to access illegal path, %s\n", dir_sdk);
-        printf("cannot have ../ in path!\n");
-        exit(-1);
-    }
-
-    //check to see if string has NULL characters in the middle of the
-    //string trying to widen access to other files in current directory
-    //NULL character should only be at the end of the string
-    pCheckPath1 = strchr(dir_sdk, 0);
-    str_offset = (uint64_t)(pCheckPath1) - (uint64_t)(dir_sdk);
-    //if NULL not at end, return fail
-    if (str_offset - path_len)
-    {
-        printf("NULL character found in path, %s\n", dir_sdk);
-        printf("cannot have NULL characters in the middle!\n");
-        exit(-1);
-    }
-
-    /* Read from file "nnum_null.bin", into global buffer g_nNum_NULL[188] */
-    if (path_len > (sizeof(file_name) - sizeof(file_nNum_NULL) - 32))
-    {
-        printf("DIR_WIRELESS_SDK path is too long!!   %s\n", dir_sdk);
-        exit(-1);
-    }
-
-    memset(file_name, 0, sizeof(file_name));
-    strncpy( file_name, dir_sdk, (sizeof(file_name) - 32));
-    file_name[path_len] = '\0';
-    strncat( file_name, file_nNum_NULL, (sizeof(file_nNum_NULL) + 1));
-
-    if((stream=fopen(file_name,"rb"))!=NULL)
-    {
-        len_read = fread( g_nNum_NULL, sizeof(int32_t), sizeof(g_nNum_NULL)/4, stream );
-        fclose(stream);
-    }
-    else
-    {
-        len_read = 0;
-        printf( "File %s could not be opened in rate matching, size  %d\n", file_name, len_read);
-        exit(-1);
-    }
-
-    /* Read from file "nindex_null.bin", into global buffer g_nIndex_NULL[188][84] */
-    memset(file_name, 0, sizeof(file_name));
-    strncpy( file_name, dir_sdk, (sizeof(file_name) - 32));
-    file_name[path_len] = '\0';
-    strncat( file_name, file_nIndex_NULL, (sizeof(file_nIndex_NULL) + 1));
-
-    if((stream=fopen( file_name,"rb"))!=NULL)
-    {
-        len_read = fread( g_nIndex_NULL, sizeof(int32_t), sizeof(g_nIndex_NULL)/4, stream );
-        fclose(stream);
-    }
-    else
+    for(int32_t ND = 0; ND < 32; ND++)
     {
-        len_read = 0;
-        printf("File %s could not be opened in rate matching, size %d\n", file_name, len_read);
-        exit(-1);
+        pTable[ND] = 0;
+        for(int32_t c = 0; c < 32; c++)
+        {
+            if (g_SubblockColumnPerm[c] < ND)
+                pTable[ND] |= 1u << c;
+        }
     }
+}
 
-    /* Read from file "ratetable.bin", into global buffer g_ratetable[188][18444] */
-    memset(file_name, 0, sizeof(file_name));
-    strncpy( file_name, dir_sdk, (sizeof(file_name) - 32));
-    file_name[path_len] = '\0';
-    strncat( file_name, file_ratetable, (sizeof(file_ratetable) + 1));
-
-    if((stream=fopen( file_name,"rb"))!=NULL)
-    {
-        len_read = fread( g_ratetable, sizeof(int32_t), sizeof(g_ratetable)/4, stream );
-        fclose(stream);
-    }
-    else
-    {
-        len_read = 0;
-        printf("File %s could not be opened in rate matching, size  %d\n", file_name, len_read);
-        exit(-1);
-    }
+/**
+ * @brief Initialize LTE rate matching with SSE instructions, build the global tables.
+ * @return 0: init success, -1: init error.
+ */
+int32_t init_rate_matching_lte_sse()
+{
+    MakeSubblockNullColumns(g_SubblockNullColumns);
 
     /* init bit to byte conversion table */
-    MakeBitToByteTable( pBitToByte );
+    MakeBitToByteTable(&g_BitToByteTABLE[0]);
 
     return 0;
 }
@@ -387,259 +387,81 @@ subblock_interleaver_d02(int32_t nLen, uint8_t * pInput, uint8_t * pOutput)
 }
 
 
+/* reverse the bits of each of the 8 bytes, the circular buffer is LSB first and the output MSB first */
+static inline uint64_t
+reverse_byte_bits(uint64_t bits)
+{
+    const __m128i vRev = _mm_setr_epi8(0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF);
+    const __m128i vLowNibble = _mm_set1_epi8(0x0F);
+    __m128i v = _mm_cvtsi64_si128(bits);
+    __m128i vLow = _mm_shuffle_epi8(vRev, _mm_and_si128(v, vLowNibble));
+    __m128i vHigh = _mm_shuffle_epi8(vRev, _mm_and_si128(_mm_srli_epi16(v, 4), vLowNibble));
+    return _mm_cvtsi128_si64(_mm_or_si128(_mm_slli_epi16(vLow, 4), vHigh));
+}
+
+/* E bits of the circular buffer without NULL bits from k0 on, wrapping around at Ncb. Each output
+   word is filled from one 64 bit read at any bit while the buffer and E have room for it, else by
+   loads of at most 57 bits up to the end of the buffer or of E, so the wrap arounds need no
+   realignment. The bits past E in the last byte are 0. */
 int32_t
 bit_selection_complete(int32_t E, int32_t k0, int32_t Ncb,int32_t Kidx, int32_t nLen, uint8_t *pout, uint8_t *psout )
 {
-    __m128i v1, v12_mix, vtmp,v12_perm, vtmp1;
-    __m128i vconst0, vconst2, vconstF, vbitmask;
-    vconst0 = _mm_setzero_si128 ();
-    vconst2 = _mm_set1_epi8 (2);
-    vconstF = _mm_set1_epi8 (0xFF);
-    vbitmask = _mm_set_epi8 (0x1, 0x2, 0x4, 0x8, 0x10,  0x20, 0x40, 0x80, 0x1, 0x2, 0x4, 0x8, 0x10,  0x20, 0x40, 0x80);
-    __m128i vshuf0, vshuf1, vshuf2, vshuf3;
-    vshuf0 = _mm_set_epi8 (1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0);
-    vshuf1 = _mm_add_epi8 (vshuf0, vconst2);
-    vshuf2 = _mm_add_epi8 (vshuf1, vconst2);
-    vshuf3 = _mm_add_epi8 (vshuf2, vconst2);
-    __m128i vconstE = _mm_set_epi8 ( 0x0,0x0,0x0,0x0, 0x0,0x0,0x0,0x0, 0x0,0x0,0x0,0x0, 0x0,0x0,0x0,0xFF);
-    __m128i vconstY = _mm_set_epi8 ( 0x0,0x0,0x0,0x0, 0x0,0x0,0x0,0x0,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF);
-    int32_t i, tmp, j;
     /* Kidx is the type of codeblock length in 188 selection */
-    int32_t k0_m;
-    int32_t Num_NULL = g_nNum_NULL[Kidx];
-    int32_t ni, nj;
-    k0_m = k0 % Ncb;
-    for (ni = 0; ni < Num_NULL; ni++)
-    {
-        if (g_nIndex_NULL[Kidx][ni] > k0_m)
-            break;
-    }
-    int32_t k0_n = k0_m - ni;
-
-    /* ni stands for the NULL number between 1 ~ k0  */
-    for (nj = 0; nj< Num_NULL; nj ++)
-    {
-        if (g_nIndex_NULL[Kidx][nj] > Ncb)
-            break;
-    }
-    int32_t Ncb_n = Ncb - nj;
-    /* nj stands for the NULL number between 1 ~ Ncb  */
-
-    /* t_beg means the primary position for the first bit; */
-    int32_t t_beg = k0_n;
-
-    /* ========== bit selection ============ */
-    int32_t nBit= 0;
-
-     int32_t nByte1 = 0;
-    int32_t nBit1 = 0;
-    nByte1 = t_beg / 8;
-    /* nBits means: there are nBit1 bits needs to be thrown in the first byte */
-    nBit1 = t_beg % 8;
-
-    int32_t nByte2 = 0;
-    int32_t nBit2 = 0;
-    nByte2 = Ncb_n / 8;
-
-    /* nBit2 is for the 2st concatenation */
-    /* nBit2 means the number of bits needs to be kept for the last byte */
-    nBit2 = Ncb_n % 64;
+    int32_t k0_m = k0 % Ncb;
+    /* k0 and Ncb without the NULL bits before them */
+    int32_t k0_n = k0_m - rate_match_null_bits(Kidx, k0_m);
+    int32_t Ncb_n = Ncb - rate_match_null_bits(Kidx, Ncb);
 
+    int32_t nPos = k0_n;
     int32_t cnt = 0;
-    int32_t tLen = nByte2 - nByte1;
-
-    /* nBit3 is for the first concatenation */
-    /* nBit3 means: in the last SSE register, there are nBit3 bits needs to be kept */
-    int32_t nBit3 = 0;
-    nBit3 = Ncb_n % 8 + (tLen % 8) * 8;
-
-    __m128i vout, vin, vin1, vout1, vtmps;
-
-    /* The nBit points to the t_beg position */
-    nBit = nBit1;
-    uint8_t *s_out = pout + nByte1;
-    i = 0;
-    vtmp1 = _mm_setzero_si128 ();
-
-    /* processing the first byte */
-    vtmps = _mm_loadu_si128((__m128i*)(s_out + i));
-    /* == leaves nBit empty bits in the high half, throw the low nBit data== */
-
-    vout = _mm_srli_epi64(vtmps, nBit);
+    int32_t nAcc = 0;
+    int32_t n;
+    uint64_t acc = 0;
+    uint64_t bits;
 
-    for(i = 8; i <= tLen; i += 8)
+    while (cnt < E)
     {
-        vtmps = _mm_loadu_si128((__m128i*)(s_out + i));
-        /* ==== prepare the low nBit in the current 128 bit, put it at high position === */
-        vout1 = _mm_slli_epi64(vtmps, 64 - nBit);
-        vin1 = _mm_or_si128(vout1, vout);
-
-        /* =======  SSE register's low 64 bit are reversed internal byte ==== */
-        vtmp = vin1;
-        v1 = _mm_shuffle_epi8 (vtmp, vshuf0);
-        v12_perm = _mm_and_si128 (v1,vbitmask);
-        v12_mix = _mm_cmpeq_epi8 (v12_perm, vconst0);
-        v12_mix  = _mm_xor_si128 (v12_mix, vconstF);
-        tmp = _mm_movemask_epi8 (v12_mix);
-        vtmp1 = _mm_insert_epi16(vtmp1, tmp, 0);
-
-        v1 = _mm_shuffle_epi8 (vtmp, vshuf1);
-        v12_perm = _mm_and_si128 (v1,vbitmask);
-        v12_mix = _mm_cmpeq_epi8 (v12_perm, vconst0);
-        v12_mix  = _mm_xor_si128 (v12_mix, vconstF);
-        tmp = _mm_movemask_epi8 (v12_mix);
-        vtmp1 = _mm_insert_epi16(vtmp1, tmp, 1);
-
-        v1 = _mm_shuffle_epi8 (vtmp, vshuf2);
-        v12_perm = _mm_and_si128 (v1,vbitmask);
-        v12_mix = _mm_cmpeq_epi8 (v12_perm, vconst0);
-        v12_mix  = _mm_xor_si128 (v12_mix, vconstF);
-        tmp = _mm_movemask_epi8 (v12_mix);
-        vtmp1 = _mm_insert_epi16(vtmp1, tmp, 2);
-
-        v1 = _mm_shuffle_epi8 (vtmp, vshuf3);
-        v12_perm = _mm_and_si128 (v1,vbitmask);
-        v12_mix = _mm_cmpeq_epi8 (v12_perm, vconst0);
-        v12_mix  = _mm_xor_si128 (v12_mix, vconstF);
-        tmp = _mm_movemask_epi8 (v12_mix);
-        vtmp1 = _mm_insert_epi16(vtmp1, tmp, 3);
-
-        vin = vtmp1;
-
-        /* ====== store ======== */
-        _mm_storel_epi64((__m128i *)(psout + (cnt >> 3)), vin);
-        cnt += 64;
-        if(cnt >= E)
-            break;
-        /* ======= leaves nBit empty position at high position ==== */
-        vout = _mm_srli_epi64(vtmps, nBit);
-    }
-
-    if(cnt == E)
-        return 0;
+        if (nPos >= Ncb_n)
+            nPos = 0;
+        n = MIN(MIN(Ncb_n - nPos, 57), MIN(64 - nAcc, E - cnt));
 
-    /* The 1st concatenation */
-    if((cnt < E) && (i >= tLen))
-    {
-        /* vout and nBit needs to be adjusted */
-        if(nBit3 > nBit1)
-        {
-            nBit = 64 - (nBit3 - nBit);
-            vout1 = _mm_srli_epi64(vconstY, nBit);
-            vout = _mm_and_si128(vout, vout1);
-        }
-        else if(nBit3 < nBit1)
+        if ((64 - nAcc <= Ncb_n - nPos) && (64 - nAcc <= E - cnt))
         {
-            nBit = nBit - nBit3;
-            vout1 = _mm_srli_epi64(vconstY, nBit);
-            vout = _mm_and_si128(vin1, vout1);
-            cnt -= 64;
-            /* Notice that data is capured from vin */
-            /* since vin contains Null bits, cnt is reduced from 64 */
+            /* steady state, the rest of the output word comes from 64 bits read at any bit */
+            uint64_t hi;
+            n = 64 - nAcc;
+            memcpy(&bits, pout + (nPos >> 3), sizeof(bits));
+            memcpy(&hi, pout + (nPos >> 3) + 8, sizeof(hi));
+            if (nPos & 7)
+                bits = (bits >> (nPos & 7)) | (hi << (64 - (nPos & 7)));
         }
-        else  /* nBit - nBit3 ==0 */
-        {
-            nBit = 64;
-            vout = _mm_setzero_si128();
-        }
-    }
-
-    /* Bellow is the process of situation aht E reads to the end of Ncb; */
-    /* and stars from 0 position again; */
-    /* we use while to resolve the read/concatenation times and times again; */
-    /* we use cnt to control the times of reading; */
-    s_out = pout;
-    while((cnt < E))
-    {
-        for(j = 0; j < nByte2; j += 8)
+        else
         {
-            vtmps = _mm_loadu_si128((__m128i*)(s_out + j));
-
-            /* Prepare the low nBit in the current 128bit, put them at high position */
-            vout1 = _mm_slli_epi64(vtmps, 64 - nBit);
-            vin1 = _mm_or_si128(vout1, vout);
-
-            /* =======  SSE register's low 64 bit are reversed internal byte ==== */
-            vtmp = vin1;
-            v1 = _mm_shuffle_epi8 (vtmp, vshuf0);
-            v12_perm = _mm_and_si128 (v1,vbitmask);
-            v12_mix = _mm_cmpeq_epi8 (v12_perm, vconst0);
-            v12_mix  = _mm_xor_si128 (v12_mix, vconstF);
-            tmp = _mm_movemask_epi8 (v12_mix);
-            vtmp1 = _mm_insert_epi16(vtmp1, tmp, 0);
-
-            v1 = _mm_shuffle_epi8 (vtmp, vshuf1);
-            v12_perm = _mm_and_si128 (v1,vbitmask);
-            v12_mix = _mm_cmpeq_epi8 (v12_perm, vconst0);
-            v12_mix  = _mm_xor_si128 (v12_mix, vconstF);
-            tmp = _mm_movemask_epi8 (v12_mix);
-            vtmp1 = _mm_insert_epi16(vtmp1, tmp, 1);
-
-            v1 = _mm_shuffle_epi8 (vtmp, vshuf2);
-            v12_perm = _mm_and_si128 (v1,vbitmask);
-            v12_mix = _mm_cmpeq_epi8 (v12_perm, vconst0);
-            v12_mix  = _mm_xor_si128 (v12_mix, vconstF);
-            tmp = _mm_movemask_epi8 (v12_mix);
-            vtmp1 = _mm_insert_epi16(vtmp1, tmp, 2);
-
-            v1 = _mm_shuffle_epi8 (vtmp, vshuf3);
-            v12_perm = _mm_and_si128 (v1,vbitmask);
-            v12_mix = _mm_cmpeq_epi8 (v12_perm, vconst0);
-            v12_mix  = _mm_xor_si128 (v12_mix, vconstF);
-            tmp = _mm_movemask_epi8 (v12_mix);
-            vtmp1 = _mm_insert_epi16(vtmp1, tmp, 3);
-
-            vin = vtmp1;
-
-            /* =========== store======== */
-            _mm_storel_epi64((__m128i*)(psout + (cnt >> 3)), vin);
-            cnt += 64;
-            if(cnt >= E)
-                break;
-            /* ======= leaves nBit empty position at high positions ==== */
-            vout = _mm_srli_epi64(vtmps, nBit);
+            memcpy(&bits, pout + (nPos >> 3), sizeof(bits));
+            bits = (bits >> (nPos & 7)) & (((uint64_t)1 << n) - 1);
         }
+        acc |= bits << nAcc;
+        nAcc += n;
+        nPos += n;
+        cnt += n;
 
-        /* Notice that when enough bits is collected, we need to jump out of 2 iteration */
-        if(cnt >= E)
-            break;
-
-        /* The 2nd concatenation  */
-        /* after each iteration, nBit and vout needs to be adjusted!! */
-        if(nBit2 > nBit)
+        if (nAcc == 64)
         {
-            nBit = 64 - (nBit2 - nBit);
-            vout1 = _mm_srli_epi64(vconstY, nBit);
-            vout = _mm_and_si128(vout, vout1);
-        }
-        else
-        {
-            nBit = nBit - nBit2;
-            vout1 = _mm_srli_epi64(vconstY, nBit);
-            vout = _mm_and_si128(vin1, vout1);
-            cnt -= 64;
-            /* Notice that we capture data from vin */
-            /* There are NULL bits in vin, hence cnt needs to be reduced 64 */
+            bits = reverse_byte_bits(acc);
+            memcpy(psout, &bits, sizeof(bits));
+            psout += sizeof(bits);
+            acc = 0;
+            nAcc = 0;
         }
     }
-    if(cnt == E)
-        return 0;
 
-    /* === to adjust the last byte according to the length of output=== */
-    int32_t ntmp = E / 8;
-    int32_t ntmpb = E % 8;
-    psout[ntmp] = (psout[ntmp]) & (255 << (8-ntmpb));
-
-    /* Bellow we remove the un-useful bits, and set them to be 0 */
-    if(cnt > E)
+    if (nAcc > 0)
     {
-        vtmps = _mm_loadu_si128((__m128i*)(&psout[ntmp]));
-        vin = _mm_and_si128(vtmps, vconstE);
-        _mm_storeu_si128((__m128i*)(&psout[ntmp]), vin);
+        bits = reverse_byte_bits(acc);
+        memcpy(psout, &bits, (nAcc + 7) >> 3);
     }
 
     return 0;
-
 }
 
 void static bit_collection(int32_t Kidx, int32_t nLen, int32_t sLen, uint8_t * pv0, uint8_t * pv1, uint8_t * pv2, uint8_t * pOutput)
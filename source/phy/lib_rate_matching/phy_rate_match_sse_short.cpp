@@ -101,6 +101,67 @@ int32_t unpack_byte_to_bit(uint8_t* pInput, uint8_t* pOutput, int32_t Len, int8_
         return 1;
     }
 }
+/**
+ * @brief Sub-block interleaving of TS 136.212 5.1.4.1.1 and bit collection of 5.1.4.1.2, one byte per bit, for the
+ *        columns of the circular buffer without its NULL bits holding bits t_beg to t_end - 1. The addresses come
+ *        from the inter-column permutation: bit row of column j of y is j + 32 * row, the first ND bits of y being
+ *        NULL, so that they are all in row 0 except the last bit of v(2), y(2) 0.
+ * @param[in] d0 bytes of streams 0, 1 and 2, nLen each, one after the other
+ * @param[in] nLen Length of each stream in bits
+ * @param[in] t_beg first bit of the circular buffer needed
+ * @param[in] t_end bit after the last one
+ * @param[out] v circular buffer without NULL bits, 3 * nLen bytes
+ * @return void
+ */
+static void subblock_collect_bytes(const uint8_t *d0, int32_t nLen, int32_t t_beg, int32_t t_end, uint8_t *v)
+{
+    const int32_t nRow = (nLen + 31) / 32;
+    const int32_t ND = 32 * nRow - nLen;
+    const uint8_t *d1 = d0 + nLen;
+    const uint8_t *d2 = d0 + 2 * nLen;
+    int32_t i = 0;
+
+    /* v(0), skipping the whole columns before t_beg */
+    for (int32_t c = 0; (c < 32) && (i < t_end); c++)
+    {
+        const int32_t j = g_SubblockColumnPerm[c];
+        const int32_t row0 = (j < ND);
+        if (i + nRow - row0 <= t_beg)
+        {
+            i += nRow - row0;
+            continue;
+        }
+        for (int32_t row = row0; row < nRow; row++)
+            v[i++] = d0[j + 32 * row - ND];
+    }
+
+    /* v(1) and v(2) bit by bit, column j of v(2) being column j + 1 of y(2) */
+    for (int32_t c = 0; (c < 32) && (i < t_end); c++)
+    {
+        const int32_t j = g_SubblockColumnPerm[c];
+        const int32_t nBits = 2 * nRow - (j < ND) - (j + 1 < ND) - ((j == 31) && (ND > 0));
+        if (i + nBits <= t_beg)
+        {
+            i += nBits;
+            continue;
+        }
+        if (j >= ND)
+            v[i++] = d1[j - ND];
+        if (j + 1 >= ND)
+            v[i++] = d2[j + 1 - ND];
+        for (int32_t row = 1; row < nRow - 1; row++)
+        {
+            v[i++] = d1[j + 32 * row - ND];
+            v[i++] = d2[j + 32 * row + 1 - ND];
+        }
+        v[i++] = d1[j + 32 * (nRow - 1) - ND];
+        if (j < 31)
+            v[i++] = d2[j + 32 * (nRow - 1) + 1 - ND];
+        else if (ND == 0)
+            v[i++] = d2[0];
+    }
+}
+
 /**
  * @brief Rate matching with large code block length, when CaseIndex<92 in TS 136.212 table 5.1.3-3, with SSE instructions
  * @param[in] r index of current code block in all code blocks
@@ -133,8 +194,8 @@ int32_t rate_matching_turbo_lte_short_sse(int32_t r, int32_t C, int8_t direction
 {
     // Add check to fix klocwork SPECTRE.VARIANT1 warning
     KLOCWORK_SPECTRE_VARIANT1_ISSUE_AVOID_SIGNED(nLen);
-    int32_t k0, i;
-    uint8_t *v0, *tmp1;
+    int32_t k0;
+    uint8_t *v0;
     int32_t nCol = 32;
     int32_t nRow = nLen / 32 + 1;
     uint8_t dd[18444];
@@ -284,25 +345,15 @@ int32_t rate_matching_turbo_lte_short_sse(int32_t r, int32_t C, int8_t direction
 
     /* ============================================================== */
     /* Kidx is the type of codeblock length in 188 selection */
-    int32_t Num_NULL = g_nNum_NULL[Kidx];
-    int32_t ni, nj;
-    for(ni = 0; ni < Num_NULL; ni++)
-    {
-        if(g_nIndex_NULL[Kidx][ni] > k0)
-            break;
-    }
-    int32_t k0_n = k0 - ni;
     /* ni stands for the NULL number between 1 ~ k0  */
+    int32_t ni = rate_match_null_bits(Kidx, k0);
+    int32_t k0_n = k0 - ni;
 
-    for(nj = 0; nj < Num_NULL; nj++)
-    {
-        if(g_nIndex_NULL[Kidx][nj] > Ncb)
-            break;
-    }
-    int32_t Ncb_n = Ncb - nj;
     /* nj stands for the NULL number between 1 ~ Ncb  */
+    int32_t nj = rate_match_null_bits(Kidx, Ncb);
+    int32_t Ncb_n = Ncb - nj;
 
-    /* ====== Part 2, sub-block interleave using look up table;====== */
+    /* ====== Part 2, sub-block interleave from the column permutation;====== */
     /* here optimize to only calculate those bits that are used*/
 
     v0 = tbuffer;
@@ -323,11 +374,7 @@ int32_t rate_matching_turbo_lte_short_sse(int32_t r, int32_t C, int8_t direction
         t_end = Ncb_n;
     }
 
-    for(i = t_beg; i < t_end; i++)
-    {
-        tmp1 = d0 + g_ratetable[Kidx][i];
-        v0[i] = *tmp1;
-    }
+    subblock_collect_bytes(d0, nLen, t_beg, t_end, v0);
 
     /* ==========   Part 3: bit collection  ========= */
     /* copy the bits from 0~ Ncb_n, starting from k0_n;*/
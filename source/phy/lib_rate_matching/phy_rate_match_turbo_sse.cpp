@@ -0,0 +1,387 @@
+/**********************************************************************
+*
+*
+*  Copyright [2019 - 2023] [Intel Corporation]
+* 
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  
+*  You may obtain a copy of the License at
+*  
+*     http://www.apache.org/licenses/LICENSE-2.0 
+*  
+*  Unless required by applicable law or agreed to in writing, software 
+*  distributed under the License is distributed on an "AS IS" BASIS, 
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and 
+*  limitations under the License. 
+*  
+*  SPDX-License-Identifier: Apache-2.0 
+*  
+* 
+*
+**********************************************************************/
+
+/*
+ * @file
+ * @brief  Turbo encoding and LTE downlink rate matching of one code block in one pass, with SSE
+ *         instructions
+*/
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <immintrin.h>
+#include <smmintrin.h> /* SSE 4 for media */
+
+#include "bblib_common_const.h"
+#include "phy_rate_match.h"
+#include "phy_rate_match_internal.h"
+#include "phy_turbo.h"
+#if defined(_BBLIB_SSE4_2_) || defined(_BBLIB_AVX2_) || defined(_BBLIB_AVX512_)
+
+/* bytes of each turbo encoder output stream, K/8 bytes and the tail byte, with room for the
+   encoder stores and the sub-block interleaver matrix */
+#define TURBO_STREAM_BYTES (6144 / 8 + 64)
+/* rows of the sub-block interleaver matrix, (6144 + 4) / 32 + 1 rounded up to 16 */
+#define SUBBLOCK_MAX_ROWS (208)
+#define SUBBLOCK_MAX_BLOCKS (SUBBLOCK_MAX_ROWS / 16)
+/* zero bytes before the stream, for the first rows of y which start with the NULL bits */
+#define SUBBLOCK_LEAD (16)
+
+/* MSB first bit stream writer, the bits not yet in a whole byte at the top of acc. Each put stores
+   8 bytes, so the buffer needs 8 bytes past the last bit. */
+struct rm_bit_writer
+{
+    uint8_t *pOut;
+    uint64_t acc;
+    int32_t nBits;
+};
+
+/* append the n low bits of bits, 0 < n <= 32, the bits above them 0 */
+static inline void rm_bit_writer_put(struct rm_bit_writer *w, uint32_t bits, int32_t n)
+{
+    w->nBits += n;
+    w->acc |= (uint64_t)bits << (64 - w->nBits);
+    uint64_t word = (uint64_t)_bswap64((int64_t)w->acc);
+    memcpy(w->pOut, &word, 8);
+    w->pOut += w->nBits >> 3;
+    w->acc <<= w->nBits & ~7;
+    w->nBits &= 7;
+}
+
+/* 64 bits of an MSB first bit stream from bit pos, reads 9 bytes from byte pos / 8 */
+static inline uint64_t rm_bit_get64(const uint8_t *pIn, int32_t pos)
+{
+    int64_t v;
+    const uint8_t *p = pIn + (pos >> 3);
+    memcpy(&v, p, 8);
+    return ((uint64_t)_bswap64(v) << (pos & 7)) | ((uint64_t)p[8] >> (8 - (pos & 7)));
+}
+
+/* bytes i to i + 15 of the MSB first bit stream pIn shifted right by shift bits, 0..8, the bits
+   shifted in from byte i - 1 */
+static inline __m128i rm_bit_shifted_bytes(const uint8_t *pIn, int32_t i, __m128i shift)
+{
+    const __m128i low_byte = _mm_set1_epi16(0x00FF);
+    __m128i cur = _mm_loadu_si128((__m128i const *)(pIn + i));
+    __m128i prev = _mm_loadu_si128((__m128i const *)(pIn + i - 1));
+    __m128i lo = _mm_and_si128(_mm_srl_epi16(_mm_unpacklo_epi8(cur, prev), shift), low_byte);
+    __m128i hi = _mm_and_si128(_mm_srl_epi16(_mm_unpackhi_epi8(cur, prev), shift), low_byte);
+    return _mm_packus_epi16(lo, hi);
+}
+
+/**
+ * @brief Rows 16 * t to 16 * t + 15 of the sub-block interleaver matrix of TS 136.212 section
+ *        5.1.4.1.1 for one turbo encoder stream: y is the nNull NULL bits, 0 here, then the bits of
+ *        the stream, written row by row in 32 columns. The 4 byte rows are transposed to byte b of
+ *        the 16 rows in byte[b], row 16 * t in the last byte, so that bit 7 - k of the bytes is
+ *        column 8 * b + k.
+ * @param[in] pIn turbo encoder output stream, MSB first, after SUBBLOCK_LEAD zero bytes and followed
+ *            by zero bytes up to the 64 * nBlocks bytes of the matrix
+ * @param[in] nNull number of NULL bits before the stream, 0..31
+ * @param[in] t block of 16 rows
+ * @param[out] byte the 4 transposed byte columns
+ * @return void
+ */
+static inline void subblock_rows(const uint8_t *pIn, int32_t nNull, int32_t t, __m128i byte[4])
+{
+    const uint8_t *pY = pIn - (nNull >> 3) + 64 * t;
+    const __m128i shift = _mm_cvtsi32_si128(nNull & 7);
+    /* byte b of each row of 4 at dword b, the last row first */
+    const __m128i byte_sel = _mm_setr_epi8(12, 8, 4, 0, 13, 9, 5, 1, 14, 10, 6, 2, 15, 11, 7, 3);
+
+    __m128i x0 = _mm_shuffle_epi8(rm_bit_shifted_bytes(pY, 0, shift), byte_sel);
+    __m128i x1 = _mm_shuffle_epi8(rm_bit_shifted_bytes(pY, 16, shift), byte_sel);
+    __m128i x2 = _mm_shuffle_epi8(rm_bit_shifted_bytes(pY, 32, shift), byte_sel);
+    __m128i x3 = _mm_shuffle_epi8(rm_bit_shifted_bytes(pY, 48, shift), byte_sel);
+    __m128i a = _mm_unpacklo_epi32(x3, x2);
+    __m128i b = _mm_unpacklo_epi32(x1, x0);
+    __m128i c = _mm_unpackhi_epi32(x3, x2);
+    __m128i d = _mm_unpackhi_epi32(x1, x0);
+    byte[0] = _mm_unpacklo_epi64(a, b);
+    byte[1] = _mm_unpackhi_epi64(a, b);
+    byte[2] = _mm_unpacklo_epi64(c, d);
+    byte[3] = _mm_unpackhi_epi64(c, d);
+}
+
+/**
+ * @brief Columns of the sub-block interleaver matrices for the three streams, by movemask of the
+ *        transposed bytes. v(1) and v(2) are collected bit by bit interleaved, column j of v(1)
+ *        with column j + 1 of y(2) (TS 136.212 section 5.1.4.1.1, the permutation of v(2) is that
+ *        of v(1) plus 1), which is column j of y(2) with one NULL bit less, so the bytes of the two
+ *        are unpacked before the movemask.
+ * @param[in] pIn turbo encoder output streams, as for subblock_rows
+ * @param[in] ND number of NULL bits, > 0
+ * @param[in] nBlocks number of blocks of 16 rows
+ * @param[out] col0 bit 15 - i of col0[j][t] is row 16 * t + i of column j of y(0)
+ * @param[out] col12 bits 31 - 2i and 30 - 2i of col12[j][t] are row 16 * t + i of column j of y(1)
+ *             and column j + 1 of y(2)
+ * @return void
+ */
+static void subblock_columns(uint8_t *const pIn[3], int32_t ND, int32_t nBlocks,
+                             uint16_t (*col0)[SUBBLOCK_MAX_BLOCKS], uint32_t (*col12)[SUBBLOCK_MAX_BLOCKS])
+{
+    __m128i byte0[4], byte1[4], byte2[4];
+
+    for (int32_t t = 0; t < nBlocks; t++)
+    {
+        subblock_rows(pIn[0], ND, t, byte0);
+        subblock_rows(pIn[1], ND, t, byte1);
+        subblock_rows(pIn[2], ND - 1, t, byte2);
+        for (int32_t b = 0; b < 4; b++)
+        {
+            __m128i lo = _mm_unpacklo_epi8(byte2[b], byte1[b]);
+            __m128i hi = _mm_unpackhi_epi8(byte2[b], byte1[b]);
+            for (int32_t k = 0; k < 8; k++)
+            {
+                col0[8 * b + k][t] = (uint16_t)_mm_movemask_epi8(byte0[b]);
+                col12[8 * b + k][t] = ((uint32_t)_mm_movemask_epi8(hi) << 16) | (uint32_t)_mm_movemask_epi8(lo);
+                byte0[b] = _mm_add_epi8(byte0[b], byte0[b]);
+                lo = _mm_add_epi8(lo, lo);
+                hi = _mm_add_epi8(hi, hi);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Append one column of v(0) to the circular buffer, 32 rows at a time
+ * @param[in,out] w circular buffer writer
+ * @param[in] col column, as from subblock_columns
+ * @param[in] nRow number of rows
+ * @param[in] skip 1 when row 0 is a NULL bit
+ * @return void
+ */
+static inline void bit_collection_column(struct rm_bit_writer *w, const uint16_t *col, int32_t nRow, int32_t skip)
+{
+    for (int32_t t = 0; 32 * t < nRow; t++)
+    {
+        int32_t n = MIN(32, nRow - 32 * t);
+        uint32_t bits = ((uint32_t)col[2 * t] << 16) | ((32 * t + 16 < nRow) ? col[2 * t + 1] : 0);
+        bits = (n == 32) ? bits : (bits >> (32 - n));
+        if (t == 0)
+        {
+            n -= skip;
+            bits &= 0xFFFFFFFF >> (32 - n);
+        }
+        rm_bit_writer_put(w, bits, n);
+    }
+}
+
+/**
+ * @brief Append one column of v(1) and v(2) to the circular buffer, 16 rows at a time
+ * @param[in,out] w circular buffer writer
+ * @param[in] col column pair, as from subblock_columns
+ * @param[in] nRow number of rows
+ * @param[in] skip NULL bits at the start, 0, 1 (v(1)) or 2 (both)
+ * @param[in] drop 1 when the last bit of v(2) is a NULL bit
+ * @return void
+ */
+static inline void bit_collection_column_pair(struct rm_bit_writer *w, const uint32_t *col, int32_t nRow,
+                                              int32_t skip, int32_t drop)
+{
+    for (int32_t t = 0; 16 * t < nRow; t++)
+    {
+        int32_t n = 2 * MIN(16, nRow - 16 * t);
+        uint32_t bits = (n == 32) ? col[t] : (col[t] >> (32 - n));
+        if (16 * (t + 1) >= nRow)
+        {
+            bits >>= drop;
+            n -= drop;
+        }
+        if (t == 0)
+        {
+            n -= skip;
+            bits &= 0xFFFFFFFF >> (32 - n);
+        }
+        rm_bit_writer_put(w, bits, n);
+    }
+}
+
+/* n <= 64 bits of the circular buffer of Ncb_n bits from *pos, in the n low bits of the result */
+static inline uint64_t bit_selection_get(const uint8_t *pBuf, int32_t Ncb_n, int32_t *pos, int32_t n)
+{
+    uint64_t v = 0;
+    while (n > 0)
+    {
+        int32_t a = MIN(n, Ncb_n - *pos);
+        v |= (rm_bit_get64(pBuf, *pos) >> (64 - a)) << (n - a);
+        n -= a;
+        *pos += a;
+        if (*pos == Ncb_n)
+            *pos = 0;
+    }
+    return v;
+}
+
+/**
+ * @brief Turbo encoding and downlink rate matching of one code block for LTE. The sub-block
+ *        interleaving and bit collection of TS 136.212 section 5.1.4.1 go from the encoder streams
+ *        in a local buffer straight to the circular buffer without its NULL bits, as packed bits,
+ *        computed from the column permutation, and the e bits are copied from there to the output.
+ * @param[in] request structure containing configuration information and input data
+ * @param[out] response structure containing kernel outputs
+ * @return success: return 0, else: return -1
+ */
+int32_t bblib_turbo_rate_match_dl(const struct bblib_turbo_rate_match_dl_request *request,
+        struct bblib_rate_match_dl_response *response)
+{
+    __align(64) uint8_t win[3][SUBBLOCK_LEAD + TURBO_STREAM_BYTES];
+    __align(64) uint16_t col0[32][SUBBLOCK_MAX_BLOCKS];
+    __align(64) uint32_t col12[32][SUBBLOCK_MAX_BLOCKS];
+    /* circular buffer without NULL bits, 3 * 32 * 193 bits, and the bytes written and read past
+       its end */
+    __align(64) uint8_t wk[18528 / 8 + 16];
+
+    const int32_t Kidx = request->Kidx;
+    const int32_t C = request->C;
+    const int32_t r = request->r;
+    const int32_t rvidx = request->rvidx;
+
+    if ((Kidx < 0) || (Kidx >= 188))
+    {
+        printf("bblib_turbo_rate_match_dl: Kidx %d out of range, valid 0..187\n", Kidx);
+        return -1;
+    }
+    if ((C <= 0) || (r < 0) || (r >= C))
+    {
+        printf("bblib_turbo_rate_match_dl: code block %d of %d out of range\n", r, C);
+        return -1;
+    }
+    if ((request->bypass_rvidx != 1) && ((rvidx < 0) || (rvidx > 3)))
+    {
+        printf("Invalid redundancy version %d valid value:0/1/2/3\n", rvidx);
+        return -1;
+    }
+
+    const int32_t K = rate_match_kidx_to_k(Kidx);
+    const int32_t D = K + 4;
+    const int32_t nRow = D / 32 + 1;
+    const int32_t ND = 32 * nRow - D;
+    const int32_t nBlocks = (nRow + 15) / 16;
+
+    /* turbo encoding */
+    struct bblib_turbo_encoder_request enc_request = {};
+    struct bblib_turbo_encoder_response enc_response;
+    enc_request.length = K / 8;
+    enc_request.case_id = (uint8_t)(Kidx + 1);
+    enc_request.input_win = request->input;
+    enc_response.output_win_0 = win[0] + SUBBLOCK_LEAD;
+    enc_response.output_win_1 = win[1] + SUBBLOCK_LEAD;
+    enc_response.output_win_2 = win[2] + SUBBLOCK_LEAD;
+    if (bblib_turbo_encoder(&enc_request, &enc_response) != 0)
+        return -1;
+
+    /* sub-block interleaving and bit collection, TS 136.212 section 5.1.4.1.1 and 5.1.4.1.2 */
+    uint8_t *const pIn[3] = {win[0] + SUBBLOCK_LEAD, win[1] + SUBBLOCK_LEAD, win[2] + SUBBLOCK_LEAD};
+    for (int32_t n = 0; n < 3; n++)
+    {
+        memset(win[n], 0, SUBBLOCK_LEAD);
+        memset(pIn[n] + K / 8 + 1, 0, 64 * nBlocks - (K / 8 + 1));
+    }
+    subblock_columns(pIn, ND, nBlocks, col0, col12);
+
+    struct rm_bit_writer wr = {wk, 0, 0};
+    for (int32_t c = 0; c < 32; c++)
+    {
+        int32_t j = g_SubblockColumnPerm[c];
+        bit_collection_column(&wr, col0[j], nRow, j < ND);
+    }
+    /* the last bit of column 31 of v(2) is y(2) 0, a NULL bit */
+    for (int32_t c = 0; c < 32; c++)
+    {
+        int32_t j = g_SubblockColumnPerm[c];
+        bit_collection_column_pair(&wr, col12[j], nRow, (j < ND) + (j + 1 < ND), j == 31);
+    }
+
+    /* E and k0 of TS 136.212 section 5.1.4.1.2 */
+    int32_t Kw = 3 * 32 * nRow;
+    int32_t NIR = request->Nsoft / (request->KMIMO * (MIN(request->MDL_HARQ, MLIMIT)));
+    int32_t Ncb = MIN(floori(NIR, C), Kw);
+
+    float G1 = (float) request->G / (request->NL * request->Qm);
+    float G1_f = floor(G1);
+    float G1_fe = G1 -  G1_f;
+
+    float gamma = (int32_t)G1_f % C + G1_fe;
+    int32_t E = request->NL * request->Qm;
+
+    if (r <= (C - gamma - 1))
+        E *= floori(request->G, (request->NL * request->Qm) * C);
+    else
+        E *= ceili(request->G, (request->NL * request->Qm) * C);
+
+    int32_t temp3 = Ncb / (8 * nRow);
+    if(Ncb % (8 * nRow) > 0)
+        temp3++;
+
+    int32_t k0 = (request->bypass_rvidx == 1) ? 0 : nRow * (2 * temp3 * rvidx + 2);
+
+    /* k0 and Ncb without the NULL bits before them */
+    int32_t Ncb_n = Ncb - rate_match_null_bits(Kidx, Ncb);
+    int32_t k = (k0 - rate_match_null_bits(Kidx, k0)) % Ncb_n;
+
+    /* bit selection, the E bits from k around the circular buffer */
+    uint8_t *pOut = response->output;
+    int32_t e = 0;
+    while (E - e >= 64)
+    {
+        /* 16 bytes at a time up to the wrap around */
+        int32_t run = MIN(E - e, Ncb_n - k) >> 7;
+        if (run > 0)
+        {
+            const __m128i shift = _mm_cvtsi32_si128(8 - (k & 7));
+            for (int32_t i = 0; i < run; i++)
+                _mm_storeu_si128((__m128i *)(pOut + 16 * i), rm_bit_shifted_bytes(wk + (k >> 3) + 1, 16 * i, shift));
+            pOut += 16 * run;
+            e += 128 * run;
+            k += 128 * run;
+            k = (k == Ncb_n) ? 0 : k;
+            continue;
+        }
+
+        uint64_t word = (uint64_t)_bswap64((int64_t)bit_selection_get(wk, Ncb_n, &k, 64));
+        memcpy(pOut, &word, 8);
+        pOut += 8;
+        e += 64;
+    }
+    if (e < E)
+    {
+        uint64_t word = bit_selection_get(wk, Ncb_n, &k, E - e) << (64 - (E - e));
+        for (; e < E; e += 8)
+        {
+            *pOut++ = (uint8_t)(word >> 56);
+            word <<= 8;
+        }
+    }
+
+    return 0;
+}
+#else
+int32_t bblib_turbo_rate_match_dl(const struct bblib_turbo_rate_match_dl_request *request,
+        struct bblib_rate_match_dl_response *response)
+{
+    printf("bblib_rate_matching requires at least SSE4.2 ISA support to run\n");
+    return(-1);
+}
+#endif
@@ -31,21 +31,19 @@
 #include <cstdint>
 #include <cstdlib>
 #include <functional>
-#include <string.h>
 
 #include "phy_turbo.h"
 #include "phy_turbo_internal.h"
 
 #include "sdk_version.h"
+#include "bblib_isa.h"
 
 _TurboInterleaver g_TurboInterleaver;
 
-/* Turbo table */
-extern __align(64) uint16_t g_TurboBufAddr[1068000];
-extern __align(64) int32_t g_TurboBufAddrOffset[188];
-
-/* TS36.212 Table 5.1.3-3, Turbo code internal interleaver parameters with XXXX */
-extern int32_t g_Kidx_K_Nmaxrep_shuf_sdk[188][5];
+/* The 64 windows decoder splits a code block into 64 windows of K/64 rows. Shorter windows do not
+   converge: at sigma 1.0 and 4 iterations its block errors were 5 to 10 times those of the 32 windows
+   AVX2 decoder for K = 512..768, so it only takes windows of at least 16 rows. */
+#define TURBO_64WINDOWS_MIN_K (64 * 16)
 
 typedef int32_t (*encode_function)(const bblib_turbo_encoder_request *request,
     bblib_turbo_encoder_response *response);
@@ -58,73 +56,9 @@ struct bblib_lte_turbo_init
                        "AVX2 or SSE\n");
         exit(-1);
 #endif
-        /* Get SDK root folder from environment variable */
-        char *pTablePath = getenv("DIR_WIRELESS_SDK");
-        char *pCheckPath1 = NULL, *pCheckPath2 = NULL, *pCheckPath3 = NULL;
-        uint32_t path_len, str_offset;
-        if (pTablePath == NULL) {
-            printf("Need to setup environment variable 'DIR_WIRELESS_SDK' for turbo,"
-                           " please set it up to folder where SDK is stored, with 'export"
-                           " DIR_WIRELESS_SDK=...'\n");
-            exit(-1);
-        }
-
-        path_len = strlen(pTablePath);
-        //check to see if string has necessary characters
-#ifdef WIN32
-        pCheckPath1 = strstr(pTablePath, "sdk");
-
-        if ((pCheckPath1 == NULL) && (pCheckPath2 == NULL))
-        {
-            printf("%s is not valid!!!  DIR_WIRELESS_SDK must include\n", pTablePath);
-            printf("sdk somewhere in path\n");
-            exit(1);
-        }
-#else
-        pCheckPath1 = strstr(pTablePath, "sdk/build-avx");
-        pCheckPath2 = strstr(pTablePath, "sdk/build-snc");
-        pCheckPath3 = strstr(pTablePath, "sdk/build-spr");
-
-        if ((pCheckPath1 == NULL) && (pCheckPath2 == NULL) && (pCheckPath3 == NULL))
-        {
-            printf("%s is not valid!!!  DIR_WIRELESS_SDK must include\n", pTablePath);
-            printf("sdk/build-avx or sdk/build-snc or sdk/build-spr somewhere in path\n");
-            exit(-1);
-        }
-#endif
-
-        //check to see if string has characters trying to access
-        //files in other directories
-#ifdef WIN32
-        pCheckPath1 = strstr(pTablePath, "../");
-#else
-        pCheckPath1 = strstr(pTablePath, "..\\");
-#endif
-        if (pCheckPath1 != NULL)
-        {
-            printf("Trying to access illegal path, %s\n", pTablePath);
-            printf("cannot have ../ in path!\n");
-            exit(-1);
-        }
-
-        //check to see if string has NULL characters in the middle of the
-        //string trying to widen access to other files in current directory
-        //NULL character should only be at the end of the string
-        pCheckPath1 = strchr(pTablePath, 0);
-        str_offset = (uint64_t)(pCheckPath1) - (uint64_t)(pTablePath);
-        //if NULL not at end, return fail
-        if (str_offset - path_len)
-        {
-            printf("NULL character found in path, %s\n", pTablePath);
-            printf("cannot have NULL characters in the middle!\n");
-            exit(-1);
-        }
-
-        bblib_lte_turbo_interleaver_initTable(pTablePath);
-        init_turbo_decoder_interleaver_table(pTablePath, &g_TurboInterleaver);
-        init_common_tables(pTablePath);
-        get_turbo_buf_addr_table_new(g_TurboBufAddr, g_TurboBufAddrOffset,
-                                     g_Kidx_K_Nmaxrep_shuf_sdk);
+        /* Interleaver tables, computed from the QPP parameters */
+        bblib_lte_turbo_interleaver_initTable();
+        init_turbo_decoder_interleaver_table(&g_TurboInterleaver);
     }
 };
 
@@ -154,13 +88,14 @@ int16_t bblib_lte_turbo_version(char *version, int buffer_size) {
 static encode_function
 bblib_encoder_select_on_isa() {
 #ifdef _BBLIB_AVX512_
-    // AVX512 has problems (see d73f51264838d41656679123733764ee3f80cb0c)
-    return bblib_lte_turbo_encoder_avx2;
-#elif defined _BBLIB_AVX2_
-    return bblib_lte_turbo_encoder_avx2;
-#else
-    return bblib_lte_turbo_encoder_sse;
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512)
+        return bblib_lte_turbo_encoder_avx512;
+#endif
+#ifdef _BBLIB_AVX2_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX2)
+        return bblib_lte_turbo_encoder_avx2;
 #endif
+    return bblib_lte_turbo_encoder_sse;
 }
 
 static encode_function default_encode = bblib_encoder_select_on_isa();
@@ -177,44 +112,44 @@ int32_t bblib_turbo_decoder(const struct bblib_turbo_decoder_request *request,
     /* Set CRC bit to Fail */
     response->crc_status = 0;
 
-#ifdef _BBLIB_AVX512_
+    const enum bblib_isa isa = bblib_get_isa();
+
     if ((request->k) % 16 != 0) {
         return bblib_lte_turbo_decoder_8windows_sse(request, response);
     }
-    else if(request->k % 32 != 0) {
-        if (0 == request->max_iter_num)
-            return bblib_lte_turbo_decoder_16windows_3iteration_sse(request, response);
-        else
-            return bblib_lte_turbo_decoder_16windows_sse(request, response);
-    }
-    else if(request->k % 64 != 0) {
-        return bblib_lte_turbo_decoder_32windows_avx2(request, response);
-    }
-    else {
+#ifdef _BBLIB_AVX512_
+    if (request->k % 64 == 0 && request->k >= TURBO_64WINDOWS_MIN_K && isa >= BBLIB_ISA_AVX512) {
         return bblib_lte_turbo_decoder_64windows_avx512(request, response);
     }
-#elif defined _BBLIB_AVX2_
-    if ((request->k) % 16 != 0) {
-        return bblib_lte_turbo_decoder_8windows_sse(request, response);
-    }
-    else if(request->k % 32 != 0) {
-        if (0 == request->max_iter_num)
-            return bblib_lte_turbo_decoder_16windows_3iteration_sse(request, response);
-        else
-            return bblib_lte_turbo_decoder_16windows_sse(request, response);
-    }
-    else {
+#endif
+#ifdef _BBLIB_AVX2_
+    if (request->k % 32 == 0 && isa >= BBLIB_ISA_AVX2) {
         return bblib_lte_turbo_decoder_32windows_avx2(request, response);
     }
-#else
-    if ((request->k) % 16 != 0) {
-        return bblib_lte_turbo_decoder_8windows_sse(request, response);
+#endif
+    if (0 == request->max_iter_num)
+        return bblib_lte_turbo_decoder_16windows_3iteration_sse(request, response);
+    else
+        return bblib_lte_turbo_decoder_16windows_sse(request, response);
+}
+
+int32_t bblib_turbo_decoder_multi(const struct bblib_turbo_decoder_request *request,
+    struct bblib_turbo_decoder_response *response, int32_t *num_iter, int32_t num) {
+
+    if (request == NULL || response == NULL || num_iter == NULL || num < 0) {
+        printf("bblib_turbo_decoder_multi input address invalid \n");
+        return -1;
+    }
+    if (num > BBLIB_TURBO_DECODER_MULTI_MAX) {
+        printf("bblib_turbo_decoder_multi: %d code blocks, more than %d\n", num, BBLIB_TURBO_DECODER_MULTI_MAX);
+        return -1;
     }
-    else {
-        if (0 == request->max_iter_num)
-            return bblib_lte_turbo_decoder_16windows_3iteration_sse(request, response);
-        else
-            return bblib_lte_turbo_decoder_16windows_sse(request, response);
+#ifdef _BBLIB_AVX512_
+    if (bblib_get_isa() >= BBLIB_ISA_AVX512) {
+        return bblib_lte_turbo_decoder_multi_avx512(request, response, num_iter, num);
     }
 #endif
+    for (int32_t n = 0; n < num; n++)
+        num_iter[n] = bblib_turbo_decoder(&request[n], &response[n]);
+    return 0;
 }
@@ -36,9 +36,32 @@
 extern "C" {
 #endif
 
+/*!
+    \enum bblib_turbo_early_term
+    \brief Values of early_term_disable in bblib_turbo_decoder_request.
+
+    Early termination checks the CRC after a half iteration only when the smallest |LLR| the SISO
+    found in the code block is above a threshold, which takes no more than a min in the SISO loop.
+*/
+enum bblib_turbo_early_term {
+    BBLIB_TURBO_EARLY_TERM = 0,         /*!< Stop once the CRC passes, checked when every |LLR| is above 2 */
+    BBLIB_TURBO_EARLY_TERM_DISABLE = 1, /*!< Always run max_iter_num iterations, with one CRC check at the end */
+    BBLIB_TURBO_EARLY_TERM_FAST = 2     /*!< Stop once the CRC passes, checked as soon as no |LLR| is 0.
+                                             Often stops an iteration earlier, for a few more CRC checks on
+                                             the code blocks that do not decode yet. */
+};
+
+/*! Options of the flags of the turbo encoder and decoder requests, none set keeps the default. */
+#define BBLIB_TURBO_QPP_ON_THE_FLY (1 << 0) /*!< Compute the QPP interleaver of TS 36.212 section 5.1.3.2.3
+    for the code block instead of reading the tables built when the library is loaded. Slower when the
+    tables are in cache, it keeps them out of L2 when code blocks of many sizes are coded back to back.
+    The 8 windows decoders always compute it. */
+
 /*!
     \struct bblib_turbo_decoder_request
     \brief Request structure for turbo decoder.
+    \note The structure must be zero-initialised (e.g. = {} or memset) before its fields are set, so that
+          options it does not set, such as flags, keep their default behaviour.
 */
 struct bblib_turbo_decoder_request {
 
@@ -56,9 +79,14 @@ struct bblib_turbo_decoder_request {
 
     int32_t max_iter_num; /*!< Maximum number of decoder iterations */
 
-    int32_t early_term_disable; /*!< If set to 1, then max_iter_num is always used regardless of CRC check pass / fail. If 0, least number of iterations are used (1 <= iter <= max_iter_num) for decoding till crc check is pass */
+    int32_t early_term_disable; /*!< If set to 1, then max_iter_num is always used regardless of CRC check pass / fail. If 0, least number of iterations are used (1 <= iter <= max_iter_num) for decoding till crc check is pass. 2 is the same with the CRC checked earlier, see bblib_turbo_early_term */
+
+    int8_t *input; /*!< Input buffer must be 64 bytes aligned.
 
-    int8_t *input; /*!< Input buffer must be 64 bytes aligned*/
+                        The decoder also keeps its extrinsic information in it, so the LLRs
+                        are not preserved and concurrent calls need separate buffers. */
+
+    uint32_t flags; /*!< Options, BBLIB_TURBO_* bits, 0 to use the interleaver tables. */
 };
 
 /*!
@@ -83,6 +111,7 @@ struct bblib_turbo_decoder_response {
 /*!
     \struct bblib_turbo_encoder_request
     \brief Request structure for turbo encoder.
+    \note The structure must be zero-initialised before its fields are set, as bblib_turbo_decoder_request.
 */
 struct bblib_turbo_encoder_request {
 
@@ -92,6 +121,8 @@ struct bblib_turbo_encoder_request {
                           Table 5.1.3-3, column 'i'. */
 
     uint8_t *input_win; /*!< Information and CRC bits buffer. */
+
+    uint32_t flags; /*!< Options, BBLIB_TURBO_* bits as bblib_turbo_decoder_request. */
 };
 
 
@@ -137,6 +168,8 @@ int32_t  bblib_lte_turbo_encoder_avx512(const struct bblib_turbo_encoder_request
 
 //! @{
 /*! \brief Turbo decoder implementation for different windows sizes as defined in TS.36.212.
+    \note The decoders keep no state between calls, several threads may decode at once as long
+          as each call has its own input and response buffers (output, ag_buf, cb_buf).
     \param request Input data container.
     \param response Output data container.
     \return Number of half iterations on success, negative on failure
@@ -155,6 +188,37 @@ int32_t bblib_lte_turbo_decoder_16windows_3iteration_sse(const struct bblib_turb
     struct bblib_turbo_decoder_response *response);
 int32_t bblib_lte_turbo_decoder_8windows_sse(const struct bblib_turbo_decoder_request *request,
     struct bblib_turbo_decoder_response *response);
+int32_t bblib_lte_turbo_decoder_8windows_avx512(const struct bblib_turbo_decoder_request *request,
+    struct bblib_turbo_decoder_response *response);
+//! @}
+
+/*! Largest batch of bblib_turbo_decoder_multi. */
+#define BBLIB_TURBO_DECODER_MULTI_MAX 128
+
+//! @{
+/*! \brief Turbo decoder for a batch of code blocks, as defined in TS.36.212.
+    \note On AVX512 the code blocks with K a multiple of 16 and up to 1024 bits are decoded four
+          at a time, one per 128-bit lane, each with its own iterations, early termination and
+          CRC. The other code blocks are decoded one by one by bblib_turbo_decoder. Each response
+          needs its own output, ag_buf and cb_buf as for bblib_turbo_decoder, a group of four runs
+          in the ag_buf of one of its code blocks.
+    \note The code blocks decoded side by side run 16 windows of K/16 rows each. Their output and
+          number of half iterations do not depend on the other code blocks of the batch, but may
+          differ from bblib_turbo_decoder, and are not bit-exact with
+          bblib_lte_turbo_decoder_16windows_sse either.
+    \param request Array of num input data containers.
+    \param response Array of num output data containers.
+    \param num_iter Array of num results, number of half iterations or negative on failure,
+           as returned by bblib_turbo_decoder for each code block.
+    \param num Number of code blocks, up to BBLIB_TURBO_DECODER_MULTI_MAX.
+    \return 0 on success, -1 on invalid arguments.
+*/
+int32_t
+bblib_turbo_decoder_multi(const struct bblib_turbo_decoder_request *request,
+    struct bblib_turbo_decoder_response *response, int32_t *num_iter, int32_t num);
+
+int32_t bblib_lte_turbo_decoder_multi_avx512(const struct bblib_turbo_decoder_request *request,
+    struct bblib_turbo_decoder_response *response, int32_t *num_iter, int32_t num);
 //! @}
 
 #ifdef __cplusplus
@@ -36,12 +36,12 @@
 #include "phy_crc.h"
 #include "phy_turbo.h"
 #if defined(_BBLIB_SSE4_2_) || defined(_BBLIB_AVX2_) || defined(_BBLIB_AVX512_)
-static __m128i TD_constant128 = _mm_setr_epi8(0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0);
-static __m128i TD_constantminus80 = _mm_setr_epi8(-80,-80,-80,-80,-80,-80,-80,-80,-80,-80,-80,-80,-80,-80,-80,-80);
-static __m128i TD_constant0 = _mm_setr_epi8(0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0);
-static __m128i TD_constant_0_16 = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
-static __m128i TD_vshuf1_BitTranspose_16windows = _mm_setr_epi8(14, 12, 10, 8, 6, 4, 2, 0, 15, 13, 11, 9, 7, 5, 3, 1);
-static __m128i TD_vshuf2_BitTranspose_16windows = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 8, 9, 10, 11, 12, 13, 14, 15);
+static const __m128i TD_constant128 = _mm_setr_epi8(0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0);
+static const __m128i TD_constantminus80 = _mm_setr_epi8(-80,-80,-80,-80,-80,-80,-80,-80,-80,-80,-80,-80,-80,-80,-80,-80);
+static const __m128i TD_constant0 = _mm_setr_epi8(0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0);
+static const __m128i TD_constant_0_16 = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+static const __m128i TD_vshuf1_BitTranspose_16windows = _mm_setr_epi8(14, 12, 10, 8, 6, 4, 2, 0, 15, 13, 11, 9, 7, 5, 3, 1);
+static const __m128i TD_vshuf2_BitTranspose_16windows = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 8, 9, 10, 11, 12, 13, 14, 15);
 
 int32_t SISO1_16windows(int8_t *OutputAddress, int8_t *InputAddress,
                                 int32_t *InterleaverInterRowAddr, int8_t *InterleaverIntraRowPattern, int32_t *InterleaverIntraRowPatSel,
@@ -82,12 +82,15 @@ bblib_lte_turbo_decoder_16windows_sse(const struct bblib_turbo_decoder_request *
     int32_t numMaxIter = request->max_iter_num;
     int32_t Lwin = K >> 4;
     int32_t Kidx = request->k_idx - 1;
-    int32_t ofst = g_TurboInterleaver.offset[Kidx];
-    int32_t * pInterleaverInterRowAddr = &(g_TurboInterleaver.inter_row_out_addr_for_interleaver[ofst]);
-    int32_t * pInterleaverIntraRowPatSel = &(g_TurboInterleaver.intra_row_perm_pattern_for_interleaver[ofst]);
-    int32_t * pDeInterleaverInterRowAddr = &(g_TurboInterleaver.inter_row_out_addr_for_deinterleaver[ofst]);
-    int32_t * pDeInterleaverIntraRowPatSel = &(g_TurboInterleaver.intra_row_perm_pattern_for_deinterleaver[ofst]);
-    int8_t * pIntraRowPattern = &(g_TurboInterleaver.pattern[0][0]);
+    _TurboInterleaverRows rows;
+    struct turbo_decoder_interleaver interleaver;
+    if (turbo_decoder_interleaver(Kidx, request->flags, &rows, &interleaver) != 0)
+        return -1;
+    int32_t * pInterleaverInterRowAddr = interleaver.inter_row_out_addr_for_interleaver;
+    int32_t * pInterleaverIntraRowPatSel = interleaver.intra_row_perm_pattern_for_interleaver;
+    int32_t * pDeInterleaverInterRowAddr = interleaver.inter_row_out_addr_for_deinterleaver;
+    int32_t * pDeInterleaverIntraRowPatSel = interleaver.intra_row_perm_pattern_for_deinterleaver;
+    int8_t * pIntraRowPattern = interleaver.pattern;
     int8_t * pLLR_tail = request->input;
 
     uint8_t *pout = response->output;
@@ -193,6 +196,7 @@ bblib_lte_turbo_decoder_16windows_sse(const struct bblib_turbo_decoder_request *
 
     /* SISO */
     int32_t min_dist;
+    const int32_t early_term_min_dist = turbo_early_term_min_dist(numMaxIter, request->early_term_disable);
 
     min_dist = SISO1_16windows(pLeXP2, pLeXP1,
     pInterleaverInterRowAddr, pIntraRowPattern, pInterleaverIntraRowPatSel,
@@ -200,7 +204,7 @@ bblib_lte_turbo_decoder_16windows_sse(const struct bblib_turbo_decoder_request *
     p_winCodeBlockBits);
     NumIter++;
 
-    if (min_dist>2)
+    if (min_dist > early_term_min_dist)
     {
         BitTranspose_16windows(K, p_winCodeBlockBits, pout);
 
@@ -223,11 +227,8 @@ bblib_lte_turbo_decoder_16windows_sse(const struct bblib_turbo_decoder_request *
         }
         if (crc_response.check_passed)
         {
-            if (request->early_term_disable == 0)
-            {
-                response->crc_status = 1;
-                return NumIter;
-            }
+            response->crc_status = 1;
+            return NumIter;
         }
 
     }
@@ -262,7 +263,7 @@ bblib_lte_turbo_decoder_16windows_sse(const struct bblib_turbo_decoder_request *
         p_winCodeBlockBits);
         NumIter++;
 
-        if (min_dist>2)
+        if (min_dist > early_term_min_dist)
         {
             BitTranspose_16windows(K, p_winCodeBlockBits, pout);
 
@@ -285,11 +286,8 @@ bblib_lte_turbo_decoder_16windows_sse(const struct bblib_turbo_decoder_request *
             }
             if (crc_response.check_passed)
             {
-                if (request->early_term_disable == 0)
-                {
-                    response->crc_status = 1;
-                    return NumIter;
-                }
+                response->crc_status = 1;
+                return NumIter;
             }
         }
     }
@@ -336,12 +334,15 @@ bblib_lte_turbo_decoder_16windows_3iteration_sse(const struct bblib_turbo_decode
 
     int32_t Lwin = K >> 4;
     int32_t Kidx = request->k_idx - 1;
-    int32_t ofst = g_TurboInterleaver.offset[Kidx];
-    int32_t * pInterleaverInterRowAddr = &(g_TurboInterleaver.inter_row_out_addr_for_interleaver[ofst]);
-    int32_t * pInterleaverIntraRowPatSel = &(g_TurboInterleaver.intra_row_perm_pattern_for_interleaver[ofst]);
-    int32_t * pDeInterleaverInterRowAddr = &(g_TurboInterleaver.inter_row_out_addr_for_deinterleaver[ofst]);
-    int32_t * pDeInterleaverIntraRowPatSel = &(g_TurboInterleaver.intra_row_perm_pattern_for_deinterleaver[ofst]);
-    int8_t * pIntraRowPattern = &(g_TurboInterleaver.pattern[0][0]);
+    _TurboInterleaverRows rows;
+    struct turbo_decoder_interleaver interleaver;
+    if (turbo_decoder_interleaver(Kidx, request->flags, &rows, &interleaver) != 0)
+        return -1;
+    int32_t * pInterleaverInterRowAddr = interleaver.inter_row_out_addr_for_interleaver;
+    int32_t * pInterleaverIntraRowPatSel = interleaver.intra_row_perm_pattern_for_interleaver;
+    int32_t * pDeInterleaverInterRowAddr = interleaver.inter_row_out_addr_for_deinterleaver;
+    int32_t * pDeInterleaverIntraRowPatSel = interleaver.intra_row_perm_pattern_for_deinterleaver;
+    int8_t * pIntraRowPattern = interleaver.pattern;
     int8_t * pLLR_tail = request->input;
 
     uint8_t *pout = response->output;
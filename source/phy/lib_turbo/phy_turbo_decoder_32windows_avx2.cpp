@@ -60,11 +60,11 @@
 #include "bblib_common.hpp"
 
 #if defined (_BBLIB_AVX2_) || defined (_BBLIB_AVX512_)
-static __m256i TD_constant256 = _mm256_setr_epi8(0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0);
-static __m128i TD_constant_0_16 = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+static const __m256i TD_constant256 = _mm256_setr_epi8(0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0);
+static const __m128i TD_constant_0_16 = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
 
 #define TURBO_OFFSET (-80)
-static __m256i TD_Offset = _mm256_setr_epi8(
+static const __m256i TD_Offset = _mm256_setr_epi8(
     TURBO_OFFSET, TURBO_OFFSET, TURBO_OFFSET, TURBO_OFFSET,
     TURBO_OFFSET, TURBO_OFFSET, TURBO_OFFSET, TURBO_OFFSET,
     TURBO_OFFSET, TURBO_OFFSET, TURBO_OFFSET, TURBO_OFFSET,
@@ -165,12 +165,15 @@ bblib_lte_turbo_decoder_32windows_avx2(const struct bblib_turbo_decoder_request
         numMaxIterUse = numMaxIter;
     int32_t Lwin = K >> 4, Lwin5 = K >> 5;
     int32_t Kidx = request->k_idx - 1;
-    int32_t ofst = g_TurboInterleaver.offset[Kidx];
-    int32_t * pInterleaverInterRowAddr = &(g_TurboInterleaver.inter_row_out_addr_for_interleaver[ofst]);
-    int32_t * pInterleaverIntraRowPatSel = &(g_TurboInterleaver.intra_row_perm_pattern_for_interleaver[ofst]);
-    int32_t * pDeInterleaverInterRowAddr = &(g_TurboInterleaver.inter_row_out_addr_for_deinterleaver[ofst]);
-    int32_t * pDeInterleaverIntraRowPatSel = &(g_TurboInterleaver.intra_row_perm_pattern_for_deinterleaver[ofst]);
-    int8_t * pIntraRowPattern = &(g_TurboInterleaver.pattern[0][0]);
+    _TurboInterleaverRows rows;
+    struct turbo_decoder_interleaver interleaver;
+    if (turbo_decoder_interleaver(Kidx, request->flags, &rows, &interleaver) != 0)
+        return -1;
+    int32_t * pInterleaverInterRowAddr = interleaver.inter_row_out_addr_for_interleaver;
+    int32_t * pInterleaverIntraRowPatSel = interleaver.intra_row_perm_pattern_for_interleaver;
+    int32_t * pDeInterleaverInterRowAddr = interleaver.inter_row_out_addr_for_deinterleaver;
+    int32_t * pDeInterleaverIntraRowPatSel = interleaver.intra_row_perm_pattern_for_deinterleaver;
+    int8_t * pIntraRowPattern = interleaver.pattern;
     int8_t * pLLR_tail = request->input;
 
     uint8_t *pout = response->output;
@@ -227,6 +230,7 @@ bblib_lte_turbo_decoder_32windows_avx2(const struct bblib_turbo_decoder_request
     pLeXP1 = request->input + 48;
 
     int32_t min_dist;
+    const int32_t early_term_min_dist = turbo_early_term_min_dist(numMaxIter, request->early_term_disable);
 
     if(numMaxIter != 0) {
         min_dist = SISO_32windows(pLeXP2, pLeXP1,
@@ -235,7 +239,7 @@ bblib_lte_turbo_decoder_32windows_avx2(const struct bblib_turbo_decoder_request
             p_winCodeBlockBits);
         NumIter++;
 
-        if ((min_dist>2) && (numMaxIter != 0))
+        if (min_dist > early_term_min_dist)
         {
             BitTranspose_16windows(K, p_winCodeBlockBits, pout);
 
@@ -257,11 +261,8 @@ bblib_lte_turbo_decoder_32windows_avx2(const struct bblib_turbo_decoder_request
             }
             if (crc_response.check_passed)
             {
-                if (request->early_term_disable == 0)
-                {
-                    response->crc_status = 1;
-                    return NumIter;
-                }
+                response->crc_status = 1;
+                return NumIter;
             }
 
         }
@@ -297,7 +298,7 @@ bblib_lte_turbo_decoder_32windows_avx2(const struct bblib_turbo_decoder_request
             p_winCodeBlockBits);
         NumIter++;
 
-        if ((min_dist > 2) && (numMaxIter != 0))
+        if (min_dist > early_term_min_dist)
         {
             BitTranspose_16windows(K, p_winCodeBlockBits, pout);
 
@@ -318,11 +319,8 @@ bblib_lte_turbo_decoder_32windows_avx2(const struct bblib_turbo_decoder_request
             }
             if (crc_response.check_passed)
             {
-                if (request->early_term_disable == 0)
-                {
-                    response->crc_status = 1;
-                    return NumIter;
-                }
+                response->crc_status = 1;
+                return NumIter;
             }
         }
     }
@@ -352,11 +350,11 @@ bblib_lte_turbo_decoder_32windows_avx2(const struct bblib_turbo_decoder_request
     return NumIter;
 }
 
-static __m256i signBitMask = _mm256_setr_epi8(0x80, 0x80, 0x80, 0x80,0x80, 0x80, 0x80,
+static const __m256i signBitMask = _mm256_setr_epi8(0x80, 0x80, 0x80, 0x80,0x80, 0x80, 0x80,
                                    0x80,0x80, 0x80, 0x80, 0x80,0x80, 0x80, 0x80, 0x80,
                                    0x80, 0x80, 0x80, 0x80,0x80, 0x80, 0x80, 0x80,0x80,
                                    0x80, 0x80, 0x80,0x80, 0x80, 0x80, 0x80);
-static __m256i tailBitMask = _mm256_setr_epi8(0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC,
+static const __m256i tailBitMask = _mm256_setr_epi8(0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC,
                                               0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC,
                                               0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC,
                                               0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC);
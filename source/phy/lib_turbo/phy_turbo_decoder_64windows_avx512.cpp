@@ -24,7 +24,7 @@
 
 /*******************************************************************************
 *  @file phy_turbo_decoder_64windows_avx512.cpp
-*  @brief this file performs the turbo Decoder when CW size is multiple of 64.
+*  @brief this file performs the turbo Decoder when CW size is multiple of 16.
 *  Trellis diagram:        0-00->0
                            0-11->4
                            1-00->4
@@ -59,32 +59,31 @@
 #include "bblib_common.hpp"
 
 #if defined (_BBLIB_AVX512_)
-static __m512i TD_constant512 = _mm512_setzero_si512();
+static const __m512i TD_constant512 = _mm512_setzero_si512();
 
 #define TURBO_OFFSET (-80)
-static __m512i TD_Offset = _mm512_set1_epi8(TURBO_OFFSET);
-static __m512i signBitMask = _mm512_set1_epi8(0x80);
-static __m512i tailBitMask = _mm512_set1_epi8(0xFC);
-static __m512i init_alpha = _mm512_set_epi8 (0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+static const __m512i TD_Offset = _mm512_set1_epi8(TURBO_OFFSET);
+static const __m512i scaleBitMask = _mm512_set1_epi8(0x3F);
+static const __m512i scaleSignBit = _mm512_set1_epi8(0x20);
+static const __m512i init_alpha = _mm512_set_epi8 (0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
                                              0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
                                              0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
                                              0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -128);
 
-static __m512i k_alpha = _mm512_set_epi8(15, 14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1,  0,
+static const __m512i k_alpha = _mm512_set_epi8(15, 14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1,  0,
                                          15, 14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1,  0,
                                          15, 14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1,  0,
                                          14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1,  0, 15);
-static __m512i k_beta = _mm512_set_epi8( 0, 15, 14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1,
+static const __m512i k_beta = _mm512_set_epi8( 0, 15, 14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1,
                                         15, 14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1,  0,
                                         15, 14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1,  0,
                                         15, 14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1,  0);
-static __m512i copy_beta = _mm512_setzero_si512();
 
-static __m256i TD_constant_0_16 = _mm256_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+static const __m256i TD_constant_0_16 = _mm256_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
                                                   0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
-static __m256i TD_vshuf1_BitTranspose_16windows = _mm256_set_epi8(1, 3, 5, 7, 9, 11, 13, 15, 0, 2, 4, 6, 8, 10, 12, 14,
+static const __m256i TD_vshuf1_BitTranspose_16windows = _mm256_set_epi8(1, 3, 5, 7, 9, 11, 13, 15, 0, 2, 4, 6, 8, 10, 12, 14,
                                                                   1, 3, 5, 7, 9, 11, 13, 15, 0, 2, 4, 6, 8, 10, 12, 14);
-static __m128i TD_vshuf2_BitTranspose_16windows = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+static const __m128i TD_vshuf2_BitTranspose_16windows = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
 
 
 /* update the alpha for the next iter.           *
@@ -99,13 +98,68 @@ static __m128i TD_vshuf2_BitTranspose_16windows = _mm_setr_epi8(7, 6, 5, 4, 3, 2
 
 /* update the beta for the next iter.           *
  * input  beta0 beta1 beta2 beta3               *
- * output beta1 beta2 beta3 beta0               */
-#define SHUFFLE_BETA(value, in, out)\
+ * output beta1 beta2 beta3 beta0               *
+ * value goes to the last window, byte tail     */
+#define SHUFFLE_BETA(tail, value, in, out)\
 {\
-    copy_beta = _mm512_set1_epi8(value);\
     out = _mm512_shuffle_i64x2 (in, in, 0x39);\
     out = _mm512_shuffle_epi8 (out, k_beta);\
-    out = _mm512_mask_blend_epi8 (0x8000000000000000, out, copy_beta);\
+    out = _mm512_mask_blend_epi8 (tail, out, value);\
+}
+
+/* the same when each 128-bit lane holds a code block of its own, *
+ * the windows only move inside their lane                        */
+#define TD_LANE_HEAD 0x0001000100010001
+#define TD_LANE_TAIL 0x8000800080008000
+#define SHIFT_ALPHA_LANES(in, out)\
+{\
+    out = _mm512_bslli_epi128 (in, 1);\
+    out = _mm512_mask_blend_epi8 (TD_LANE_HEAD, out, _mm512_set1_epi8(-128));\
+}
+
+#define SHIFT_BETA_LANES(value, in, out)\
+{\
+    out = _mm512_bsrli_epi128 (in, 1);\
+    out = _mm512_mask_blend_epi8 (TD_LANE_TAIL, out, value);\
+}
+
+/* zeros read by the rows past the end of the code block */
+__align(64) static __m128i TD_zero_row[3];
+
+/* 16 windows of a code block run in each 128-bit lane of the SISO registers, either the 4 lanes
+   are consecutive parts of one code block or each lane is a code block of its own. The code blocks
+   with K not a multiple of 16 run 8 windows in bytes 0 to 7 of the 4 consecutive lanes. */
+struct siso_lanes_64windows
+{
+    int8_t *output[4];       /* extrinsic output, rows of 48 bytes */
+    int8_t *input[4];        /* first row of the lane, rows of 48 bytes */
+    int8_t *pattern[4];      /* intra row patterns */
+    int32_t *pattern_sel[4]; /* byte offset in pattern of each row */
+    int32_t *row_addr[4];    /* byte offset in output of each row */
+    uint16_t *cb_bits[4];    /* hard bits of each row */
+    int32_t rows[4];         /* rows of the lane inside its code block, 0 leaves the lane out */
+    int32_t separate_cb;     /* 1 when each lane is a code block of its own */
+    int32_t windows;         /* windows in each lane, 16, or 8 with bytes 8 to 15 left out */
+};
+
+/* byte of the last window of the 4 consecutive lanes, where the tail beta goes */
+static inline __mmask64 tail_window_64windows(int32_t windows)
+{
+    return (__mmask64)1 << (47 + windows);
+}
+
+/* lanes whose row i is inside their code block */
+static inline __mmask64 valid_rows_64windows(const int32_t *rows, int32_t i)
+{
+    __mmask64 valid = 0;
+    for (int32_t g = 0; g < 4; g++)
+    {
+        if (i < rows[g])
+        {
+            valid |= (__mmask64)0xFFFF << (16 * g);
+        }
+    }
+    return valid;
 }
 
 #define CALC_ALPHA_BETA(info0, info1, in0, in1, tmp0, tmp1, out0, out1)\
@@ -124,27 +178,51 @@ static __m128i TD_vshuf2_BitTranspose_16windows = _mm_setr_epi8(7, 6, 5, 4, 3, 2
     tmpDelta1 = _mm512_adds_epi8(tmpDelta1, beta0);\
 }
 
+/* a - a/4, a/4 as the 6 low bits of the 16 bits shift sign extended by xor and sub of their top bit */
 #define SCALE_075(a)\
 {\
-    __m512i signBit;\
-    __m512i signBit1;\
-    signBit = _mm512_and_si512(a, signBitMask);\
-    signBit1 = _mm512_srli_epi16(signBit, 1);\
-    signBit = _mm512_or_si512(signBit, signBit1);\
-    signBit1 = _mm512_and_si512(a, tailBitMask);\
-    signBit1 = _mm512_srli_epi16(signBit1, 2);\
-    signBit1 = _mm512_or_si512(signBit1, signBit);\
-    a = _mm512_subs_epi8(a, signBit1);\
+    __m512i quarter;\
+    quarter = _mm512_srli_epi16(a, 2);\
+    quarter = _mm512_ternarylogic_epi32(quarter, scaleBitMask, scaleSignBit, 0x6A);\
+    quarter = _mm512_sub_epi8(quarter, scaleSignBit);\
+    a = _mm512_subs_epi8(a, quarter);\
 }
 
-int32_t SISO_64windows(int8_t *OutputAddress, int8_t *InputAddress,
-                       int32_t *InterleaverInterRowAddr, int8_t *InterleaverIntraRowPattern, int32_t *InterleaverIntraRowPatSel,
-                       int8_t *Tempalpha_sigma, __m512i *initalpha, __m512i* initbeta, int8_t *tailbeta, int32_t WindowSize,
-                       uint16_t *pCodeBlockBits);
+int32_t SISO_64windows(const struct siso_lanes_64windows *lanes,
+                       int8_t *Tempalpha_sigma, __m512i *initalpha, __m512i* initbeta, const __m512i *tailbeta,
+                       int32_t WindowSize, int32_t *lane_min_dist);
 
 void BitTranspose_16windows_new(int32_t K, uint16_t * pin, uint8_t * pout);
 
-inline void init_beta_comp(int8_t *a, int8_t *c, __m512i* initbeta, int8_t *tailbeta)
+/* CRC24B (C > 1) or CRC24A check of the code block in the output */
+static int32_t crc_check_output(int32_t C, int32_t K, uint8_t *pout)
+{
+    struct bblib_crc_request crc_request;
+    crc_request.data = pout;
+    crc_request.len = ((K >> 3) - 3)*8;
+
+    struct bblib_crc_response crc_response;
+    crc_response.data = crc_request.data;
+
+    if (C > 1)
+    {
+        bblib_lte_crc24b_check_avx512(&crc_request, &crc_response);
+    }
+    else
+    {
+        bblib_lte_crc24a_check_avx512(&crc_request, &crc_response);
+    }
+    return crc_response.check_passed;
+}
+
+/* hard bits of the 16 windows to the output and CRC check of it */
+static int32_t crc_check_16windows(int32_t C, int32_t K, uint16_t *pCodeBlockBits, uint8_t *pout)
+{
+    BitTranspose_16windows_new(K, pCodeBlockBits, pout);
+    return crc_check_output(C, K, pout);
+}
+
+inline void tail_beta_comp(int8_t *a, int8_t *c, int8_t *tailbeta)
 {
 
     int8_t beta[4];
@@ -161,21 +239,19 @@ inline void init_beta_comp(int8_t *a, int8_t *c, __m512i* initbeta, int8_t *tail
     tailbeta[5] = beta[3] + a[0];            /*xk[0]+xk[1]+xk[2]+zk[2]*/
     tailbeta[7] = beta[2] + c[1];            /*zk[1]+xk[2]+zk[2]*/
     tailbeta[6] = tailbeta[7] + tailbeta[1]; /*xk[0]+zk[0]+zk[1]+xk[2]+zk[2]*/
+}
 
-    copy_beta = _mm512_set1_epi8(tailbeta[1]);
-    initbeta[1] = _mm512_mask_blend_epi8 (0x8000000000000000, initbeta[1], copy_beta);
-    copy_beta = _mm512_set1_epi8(tailbeta[2]);
-    initbeta[2] = _mm512_mask_blend_epi8 (0x8000000000000000, initbeta[2], copy_beta);
-    copy_beta = _mm512_set1_epi8(tailbeta[3]);
-    initbeta[3] = _mm512_mask_blend_epi8 (0x8000000000000000, initbeta[3], copy_beta);
-    copy_beta = _mm512_set1_epi8(tailbeta[4]);
-    initbeta[4] = _mm512_mask_blend_epi8 (0x8000000000000000, initbeta[4], copy_beta);
-    copy_beta = _mm512_set1_epi8(tailbeta[5]);
-    initbeta[5] = _mm512_mask_blend_epi8 (0x8000000000000000, initbeta[5], copy_beta);
-    copy_beta = _mm512_set1_epi8(tailbeta[6]);
-    initbeta[6] = _mm512_mask_blend_epi8 (0x8000000000000000, initbeta[6], copy_beta);
-    copy_beta = _mm512_set1_epi8(tailbeta[7]);
-    initbeta[7] = _mm512_mask_blend_epi8 (0x8000000000000000, initbeta[7], copy_beta);
+inline void init_beta_comp(int8_t *a, int8_t *c, __m512i* initbeta, int8_t *tailbeta, __mmask64 tail)
+{
+    tail_beta_comp(a, c, tailbeta);
+
+    initbeta[1] = _mm512_mask_blend_epi8 (tail, initbeta[1], _mm512_set1_epi8(tailbeta[1]));
+    initbeta[2] = _mm512_mask_blend_epi8 (tail, initbeta[2], _mm512_set1_epi8(tailbeta[2]));
+    initbeta[3] = _mm512_mask_blend_epi8 (tail, initbeta[3], _mm512_set1_epi8(tailbeta[3]));
+    initbeta[4] = _mm512_mask_blend_epi8 (tail, initbeta[4], _mm512_set1_epi8(tailbeta[4]));
+    initbeta[5] = _mm512_mask_blend_epi8 (tail, initbeta[5], _mm512_set1_epi8(tailbeta[5]));
+    initbeta[6] = _mm512_mask_blend_epi8 (tail, initbeta[6], _mm512_set1_epi8(tailbeta[6]));
+    initbeta[7] = _mm512_mask_blend_epi8 (tail, initbeta[7], _mm512_set1_epi8(tailbeta[7]));
 }
 
 int32_t bblib_lte_turbo_decoder_64windows_avx512(const struct bblib_turbo_decoder_request *request,
@@ -189,9 +265,9 @@ int32_t bblib_lte_turbo_decoder_64windows_avx512(const struct bblib_turbo_decode
     int32_t NumIter = 0;
     int32_t C = request->c;
     int32_t K = request->k;
-    if ((K&0x3F)!=0)
+    if ((K&0xF)!=0)
     {
-        printf("bblib_lte_turbo_decoder_64windows_avx512: K mod 64 is NOT 0.\n");
+        printf("bblib_lte_turbo_decoder_64windows_avx512: K mod 16 is NOT 0.\n");
         return -1;
     }
     int32_t numMaxIter = request->max_iter_num;
@@ -202,19 +278,22 @@ int32_t bblib_lte_turbo_decoder_64windows_avx512(const struct bblib_turbo_decode
         //numMaxIterUse = numMaxIter;
         numMaxIterUse = numMaxIter;
     int32_t Lwin = K>>4;
-    int32_t Lwin6 = K>>6;            //win size
+    int32_t Lwin6 = (Lwin+3)>>2;     //win size, the last windows end past Lwin when K mod 64 is not 0
     int32_t Kidx = request->k_idx-1; //from 36.211 Table 5.1.3
-    int32_t ofst = g_TurboInterleaver.offset[Kidx];
-    int8_t * pIntraRowPattern = &(g_TurboInterleaver.pattern[0][0]);
+    _TurboInterleaverRows rows;
+    struct turbo_decoder_interleaver interleaver;
+    if (turbo_decoder_interleaver(Kidx, request->flags, &rows, &interleaver) != 0)
+        return -1;
+    int8_t * pIntraRowPattern = interleaver.pattern;
     int8_t * pLLR_tail = request->input;
     uint8_t *pout = response->output;
     int32_t i, j;
 
     /* adapter the interleaver Addr and DeInterleaver Addr for win64 */
-    int32_t * pInterleaverInterRowAddr = &(g_TurboInterleaver.inter_row_out_addr_for_interleaver[ofst]);
-    int32_t * pInterleaverIntraRowPatSel = &(g_TurboInterleaver.intra_row_perm_pattern_for_interleaver[ofst]);
-    int32_t * pDeInterleaverInterRowAddr = &(g_TurboInterleaver.inter_row_out_addr_for_deinterleaver[ofst]);
-    int32_t * pDeInterleaverIntraRowPatSel = &(g_TurboInterleaver.intra_row_perm_pattern_for_deinterleaver[ofst]);
+    int32_t * pInterleaverInterRowAddr = interleaver.inter_row_out_addr_for_interleaver;
+    int32_t * pInterleaverIntraRowPatSel = interleaver.intra_row_perm_pattern_for_interleaver;
+    int32_t * pDeInterleaverInterRowAddr = interleaver.inter_row_out_addr_for_deinterleaver;
+    int32_t * pDeInterleaverIntraRowPatSel = interleaver.intra_row_perm_pattern_for_deinterleaver;
 
     __m512i in_line_addr, out_line_addr;
     int32_t vLen = (Lwin%16==0)?(Lwin>>4):((Lwin>>4)+1);
@@ -229,12 +308,12 @@ int32_t bblib_lte_turbo_decoder_64windows_avx512(const struct bblib_turbo_decode
 
     for(i=0; i<vLen; i++)
     {
-        in_line_addr = _mm512_load_si512((__m512i *)(pInterleaverIntraRowPatSel+i*16));
+        in_line_addr = _mm512_loadu_si512((__m512i *)(pInterleaverIntraRowPatSel+i*16));
         in_line_addr = _mm512_rol_epi32 (in_line_addr, 4);
-        _mm512_store_si512((__m512i *)&InterleaverIntra[i*16], in_line_addr);
-        out_line_addr = _mm512_load_si512((__m512i *)(pInterleaverInterRowAddr+i*16));
+        _mm512_storeu_si512((__m512i *)&InterleaverIntra[i*16], in_line_addr);
+        out_line_addr = _mm512_loadu_si512((__m512i *)(pInterleaverInterRowAddr+i*16));
         out_line_addr = _mm512_add_epi32(_mm512_rol_epi32(out_line_addr, 5),_mm512_rol_epi32(out_line_addr, 4));
-        _mm512_store_si512((__m512i *)&InterleaverInter[i*16], out_line_addr);
+        _mm512_storeu_si512((__m512i *)&InterleaverInter[i*16], out_line_addr);
     }
 
     /* init alpha */
@@ -252,10 +331,16 @@ int32_t bblib_lte_turbo_decoder_64windows_avx512(const struct bblib_turbo_decode
     int8_t x0k[3], z0k[3], x1k[3], z1k[3], tailbeta[8], tailbeta_2[8];
     x0k[0] = *(pLLR_tail); x0k[1] = *(pLLR_tail + 8); x0k[2] = *(pLLR_tail + 5);
     z0k[0] = *(pLLR_tail + 4); z0k[1] = *(pLLR_tail + 1); z0k[2] = *(pLLR_tail + 9);
-    init_beta_comp(x0k, z0k, initbeta, tailbeta);
+    init_beta_comp(x0k, z0k, initbeta, tailbeta, tail_window_64windows(16));
     x1k[0] = *(pLLR_tail + 2); x1k[1] = *(pLLR_tail + 10); x1k[2] = *(pLLR_tail + 7);
     z1k[0] = *(pLLR_tail + 6); z1k[1] = *(pLLR_tail + 3); z1k[2] = *(pLLR_tail + 11);
-    init_beta_comp(x1k, z1k, initbeta_2, tailbeta_2);
+    init_beta_comp(x1k, z1k, initbeta_2, tailbeta_2, tail_window_64windows(16));
+    __m512i tailbeta_v[8], tailbeta_v2[8];
+    for (i = 1; i < 8; i++)
+    {
+        tailbeta_v[i] = _mm512_set1_epi8(tailbeta[i]);
+        tailbeta_v2[i] = _mm512_set1_epi8(tailbeta_2[i]);
+    }
 
     /* Preparing for iteration */
     /* xtrinsic information, LLR for systematic bits, LLR for parity bits */
@@ -264,43 +349,38 @@ int32_t bblib_lte_turbo_decoder_64windows_avx512(const struct bblib_turbo_decode
 
     int8_t* pAG = response->ag_buf; //pAG = &(AG[0][0]);
     uint16_t* p_winCodeBlockBits = response->cb_buf;
+
+    /* lane g runs rows g*Lwin6 to (g+1)*Lwin6-1 of the code block */
+    struct siso_lanes_64windows lanes, lanes_2;
+    for (i = 0; i < 4; i++)
+    {
+        lanes.output[i] = pLeXP2;
+        lanes.input[i] = pLeXP1 + 48 * i * Lwin6;
+        lanes.pattern[i] = pIntraRowPattern;
+        lanes.pattern_sel[i] = InterleaverIntra + i * Lwin6;
+        lanes.row_addr[i] = InterleaverInter + i * Lwin6;
+        lanes.cb_bits[i] = p_winCodeBlockBits + i * Lwin6;
+        lanes.rows[i] = (Lwin - i * Lwin6 < Lwin6) ? Lwin - i * Lwin6 : Lwin6;
+        if (lanes.rows[i] < 0)
+            lanes.rows[i] = 0;
+    }
+    lanes.separate_cb = 0;
+    lanes.windows = 16;
+    lanes_2 = lanes;
+
     int32_t min_dist;
+    const int32_t early_term_min_dist = turbo_early_term_min_dist(numMaxIter, request->early_term_disable);
     if (numMaxIter != 0)
     {
-        min_dist = SISO_64windows(pLeXP2, pLeXP1,
-                                  InterleaverInter, pIntraRowPattern, InterleaverIntra,
-                                  pAG, initalpha, initbeta, tailbeta, Lwin6,
-                                  p_winCodeBlockBits);
+        min_dist = SISO_64windows(&lanes, pAG, initalpha, initbeta, tailbeta_v, Lwin6, NULL);
         NumIter++;
-        if ((min_dist > 2) && (numMaxIter != 0))
+        if (min_dist > early_term_min_dist)
         {
-            BitTranspose_16windows_new(K, p_winCodeBlockBits, pout);
-
-            struct bblib_crc_request crc_request;
-            crc_request.data = pout;
-            crc_request.len = ((K >> 3) - 3)*8;
-
-            struct bblib_crc_response crc_response;
-            crc_response.data = crc_request.data;
-
-
-            if (C > 1)
+            if (crc_check_16windows(C, K, p_winCodeBlockBits, pout))
             {
-                bblib_lte_crc24b_check_avx512(&crc_request, &crc_response);
+                response->crc_status = 1;
+                return NumIter;
             }
-            else
-            {
-                bblib_lte_crc24a_check_avx512(&crc_request, &crc_response);
-            }
-            if (crc_response.check_passed)
-            {
-                if (request->early_term_disable == 0)
-                {
-                    response->crc_status = 1;
-                    return NumIter;
-                }
-            }
-
         }
     }
 
@@ -348,74 +428,38 @@ int32_t bblib_lte_turbo_decoder_64windows_avx512(const struct bblib_turbo_decode
     int32_t DeInterleaverInter[vLen*16];
     for(i=0; i<vLen; i++)
     {
-        in_line_addr = _mm512_load_si512((__m512i *)(pDeInterleaverIntraRowPatSel+i*16));
+        in_line_addr = _mm512_loadu_si512((__m512i *)(pDeInterleaverIntraRowPatSel+i*16));
         in_line_addr = _mm512_rol_epi32 (in_line_addr, 4);                                                      //*16
-        _mm512_store_si512((__m512i *)&DeInterleaverIntra[i*16], in_line_addr);
-        out_line_addr = _mm512_load_si512((__m512i *)(pDeInterleaverInterRowAddr+i*16));
+        _mm512_storeu_si512((__m512i *)&DeInterleaverIntra[i*16], in_line_addr);
+        out_line_addr = _mm512_loadu_si512((__m512i *)(pDeInterleaverInterRowAddr+i*16));
         out_line_addr = _mm512_add_epi32(_mm512_rol_epi32(out_line_addr, 5),_mm512_rol_epi32(out_line_addr, 4));//*48
-        _mm512_store_si512((__m512i *)&DeInterleaverInter[i*16], out_line_addr);
+        _mm512_storeu_si512((__m512i *)&DeInterleaverInter[i*16], out_line_addr);
+    }
+    for (i = 0; i < 4; i++)
+    {
+        lanes_2.output[i] = pLeXP1;
+        lanes_2.input[i] = pLeXP2 + 48 * i * Lwin6;
+        lanes_2.pattern_sel[i] = DeInterleaverIntra + i * Lwin6;
+        lanes_2.row_addr[i] = DeInterleaverInter + i * Lwin6;
     }
 
     for (j = 0; j < numMaxIterUse; j++)
     {
-        SISO_64windows(pLeXP1, pLeXP2,
-                       DeInterleaverInter, pIntraRowPattern, DeInterleaverIntra,
-                       pAG, initalpha_2, initbeta_2, tailbeta_2, Lwin6,
-                       p_winCodeBlockBits);
+        SISO_64windows(&lanes_2, pAG, initalpha_2, initbeta_2, tailbeta_v2, Lwin6, NULL);
         NumIter++;
-        min_dist = SISO_64windows(pLeXP2, pLeXP1,
-                                  InterleaverInter, pIntraRowPattern, InterleaverIntra,
-                                  pAG, initalpha, initbeta, tailbeta, Lwin6,
-                                  p_winCodeBlockBits);
+        min_dist = SISO_64windows(&lanes, pAG, initalpha, initbeta, tailbeta_v, Lwin6, NULL);
         NumIter++;
 
-        if ((min_dist > 2) && (numMaxIter != 0))
+        if (min_dist > early_term_min_dist)
         {
-            BitTranspose_16windows_new(K, p_winCodeBlockBits, pout);
-            struct bblib_crc_request crc_request;
-            crc_request.data = pout;
-            crc_request.len = ((K >> 3) - 3)*8;
-
-            struct bblib_crc_response crc_response;
-            crc_response.data = crc_request.data;
-
-
-            if (C > 1)
-            {
-                bblib_lte_crc24b_check_avx512(&crc_request, &crc_response);
-            }
-            else
-            {
-                bblib_lte_crc24a_check_avx512(&crc_request, &crc_response);
-            }
-            if (crc_response.check_passed)
+            if (crc_check_16windows(C, K, p_winCodeBlockBits, pout))
             {
-                if (request->early_term_disable == 0)
-                {
-                    response->crc_status = 1;
-                    return NumIter;
-                }
+                response->crc_status = 1;
+                return NumIter;
             }
         }
     }
-    BitTranspose_16windows_new(K, p_winCodeBlockBits, pout);
-
-    struct bblib_crc_request crc_request;
-    crc_request.data = pout;
-    crc_request.len = (K/8 - 3)*8;
-
-    struct bblib_crc_response crc_response;
-    crc_response.data = crc_request.data;
-
-    if (C > 1)
-    {
-        bblib_lte_crc24b_check_avx512(&crc_request, &crc_response);
-    }
-    else
-    {
-        bblib_lte_crc24a_check_avx512(&crc_request, &crc_response);
-    }
-    if (crc_response.check_passed)
+    if (crc_check_16windows(C, K, p_winCodeBlockBits, pout))
     {
         response->crc_status = 1;
     }
@@ -426,22 +470,28 @@ int32_t bblib_lte_turbo_decoder_64windows_avx512(const struct bblib_turbo_decode
 /* return val is 0.75*a */
 
 
-// OutputAddress                          <--pLeXP2
-// InputAddress                           <--pLeXP1
-// InterleaverInterRowAddr
-// InterleaverIntraRowPattern
-// InterleaverIntraRowPatSel
+// lanes                                  input, output and interleaver rows of each lane
 // Tempalpha_sigma                        <--pAG
 // initalpha
 // initbeta
-// tailbeta
-// WindowSize                             <--Lwin6
-// pCodeBlockBits                         <--p_winCodeBlockBits
-
-int32_t SISO_64windows(int8_t *OutputAddress, int8_t *InputAddress,
-          int32_t *InterleaverInterRowAddr, int8_t *InterleaverIntraRowPattern, int32_t *InterleaverIntraRowPatSel,
-          int8_t *Tempalpha_sigma, __m512i *initalpha, __m512i* initbeta, int8_t *tailbeta, int32_t WindowSize,
-          uint16_t *pCodeBlockBits)
+// tailbeta                               beta inserted at the end of the code blocks
+// WindowSize                             <--Lwin6, at least the rows of each lane
+// lane_min_dist                          min distance of each lane, may be NULL
+//
+// Each 128-bit lane of a register runs lanes->rows[g] rows of 16 windows. Rows past that, at the
+// end of the last lanes when Lwin is not a multiple of 4 or of the shorter code blocks when each
+// lane is a code block of its own, read zeros, leave the alpha and beta of their lanes unchanged
+// and are not written back, so those windows are just shorter. With lanes->windows 8 the bytes 8
+// to 15 of the lanes are left out of the min distance, what they compute is never read.
+//
+// Each row is one trellis step (radix-2). With 64 windows side by side a half iteration is bound by
+// the vector ops per step, not by the latency of the alpha and beta recursions, and a radix-4 step
+// would need about twice the adds and max per decoded bit for its 4 branches per state and the
+// joint LLR of the 2 bits.
+
+int32_t SISO_64windows(const struct siso_lanes_64windows *lanes,
+          int8_t *Tempalpha_sigma, __m512i *initalpha, __m512i* initbeta, const __m512i *tailbeta,
+          int32_t WindowSize, int32_t *lane_min_dist)
 {
     __align(64) __m512i alpha0, alpha1, alpha2, alpha3, alpha4, alpha5, alpha6, alpha7;
     __align(64) __m512i beta0, beta1, beta2, beta3, beta4, beta5, beta6, beta7;
@@ -457,19 +507,44 @@ int32_t SISO_64windows(int8_t *OutputAddress, int8_t *InputAddress,
     __m512i min_distance = _mm512_set1_epi8(127);
     __m512i* output_addr = (__m512i *)(Tempalpha_sigma);
 
-    __m128i* input_addr0 = (__m128i *)(InputAddress);
-    __m128i* input_addr1 = (__m128i *)(InputAddress) +   3*WindowSize;
-    __m128i* input_addr2 = (__m128i *)(InputAddress) + 2*3*WindowSize;
-    __m128i* input_addr3 = (__m128i *)(InputAddress) + 3*3*WindowSize;
+    __m128i* input_addr0 = (__m128i *)(lanes->input[0]);
+    __m128i* input_addr1 = (__m128i *)(lanes->input[1]);
+    __m128i* input_addr2 = (__m128i *)(lanes->input[2]);
+    __m128i* input_addr3 = (__m128i *)(lanes->input[3]);
+
+    /* local copies, the stores below may alias lanes */
+    int8_t *OutputAddress[4], *InterleaverIntraRowPattern[4];
+    int32_t *InterleaverInterRowAddr[4], *InterleaverIntraRowPatSel[4];
+    uint16_t *pCodeBlockBits[4];
+    int32_t rows[4];
 
     int32_t in_line_addr0, in_line_addr1, in_line_addr2, in_line_addr3;
     int32_t out_line_addr0, out_line_addr1, out_line_addr2, out_line_addr3;
 
     __m256i delta_tmp0, delta_tmp1;
-    __m128i min0, min1;
+    __m128i min0, min1, vtmp;
 
     int32_t i,j;
-    int32_t bitWord0, bitWord1;
+    __mmask64 bitWord;
+    int32_t FullSteps = WindowSize; /* steps with the 4 lanes inside their code blocks */
+    const __mmask64 all_valid = (__mmask64)-1;
+    const __mmask64 windows = (lanes->windows == 8) ? 0x00FF00FF00FF00FF : all_valid;
+    const __mmask64 tail = tail_window_64windows(lanes->windows);
+    __mmask64 valid;
+    __align(64) int8_t extrinsic[64];
+    uint16_t bitWords[4];
+
+    for (j = 0; j < 4; j++)
+    {
+        OutputAddress[j] = lanes->output[j];
+        InterleaverIntraRowPattern[j] = lanes->pattern[j];
+        InterleaverIntraRowPatSel[j] = lanes->pattern_sel[j];
+        InterleaverInterRowAddr[j] = lanes->row_addr[j];
+        pCodeBlockBits[j] = lanes->cb_bits[j];
+        rows[j] = lanes->rows[j];
+        if (rows[j] < FullSteps)
+            FullSteps = rows[j];
+    }
 
      //aligned 256 bit
     initalpha1 = _mm512_load_si512(initalpha + 1);
@@ -488,6 +563,20 @@ int32_t SISO_64windows(int8_t *OutputAddress, int8_t *InputAddress,
     
     for (i = 0; i < WindowSize; i++)
     {
+        valid = all_valid;
+        if (i >= FullSteps)
+        {
+            valid = valid_rows_64windows(rows, i);
+            if (i >= rows[0])
+                input_addr0 = TD_zero_row;
+            if (i >= rows[1])
+                input_addr1 = TD_zero_row;
+            if (i >= rows[2])
+                input_addr2 = TD_zero_row;
+            if (i >= rows[3])
+                input_addr3 = TD_zero_row;
+        }
+
         //xe = _mm512_load_si512(input_addr++); /* load extrinsic information */
         xe = _mm512_inserti32x4(xe, *input_addr0++, 0);
         xe = _mm512_inserti32x4(xe, *input_addr1++, 1);
@@ -585,6 +674,17 @@ int32_t SISO_64windows(int8_t *OutputAddress, int8_t *InputAddress,
         //alpha7 = _mm512_subs_epi8(alpha7, alpha0);
         CALC_ALPHA_BETA(initalpha7, initalpha6, xa, TD_Offset, tmpalpha0[7], tmpalpha1[7], alpha0, alpha7);
 
+        if (valid != all_valid)
+        {
+            alpha1 = _mm512_mask_blend_epi8(valid, initalpha1, alpha1);
+            alpha2 = _mm512_mask_blend_epi8(valid, initalpha2, alpha2);
+            alpha3 = _mm512_mask_blend_epi8(valid, initalpha3, alpha3);
+            alpha4 = _mm512_mask_blend_epi8(valid, initalpha4, alpha4);
+            alpha5 = _mm512_mask_blend_epi8(valid, initalpha5, alpha5);
+            alpha6 = _mm512_mask_blend_epi8(valid, initalpha6, alpha6);
+            alpha7 = _mm512_mask_blend_epi8(valid, initalpha7, alpha7);
+        }
+
         initalpha1 = alpha1;
         initalpha2 = alpha2;
         initalpha3 = alpha3;
@@ -594,13 +694,35 @@ int32_t SISO_64windows(int8_t *OutputAddress, int8_t *InputAddress,
         initalpha7 = alpha7;
     }
 
-    SHUFFLE_ALPHA (initalpha1, initalpha[1]);
-    SHUFFLE_ALPHA (initalpha2, initalpha[2]);
-    SHUFFLE_ALPHA (initalpha3, initalpha[3]);
-    SHUFFLE_ALPHA (initalpha4, initalpha[4]);
-    SHUFFLE_ALPHA (initalpha5, initalpha[5]);
-    SHUFFLE_ALPHA (initalpha6, initalpha[6]);
-    SHUFFLE_ALPHA (initalpha7, initalpha[7]);
+    /* lanes left out keep their alpha and beta for the next iter */
+    const __mmask64 lanes_run = valid_rows_64windows(rows, 0);
+    if (lanes->separate_cb)
+    {
+        SHIFT_ALPHA_LANES (initalpha1, alpha1);
+        SHIFT_ALPHA_LANES (initalpha2, alpha2);
+        SHIFT_ALPHA_LANES (initalpha3, alpha3);
+        SHIFT_ALPHA_LANES (initalpha4, alpha4);
+        SHIFT_ALPHA_LANES (initalpha5, alpha5);
+        SHIFT_ALPHA_LANES (initalpha6, alpha6);
+        SHIFT_ALPHA_LANES (initalpha7, alpha7);
+        initalpha[1] = _mm512_mask_blend_epi8(lanes_run, initalpha[1], alpha1);
+        initalpha[2] = _mm512_mask_blend_epi8(lanes_run, initalpha[2], alpha2);
+        initalpha[3] = _mm512_mask_blend_epi8(lanes_run, initalpha[3], alpha3);
+        initalpha[4] = _mm512_mask_blend_epi8(lanes_run, initalpha[4], alpha4);
+        initalpha[5] = _mm512_mask_blend_epi8(lanes_run, initalpha[5], alpha5);
+        initalpha[6] = _mm512_mask_blend_epi8(lanes_run, initalpha[6], alpha6);
+        initalpha[7] = _mm512_mask_blend_epi8(lanes_run, initalpha[7], alpha7);
+    }
+    else
+    {
+        SHUFFLE_ALPHA (initalpha1, initalpha[1]);
+        SHUFFLE_ALPHA (initalpha2, initalpha[2]);
+        SHUFFLE_ALPHA (initalpha3, initalpha[3]);
+        SHUFFLE_ALPHA (initalpha4, initalpha[4]);
+        SHUFFLE_ALPHA (initalpha5, initalpha[5]);
+        SHUFFLE_ALPHA (initalpha6, initalpha[6]);
+        SHUFFLE_ALPHA (initalpha7, initalpha[7]);
+    }
 
     /* calculate beta */
     initbeta1 = _mm512_load_si512(initbeta + 1);
@@ -614,6 +736,8 @@ int32_t SISO_64windows(int8_t *OutputAddress, int8_t *InputAddress,
 
     for (i = WindowSize-1;i >= 0; i--)
     {
+        valid = (i >= FullSteps) ? valid_rows_64windows(rows, i) : all_valid;
+
         /* load alpha, xs, xp and xa */
         alpha7 = _mm512_load_si512(output_addr--);
         alpha6 = _mm512_load_si512(output_addr--);
@@ -717,42 +841,59 @@ int32_t SISO_64windows(int8_t *OutputAddress, int8_t *InputAddress,
 #ifdef _LOG_P1_P0
         delta = _mm512_subs_epi8(TD_constant512, delta);// 0-delta
 #endif
-        //delta = _mm512_shuffle_epi8(delta, TD_constant_0_63);
-        delta_tmp0 = _mm512_extracti32x8_epi32(delta, 0);      //low 128
-        delta_tmp1 = _mm512_extracti32x8_epi32(delta, 1);
-        //delta_tmp0 = _mm256_shuffle_epi8(delta_tmp0, TD_constant_0_16);
-        //delta_tmp1 = _mm256_shuffle_epi8(delta_tmp1, TD_constant_0_16);
-        bitWord0 = _mm256_movemask_epi8(delta_tmp0);  //get the sign bit (7bit) for each 8 intergrate number, put to int_16 for each bit
-        bitWord1 = _mm256_movemask_epi8(delta_tmp1);
-        *(pCodeBlockBits + i) = bitWord0;
-        *(pCodeBlockBits + WindowSize+ i) = bitWord0 >> 16;
-        *(pCodeBlockBits + 2*WindowSize+ i) = bitWord1;
-        *(pCodeBlockBits + 3*WindowSize+ i) = bitWord1 >> 16;
+        bitWord = _mm512_movepi8_mask(delta);  //get the sign bit of each window, 16 bits per lane
 
         delta = _mm512_abs_epi8(delta);
-        min_distance  = _mm512_min_epi8(min_distance, delta); //store the min distance for each win
-
-        /* save extrinsic after interleaver */
-        in_line_addr0 = *(InterleaverIntraRowPatSel + i);
-        in_line_addr1 = *(InterleaverIntraRowPatSel + i +   WindowSize);
-        in_line_addr2 = *(InterleaverIntraRowPatSel + i + 2*WindowSize);
-        in_line_addr3 = *(InterleaverIntraRowPatSel + i + 3*WindowSize);
-
-        out_line_addr0 = *(InterleaverInterRowAddr + i);
-        out_line_addr1 = *(InterleaverInterRowAddr + i + WindowSize);
-        out_line_addr2 = *(InterleaverInterRowAddr + i + 2*WindowSize);
-        out_line_addr3 = *(InterleaverInterRowAddr + i + 3*WindowSize);
-
-        delta1 = _mm512_inserti32x4(delta1, *(__m128i *)(InterleaverIntraRowPattern+in_line_addr0), 0);
-        delta1 = _mm512_inserti32x4(delta1, *(__m128i *)(InterleaverIntraRowPattern+in_line_addr1), 1);
-        delta1 = _mm512_inserti32x4(delta1, *(__m128i *)(InterleaverIntraRowPattern+in_line_addr2), 2);
-        delta1 = _mm512_inserti32x4(delta1, *(__m128i *)(InterleaverIntraRowPattern+in_line_addr3), 3);
-        delta0 = _mm512_shuffle_epi8(delta0, delta1);
-
-        delta_tmp0= _mm512_extracti32x8_epi32(delta0, 0);
-        delta_tmp1= _mm512_extracti32x8_epi32(delta0, 1);
-        _mm256_storeu2_m128i((__m128i *)(OutputAddress + out_line_addr1), (__m128i *)(OutputAddress + out_line_addr0), delta_tmp0);
-        _mm256_storeu2_m128i((__m128i *)(OutputAddress + out_line_addr3), (__m128i *)(OutputAddress + out_line_addr2), delta_tmp1);
+        min_distance  = _mm512_mask_min_epi8(min_distance, valid & windows, min_distance, delta); //store the min distance for each win
+
+        if (valid != all_valid)
+        {
+            /* hard bits and extrinsic after interleaver of the groups still inside the code block */
+            bitWords[0] = bitWord;
+            bitWords[1] = bitWord >> 16;
+            bitWords[2] = bitWord >> 32;
+            bitWords[3] = bitWord >> 48;
+            _mm512_store_si512((__m512i *)extrinsic, delta0);
+            for (j = 0; j < 4; j++)
+            {
+                if (i < rows[j])
+                {
+                    *(pCodeBlockBits[j] + i) = bitWords[j];
+                    vtmp = _mm_load_si128((__m128i const*)(InterleaverIntraRowPattern[j] + *(InterleaverIntraRowPatSel[j] + i)));
+                    vtmp = _mm_shuffle_epi8(_mm_load_si128((__m128i const*)(extrinsic + 16*j)), vtmp);
+                    _mm_storeu_si128((__m128i *)(OutputAddress[j] + *(InterleaverInterRowAddr[j] + i)), vtmp);
+                }
+            }
+        }
+        else
+        {
+            *(pCodeBlockBits[0] + i) = bitWord;
+            *(pCodeBlockBits[1] + i) = bitWord >> 16;
+            *(pCodeBlockBits[2] + i) = bitWord >> 32;
+            *(pCodeBlockBits[3] + i) = bitWord >> 48;
+
+            /* save extrinsic after interleaver */
+            in_line_addr0 = *(InterleaverIntraRowPatSel[0] + i);
+            in_line_addr1 = *(InterleaverIntraRowPatSel[1] + i);
+            in_line_addr2 = *(InterleaverIntraRowPatSel[2] + i);
+            in_line_addr3 = *(InterleaverIntraRowPatSel[3] + i);
+
+            out_line_addr0 = *(InterleaverInterRowAddr[0] + i);
+            out_line_addr1 = *(InterleaverInterRowAddr[1] + i);
+            out_line_addr2 = *(InterleaverInterRowAddr[2] + i);
+            out_line_addr3 = *(InterleaverInterRowAddr[3] + i);
+
+            delta1 = _mm512_inserti32x4(delta1, *(__m128i *)(InterleaverIntraRowPattern[0]+in_line_addr0), 0);
+            delta1 = _mm512_inserti32x4(delta1, *(__m128i *)(InterleaverIntraRowPattern[1]+in_line_addr1), 1);
+            delta1 = _mm512_inserti32x4(delta1, *(__m128i *)(InterleaverIntraRowPattern[2]+in_line_addr2), 2);
+            delta1 = _mm512_inserti32x4(delta1, *(__m128i *)(InterleaverIntraRowPattern[3]+in_line_addr3), 3);
+            delta0 = _mm512_shuffle_epi8(delta0, delta1);
+
+            delta_tmp0= _mm512_extracti32x8_epi32(delta0, 0);
+            delta_tmp1= _mm512_extracti32x8_epi32(delta0, 1);
+            _mm256_storeu2_m128i((__m128i *)(OutputAddress[1] + out_line_addr1), (__m128i *)(OutputAddress[0] + out_line_addr0), delta_tmp0);
+            _mm256_storeu2_m128i((__m128i *)(OutputAddress[3] + out_line_addr3), (__m128i *)(OutputAddress[2] + out_line_addr2), delta_tmp1);
+        }
 
         xs = _mm512_adds_epi8(xs, TD_Offset);// avoid saturation
         /******** update beta ********/
@@ -811,6 +952,17 @@ int32_t SISO_64windows(int8_t *OutputAddress, int8_t *InputAddress,
         //beta7 = _mm512_subs_epi8(beta7, beta0);
         CALC_ALPHA_BETA(initbeta7, initbeta3, xa, TD_Offset, tmpbeta0[7], tmpbeta1[7], beta0, beta7);
 
+        if (valid != all_valid)
+        {
+            beta1 = _mm512_mask_blend_epi8(valid, initbeta1, beta1);
+            beta2 = _mm512_mask_blend_epi8(valid, initbeta2, beta2);
+            beta3 = _mm512_mask_blend_epi8(valid, initbeta3, beta3);
+            beta4 = _mm512_mask_blend_epi8(valid, initbeta4, beta4);
+            beta5 = _mm512_mask_blend_epi8(valid, initbeta5, beta5);
+            beta6 = _mm512_mask_blend_epi8(valid, initbeta6, beta6);
+            beta7 = _mm512_mask_blend_epi8(valid, initbeta7, beta7);
+        }
+
         initbeta1 = beta1;
         initbeta2 = beta2;
         initbeta3 = beta3;
@@ -821,13 +973,45 @@ int32_t SISO_64windows(int8_t *OutputAddress, int8_t *InputAddress,
     }
 
     //shuffle the beta state and insert init value
-    SHUFFLE_BETA(tailbeta[1], initbeta1, initbeta[1]);
-    SHUFFLE_BETA(tailbeta[2], initbeta2, initbeta[2]);
-    SHUFFLE_BETA(tailbeta[3], initbeta3, initbeta[3]);
-    SHUFFLE_BETA(tailbeta[4], initbeta4, initbeta[4]);
-    SHUFFLE_BETA(tailbeta[5], initbeta5, initbeta[5]);
-    SHUFFLE_BETA(tailbeta[6], initbeta6, initbeta[6]);
-    SHUFFLE_BETA(tailbeta[7], initbeta7, initbeta[7]);
+    if (lanes->separate_cb)
+    {
+        SHIFT_BETA_LANES(tailbeta[1], initbeta1, beta1);
+        SHIFT_BETA_LANES(tailbeta[2], initbeta2, beta2);
+        SHIFT_BETA_LANES(tailbeta[3], initbeta3, beta3);
+        SHIFT_BETA_LANES(tailbeta[4], initbeta4, beta4);
+        SHIFT_BETA_LANES(tailbeta[5], initbeta5, beta5);
+        SHIFT_BETA_LANES(tailbeta[6], initbeta6, beta6);
+        SHIFT_BETA_LANES(tailbeta[7], initbeta7, beta7);
+        initbeta[1] = _mm512_mask_blend_epi8(lanes_run, initbeta[1], beta1);
+        initbeta[2] = _mm512_mask_blend_epi8(lanes_run, initbeta[2], beta2);
+        initbeta[3] = _mm512_mask_blend_epi8(lanes_run, initbeta[3], beta3);
+        initbeta[4] = _mm512_mask_blend_epi8(lanes_run, initbeta[4], beta4);
+        initbeta[5] = _mm512_mask_blend_epi8(lanes_run, initbeta[5], beta5);
+        initbeta[6] = _mm512_mask_blend_epi8(lanes_run, initbeta[6], beta6);
+        initbeta[7] = _mm512_mask_blend_epi8(lanes_run, initbeta[7], beta7);
+    }
+    else
+    {
+        SHUFFLE_BETA(tail, tailbeta[1], initbeta1, initbeta[1]);
+        SHUFFLE_BETA(tail, tailbeta[2], initbeta2, initbeta[2]);
+        SHUFFLE_BETA(tail, tailbeta[3], initbeta3, initbeta[3]);
+        SHUFFLE_BETA(tail, tailbeta[4], initbeta4, initbeta[4]);
+        SHUFFLE_BETA(tail, tailbeta[5], initbeta5, initbeta[5]);
+        SHUFFLE_BETA(tail, tailbeta[6], initbeta6, initbeta[6]);
+        SHUFFLE_BETA(tail, tailbeta[7], initbeta7, initbeta[7]);
+    }
+
+    if (lane_min_dist != NULL)
+    {
+        /* min of the 16 windows of each lane, in byte 0 of the lane */
+        delta = _mm512_min_epi8(min_distance, _mm512_alignr_epi8(min_distance, min_distance, 8));
+        delta = _mm512_min_epi8(delta, _mm512_alignr_epi8(delta, delta, 4));
+        delta = _mm512_min_epi8(delta, _mm512_alignr_epi8(delta, delta, 2));
+        delta = _mm512_min_epi8(delta, _mm512_alignr_epi8(delta, delta, 1));
+        _mm512_store_si512((__m512i *)extrinsic, delta);
+        for (j = 0; j < 4; j++)
+            lane_min_dist[j] = extrinsic[16*j];
+    }
 
     delta_tmp0 = _mm512_extracti32x8_epi32(min_distance, 0);
     delta_tmp1 = _mm512_extracti32x8_epi32(min_distance, 1);
@@ -936,12 +1120,462 @@ void BitTranspose_16windows_new(int32_t K, uint16_t * pin, uint8_t * pout)
         }
         if (resBitNum!=0)
         {
+            /* only (resBitNum+7)/8 bytes are left in the output when Lwin is not a multiple of 4 */
             vnow = _mm_shuffle_epi8(vnow, TD_vshuf2_BitTranspose_16windows);           /* big endian to little endian*/
-            _mm_storel_epi64((__m128i *)pout, vnow);
+            _mm_mask_storeu_epi8(pout, (__mmask16)((1 << ((resBitNum + 7) >> 3)) - 1), vnow);
+        }
+    }
+}
+
+/* K/8 of the code blocks with K not a multiple of 16, at most 504 */
+#define TURBO_8WINDOWS_MAX_LWIN 64
+
+static const __m128i TD_vshuf_8windows_pairs = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+static const __m512i TD_vshuf_8windows_reverse = _mm512_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                                                                 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                                                                 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                                                                 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+/* (systematic, parity) LLR pairs of the 8 windows decoder input, bit j*Lwin+i at pairs[2*(j*Lwin+i)],
+   to rows i of 48 bytes [0, systematic, parity] with window j in byte j, bytes 8 to 15 zero. The rows
+   are written 8 at a time, out holds Lwin rounded up to 8 of them. */
+static void rows_8windows(const int8_t *pairs, int32_t Lwin, int8_t *out)
+{
+    __m128i a[8], t[8], u[8], r;
+    __mmask8 load;
+    int32_t i, j;
+
+    for (i = 0; i < Lwin; i += 8)
+    {
+        /* rows i to i+7 of each window, as 16 bits pairs */
+        load = (Lwin - i < 8) ? (__mmask8)((1 << (Lwin - i)) - 1) : (__mmask8)0xFF;
+        for (j = 0; j < 8; j++)
+        {
+            a[j] = _mm_maskz_loadu_epi16(load, pairs + 2 * (j * Lwin + i));
+        }
+
+        /* 8x8 transpose of the 16 bits pairs */
+        for (j = 0; j < 4; j++)
+        {
+            t[2 * j] = _mm_unpacklo_epi16(a[2 * j], a[2 * j + 1]);
+            t[2 * j + 1] = _mm_unpackhi_epi16(a[2 * j], a[2 * j + 1]);
+        }
+        u[0] = _mm_unpacklo_epi32(t[0], t[2]);
+        u[1] = _mm_unpackhi_epi32(t[0], t[2]);
+        u[2] = _mm_unpacklo_epi32(t[1], t[3]);
+        u[3] = _mm_unpackhi_epi32(t[1], t[3]);
+        u[4] = _mm_unpacklo_epi32(t[4], t[6]);
+        u[5] = _mm_unpackhi_epi32(t[4], t[6]);
+        u[6] = _mm_unpacklo_epi32(t[5], t[7]);
+        u[7] = _mm_unpackhi_epi32(t[5], t[7]);
+
+        for (j = 0; j < 8; j++)
+        {
+            r = (j & 1) ? _mm_unpackhi_epi64(u[j >> 1], u[(j >> 1) + 4]) : _mm_unpacklo_epi64(u[j >> 1], u[(j >> 1) + 4]);
+            r = _mm_shuffle_epi8(r, TD_vshuf_8windows_pairs);
+            _mm_store_si128((__m128i *)(out + 48 * (i + j)), _mm_setzero_si128());
+            _mm_store_si128((__m128i *)(out + 48 * (i + j) + 16), _mm_move_epi64(r));
+            _mm_store_si128((__m128i *)(out + 48 * (i + j) + 32), _mm_srli_si128(r, 8));
+        }
+    }
+}
+
+/* hard bits of the 8 windows, bit j of row i, to the output as bit j*Lwin+i, MSB first */
+static void BitTranspose_8windows(int32_t K, const uint16_t *pin, uint8_t *pout)
+{
+    int32_t Lwin = K >> 3;
+    int32_t n = 0, j;
+    uint64_t acc = 0, bits;
+    const uint64_t rows = ((uint64_t)1 << Lwin) - 1;
+    __m256i lo, hi;
+    __m512i v;
+
+    /* row i in byte 63-i, so that the mask of a window has its first row in the MSB */
+    lo = _mm512_cvtepi16_epi8(_mm512_maskz_loadu_epi16((__mmask32)rows, pin));
+    hi = _mm512_cvtepi16_epi8(_mm512_maskz_loadu_epi16((__mmask32)(rows >> 32), pin + 32));
+    v = _mm512_inserti64x4(_mm512_castsi256_si512(lo), hi, 1);
+    v = _mm512_shuffle_i64x2(v, v, 0x1B);
+    v = _mm512_shuffle_epi8(v, TD_vshuf_8windows_reverse);
+
+    for (j = 0; j < 8; j++)
+    {
+        bits = _mm512_test_epi8_mask(v, _mm512_set1_epi8((char)(1 << j)));
+        acc |= bits >> n;
+        n += Lwin;
+        if (n >= 64)
+        {
+            n -= 64;
+            *(uint64_t *)pout = __builtin_bswap64(acc);
+            pout += 8;
+            acc = (n != 0) ? bits << (Lwin - n) : 0;
+        }
+    }
+    for (j = 0; j < (n >> 3); j++)
+    {
+        pout[j] = (uint8_t)(acc >> (56 - 8 * j));
+    }
+}
+
+/* hard bits of the 8 windows to the output and CRC check of it */
+static int32_t crc_check_8windows(int32_t C, int32_t K, uint16_t *pCodeBlockBits, uint8_t *pout)
+{
+    BitTranspose_8windows(K, pCodeBlockBits, pout);
+    return crc_check_output(C, K, pout);
+}
+
+/* Code blocks with K not a multiple of 16 read the input of bblib_lte_turbo_decoder_8windows_sse,
+   8 windows of K/8 bits, and run them in bytes 0 to 7 of the 4 lanes of SISO_64windows, as the 64
+   windows decoder does with 16 windows. The LLRs are repacked to rows of 48 bytes on the stack, the
+   input is only read. Iterations, early termination and CRC status follow the 8 windows SSE decoder,
+   but windows of 5 to 63 rows in the 8 bits SISO have many more block errors than it on noisy code
+   blocks, so bblib_turbo_decoder keeps the SSE decoder for these K. */
+int32_t bblib_lte_turbo_decoder_8windows_avx512(const struct bblib_turbo_decoder_request *request,
+                                                struct bblib_turbo_decoder_response *response)
+{
+    if (request == NULL || response == NULL || request->input == NULL || response->output == NULL ||
+        response->ag_buf == NULL)
+    {
+        printf("bblib_lte_turbo_decoder_8windows_avx512 input address invalid \n");
+        return -1;
+    }
+    int32_t C = request->c;
+    int32_t K = request->k;
+    int32_t Kidx = request->k_idx - 1; //from 36.211 Table 5.1.3
+    if ((K & 0xF) == 0 || Kidx < 0 || Kidx > 187 || g_TurboQPP_sdk[Kidx][0] != K)
+    {
+        printf("bblib_lte_turbo_decoder_8windows_avx512: Not 8 windows Turbo Code.\n");
+        return -1;
+    }
+    int32_t Lwin = K >> 3;
+    int32_t Lwin4 = (Lwin + 3) >> 2; //rows of each lane, the last lanes end past Lwin when Lwin mod 4 is not 0
+    int32_t NumIter = 0, crc_status = 0;
+    int32_t i, j;
+
+    _TurboInterleaverRows rows;
+    if (turbo_decoder_interleaver_rows(Kidx, 8, &rows) != 0)
+        return -1;
+    int8_t *pIntraRowPattern = &(rows.pattern[0][0]);
+    __align(64) int32_t InterleaverIntra[TURBO_8WINDOWS_MAX_LWIN], InterleaverInter[TURBO_8WINDOWS_MAX_LWIN];
+    __align(64) int32_t DeInterleaverIntra[TURBO_8WINDOWS_MAX_LWIN], DeInterleaverInter[TURBO_8WINDOWS_MAX_LWIN];
+    for (i = 0; i < Lwin; i++)
+    {
+        InterleaverIntra[i] = rows.intra_row_perm_pattern_for_interleaver[i] * 16;
+        InterleaverInter[i] = rows.inter_row_out_addr_for_interleaver[i] * 48;
+        DeInterleaverIntra[i] = rows.intra_row_perm_pattern_for_deinterleaver[i] * 16;
+        DeInterleaverInter[i] = rows.inter_row_out_addr_for_deinterleaver[i] * 48;
+    }
+
+    /* xtrinsic information, LLR for systematic bits, LLR for parity bits of both branches */
+    __align(64) int8_t llr_rows[2][TURBO_8WINDOWS_MAX_LWIN * 48];
+    int8_t *pLeXP1 = llr_rows[0];
+    int8_t *pLeXP2 = llr_rows[1];
+    rows_8windows(request->input + 48, Lwin, pLeXP1);
+    rows_8windows(request->input + Lwin * 48 + 48, Lwin, pLeXP2);
+
+    /* interleave systematic LLR for second branch */
+    __m128i vtmp, vshuf;
+    for (i = 0; i < Lwin; i++)
+    {
+        vtmp = _mm_load_si128((__m128i const*)(pLeXP1 + 16 + 48 * i));
+        vshuf = _mm_load_si128((__m128i const*)(pIntraRowPattern + InterleaverIntra[i]));
+        vtmp = _mm_shuffle_epi8(vtmp, vshuf);
+        _mm_store_si128((__m128i *)(pLeXP2 + 16 + InterleaverInter[i]), vtmp);
+    }
+
+    /* init alpha, and beta from tail_bit in the last of the 8 windows */
+    __m512i initalpha[8], initbeta[8], initalpha_2[8], initbeta_2[8], tailbeta_v[8], tailbeta_v2[8];
+    for (i = 1; i < 8; i++)
+    {
+        initalpha[i] = init_alpha;
+        initalpha_2[i] = init_alpha;
+        initbeta[i] = _mm512_setzero_si512();
+        initbeta_2[i] = _mm512_setzero_si512();
+    }
+    int8_t *pLLR_tail = request->input;
+    int8_t x0k[3], z0k[3], x1k[3], z1k[3], tailbeta[8], tailbeta_2[8];
+    x0k[0] = *(pLLR_tail); x0k[1] = *(pLLR_tail + 8); x0k[2] = *(pLLR_tail + 5);
+    z0k[0] = *(pLLR_tail + 4); z0k[1] = *(pLLR_tail + 1); z0k[2] = *(pLLR_tail + 9);
+    init_beta_comp(x0k, z0k, initbeta, tailbeta, tail_window_64windows(8));
+    x1k[0] = *(pLLR_tail + 2); x1k[1] = *(pLLR_tail + 10); x1k[2] = *(pLLR_tail + 7);
+    z1k[0] = *(pLLR_tail + 6); z1k[1] = *(pLLR_tail + 3); z1k[2] = *(pLLR_tail + 11);
+    init_beta_comp(x1k, z1k, initbeta_2, tailbeta_2, tail_window_64windows(8));
+    for (i = 1; i < 8; i++)
+    {
+        tailbeta_v[i] = _mm512_set1_epi8(tailbeta[i]);
+        tailbeta_v2[i] = _mm512_set1_epi8(tailbeta_2[i]);
+    }
+
+    /* lane g runs rows g*Lwin4 to (g+1)*Lwin4-1 of the code block */
+    __align(64) uint16_t winCodeBlockBits[TURBO_8WINDOWS_MAX_LWIN];
+    struct siso_lanes_64windows lanes, lanes_2;
+    for (i = 0; i < 4; i++)
+    {
+        lanes.output[i] = pLeXP2;
+        lanes.input[i] = pLeXP1 + 48 * i * Lwin4;
+        lanes.pattern[i] = pIntraRowPattern;
+        lanes.pattern_sel[i] = InterleaverIntra + i * Lwin4;
+        lanes.row_addr[i] = InterleaverInter + i * Lwin4;
+        lanes.cb_bits[i] = winCodeBlockBits + i * Lwin4;
+        lanes.rows[i] = (Lwin - i * Lwin4 < Lwin4) ? Lwin - i * Lwin4 : Lwin4;
+        if (lanes.rows[i] < 0)
+            lanes.rows[i] = 0;
+    }
+    lanes.separate_cb = 0;
+    lanes.windows = 8;
+    lanes_2 = lanes;
+    for (i = 0; i < 4; i++)
+    {
+        lanes_2.output[i] = pLeXP1;
+        lanes_2.input[i] = pLeXP2 + 48 * i * Lwin4;
+        lanes_2.pattern_sel[i] = DeInterleaverIntra + i * Lwin4;
+        lanes_2.row_addr[i] = DeInterleaverInter + i * Lwin4;
+    }
+
+    const int32_t early_term = (request->early_term_disable == BBLIB_TURBO_EARLY_TERM ||
+                                request->early_term_disable == BBLIB_TURBO_EARLY_TERM_FAST);
+    int8_t *pAG = response->ag_buf;
+    uint8_t *pout = response->output;
+
+    SISO_64windows(&lanes, pAG, initalpha, initbeta, tailbeta_v, Lwin4, NULL);
+    NumIter++;
+    for (j = 0; ; j++)
+    {
+        if (crc_check_8windows(C, K, winCodeBlockBits, pout))
+        {
+            crc_status = 1;
+            if (early_term)
+                break;
+        }
+        if (j >= request->max_iter_num)
+            break;
+
+        SISO_64windows(&lanes_2, pAG, initalpha_2, initbeta_2, tailbeta_v2, Lwin4, NULL);
+        NumIter++;
+        SISO_64windows(&lanes, pAG, initalpha, initbeta, tailbeta_v, Lwin4, NULL);
+        NumIter++;
+    }
+
+    if (crc_status)
+    {
+        response->crc_status = 1;
+    }
+    return NumIter;
+}
+
+/* code blocks up to this size are decoded side by side by bblib_lte_turbo_decoder_multi_avx512, *
+ * longer ones fill the 64 windows on their own                                                 */
+#define TURBO_MULTI_MAX_K 1024
+#define TURBO_MULTI_MAX_LWIN (TURBO_MULTI_MAX_K >> 4)
+
+/* Decodes up to 4 code blocks side by side, code block b in lane b as the 16 windows of K/16 rows of
+   the 16 windows decoders. Each lane follows the iterations, early termination and CRC of its own
+   request, and is left out of the SISO once its code block is done. */
+static void decoder_multi_lanes_64windows(const struct bblib_turbo_decoder_request *request,
+                                          struct bblib_turbo_decoder_response *response,
+                                          int32_t *num_iter, const int32_t *cb, int32_t num_cb)
+{
+    _TurboInterleaverRows rows[4];
+    struct turbo_decoder_interleaver interleaver[4];
+    __align(64) int32_t InterleaverIntra[4][TURBO_MULTI_MAX_LWIN], InterleaverInter[4][TURBO_MULTI_MAX_LWIN];
+    __align(64) int32_t DeInterleaverIntra[4][TURBO_MULTI_MAX_LWIN], DeInterleaverInter[4][TURBO_MULTI_MAX_LWIN];
+    __align(64) uint16_t winCodeBlockBits[4][TURBO_MULTI_MAX_LWIN];
+    __align(64) int8_t tail_lanes[2][8][64] = {};
+    __m512i initalpha[8], initbeta[8], initalpha_2[8], initbeta_2[8], tailbeta[8], tailbeta_2[8];
+    struct siso_lanes_64windows lanes, lanes_2;
+    int32_t Lwin[4] = {0, 0, 0, 0}, NumIter[4] = {0, 0, 0, 0}, numMaxIterUse[4] = {0, 0, 0, 0};
+    int32_t active[4] = {0, 0, 0, 0}; /* lane still decoding its code block */
+    int32_t lane_min_dist[4];
+    int8_t x0k[3], z0k[3], x1k[3], z1k[3], tail[8];
+    int32_t b, i, j, n, WindowSize;
+    __m128i vtmp, vshuf;
+
+    for (b = 0; b < 4; b++)
+    {
+        lanes.input[b] = (int8_t *)TD_zero_row;
+        lanes.rows[b] = 0;
+    }
+    lanes.separate_cb = 1;
+    lanes.windows = 16;
+    lanes_2 = lanes;
+
+    for (b = 0; b < num_cb; b++)
+    {
+        n = cb[b];
+        if (turbo_decoder_interleaver(request[n].k_idx - 1, request[n].flags, &rows[b], &interleaver[b]) != 0)
+        {
+            num_iter[n] = -1;
+            continue;
+        }
+        Lwin[b] = request[n].k >> 4;
+        for (i = 0; i < Lwin[b]; i++)
+        {
+            InterleaverIntra[b][i] = interleaver[b].intra_row_perm_pattern_for_interleaver[i] * 16;
+            InterleaverInter[b][i] = interleaver[b].inter_row_out_addr_for_interleaver[i] * 48;
+            DeInterleaverIntra[b][i] = interleaver[b].intra_row_perm_pattern_for_deinterleaver[i] * 16;
+            DeInterleaverInter[b][i] = interleaver[b].inter_row_out_addr_for_deinterleaver[i] * 48;
+        }
+
+        int8_t *pLeXP1 = request[n].input + 48;
+        int8_t *pLeXP2 = request[n].input + 48 * (Lwin[b] + 1);
+        lanes.output[b] = pLeXP2;
+        lanes.input[b] = pLeXP1;
+        lanes.pattern[b] = interleaver[b].pattern;
+        lanes.pattern_sel[b] = InterleaverIntra[b];
+        lanes.row_addr[b] = InterleaverInter[b];
+        lanes.cb_bits[b] = winCodeBlockBits[b];
+        lanes_2.output[b] = pLeXP1;
+        lanes_2.input[b] = pLeXP2;
+        lanes_2.pattern[b] = interleaver[b].pattern;
+        lanes_2.pattern_sel[b] = DeInterleaverIntra[b];
+        lanes_2.row_addr[b] = DeInterleaverInter[b];
+        lanes_2.cb_bits[b] = winCodeBlockBits[b];
+
+        /* init beta from tail_bit, in the last window of the lane */
+        int8_t *pLLR_tail = request[n].input;
+        x0k[0] = *(pLLR_tail); x0k[1] = *(pLLR_tail + 8); x0k[2] = *(pLLR_tail + 5);
+        z0k[0] = *(pLLR_tail + 4); z0k[1] = *(pLLR_tail + 1); z0k[2] = *(pLLR_tail + 9);
+        tail_beta_comp(x0k, z0k, tail);
+        for (i = 1; i < 8; i++)
+            tail_lanes[0][i][16 * b + 15] = tail[i];
+        x1k[0] = *(pLLR_tail + 2); x1k[1] = *(pLLR_tail + 10); x1k[2] = *(pLLR_tail + 7);
+        z1k[0] = *(pLLR_tail + 6); z1k[1] = *(pLLR_tail + 3); z1k[2] = *(pLLR_tail + 11);
+        tail_beta_comp(x1k, z1k, tail);
+        for (i = 1; i < 8; i++)
+            tail_lanes[1][i][16 * b + 15] = tail[i];
+
+        /* interleave systematic LLR for second branch */
+        for (i = 0; i < Lwin[b]; i++)
+        {
+            vtmp = _mm_load_si128((__m128i const*)(pLeXP1 + 16 + 48 * i));
+            vshuf = _mm_load_si128((__m128i const*)(lanes.pattern[b] + InterleaverIntra[b][i]));
+            vtmp = _mm_shuffle_epi8(vtmp, vshuf);
+            _mm_store_si128((__m128i *)(pLeXP2 + 16 + InterleaverInter[b][i]), vtmp);
+        }
+
+        numMaxIterUse[b] = (request[n].max_iter_num == 0) ? 3 : request[n].max_iter_num;
+        active[b] = 1;
+    }
+
+    for (i = 1; i < 8; i++)
+    {
+        tailbeta[i] = _mm512_load_si512((__m512i const*)tail_lanes[0][i]);
+        tailbeta_2[i] = _mm512_load_si512((__m512i const*)tail_lanes[1][i]);
+        initalpha[i] = _mm512_maskz_set1_epi8(TD_LANE_HEAD, -128);
+        initalpha_2[i] = initalpha[i];
+        initbeta[i] = tailbeta[i];
+        initbeta_2[i] = tailbeta_2[i];
+    }
+    /* every response has an ag_buf of its own, the group runs in the one of its first code block */
+    int8_t *pAG = response[cb[0]].ag_buf;
+
+    /* j = -1 is the first half iteration, skipped as in the one code block decoder when
+       max_iter_num is 0 */
+    for (j = -1; ; j++)
+    {
+        WindowSize = 0;
+        for (b = 0; b < 4; b++)
+        {
+            if (j < 0)
+                lanes.rows[b] = (active[b] && request[cb[b]].max_iter_num != 0) ? Lwin[b] : 0;
+            else
+                lanes.rows[b] = (active[b] && j < numMaxIterUse[b]) ? Lwin[b] : 0;
+            lanes_2.rows[b] = lanes.rows[b];
+            if (lanes.rows[b] > WindowSize)
+                WindowSize = lanes.rows[b];
+        }
+        if (WindowSize == 0)
+        {
+            if (j < 0)
+                continue;
+            break;
+        }
+
+        if (j >= 0)
+            SISO_64windows(&lanes_2, pAG, initalpha_2, initbeta_2, tailbeta_2, WindowSize, NULL);
+        SISO_64windows(&lanes, pAG, initalpha, initbeta, tailbeta, WindowSize, lane_min_dist);
+
+        for (b = 0; b < num_cb; b++)
+        {
+            if (lanes.rows[b] == 0)
+                continue;
+            n = cb[b];
+            NumIter[b] += (j >= 0) ? 2 : 1;
+            if (lane_min_dist[b] > turbo_early_term_min_dist(request[n].max_iter_num, request[n].early_term_disable))
+            {
+                if (crc_check_16windows(request[n].c, request[n].k, winCodeBlockBits[b], response[n].output))
+                {
+                    response[n].crc_status = 1;
+                    num_iter[n] = NumIter[b];
+                    active[b] = 0;
+                }
+            }
+        }
+    }
+
+    for (b = 0; b < num_cb; b++)
+    {
+        if (active[b])
+        {
+            n = cb[b];
+            if (crc_check_16windows(request[n].c, request[n].k, winCodeBlockBits[b], response[n].output))
+            {
+                response[n].crc_status = 1;
+            }
+            num_iter[n] = NumIter[b];
         }
     }
 }
 
+int32_t bblib_lte_turbo_decoder_multi_avx512(const struct bblib_turbo_decoder_request *request,
+                                              struct bblib_turbo_decoder_response *response,
+                                              int32_t *num_iter, int32_t num)
+{
+    if (request == NULL || response == NULL || num_iter == NULL || num < 0)
+    {
+        printf("bblib_lte_turbo_decoder_multi_avx512 input address invalid \n");
+        return -1;
+    }
+    if (num > BBLIB_TURBO_DECODER_MULTI_MAX)
+    {
+        printf("bblib_lte_turbo_decoder_multi_avx512: %d code blocks, more than %d\n", num, BBLIB_TURBO_DECODER_MULTI_MAX);
+        return -1;
+    }
+    int32_t order[BBLIB_TURBO_DECODER_MULTI_MAX];
+    int32_t num_lanes = 0;
+    int32_t n, m;
+
+    for (n = 0; n < num; n++)
+    {
+        response[n].crc_status = 0;
+        if (((request[n].k & 0xF) != 0) || (request[n].k > TURBO_MULTI_MAX_K))
+        {
+            /* one by one, with the block errors of the decoder bblib_turbo_decoder takes */
+            num_iter[n] = bblib_turbo_decoder(&request[n], &response[n]);
+        }
+        else if (request[n].input == NULL || response[n].output == NULL || response[n].ag_buf == NULL ||
+                 request[n].k_idx < 1 || request[n].k_idx > 188 || g_TurboQPP_sdk[request[n].k_idx - 1][0] != request[n].k)
+        {
+            printf("bblib_lte_turbo_decoder_multi_avx512: code block %d is invalid\n", n);
+            num_iter[n] = -1;
+        }
+        else
+        {
+            /* longest first, so that the code blocks side by side have close sizes */
+            for (m = num_lanes; (m > 0) && (request[order[m - 1]].k < request[n].k); m--)
+                order[m] = order[m - 1];
+            order[m] = n;
+            num_lanes++;
+        }
+    }
+
+    for (n = 0; n < num_lanes; n += 4)
+    {
+        decoder_multi_lanes_64windows(request, response, num_iter, order + n,
+                                      (num_lanes - n < 4) ? num_lanes - n : 4);
+    }
+    return 0;
+}
+
 #else
 int32_t bblib_lte_turbo_decoder_64windows_avx512(const struct bblib_turbo_decoder_request *request,
                                                  struct bblib_turbo_decoder_response *response)
@@ -949,4 +1583,19 @@ int32_t bblib_lte_turbo_decoder_64windows_avx512(const struct bblib_turbo_decode
     printf("bblib_turbo requires AVX512 ISA support to run\n");
     return(-1);
 }
+
+int32_t bblib_lte_turbo_decoder_8windows_avx512(const struct bblib_turbo_decoder_request *request,
+                                                struct bblib_turbo_decoder_response *response)
+{
+    printf("bblib_turbo requires AVX512 ISA support to run\n");
+    return(-1);
+}
+
+int32_t bblib_lte_turbo_decoder_multi_avx512(const struct bblib_turbo_decoder_request *request,
+                                              struct bblib_turbo_decoder_response *response,
+                                              int32_t *num_iter, int32_t num)
+{
+    printf("bblib_turbo requires AVX512 ISA support to run\n");
+    return(-1);
+}
 #endif
@@ -38,373 +38,263 @@
 
 #include "phy_turbo_internal.h"
 
-/* Turbo table */
-__align(64) uint16_t g_TurboBufAddr[1068000];
-__align(64) int32_t g_TurboBufAddrOffset[188];
-extern __align(64) uint16_t g_OutputWinTable8_sdk[256][8];
-
-
-/* TS36.212 Table 5.1.3-3, Turbo code internal interleaver parameters with XXXX */
-int32_t g_Kidx_K_Nmaxrep_shuf_sdk[188][5];
-
-#define MAX_PATH_LEN 1024
-#define C_TC_subblock 32
-
-int8_t g_DataColumnPerm01_sdk[32] = {\
-0, 16, 8, 24, 4, 20, 12, 28, 2, 18, 10, 26, 6, 22, 14, 30, 1, 17, 9, 25, 5, 21, 13, 29, 3, 19, 11, 27, 7, 23, 15, 31};
-int8_t g_DataColumnPerm2_sdk[32] = {\
-1, 17, 9, 25, 5, 21, 13, 29, 3, 19, 11, 27, 7, 23, 15, 31, 2, 18, 10, 26, 6, 22, 14, 30, 4, 20, 12, 28, 8, 24, 16, 0};
+/* TS36.212 Table 5.1.3-3, K, f1 and f2 of the turbo code internal interleaver for each Kidx */
+const int16_t g_TurboQPP_sdk[188][3] = {
+    {40, 3, 10}, {48, 7, 12}, {56, 19, 42}, {64, 7, 16}, {72, 7, 18}, {80, 11, 20},
+    {88, 5, 22}, {96, 11, 24}, {104, 7, 26}, {112, 41, 84}, {120, 103, 90}, {128, 15, 32},
+    {136, 9, 34}, {144, 17, 108}, {152, 9, 38}, {160, 21, 120}, {168, 101, 84}, {176, 21, 44},
+    {184, 57, 46}, {192, 23, 48}, {200, 13, 50}, {208, 27, 52}, {216, 11, 36}, {224, 27, 56},
+    {232, 85, 58}, {240, 29, 60}, {248, 33, 62}, {256, 15, 32}, {264, 17, 198}, {272, 33, 68},
+    {280, 103, 210}, {288, 19, 36}, {296, 19, 74}, {304, 37, 76}, {312, 19, 78}, {320, 21, 120},
+    {328, 21, 82}, {336, 115, 84}, {344, 193, 86}, {352, 21, 44}, {360, 133, 90}, {368, 81, 46},
+    {376, 45, 94}, {384, 23, 48}, {392, 243, 98}, {400, 151, 40}, {408, 155, 102}, {416, 25, 52},
+    {424, 51, 106}, {432, 47, 72}, {440, 91, 110}, {448, 29, 168}, {456, 29, 114}, {464, 247, 58},
+    {472, 29, 118}, {480, 89, 180}, {488, 91, 122}, {496, 157, 62}, {504, 55, 84}, {512, 31, 64},
+    {528, 17, 66}, {544, 35, 68}, {560, 227, 420}, {576, 65, 96}, {592, 19, 74}, {608, 37, 76},
+    {624, 41, 234}, {640, 39, 80}, {656, 185, 82}, {672, 43, 252}, {688, 21, 86}, {704, 155, 44},
+    {720, 79, 120}, {736, 139, 92}, {752, 23, 94}, {768, 217, 48}, {784, 25, 98}, {800, 17, 80},
+    {816, 127, 102}, {832, 25, 52}, {848, 239, 106}, {864, 17, 48}, {880, 137, 110}, {896, 215, 112},
+    {912, 29, 114}, {928, 15, 58}, {944, 147, 118}, {960, 29, 60}, {976, 59, 122}, {992, 65, 124},
+    {1008, 55, 84}, {1024, 31, 64}, {1056, 17, 66}, {1088, 171, 204}, {1120, 67, 140}, {1152, 35, 72},
+    {1184, 19, 74}, {1216, 39, 76}, {1248, 19, 78}, {1280, 199, 240}, {1312, 21, 82}, {1344, 211, 252},
+    {1376, 21, 86}, {1408, 43, 88}, {1440, 149, 60}, {1472, 45, 92}, {1504, 49, 846}, {1536, 71, 48},
+    {1568, 13, 28}, {1600, 17, 80}, {1632, 25, 102}, {1664, 183, 104}, {1696, 55, 954}, {1728, 127, 96},
+    {1760, 27, 110}, {1792, 29, 112}, {1824, 29, 114}, {1856, 57, 116}, {1888, 45, 354}, {1920, 31, 120},
+    {1952, 59, 610}, {1984, 185, 124}, {2016, 113, 420}, {2048, 31, 64}, {2112, 17, 66}, {2176, 171, 136},
+    {2240, 209, 420}, {2304, 253, 216}, {2368, 367, 444}, {2432, 265, 456}, {2496, 181, 468}, {2560, 39, 80},
+    {2624, 27, 164}, {2688, 127, 504}, {2752, 143, 172}, {2816, 43, 88}, {2880, 29, 300}, {2944, 45, 92},
+    {3008, 157, 188}, {3072, 47, 96}, {3136, 13, 28}, {3200, 111, 240}, {3264, 443, 204}, {3328, 51, 104},
+    {3392, 51, 212}, {3456, 451, 192}, {3520, 257, 220}, {3584, 57, 336}, {3648, 313, 228}, {3712, 271, 232},
+    {3776, 179, 236}, {3840, 331, 120}, {3904, 363, 244}, {3968, 375, 248}, {4032, 127, 168}, {4096, 31, 64},
+    {4160, 33, 130}, {4224, 43, 264}, {4288, 33, 134}, {4352, 477, 408}, {4416, 35, 138}, {4480, 233, 280},
+    {4544, 357, 142}, {4608, 337, 480}, {4672, 37, 146}, {4736, 71, 444}, {4800, 71, 120}, {4864, 37, 152},
+    {4928, 39, 462}, {4992, 127, 234}, {5056, 39, 158}, {5120, 39, 80}, {5184, 31, 96}, {5248, 113, 902},
+    {5312, 41, 166}, {5376, 251, 336}, {5440, 43, 170}, {5504, 21, 86}, {5568, 43, 174}, {5632, 45, 176},
+    {5696, 45, 178}, {5760, 161, 120}, {5824, 89, 182}, {5888, 323, 184}, {5952, 47, 186}, {6016, 23, 94},
+    {6080, 47, 190}, {6144, 263, 480}
+};
 
 /*******************************************************************************
  * Function
  ******************************************************************************/
-/** @fn InitTurboDecoderInterleaverTable
- *  @brief Turbo decoded used interleave table init
- *  @param [in] WORD8 * Table_Path
- *         [in out] _TurboInterleaver * p
- *  @return void
+#define PATTERN_HASH_SIZE 1024
+
+/** @fn find_pattern
+ *  @brief Index of an intra row permutation pattern, appended to the table when not found
+ *  @param [in out] _TurboInterleaver * p
+ *         [in out] uint64_t * p_key the patterns already in the table, 4 bits per window
+ *         [in out] int16_t * p_hash open addressing hash of p_key, -1 for empty slots
+ *         [in out] int32_t * p_num_pattern number of patterns in the table
+ *         [in] int8_t * pattern the 16 windows permutation
+ *  @return index of the pattern, -1 if the table is full
  */
-void init_turbo_decoder_interleaver_table(char *Table_Path,
-                                          _TurboInterleaver *p)
+static int32_t find_pattern(_TurboInterleaver *p, uint64_t *p_key, int16_t *p_hash,
+                            int32_t *p_num_pattern, const int8_t *pattern)
 {
-    if( (Table_Path == NULL) || (p == NULL) )
-    {
-        return;
-    }
-
-    int32_t i, j, re;
-    FILE * fp;
-    char interleavertable[] = "/source/phy/lib_turbo/TurboInterleaver.dat";
-    char filename[MAX_PATH_LEN];
-    int32_t table_pathlen = strlen(Table_Path);
-
-    if ((table_pathlen + strlen(interleavertable)) >= (sizeof(filename) - 64))
-    {
-        printf("config invalid: tablePath = %s\n", Table_Path);
-        return;
-    }
-    strncpy(filename, Table_Path, (sizeof(filename) - 64));
-    filename[table_pathlen] = '\0';
-    strncat(filename, interleavertable, (strlen(interleavertable) + 1));
+    int32_t i, h;
+    uint64_t key = 0;
 
-    fp = fopen(filename, "r");
-    if (fp == NULL)
-    {
-        printf("Cannot open file\n");
-        return;
-    }
-    for (i=0; i<188; i++)
-    {
-        fscanf(fp, "%d ", &re);
-        p->offset[i] = re;
-    }
-    for (i=0; i<21693; i++)
-    {
-        fscanf(fp, "%d ", &re);
-        p->inter_row_out_addr_for_interleaver[i] = re;
-    }
-    for (i=0; i<21693; i++)
-    {
-        fscanf(fp, "%d ", &re);
-        p->inter_row_out_addr_for_deinterleaver[i] = re;
-    }
-    for (i=0; i<21693; i++)
+    for (i = 0; i < 16; i++)
     {
-        fscanf(fp, "%d ", &re);
-        p->intra_row_perm_pattern_for_interleaver[i] = re;
+        key |= (uint64_t)pattern[i] << (4 * i);
     }
-    for (i=0; i<21693; i++)
+    h = (int32_t)((key * 0x9E3779B97F4A7C15ULL) >> 54);
+    while (p_hash[h] >= 0)
     {
-        fscanf(fp, "%d ", &re);
-        p->intra_row_perm_pattern_for_deinterleaver[i] = re;
-    }
-    for (i=0; i<448; i++)
-    {
-        for (j=0; j<16; j++)
+        if (p_key[p_hash[h]] == key)
         {
-            fscanf(fp, "%d ", &re);
-            p->pattern[i][j] = (int8_t) re;
+            return p_hash[h];
         }
+        h = (h + 1) & (PATTERN_HASH_SIZE - 1);
     }
-    fclose(fp);
-    return;
-}
-
-static size_t read_table(char * table, void * ptr, size_t len)
-{
-    FILE * fp;
-    size_t rlen;
-
-    fp = fopen(table, "rb");
-    if (fp == NULL)
+    i = *p_num_pattern;
+    if (i == 448)
     {
-        printf("Invalid: failed to open %s\n", table);
-        return(-1);
+        return -1;
     }
-
-    rlen = fread(ptr, 1, len, fp);
-    fclose(fp);
-    return rlen;
+    p_hash[h] = (int16_t)i;
+    p_key[i] = key;
+    memcpy(p->pattern[i], pattern, 16);
+    (*p_num_pattern)++;
+    return i;
 }
 
-struct tableItem {
-    void * tableptr;
-    size_t len;
-    char * tablenm;
-};
-
-int32_t init_common_tables(char *pTabelPath)
-{
-    #define TABLE_NR 2
-
-    char filename[MAX_PATH_LEN];
-    struct tableItem tables[TABLE_NR] = {
-             {g_Kidx_K_Nmaxrep_shuf_sdk, sizeof(g_Kidx_K_Nmaxrep_shuf_sdk), "/source/phy/lib_turbo/kidx_k_nmaxrep_shuf.bin"},
-             {g_OutputWinTable8_sdk, sizeof(g_OutputWinTable8_sdk), "/source/phy/lib_turbo/output_win_table8.bin"},
-        };
-
-    size_t lens[TABLE_NR], rlen;
-    size_t maxlen = 0, maxIdx = 0, path_len = 0;
-    int32_t i;
-
-    memset(filename, 0, MAX_PATH_LEN);
-    for (i = 0; i < TABLE_NR; i++)
-    {
-        lens[i] = strlen(tables[i].tablenm);
-        if (maxlen < lens[i])
-        {
-            maxlen = lens[i];
-        }
-    }
-
-    //added for Klocworks
-    path_len = strlen(pTabelPath);
-    if ((path_len + 1) >= (sizeof(filename) - 5))
-    {
-        printf("config error1: tablePath = %s is too long, limit to 250 characters\n", pTabelPath);
-        exit(-1);
-    }
-
-    if ((path_len + maxlen + 2) >= (sizeof(filename) - 5))
-    {
-        printf("config error2: tablePath = %s plus table name = %s is too long, limit to 250 characters\n", pTabelPath, tables[maxIdx].tablenm);
-        exit(-1);
-    }
-
-    for (i = 0; i < TABLE_NR; i++)
-    {
-        strncpy(filename, pTabelPath, sizeof(filename) - 5);
-        filename[path_len] = '\0';
-        strncat(filename, tables[i].tablenm, lens[i] + 1);
-
-        rlen = read_table(filename, tables[i].tableptr, tables[i].len);
-        if (rlen != tables[i].len)
-        {
-            printf("table invalid: length of %s = %zd [%zd]\n", filename, rlen, tables[i].len);
-            return(-1);
-        }
-    }
-    return 0;
-}
-
-/** @fn GetTurboBufAddrTable_New
- *  @brief Turbo decoded related table init
- *  @param [in out] UWORD16 * p_table_TurboBufAddr
- *         [in out] WORD32 * p_table_TurboBufAddr_Offset
- *         [in out] WORD32 * p_table_Kidx_K_Nmaxrep_shuf
+/** @fn InitTurboDecoderInterleaverTable
+ *  @brief Turbo decoder interleave table init, computed from the QPP parameters.
+ *         The code block is split in 16 windows of Lwin bits, bit j*Lwin+i being window j of row i.
+ *         Since pi(x+Lwin) = pi(x) mod Lwin, each row is interleaved into a single row, with its
+ *         windows permuted by one of the 16 bytes patterns.
+ *  @param [in out] _TurboInterleaver * p
  *  @return void
  */
-void get_turbo_buf_addr_table_new(uint16_t *p_table_TurboBufAddr,
-                                  int32_t *p_table_TurboBufAddr_Offset,
-                                  int32_t (*p_table_Kidx_K_Nmaxrep_shuf)[5])
+void init_turbo_decoder_interleaver_table(_TurboInterleaver *p)
 {
-    int32_t v0[6176], v1[6176], v2[6176];
-    int32_t y0[6176], y1[6176], y2[6176];
-    int32_t CircularBuf[18528];
-
-    memset(y2, 0, sizeof(y2));
-
-    int32_t i, j, k;
-    int32_t K, D, Kblock, R_TC_subblock, Kpai, ND, Ncb, Kw, Kidx;
-
-    int32_t bit, bit_RSC, bit_addr, row, col, Nw, addr_at_Turbo_input_struct=0;
-
-    int32_t cnt = 0;
-    int32_t cnt_good_bit;
-
+    int32_t Kidx, i, j, K, Lwin, f1, f2, sel;
+    int32_t ofst = 0, num_pattern = 0;
+    int32_t row_of_rem[384];
+    int16_t pi[6144];
+    uint64_t pattern_key[448];
+    int16_t pattern_hash[PATTERN_HASH_SIZE];
+    int8_t pattern[16];
+
+    if (p == NULL)
+    {
+        return;
+    }
+    memset(pattern_hash, -1, sizeof(pattern_hash));
 
-    for (Kidx=1; Kidx<=188; Kidx++)
+    for (Kidx = 0; Kidx < 188; Kidx++)
     {
-        * (p_table_TurboBufAddr_Offset + Kidx-1) = cnt;
-        /* --------------------------------------------------------------------------------------------------*/
-        /* code block size related parameters */
-        /*K = *(p_table_Kidx_K_Nmaxrep_shuf + ((((Kidx-1)*5 + 1)<188*5)?((Kidx-1)*5 + 1):0)); */
-        K = p_table_Kidx_K_Nmaxrep_shuf[Kidx-1][1];
-        D = K + 4;
-        Kblock = 3 * D;
-        if (D%32!=0)
+        K = g_TurboQPP_sdk[Kidx][0];
+        f1 = g_TurboQPP_sdk[Kidx][1];
+        f2 = g_TurboQPP_sdk[Kidx][2];
+        if (K % 16 != 0)
         {
-            R_TC_subblock = D / C_TC_subblock + 1;
+            p->offset[Kidx] = -2;
+            continue;
         }
-        else
-        {
-            R_TC_subblock = D / C_TC_subblock;
-        }
-        Kpai = R_TC_subblock * C_TC_subblock;
-        ND = Kpai - D;
-        Kw = 3 * Kpai;
-        Ncb = Kw;
+        p->offset[Kidx] = ofst;
+        Lwin = K / 16;
+        turbo_qpp_table(K, f1, f2, pi);
 
-        /* -------------------------------------------------------------------------------------------------- */
-        /* fulfill buffer for subblock permuted matrix */
-        for (i=0; i<ND; i++)
-        {
-            v0[i] = (-1); /* <NULL> */
-            v1[i] = (-1); /* <NULL> */
-            v2[i] = (-1); /* <NULL> */
-        }
-        for (i=ND; i<K+ND; i++)
+        for (i = 0; i < Lwin; i++)
         {
-            v0[i] = i-ND; /* system bits */
-            v1[i] = 10000 + (i-ND); /* parity bits 0 */
-            v2[i] = 20000 + (i-ND); /* parity bits 1 */
-        }
-        for (i=K+ND; i<Kpai; i++)
-        {
-            v0[i] = 30000 + (i-K-ND); /* system tail bits */
-            v1[i] = 40000 + (i-K-ND); /* parity tail bits 0 */
-            v2[i] = 50000 + (i-K-ND); /* parity tail bits 1 */
+            row_of_rem[pi[i] % Lwin] = i;
         }
 
-        /* subblock matrix column permutation */
-        for (i=0; i<R_TC_subblock; i++)
+        /* interleaver: row i is read into row r with pi(r) = i mod Lwin, window j taking
+           window pi(j*Lwin+r)/Lwin of row i */
+        for (i = 0; i < Lwin; i++)
         {
-            for (j=0; j<C_TC_subblock; j++)
+            for (j = 0; j < 16; j++)
+            {
+                pattern[j] = (int8_t)(pi[j * Lwin + row_of_rem[i]] / Lwin);
+            }
+            sel = find_pattern(p, pattern_key, pattern_hash, &num_pattern, pattern);
+            if (sel < 0)
             {
-                y0[i*C_TC_subblock+j] = v0[i*C_TC_subblock+g_DataColumnPerm01_sdk[j]];
-                y1[i*C_TC_subblock+j] = v1[i*C_TC_subblock+g_DataColumnPerm01_sdk[j]];
-                y2[i*C_TC_subblock+j] = v2[i*C_TC_subblock+g_DataColumnPerm2_sdk[j]];
+                printf("turbo decoder interleaver pattern table is full\n");
+                return;
             }
+            p->inter_row_out_addr_for_interleaver[ofst + i] = row_of_rem[i];
+            p->intra_row_perm_pattern_for_interleaver[ofst + i] = sel;
         }
-        j = C_TC_subblock - 1;
-        i = 0;
-        k = y2[i*C_TC_subblock+j];
-        for (i=0; i<(R_TC_subblock-1); i++) y2[i*C_TC_subblock+j] = y2[(i+1)*C_TC_subblock+j];
-        y2[i*C_TC_subblock+j] = k;
 
-        /* -------------------------------------------------------------------------------------------------- */
-        /* obtain virtual circular buffer */
-        i = 0;
-        for (col=0; col<C_TC_subblock; col++)
+        /* deinterleaver: row i goes back to row pi(i) mod Lwin, window pi(j*Lwin+i)/Lwin taking
+           window j of row i */
+        for (i = 0; i < Lwin; i++)
         {
-            for (row=0; row<R_TC_subblock; row++)
+            for (j = 0; j < 16; j++)
             {
-                CircularBuf[i++] = y0[row*C_TC_subblock+col];
+                pattern[pi[j * Lwin + i] / Lwin] = (int8_t)j;
             }
-        }
-        for (col=0; col<C_TC_subblock; col++)
-        {
-            for (row=0; row<R_TC_subblock; row++)
+            sel = find_pattern(p, pattern_key, pattern_hash, &num_pattern, pattern);
+            if (sel < 0)
             {
-                CircularBuf[i++] = y1[row*C_TC_subblock+col];
-                CircularBuf[i++] = y2[row*C_TC_subblock+col];
+                printf("turbo decoder interleaver pattern table is full\n");
+                return;
             }
+            p->inter_row_out_addr_for_deinterleaver[ofst + i] = pi[i] % Lwin;
+            p->intra_row_perm_pattern_for_deinterleaver[ofst + i] = sel;
         }
 
-        /* --------------------------------------------------------------------------------------------------
-        /* get TurboBufAddr */
-        if (K%16!=0) /* 8-window case */
+        ofst += Lwin;
+    }
+}
+
+/** @fn turbo_decoder_interleaver_rows
+ *  @brief Interleaver rows of the 16 or 8 windows decoders for one code block, computed from the
+ *         QPP parameters. The code block is split in N windows of Lwin bits, bit j*Lwin+i being
+ *         window j of row i. Interleaved row r comes from row rho = pi(r) mod Lwin, window j
+ *         taking window q[j] of it, rho and q being stepped by turbo_qpp_rows_next. With 8
+ *         windows the bytes 8 to 15 of the patterns keep their place.
+ *  @param [in] Kidx index of K in TS36.212 Table 5.1.3-3, from 0
+ *  @param [in] N windows, 16 or 8
+ *  @param [out] _TurboInterleaverRows * p
+ *  @return 0 successful, -1 if K is not a multiple of N
+ */
+int32_t turbo_decoder_interleaver_rows(int32_t Kidx, int32_t N, _TurboInterleaverRows *p)
+{
+    int32_t r, j, rho, Lwin;
+    int32_t K = g_TurboQPP_sdk[Kidx][0];
+    struct turbo_qpp_rows rows;
+    const __m128i high_windows = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i q;
+
+    if (K % N != 0 || K / N > 384)
+    {
+        printf("turbo_decoder_interleaver_rows: K = %d is not a multiple of %d\n", K, N);
+        return -1;
+    }
+    Lwin = K / N;
+    turbo_qpp_rows_init(&rows, K, g_TurboQPP_sdk[Kidx][1], g_TurboQPP_sdk[Kidx][2], N, 0);
+
+    for (r = 0; r < Lwin; r++)
+    {
+        rho = turbo_qpp_rows_rho(&rows);
+        q = turbo_qpp_rows_q(&rows);
+        if (N == 8)
         {
-            Nw = K / 8;
-            cnt_good_bit = 0;
-            for (j=0; j<Ncb; j++)
-            {
-                if (CircularBuf[j]!=(-1))
-                {
-                    bit = CircularBuf[j];
-                    bit_RSC = bit / 10000;
-                    bit_addr = bit % 10000;
-                    switch(bit_RSC)
-                    {
-                    case 0: /* system bits */
-                        addr_at_Turbo_input_struct = 3*16 + bit_addr*2;
-                        break;
-                    case 1: /* parity bits 0 */
-                        addr_at_Turbo_input_struct = 3*16 + bit_addr*2 + 1;
-                        break;
-                    case 2: /* parity bits 1 */
-                        addr_at_Turbo_input_struct = (3 + 3*Nw)*16 + bit_addr*2 + 1;
-                        break;
-                    case 3: /* system tail bits */
-                        addr_at_Turbo_input_struct = 0*3*16 + bit_addr;
-                        break;
-                    case 4: /* parity tail bits 0 */
-                        addr_at_Turbo_input_struct = 0*3*16 + bit_addr + 4;
-                        break;
-                    case 5: /* parity tail bits 1 */
-                        addr_at_Turbo_input_struct = 0*3*16 + bit_addr + 8;
-                        break;
-                    default:
-                        printf("bit_RSC invalid\n");
-                        break;
-                } /* end of bit_RSC switch */
-                *(p_table_TurboBufAddr + cnt++) =  (uint16_t) addr_at_Turbo_input_struct;
-                cnt_good_bit++;
-                } /* end of "if (CircularBuf[j]!=(-1))" */
-            }
-            if (cnt_good_bit!=Kblock)
-            {
-                printf("cnt_good_bit not match\n");
-            }
+            q = _mm_blend_epi16(q, high_windows, 0xF0);
         }
-        else /* 16-window case */
+
+        /* interleaver: row rho is read into row r, window j taking window q[j] */
+        _mm_store_si128((__m128i *)p->pattern[rho], q);
+        p->inter_row_out_addr_for_interleaver[rho] = r;
+        p->intra_row_perm_pattern_for_interleaver[r] = r;
+
+        /* deinterleaver: row r goes back to row rho, window q[j] taking window j */
+        for (j = 0; j < 16; j++)
         {
-            Nw = K / 16;
-            cnt_good_bit = 0;
-            for (j=0; j<Ncb; j++)
-            {
-                if (CircularBuf[j]!=(-1))
-                {
-                    bit = CircularBuf[j];
-                    bit_RSC = bit / 10000;
-                    bit_addr = bit % 10000;
-                    row = bit_addr % Nw;
-                    col = bit_addr / Nw;
-                    switch(bit_RSC)
-                    {
-                    case 0: /* system bits */
-                        addr_at_Turbo_input_struct = (row+1)*3*16 + col + 16;
-                        break;
-                    case 1: /* parity bits 0 */
-                        addr_at_Turbo_input_struct = (row+1)*3*16 + col + 32;
-                        break;
-                    case 2: /* parity bits 1 */
-                        addr_at_Turbo_input_struct = (row+1+Nw)*3*16 + col + 32;
-                        break;
-                    case 3: /* system tail bits */
-                        addr_at_Turbo_input_struct = 0*3*16 + bit_addr;
-                        break;
-                    case 4: /* parity tail bits 0 */
-                        addr_at_Turbo_input_struct = 0*3*16 + bit_addr + 4;
-                        break;
-                    case 5: /* parity tail bits 0 */
-                        addr_at_Turbo_input_struct = 0*3*16 + bit_addr + 8;
-                        break;
-                    default:
-                        printf("bit_RSC invalid\n");
-                        break;
-                    } /* end of bit_RSC switch */
-                    *(p_table_TurboBufAddr + cnt++) =  (uint16_t) addr_at_Turbo_input_struct;
-                    cnt_good_bit++;
-                } /* end of "if (CircularBuf[j]!=(-1))" */
-            }
-            if (cnt_good_bit!=Kblock)
-            {
-                printf("cnt_good_bit not match\n");
-            }
+            p->pattern[Lwin + r][p->pattern[rho][j]] = (int8_t)j;
         }
+        p->inter_row_out_addr_for_deinterleaver[r] = rho;
+        p->intra_row_perm_pattern_for_deinterleaver[r] = Lwin + r;
 
-    } /* end of "for (Kidx=1; Kidx<=188; Kidx++)" */
+        turbo_qpp_rows_next(&rows);
+    }
+    return 0;
+}
 
-    return;
+/** @fn turbo_decoder_interleaver
+ *  @brief Interleaver rows of the 16 windows decoders for one code block, from the tables built
+ *         by init_turbo_decoder_interleaver_table or, with BBLIB_TURBO_QPP_ON_THE_FLY, computed
+ *         in rows by turbo_decoder_interleaver_rows
+ *  @param [in] Kidx index of K in TS36.212 Table 5.1.3-3, from 0
+ *  @param [in] flags flags of the decoder request
+ *  @param [in] rows room for the rows computed on the fly
+ *  @param [out] struct turbo_decoder_interleaver * p
+ *  @return 0 successful, -1 if K is not a multiple of 16
+ */
+int32_t turbo_decoder_interleaver(int32_t Kidx, uint32_t flags, _TurboInterleaverRows *rows,
+                                  struct turbo_decoder_interleaver *p)
+{
+    int32_t ofst;
+
+    if (flags & BBLIB_TURBO_QPP_ON_THE_FLY)
+    {
+        if (turbo_decoder_interleaver_rows(Kidx, 16, rows) != 0)
+        {
+            return -1;
+        }
+        p->pattern = &(rows->pattern[0][0]);
+        p->inter_row_out_addr_for_interleaver = rows->inter_row_out_addr_for_interleaver;
+        p->inter_row_out_addr_for_deinterleaver = rows->inter_row_out_addr_for_deinterleaver;
+        p->intra_row_perm_pattern_for_interleaver = rows->intra_row_perm_pattern_for_interleaver;
+        p->intra_row_perm_pattern_for_deinterleaver = rows->intra_row_perm_pattern_for_deinterleaver;
+        return 0;
+    }
+
+    ofst = g_TurboInterleaver.offset[Kidx];
+    if (ofst < 0)
+    {
+        printf("turbo_decoder_interleaver: K = %d is not a multiple of 16\n", g_TurboQPP_sdk[Kidx][0]);
+        return -1;
+    }
+    p->pattern = &(g_TurboInterleaver.pattern[0][0]);
+    p->inter_row_out_addr_for_interleaver = &(g_TurboInterleaver.inter_row_out_addr_for_interleaver[ofst]);
+    p->inter_row_out_addr_for_deinterleaver = &(g_TurboInterleaver.inter_row_out_addr_for_deinterleaver[ofst]);
+    p->intra_row_perm_pattern_for_interleaver = &(g_TurboInterleaver.intra_row_perm_pattern_for_interleaver[ofst]);
+    p->intra_row_perm_pattern_for_deinterleaver = &(g_TurboInterleaver.intra_row_perm_pattern_for_deinterleaver[ofst]);
+    return 0;
 }
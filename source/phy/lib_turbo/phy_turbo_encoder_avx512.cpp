@@ -36,7 +36,6 @@
 #include "phy_turbo.h"
 #include "phy_turbo_internal.h"
 #if defined (_BBLIB_AVX512_)
-extern __align(64) uint16_t g_OutputWinTable8_sdk[256][8];
 extern __align(64) uint8_t g_TailWinTable_sdk[8];
 
 /* const for 512-bit processing */
@@ -65,6 +64,103 @@ inline __m128i a_fun(__m128i cw)
     return a;
 }
 
+static inline __m512i turbo_qpp_lanes(__m128i a, __m128i b, __m128i c, __m128i d)
+{
+    __m512i v = _mm512_castsi128_si512(a);
+    v = _mm512_inserti32x4(v, b, 1);
+    v = _mm512_inserti32x4(v, c, 2);
+    return _mm512_inserti32x4(v, d, 3);
+}
+
+/* Row shuffle of the 8 windows interleaver, 4 rows at once: lane l of the registers steps its own
+   turbo_qpp_rows from row l*R. The rows past Lwin of the last lane are written to
+   tmp_buf[Lwin..4*R-1] and never read. */
+static void turbo_interleaver_rows_avx512(int8_t (*tmp_row)[8], uint8_t *tmp_buf, int32_t K,
+                                          int32_t f1, int32_t f2)
+{
+    const int32_t Lwin = K/8;
+    const int32_t R = (Lwin + 3)/4;
+    struct turbo_qpp_rows lane[4];
+    __m128i rho_lanes;
+    uint64_t rho01, rho23;
+    __m512i rho, g_rho, g_rho_L, m_rho, m_rho_L, L, q, g_q1, m_q1, mask;
+    __m512i sum, sum_L, vrows;
+    __mmask64 bits;
+    int32_t r, l;
+
+    for (l=0; l<4; l++)
+        turbo_qpp_rows_init(&lane[l], K, f1, f2, 8, l*R);
+    rho = turbo_qpp_lanes(lane[0].rho, lane[1].rho, lane[2].rho, lane[3].rho);
+    g_rho = turbo_qpp_lanes(lane[0].g_rho, lane[1].g_rho, lane[2].g_rho, lane[3].g_rho);
+    g_rho_L = turbo_qpp_lanes(lane[0].g_rho_L, lane[1].g_rho_L, lane[2].g_rho_L, lane[3].g_rho_L);
+    q = turbo_qpp_lanes(lane[0].q, lane[1].q, lane[2].q, lane[3].q);
+    g_q1 = turbo_qpp_lanes(lane[0].g_q1, lane[1].g_q1, lane[2].g_q1, lane[3].g_q1);
+    m_rho = _mm512_broadcast_i32x4(lane[0].m_rho);
+    m_rho_L = _mm512_broadcast_i32x4(lane[0].m_rho_L);
+    L = _mm512_broadcast_i32x4(lane[0].L);
+    m_q1 = _mm512_broadcast_i32x4(lane[0].m_q1);
+    mask = _mm512_broadcast_i32x4(lane[0].mask);
+
+    for (r=0; r<R; r++)
+    {
+        /* rho of lanes 0..3 in the 16 bits words 0, 2, 4 and 6 */
+        rho_lanes = _mm512_cvtepi64_epi16(rho);
+        rho01 = (uint64_t)_mm_cvtsi128_si64(rho_lanes);
+        rho23 = (uint64_t)_mm_extract_epi64(rho_lanes, 1);
+        vrows = _mm512_castsi128_si512(_mm_loadl_epi64((__m128i const*)tmp_row[rho01 & 0xffff]));
+        vrows = _mm512_inserti32x4(vrows, _mm_loadl_epi64((__m128i const*)tmp_row[(rho01 >> 32) & 0xffff]), 1);
+        vrows = _mm512_inserti32x4(vrows, _mm_loadl_epi64((__m128i const*)tmp_row[rho23 & 0xffff]), 2);
+        vrows = _mm512_inserti32x4(vrows, _mm_loadl_epi64((__m128i const*)tmp_row[(rho23 >> 32) & 0xffff]), 3);
+        vrows = _mm512_shuffle_epi8(vrows, _mm512_and_si512(q, mask));
+        bits = _mm512_movepi8_mask(vrows);
+        tmp_buf[r] = (uint8_t)bits;
+        tmp_buf[R + r] = (uint8_t)(bits >> 16);
+        tmp_buf[2*R + r] = (uint8_t)(bits >> 32);
+        tmp_buf[3*R + r] = (uint8_t)(bits >> 48);
+
+        /* turbo_qpp_rows_next, the no carry mask taken from the sign of a + b - L */
+        sum = _mm512_add_epi16(rho, g_rho);
+        sum_L = _mm512_add_epi16(rho, g_rho_L);
+        rho = _mm512_min_epu16(sum, sum_L);
+        q = _mm512_add_epi8(_mm512_add_epi8(q, g_q1), _mm512_srai_epi16(sum_L, 15));
+
+        sum = _mm512_add_epi16(g_rho, m_rho);
+        sum_L = _mm512_add_epi16(g_rho, m_rho_L);
+        g_rho = _mm512_min_epu16(sum, sum_L);
+        g_rho_L = _mm512_sub_epi16(g_rho, L);
+        g_q1 = _mm512_add_epi8(_mm512_add_epi8(g_q1, m_q1), _mm512_srai_epi16(sum_L, 15));
+    }
+}
+
+/* 16 bytes of one constituent encoder, cw holding the input bytes in reverse order. b and yr
+   carry the end state into the next 16 bytes, a is kept for the byte by byte tail. Returns the
+   parity bytes in input order. */
+static inline __m128i encoder_16bytes(__m128i cw, __m128i *a, __m128i *b, __m128i *yr)
+{
+    __m128i x, y, yt;
+
+    cw = _mm_xor_si128(cw, *b);
+    *a = a_fun(cw);
+
+    x = _mm_slli_si128(*a, 15);
+    *b = _mm_slli_epi64(x, 1);
+    *b = _mm_xor_si128(*b, x);
+    *b = _mm_slli_epi64(*b, 5);
+
+    yt = _mm_clmulepi64_si128(*a, g18, 0x11);
+    yt = _mm_xor_si128(yt, *a);
+    y = _mm_clmulepi64_si128(*a, g18, 0x10);
+    y = _mm_srli_si128(y, 8);
+    yt = _mm_xor_si128(yt, y);
+    yt = _mm_xor_si128(yt, *yr);
+
+    *yr = _mm_slli_epi64(x, 2);
+    *yr = _mm_xor_si128(x, *yr);
+    *yr = _mm_slli_epi64(*yr, 5);
+
+    return _mm_shuffle_epi8(yt, shuffleMask);
+}
+
 #define unlikely_local(x)     __builtin_expect(!!(x), 0)
 
 struct init_turbo_encoder_avx512
@@ -85,14 +181,21 @@ bblib_lte_turbo_encoder_avx512(const struct bblib_turbo_encoder_request *request
 {
     __align(64) uint8_t input_win_2[MAX_DATA_LEN_INTERLEAVE*4];
 
-    bblib_lte_turbo_interleaver_8windows_sse(request->case_id, request->input_win,
-                                            input_win_2);
+    if (request->flags & BBLIB_TURBO_QPP_ON_THE_FLY)
+    {
+        /* below 32 rows, setting up the 4 lanes of the row shuffle costs more than it saves */
+        bblib_lte_turbo_interleaver_8windows_rows(request->case_id, request->input_win, input_win_2,
+                                                  (request->length < 32) ? NULL : turbo_interleaver_rows_avx512);
+    }
+    else
+    {
+        bblib_lte_turbo_interleaver_8windows_sse(request->case_id, request->input_win, input_win_2);
+    }
 
-    __m512i cw0, cw1;
-    __m128i *ptr0, *ptr1;
+    __m512i cw0, cw1, par0, par1;
     __m128i tmp_0;
     __m128i tmp_1;
-    __m128i b0, b1, yt0, yt1, yr0, yr1, x0, x1, y0, y1;
+    __m128i b0, b1, yr0, yr1;
     __m128i a0 = {0};
     __m128i a1 = {0};
     int32_t len512, lens, idx;
@@ -125,163 +228,17 @@ bblib_lte_turbo_encoder_avx512(const struct bblib_turbo_encoder_request *request
             cw0 = _mm512_shuffle_epi8 (cw0, shuffleMask512);
             cw1 = _mm512_shuffle_epi8 (cw1, shuffleMask512);
 
-            ptr0 = (__m128i *)(&cw0);
-            ptr1 = (__m128i *)(&cw1);
-
-            ptr0[0] = _mm_xor_si128(ptr0[0], b0);
-            ptr1[0] = _mm_xor_si128(ptr1[0], b1);
-
-            a0 = a_fun(ptr0[0]);
-            a1 = a_fun(ptr1[0]);
-
-            x0 = _mm_slli_si128(a0, 15);
-            x1 = _mm_slli_si128(a1, 15);
-            b0 = _mm_slli_epi64(x0, 1);
-            b1 = _mm_slli_epi64(x1, 1);
-            b0 = _mm_xor_si128(b0, x0);
-            b1 = _mm_xor_si128(b1, x1);
-            b0 = _mm_slli_epi64(b0, 5);
-            b1 = _mm_slli_epi64(b1, 5);
-
-            yt0 = _mm_clmulepi64_si128(a0, g18, 0x11);
-            yt1 = _mm_clmulepi64_si128(a1, g18, 0x11);
-            yt0 = _mm_xor_si128(yt0, a0);
-            yt1 = _mm_xor_si128(yt1, a1);
-            y0 = _mm_clmulepi64_si128(a0, g18, 0x10);
-            y1 = _mm_clmulepi64_si128(a1, g18, 0x10);
-            y0 = _mm_srli_si128(y0, 8);
-            y1 = _mm_srli_si128(y1, 8);
-            yt0 = _mm_xor_si128(yt0, y0);
-            yt1 = _mm_xor_si128(yt1, y1);
-
-            yt0 = _mm_xor_si128(yt0, yr0);
-            yt1 = _mm_xor_si128(yt1, yr1);
-            ptr0[0] = _mm_shuffle_epi8(yt0, shuffleMask);
-            ptr1[0] = _mm_shuffle_epi8(yt1, shuffleMask);
-
-            yr0 = _mm_slli_epi64(x0, 2);
-            yr1 = _mm_slli_epi64(x1, 2);
-            yr0 = _mm_xor_si128(x0, yr0);
-            yr1 = _mm_xor_si128(x1, yr1);
-            yr0 = _mm_slli_epi64(yr0, 5);
-            yr1 = _mm_slli_epi64(yr1, 5);
-
-            ptr0[1] = _mm_xor_si128(ptr0[1], b0);
-            ptr1[1] = _mm_xor_si128(ptr1[1], b1);
-
-            a0 = a_fun(ptr0[1]);
-            a1 = a_fun(ptr1[1]);
-
-            x0 = _mm_slli_si128(a0, 15);
-            x1 = _mm_slli_si128(a1, 15);
-            b0 = _mm_slli_epi64(x0, 1);
-            b1 = _mm_slli_epi64(x1, 1);
-            b0 = _mm_xor_si128(b0, x0);
-            b1 = _mm_xor_si128(b1, x1);
-            b0 = _mm_slli_epi64(b0, 5);
-            b1 = _mm_slli_epi64(b1, 5);
-
-            yt0 = _mm_clmulepi64_si128(a0, g18, 0x11);
-            yt1 = _mm_clmulepi64_si128(a1, g18, 0x11);
-            yt0 = _mm_xor_si128(yt0, a0);
-            yt1 = _mm_xor_si128(yt1, a1);
-            y0 = _mm_clmulepi64_si128(a0, g18, 0x10);
-            y1 = _mm_clmulepi64_si128(a1, g18, 0x10);
-            y0 = _mm_srli_si128(y0, 8);
-            y1 = _mm_srli_si128(y1, 8);
-            yt0 = _mm_xor_si128(yt0, y0);
-            yt1 = _mm_xor_si128(yt1, y1);
-
-            yt0 = _mm_xor_si128(yt0, yr0);
-            yt1 = _mm_xor_si128(yt1, yr1);
-            ptr0[1] = _mm_shuffle_epi8(yt0, shuffleMask);
-            ptr1[1] = _mm_shuffle_epi8(yt1, shuffleMask);
-
-            yr0 = _mm_slli_epi64(x0, 2);
-            yr1 = _mm_slli_epi64(x1, 2);
-            yr0 = _mm_xor_si128(x0, yr0);
-            yr1 = _mm_xor_si128(x1, yr1);
-            yr0 = _mm_slli_epi64(yr0, 5);
-            yr1 = _mm_slli_epi64(yr1, 5);
-
-            ptr0[2] = _mm_xor_si128(ptr0[2], b0);
-            ptr1[2] = _mm_xor_si128(ptr1[2], b1);
-
-            a0 = a_fun(ptr0[2]);
-            a1 = a_fun(ptr1[2]);
-
-            x0 = _mm_slli_si128(a0, 15);
-            x1 = _mm_slli_si128(a1, 15);
-            b0 = _mm_slli_epi64(x0, 1);
-            b1 = _mm_slli_epi64(x1, 1);
-            b0 = _mm_xor_si128(b0, x0);
-            b1 = _mm_xor_si128(b1, x1);
-            b0 = _mm_slli_epi64(b0, 5);
-            b1 = _mm_slli_epi64(b1, 5);
-
-            yt0 = _mm_clmulepi64_si128(a0, g18, 0x11);
-            yt1 = _mm_clmulepi64_si128(a1, g18, 0x11);
-            yt0 = _mm_xor_si128(yt0, a0);
-            yt1 = _mm_xor_si128(yt1, a1);
-            y0 = _mm_clmulepi64_si128(a0, g18, 0x10);
-            y1 = _mm_clmulepi64_si128(a1, g18, 0x10);
-            y0 = _mm_srli_si128(y0, 8);
-            y1 = _mm_srli_si128(y1, 8);
-            yt0 = _mm_xor_si128(yt0, y0);
-            yt1 = _mm_xor_si128(yt1, y1);
-
-            yt0 = _mm_xor_si128(yt0, yr0);
-            yt1 = _mm_xor_si128(yt1, yr1);
-            ptr0[2] = _mm_shuffle_epi8(yt0, shuffleMask);
-            ptr1[2] = _mm_shuffle_epi8(yt1, shuffleMask);
-
-            yr0 = _mm_slli_epi64(x0, 2);
-            yr1 = _mm_slli_epi64(x1, 2);
-            yr0 = _mm_xor_si128(x0, yr0);
-            yr1 = _mm_xor_si128(x1, yr1);
-            yr0 = _mm_slli_epi64(yr0, 5);
-            yr1 = _mm_slli_epi64(yr1, 5);
-
-            ptr0[3] = _mm_xor_si128(ptr0[3], b0);
-            ptr1[3] = _mm_xor_si128(ptr1[3], b1);
-
-            a0 = a_fun(ptr0[3]);
-            a1 = a_fun(ptr1[3]);
-
-            x0 = _mm_slli_si128(a0, 15);
-            x1 = _mm_slli_si128(a1, 15);
-            b0 = _mm_slli_epi64(x0, 1);
-            b1 = _mm_slli_epi64(x1, 1);
-            b0 = _mm_xor_si128(b0, x0);
-            b1 = _mm_xor_si128(b1, x1);
-            b0 = _mm_slli_epi64(b0, 5);
-            b1 = _mm_slli_epi64(b1, 5);
-
-            yt0 = _mm_clmulepi64_si128(a0, g18, 0x11);
-            yt1 = _mm_clmulepi64_si128(a1, g18, 0x11);
-            yt0 = _mm_xor_si128(yt0, a0);
-            yt1 = _mm_xor_si128(yt1, a1);
-            y0 = _mm_clmulepi64_si128(a0, g18, 0x10);
-            y1 = _mm_clmulepi64_si128(a1, g18, 0x10);
-            y0 = _mm_srli_si128(y0, 8);
-            y1 = _mm_srli_si128(y1, 8);
-            yt0 = _mm_xor_si128(yt0, y0);
-            yt1 = _mm_xor_si128(yt1, y1);
-
-            yt0 = _mm_xor_si128(yt0, yr0);
-            yt1 = _mm_xor_si128(yt1, yr1);
-            ptr0[3] = _mm_shuffle_epi8(yt0, shuffleMask);
-            ptr1[3] = _mm_shuffle_epi8(yt1, shuffleMask);
-
-            _mm512_storeu_si512((__m512i *)(response->output_win_1 + idx), cw0);
-            _mm512_storeu_si512((__m512i *)(response->output_win_2 + idx), cw1);
-
-            yr0 = _mm_slli_epi64(x0, 2);
-            yr1 = _mm_slli_epi64(x1, 2);
-            yr0 = _mm_xor_si128(x0, yr0);
-            yr1 = _mm_xor_si128(x1, yr1);
-            yr0 = _mm_slli_epi64(yr0, 5);
-            yr1 = _mm_slli_epi64(yr1, 5);
+            par0 = _mm512_castsi128_si512(encoder_16bytes(_mm512_castsi512_si128(cw0), &a0, &b0, &yr0));
+            par1 = _mm512_castsi128_si512(encoder_16bytes(_mm512_castsi512_si128(cw1), &a1, &b1, &yr1));
+            par0 = _mm512_inserti32x4(par0, encoder_16bytes(_mm512_extracti32x4_epi32(cw0, 1), &a0, &b0, &yr0), 1);
+            par1 = _mm512_inserti32x4(par1, encoder_16bytes(_mm512_extracti32x4_epi32(cw1, 1), &a1, &b1, &yr1), 1);
+            par0 = _mm512_inserti32x4(par0, encoder_16bytes(_mm512_extracti32x4_epi32(cw0, 2), &a0, &b0, &yr0), 2);
+            par1 = _mm512_inserti32x4(par1, encoder_16bytes(_mm512_extracti32x4_epi32(cw1, 2), &a1, &b1, &yr1), 2);
+            par0 = _mm512_inserti32x4(par0, encoder_16bytes(_mm512_extracti32x4_epi32(cw0, 3), &a0, &b0, &yr0), 3);
+            par1 = _mm512_inserti32x4(par1, encoder_16bytes(_mm512_extracti32x4_epi32(cw1, 3), &a1, &b1, &yr1), 3);
+
+            _mm512_storeu_si512((__m512i *)(response->output_win_1 + idx), par0);
+            _mm512_storeu_si512((__m512i *)(response->output_win_2 + idx), par1);
         }
     }
     lens = requestLength - len512;
@@ -326,46 +283,8 @@ bblib_lte_turbo_encoder_avx512(const struct bblib_turbo_encoder_request *request
             tmp_0 = _mm_shuffle_epi8 (tmp_0, shuffleMask);
             tmp_1 = _mm_shuffle_epi8 (tmp_1, shuffleMask);
 
-            tmp_0 = _mm_xor_si128(tmp_0, b0);
-            tmp_1 = _mm_xor_si128(tmp_1, b1);
-
-            a0 = a_fun(tmp_0);
-            a1 = a_fun(tmp_1);
-
-            x0 = _mm_slli_si128(a0, 15);
-            x1 = _mm_slli_si128(a1, 15);
-            b0 = _mm_slli_epi64(x0, 1);
-            b1 = _mm_slli_epi64(x1, 1);
-            b0 = _mm_xor_si128(b0, x0);
-            b1 = _mm_xor_si128(b1, x1);
-            b0 = _mm_slli_epi64(b0, 5);
-            b1 = _mm_slli_epi64(b1, 5);
-
-            yt0 = _mm_clmulepi64_si128(a0, g18, 0x11);
-            yt1 = _mm_clmulepi64_si128(a1, g18, 0x11);
-            yt0 = _mm_xor_si128(yt0, a0);
-            yt1 = _mm_xor_si128(yt1, a1);
-            y0 = _mm_clmulepi64_si128(a0, g18, 0x10);
-            y1 = _mm_clmulepi64_si128(a1, g18, 0x10);
-            y0 = _mm_srli_si128(y0, 8);
-            y1 = _mm_srli_si128(y1, 8);
-            yt0 = _mm_xor_si128(yt0, y0);
-            yt1 = _mm_xor_si128(yt1, y1);
-
-            yt0 = _mm_xor_si128(yt0, yr0);
-            yt1 = _mm_xor_si128(yt1, yr1);
-            yt0 = _mm_shuffle_epi8(yt0, shuffleMask);
-            yt1 = _mm_shuffle_epi8(yt1, shuffleMask);
-
-            _mm_storeu_si128((__m128i *)(response->output_win_1 + len512), yt0);
-            _mm_storeu_si128((__m128i *)(response->output_win_2 + len512), yt1);
-
-            yr0 = _mm_slli_epi64(x0, 2);
-            yr1 = _mm_slli_epi64(x1, 2);
-            yr0 = _mm_xor_si128(x0, yr0);
-            yr1 = _mm_xor_si128(x1, yr1);
-            yr0 = _mm_slli_epi64(yr0, 5);
-            yr1 = _mm_slli_epi64(yr1, 5);
+            _mm_storeu_si128((__m128i *)(response->output_win_1 + len512), encoder_16bytes(tmp_0, &a0, &b0, &yr0));
+            _mm_storeu_si128((__m128i *)(response->output_win_2 + len512), encoder_16bytes(tmp_1, &a1, &b1, &yr1));
 
             len512 += 16;
             lens = requestLength - len512;
@@ -411,8 +330,8 @@ bblib_lte_turbo_encoder_avx512(const struct bblib_turbo_encoder_request *request
             Tmp1 = *(request->input_win + idx);
             Tmp2 = *(input_win_2 + idx);
 
-            TmpShort1 = g_OutputWinTable8_sdk[Tmp1][State0];
-            TmpShort2 = g_OutputWinTable8_sdk[Tmp2][State1];
+            TmpShort1 = g_OutputWinTable8_sdk.win[Tmp1][State0];
+            TmpShort2 = g_OutputWinTable8_sdk.win[Tmp2][State1];
 
             *(response->output_win_0 + idx) = Tmp1;
             *(response->output_win_1 + idx) = (uint8_t)(TmpShort1 >> 8);
@@ -39,7 +39,7 @@
 
 #if defined(_BBLIB_SSE4_2_) || defined(_BBLIB_AVX2_) || defined(_BBLIB_AVX512_)
 
-__align(64) uint16_t g_OutputWinTable8_sdk[256][8];
+constexpr turbo_output_win_table g_OutputWinTable8_sdk;
 __align(64) uint8_t g_TailWinTable_sdk[8] = {0, 60, 200, 244, 160, 156, 104, 84};
 
 /* const for 128-bit processing */
@@ -89,8 +89,10 @@ bblib_lte_turbo_encoder_sse(const struct bblib_turbo_encoder_request *request,
 {
     __align(64) uint8_t input_win_2[MAX_DATA_LEN_INTERLEAVE*4];
 
-    bblib_lte_turbo_interleaver_8windows_sse(request->case_id, request->input_win,
-                                            input_win_2);
+    if (request->flags & BBLIB_TURBO_QPP_ON_THE_FLY)
+        bblib_lte_turbo_interleaver_8windows_rows(request->case_id, request->input_win, input_win_2, NULL);
+    else
+        bblib_lte_turbo_interleaver_8windows_sse(request->case_id, request->input_win, input_win_2);
 
     __m128i cw0, cw1, b0, b1, yt0, yt1, yr0, yr1, x0, x1, y0, y1;
     __m128i a0 = {0};
@@ -290,8 +292,8 @@ bblib_lte_turbo_encoder_sse(const struct bblib_turbo_encoder_request *request,
             Tmp1 = *(request->input_win + idx);
             Tmp2 = *(input_win_2 + idx);
 
-            TmpShort1 = g_OutputWinTable8_sdk[Tmp1][State0];
-            TmpShort2 = g_OutputWinTable8_sdk[Tmp2][State1];
+            TmpShort1 = g_OutputWinTable8_sdk.win[Tmp1][State0];
+            TmpShort2 = g_OutputWinTable8_sdk.win[Tmp2][State1];
 
             *(response->output_win_0 + idx) = Tmp1;
             *(response->output_win_1 + idx) = (uint8_t)(TmpShort1 >> 8);
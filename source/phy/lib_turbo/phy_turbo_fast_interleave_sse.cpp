@@ -36,7 +36,6 @@
 
 #include "phy_turbo_internal.h"
 #if defined(_BBLIB_SSE4_2_) || defined(_BBLIB_AVX2_) || defined(_BBLIB_AVX512_)
-#define MAX_PATH_LEN 1024
 
 /**@struct _Turbo_Interleaver_Input_Assistant
  * @brief this sturcture is Turbo Interleave structure
@@ -52,17 +51,23 @@ typedef struct
     int32_t nTailBit;
 } _Turbo_Interleaver_Input_Assistant;
 
-/**@struct _Turbo_Interleaver_Input_Assistant
+/**@struct _Turbo_Interleaver_Para
  * @brief this sturcture is Turbo Interleave para structure
  */
 typedef struct 
 {
     uint8_t * pInput;
     uint8_t * pOutput;
+    /* tables of the default interleaver */
     __m128i * pvIntra_row_perm_shuffle_vector;
     int8_t * p_intra_row_perm_mode;
     int16_t * p_inter_row_out_addr;
     _Turbo_Interleaver_Input_Assistant * p_Input_Assistant;
+    /* QPP parameters of the interleaver computed on the fly */
+    int32_t K;
+    int32_t f1;
+    int32_t f2;
+    turbo_interleaver_rows_function rows; /* row shuffle, NULL for the SSE one */
 } _Turbo_Interleaver_Para;
 
 /* FastInterleave Table */
@@ -200,15 +205,96 @@ _Turbo_Interleaver_Input_Assistant g_Turbo_Intx_Input_Assistant_sdk[188];
     tmp_buf[*(p_inter_row_out_addr+cnt_tmp++)] = _mm_movemask_epi8 (vtmpf); \
 }
 
-/** @fn lte_turbo_interleaver_8windows_sse
- *  @brief  Interleaver function
- *  @param [in out] p_para
+/* The same transposes storing the rows in input order, for the interleaver computed on the fly */
+#define BIT_MATRIX_TRANSPOSE_8BYTEOUT_8Windows_IN_ORDER(vin) \
+{ \
+    vtmp0 = _mm_slli_epi16 (vin, 15); \
+    vtmp1 = _mm_slli_epi16 (vin, 14); \
+    vtmp2 = _mm_slli_epi16 (vin, 13); \
+    vtmp3 = _mm_slli_epi16 (vin, 12); \
+    vtmp4 = _mm_slli_epi16 (vin, 11); \
+    vtmp5 = _mm_slli_epi16 (vin, 10); \
+    vtmp6 = _mm_slli_epi16 (vin, 9); \
+    vtmp7 = _mm_slli_epi16 (vin, 8); \
+    vtmp0 = _mm_shuffle_epi8 (vtmp0, vrow); \
+    vtmp1 = _mm_shuffle_epi8 (vtmp1, vrow); \
+    vtmp2 = _mm_shuffle_epi8 (vtmp2, vrow); \
+    vtmp3 = _mm_shuffle_epi8 (vtmp3, vrow); \
+    vtmp4 = _mm_shuffle_epi8 (vtmp4, vrow); \
+    vtmp5 = _mm_shuffle_epi8 (vtmp5, vrow); \
+    vtmp6 = _mm_shuffle_epi8 (vtmp6, vrow); \
+    vtmp7 = _mm_shuffle_epi8 (vtmp7, vrow); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmp0); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmp1); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmp2); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmp3); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmp4); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmp5); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmp6); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmp7); \
+}
+
+#define BIT_MATRIX_TRANSPOSE_16BYTEOUT_8Windows_IN_ORDER(vin) \
+{ \
+    vtmp0 = _mm_slli_epi16 (vin, 15); \
+    vtmp1 = _mm_slli_epi16 (vin, 14); \
+    vtmp2 = _mm_slli_epi16 (vin, 13); \
+    vtmp3 = _mm_slli_epi16 (vin, 12); \
+    vtmp4 = _mm_slli_epi16 (vin, 11); \
+    vtmp5 = _mm_slli_epi16 (vin, 10); \
+    vtmp6 = _mm_slli_epi16 (vin, 9); \
+    vtmp7 = _mm_slli_epi16 (vin, 8); \
+    vtmp8 = _mm_slli_epi16 (vin, 7); \
+    vtmp9 = _mm_slli_epi16 (vin, 6); \
+    vtmpa = _mm_slli_epi16 (vin, 5); \
+    vtmpb = _mm_slli_epi16 (vin, 4); \
+    vtmpc = _mm_slli_epi16 (vin, 3); \
+    vtmpd = _mm_slli_epi16 (vin, 2); \
+    vtmpe = _mm_slli_epi16 (vin, 1); \
+    vtmpf = _mm_slli_epi16 (vin, 0); \
+    vtmp0 = _mm_shuffle_epi8 (vtmp0, vrow); \
+    vtmp1 = _mm_shuffle_epi8 (vtmp1, vrow); \
+    vtmp2 = _mm_shuffle_epi8 (vtmp2, vrow); \
+    vtmp3 = _mm_shuffle_epi8 (vtmp3, vrow); \
+    vtmp4 = _mm_shuffle_epi8 (vtmp4, vrow); \
+    vtmp5 = _mm_shuffle_epi8 (vtmp5, vrow); \
+    vtmp6 = _mm_shuffle_epi8 (vtmp6, vrow); \
+    vtmp7 = _mm_shuffle_epi8 (vtmp7, vrow); \
+    vtmp8 = _mm_shuffle_epi8 (vtmp8, vrow); \
+    vtmp9 = _mm_shuffle_epi8 (vtmp9, vrow); \
+    vtmpa = _mm_shuffle_epi8 (vtmpa, vrow); \
+    vtmpb = _mm_shuffle_epi8 (vtmpb, vrow); \
+    vtmpc = _mm_shuffle_epi8 (vtmpc, vrow); \
+    vtmpd = _mm_shuffle_epi8 (vtmpd, vrow); \
+    vtmpe = _mm_shuffle_epi8 (vtmpe, vrow); \
+    vtmpf = _mm_shuffle_epi8 (vtmpf, vrow); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmp0); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmp1); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmp2); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmp3); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmp4); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmp5); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmp6); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmp7); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmp8); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmp9); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmpa); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmpb); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmpc); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmpd); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmpe); \
+    _mm_storel_epi64 ((__m128i *)tmp_row[cnt++], vtmpf); \
+}
+
+/** @fn turbo_interleaver_8windows_concat
+ *  @brief  Bit transpose back of the interleaved rows and concatenation of the 8 windows
+ *  @param [in] tmp_buf the Lwin = K/8 interleaved rows, window j in bit j
+ *  @param [in] K code block size
+ *  @param [out] pOutput interleaved bit stream
  *  @return void
  */
-void turbo_interleaver_8windows_sse(_Turbo_Interleaver_Para * p_para)
+static void turbo_interleaver_8windows_concat(uint8_t * tmp_buf, int32_t K, uint8_t * pOutput)
 {
-    /* internal temp buffer */
-    uint8_t tmp_buf[769];
     uint16_t tmp_buf_2[384];
 
     __m128i vtmp_t;
@@ -221,89 +307,16 @@ void turbo_interleaver_8windows_sse(_Turbo_Interleaver_Para * p_para)
     __m128i vmask6 = _mm_set1_epi8(0x20);
     __m128i vmask7 = _mm_set1_epi8(0x40);
     __m128i vmask8 = _mm_set1_epi8(0x80);
-    
-    uint8_t * pInput = p_para->pInput;
-    uint8_t * pOutput = p_para->pOutput;
-    __m128i * pvIntra_row_perm_shuffle_vector = p_para->pvIntra_row_perm_shuffle_vector;
-    int8_t * p_intra_row_perm_mode = p_para->p_intra_row_perm_mode;
-    int16_t * p_inter_row_out_addr = p_para->p_inter_row_out_addr;
-    _Turbo_Interleaver_Input_Assistant * p_Input_Assistant = p_para->p_Input_Assistant;
-
-    int32_t K = p_Input_Assistant->K;
-    int32_t Nseg = p_Input_Assistant->Nseg;
 
-    __m128i * ptmp;
+    __m128i * ptmp = (__m128i *) tmp_buf;
     uint16_t * ptmp2;
 
-    int32_t i, j, cnt, cnt_tmp;
-    __m128i vA70, vB70, vC70, vD70, vE70, vF70, vG70, vH70;
-    __m128i vA701, vB701, vC701, vD701, vE701, vF701, vG701, vH701;
-    __m128i vBA30, vBA74, vDC30, vDC74, vFE30, vFE74, vHG30, vHG74;
-    __m128i vDCBA10, vDCBA32, vDCBA54, vDCBA76, vHGFE10, vHGFE32, vHGFE54, vHGFE76;
-    __m128i vHGFEBCDA0, vHGFEBCDA1, vHGFEBCDA2, vHGFEBCDA3, vHGFEBCDA4, vHGFEBCDA5, vHGFEBCDA6, vHGFEBCDA7;
-    __m128i vtmp0, vtmp1, vtmp2, vtmp3, vtmp4, vtmp5, vtmp6, vtmp7;
-    __m128i vtmp8, vtmp9, vtmpa, vtmpb, vtmpc, vtmpd, vtmpe, vtmpf;
-    __m128i vshuf = _mm_set_epi8 (7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    int32_t i, j;
+    int32_t Lwin = K/8;
+    __m128i vtmp0, vtmp1, vtmp2, vtmp3, vtmp4, vtmp5, vtmp6, vtmp7, vtmp8;
     __m128i vAllOne = _mm_set1_epi8 (0xff);
     __m128i vout, vout1;
 
-    /* matrix transpose 1, intra-row shuffle and inter-row shuffle */
-    cnt = 0;
-    ptmp = (__m128i *) tmp_buf;
-    for (i=0; i<Nseg; i++)
-    {
-        vA701 = _mm_lddqu_si128 ((__m128i const*) (pInput+p_Input_Assistant->ByteInAddr[i][0]));
-        _MM_BR_EPI128(vA701, vA70);        _MM_SLLI_EPI128(vA70, vA70, p_Input_Assistant->BitLeftShift[i][0]);
-        vB701 = _mm_lddqu_si128 ((__m128i const*) (pInput+p_Input_Assistant->ByteInAddr[i][1]));
-        _MM_BR_EPI128(vB701, vB70);        _MM_SLLI_EPI128(vB70, vB70, p_Input_Assistant->BitLeftShift[i][1]);
-        vC701 = _mm_lddqu_si128 ((__m128i const*) (pInput+p_Input_Assistant->ByteInAddr[i][2]));
-        _MM_BR_EPI128(vC701, vC70);        _MM_SLLI_EPI128(vC70, vC70, p_Input_Assistant->BitLeftShift[i][2]);
-        vD701 = _mm_lddqu_si128 ((__m128i const*) (pInput+p_Input_Assistant->ByteInAddr[i][3]));
-        _MM_BR_EPI128(vD701, vD70);        _MM_SLLI_EPI128(vD70, vD70, p_Input_Assistant->BitLeftShift[i][3]);
-        vE701 = _mm_lddqu_si128 ((__m128i const*) (pInput+p_Input_Assistant->ByteInAddr[i][4]));
-        _MM_BR_EPI128(vE701, vE70);        _MM_SLLI_EPI128(vE70, vE70, p_Input_Assistant->BitLeftShift[i][4]);
-        vF701 = _mm_lddqu_si128 ((__m128i const*) (pInput+p_Input_Assistant->ByteInAddr[i][5]));
-        _MM_BR_EPI128(vF701, vF70);        _MM_SLLI_EPI128(vF70, vF70, p_Input_Assistant->BitLeftShift[i][5]);
-        vG701 = _mm_lddqu_si128 ((__m128i const*) (pInput+p_Input_Assistant->ByteInAddr[i][6]));
-        _MM_BR_EPI128(vG701, vG70);        _MM_SLLI_EPI128(vG70, vG70, p_Input_Assistant->BitLeftShift[i][6]);
-        vH701 = _mm_lddqu_si128 ((__m128i const*) (pInput+p_Input_Assistant->ByteInAddr[i][7]));
-        _MM_BR_EPI128(vH701, vH70);        _MM_SLLI_EPI128(vH70, vH70, p_Input_Assistant->BitLeftShift[i][7]);
-
-        vBA30 = _mm_unpacklo_epi16 (vA70, vB70); 
-        vBA74 = _mm_unpackhi_epi16 (vA70, vB70);
-        vDC30 = _mm_unpacklo_epi16 (vC70, vD70);
-        vDC74 = _mm_unpackhi_epi16 (vC70, vD70);
-        vFE30 = _mm_unpacklo_epi16 (vE70, vF70);
-        vFE74 = _mm_unpackhi_epi16 (vE70, vF70);
-        vHG30 = _mm_unpacklo_epi16 (vG70, vH70);
-        vHG74 = _mm_unpackhi_epi16 (vG70, vH70);
-        vDCBA10 = _mm_unpacklo_epi32 (vBA30, vDC30); 
-        vDCBA32 = _mm_unpackhi_epi32 (vBA30, vDC30);
-        vDCBA54 = _mm_unpacklo_epi32 (vBA74, vDC74);
-        vDCBA76 = _mm_unpackhi_epi32 (vBA74, vDC74);
-        vHGFE10 = _mm_unpacklo_epi32 (vFE30, vHG30); 
-        vHGFE32 = _mm_unpackhi_epi32 (vFE30, vHG30);
-        vHGFE54 = _mm_unpacklo_epi32 (vFE74, vHG74);
-        vHGFE76 = _mm_unpackhi_epi32 (vFE74, vHG74);
-        vHGFEBCDA0 = _mm_unpacklo_epi64 (vDCBA10, vHGFE10);
-        vHGFEBCDA1 = _mm_unpackhi_epi64 (vDCBA10, vHGFE10);
-        vHGFEBCDA2 = _mm_unpacklo_epi64 (vDCBA32, vHGFE32);
-        vHGFEBCDA3 = _mm_unpackhi_epi64 (vDCBA32, vHGFE32);
-        vHGFEBCDA4 = _mm_unpacklo_epi64 (vDCBA54, vHGFE54);
-        vHGFEBCDA5 = _mm_unpackhi_epi64 (vDCBA54, vHGFE54);
-        vHGFEBCDA6 = _mm_unpacklo_epi64 (vDCBA76, vHGFE76);
-        vHGFEBCDA7 = _mm_unpackhi_epi64 (vDCBA76, vHGFE76);
-        
-        BIT_MATRIX_TRANSPOSE_16BYTEOUT_8Windows(vHGFEBCDA0);
-        BIT_MATRIX_TRANSPOSE_16BYTEOUT_8Windows(vHGFEBCDA1);
-        BIT_MATRIX_TRANSPOSE_16BYTEOUT_8Windows(vHGFEBCDA2);
-        BIT_MATRIX_TRANSPOSE_16BYTEOUT_8Windows(vHGFEBCDA3);
-        BIT_MATRIX_TRANSPOSE_16BYTEOUT_8Windows(vHGFEBCDA4);
-        BIT_MATRIX_TRANSPOSE_16BYTEOUT_8Windows(vHGFEBCDA5);
-        BIT_MATRIX_TRANSPOSE_16BYTEOUT_8Windows(vHGFEBCDA6);
-        BIT_MATRIX_TRANSPOSE_8BYTEOUT_8Windows(vHGFEBCDA7);
-    }
-
     /* bit transpose back */
     int32_t Nseg2 = (K%128!=0) ? (K/128 + 1) : (K/128);
     for (i=0; i<Nseg2; i++)
@@ -328,7 +341,6 @@ void turbo_interleaver_8windows_sse(_Turbo_Interleaver_Para * p_para)
     }
 
     /* concatenation */
-    int32_t Lwin = K/8;
     int32_t Nseg3 = Lwin/64;
     int32_t nRestBit = (Lwin%64!=0) ? (Lwin%64) : 0;
     int32_t running_rest_bit = 0;
@@ -382,54 +394,328 @@ void turbo_interleaver_8windows_sse(_Turbo_Interleaver_Para * p_para)
     return;
 }
 
-/* used to generate interleave table */
-static void initInterleaveTable(char* pTabelPath, void* p1, int8_t (*p2)[840], int16_t (*p3)[840], void* p4)
+/** @fn lte_turbo_interleaver_8windows_sse
+ *  @brief  Interleaver function
+ *  @param [in out] p_para
+ *  @return void
+ */
+void turbo_interleaver_8windows_sse(_Turbo_Interleaver_Para * p_para)
 {
-    FILE * fp;
-    int32_t count;
-    char filename[MAX_PATH_LEN];
-    char interleavetable[] = "/source/phy/lib_turbo/Fast_LteTurboInterleaver.bin";
-    int32_t table_pathlen = strlen(pTabelPath);
+    /* internal temp buffer */
+    uint8_t tmp_buf[769];
+
+    __m128i vtmp_t;
+
+    __m128i vmask1 = _mm_set1_epi8(0x01);
+    __m128i vmask2 = _mm_set1_epi8(0x02);
+    __m128i vmask3 = _mm_set1_epi8(0x04);
+    __m128i vmask4 = _mm_set1_epi8(0x08);
+    __m128i vmask5 = _mm_set1_epi8(0x10);
+    __m128i vmask6 = _mm_set1_epi8(0x20);
+    __m128i vmask7 = _mm_set1_epi8(0x40);
+    __m128i vmask8 = _mm_set1_epi8(0x80);
+    
+    uint8_t * pInput = p_para->pInput;
+    uint8_t * pOutput = p_para->pOutput;
+    __m128i * pvIntra_row_perm_shuffle_vector = p_para->pvIntra_row_perm_shuffle_vector;
+    int8_t * p_intra_row_perm_mode = p_para->p_intra_row_perm_mode;
+    int16_t * p_inter_row_out_addr = p_para->p_inter_row_out_addr;
+    _Turbo_Interleaver_Input_Assistant * p_Input_Assistant = p_para->p_Input_Assistant;
+
+    int32_t K = p_Input_Assistant->K;
+    int32_t Nseg = p_Input_Assistant->Nseg;
+
+    int32_t i, cnt, cnt_tmp;
+    __m128i vA70, vB70, vC70, vD70, vE70, vF70, vG70, vH70;
+    __m128i vA701, vB701, vC701, vD701, vE701, vF701, vG701, vH701;
+    __m128i vBA30, vBA74, vDC30, vDC74, vFE30, vFE74, vHG30, vHG74;
+    __m128i vDCBA10, vDCBA32, vDCBA54, vDCBA76, vHGFE10, vHGFE32, vHGFE54, vHGFE76;
+    __m128i vHGFEBCDA0, vHGFEBCDA1, vHGFEBCDA2, vHGFEBCDA3, vHGFEBCDA4, vHGFEBCDA5, vHGFEBCDA6, vHGFEBCDA7;
+    __m128i vtmp0, vtmp1, vtmp2, vtmp3, vtmp4, vtmp5, vtmp6, vtmp7;
+    __m128i vtmp8, vtmp9, vtmpa, vtmpb, vtmpc, vtmpd, vtmpe, vtmpf;
+    __m128i vshuf = _mm_set_epi8 (7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
 
-    if ((strlen(interleavetable) + table_pathlen) >= (sizeof(filename) - 64))
+    /* matrix transpose 1, intra-row shuffle and inter-row shuffle */
+    cnt = 0;
+    for (i=0; i<Nseg; i++)
     {
-        printf("config invalid: tablePath = %s\n", pTabelPath);
-        return ;
+        vA701 = _mm_lddqu_si128 ((__m128i const*) (pInput+p_Input_Assistant->ByteInAddr[i][0]));
+        _MM_BR_EPI128(vA701, vA70);        _MM_SLLI_EPI128(vA70, vA70, p_Input_Assistant->BitLeftShift[i][0]);
+        vB701 = _mm_lddqu_si128 ((__m128i const*) (pInput+p_Input_Assistant->ByteInAddr[i][1]));
+        _MM_BR_EPI128(vB701, vB70);        _MM_SLLI_EPI128(vB70, vB70, p_Input_Assistant->BitLeftShift[i][1]);
+        vC701 = _mm_lddqu_si128 ((__m128i const*) (pInput+p_Input_Assistant->ByteInAddr[i][2]));
+        _MM_BR_EPI128(vC701, vC70);        _MM_SLLI_EPI128(vC70, vC70, p_Input_Assistant->BitLeftShift[i][2]);
+        vD701 = _mm_lddqu_si128 ((__m128i const*) (pInput+p_Input_Assistant->ByteInAddr[i][3]));
+        _MM_BR_EPI128(vD701, vD70);        _MM_SLLI_EPI128(vD70, vD70, p_Input_Assistant->BitLeftShift[i][3]);
+        vE701 = _mm_lddqu_si128 ((__m128i const*) (pInput+p_Input_Assistant->ByteInAddr[i][4]));
+        _MM_BR_EPI128(vE701, vE70);        _MM_SLLI_EPI128(vE70, vE70, p_Input_Assistant->BitLeftShift[i][4]);
+        vF701 = _mm_lddqu_si128 ((__m128i const*) (pInput+p_Input_Assistant->ByteInAddr[i][5]));
+        _MM_BR_EPI128(vF701, vF70);        _MM_SLLI_EPI128(vF70, vF70, p_Input_Assistant->BitLeftShift[i][5]);
+        vG701 = _mm_lddqu_si128 ((__m128i const*) (pInput+p_Input_Assistant->ByteInAddr[i][6]));
+        _MM_BR_EPI128(vG701, vG70);        _MM_SLLI_EPI128(vG70, vG70, p_Input_Assistant->BitLeftShift[i][6]);
+        vH701 = _mm_lddqu_si128 ((__m128i const*) (pInput+p_Input_Assistant->ByteInAddr[i][7]));
+        _MM_BR_EPI128(vH701, vH70);        _MM_SLLI_EPI128(vH70, vH70, p_Input_Assistant->BitLeftShift[i][7]);
+
+        vBA30 = _mm_unpacklo_epi16 (vA70, vB70); 
+        vBA74 = _mm_unpackhi_epi16 (vA70, vB70);
+        vDC30 = _mm_unpacklo_epi16 (vC70, vD70);
+        vDC74 = _mm_unpackhi_epi16 (vC70, vD70);
+        vFE30 = _mm_unpacklo_epi16 (vE70, vF70);
+        vFE74 = _mm_unpackhi_epi16 (vE70, vF70);
+        vHG30 = _mm_unpacklo_epi16 (vG70, vH70);
+        vHG74 = _mm_unpackhi_epi16 (vG70, vH70);
+        vDCBA10 = _mm_unpacklo_epi32 (vBA30, vDC30); 
+        vDCBA32 = _mm_unpackhi_epi32 (vBA30, vDC30);
+        vDCBA54 = _mm_unpacklo_epi32 (vBA74, vDC74);
+        vDCBA76 = _mm_unpackhi_epi32 (vBA74, vDC74);
+        vHGFE10 = _mm_unpacklo_epi32 (vFE30, vHG30); 
+        vHGFE32 = _mm_unpackhi_epi32 (vFE30, vHG30);
+        vHGFE54 = _mm_unpacklo_epi32 (vFE74, vHG74);
+        vHGFE76 = _mm_unpackhi_epi32 (vFE74, vHG74);
+        vHGFEBCDA0 = _mm_unpacklo_epi64 (vDCBA10, vHGFE10);
+        vHGFEBCDA1 = _mm_unpackhi_epi64 (vDCBA10, vHGFE10);
+        vHGFEBCDA2 = _mm_unpacklo_epi64 (vDCBA32, vHGFE32);
+        vHGFEBCDA3 = _mm_unpackhi_epi64 (vDCBA32, vHGFE32);
+        vHGFEBCDA4 = _mm_unpacklo_epi64 (vDCBA54, vHGFE54);
+        vHGFEBCDA5 = _mm_unpackhi_epi64 (vDCBA54, vHGFE54);
+        vHGFEBCDA6 = _mm_unpacklo_epi64 (vDCBA76, vHGFE76);
+        vHGFEBCDA7 = _mm_unpackhi_epi64 (vDCBA76, vHGFE76);
+        
+        BIT_MATRIX_TRANSPOSE_16BYTEOUT_8Windows(vHGFEBCDA0);
+        BIT_MATRIX_TRANSPOSE_16BYTEOUT_8Windows(vHGFEBCDA1);
+        BIT_MATRIX_TRANSPOSE_16BYTEOUT_8Windows(vHGFEBCDA2);
+        BIT_MATRIX_TRANSPOSE_16BYTEOUT_8Windows(vHGFEBCDA3);
+        BIT_MATRIX_TRANSPOSE_16BYTEOUT_8Windows(vHGFEBCDA4);
+        BIT_MATRIX_TRANSPOSE_16BYTEOUT_8Windows(vHGFEBCDA5);
+        BIT_MATRIX_TRANSPOSE_16BYTEOUT_8Windows(vHGFEBCDA6);
+        BIT_MATRIX_TRANSPOSE_8BYTEOUT_8Windows(vHGFEBCDA7);
     }
 
-    memset(filename, 0, sizeof(filename));
-    strncpy(filename, pTabelPath, sizeof(filename) - 64);
-    filename[table_pathlen] = '\0';
-    strncat(filename, interleavetable, sizeof(interleavetable) + 1);
+    turbo_interleaver_8windows_concat(tmp_buf, K, pOutput);
+}
+
+/** @fn turbo_interleaver_8windows_qpp_sse
+ *  @brief  Interleaver function, rows computed from the QPP parameters
+ *  @param [in out] p_para
+ *  @return void
+ */
+void turbo_interleaver_8windows_qpp_sse(_Turbo_Interleaver_Para * p_para)
+{
+    /* internal temp buffer */
+    int8_t tmp_row[840][8];
+    uint8_t tmp_buf[768 + 4];
+
+    __m128i vtmp_t;
+
+    __m128i vmask1 = _mm_set1_epi8(0x01);
+    __m128i vmask2 = _mm_set1_epi8(0x02);
+    __m128i vmask3 = _mm_set1_epi8(0x04);
+    __m128i vmask4 = _mm_set1_epi8(0x08);
+    __m128i vmask5 = _mm_set1_epi8(0x10);
+    __m128i vmask6 = _mm_set1_epi8(0x20);
+    __m128i vmask7 = _mm_set1_epi8(0x40);
+    __m128i vmask8 = _mm_set1_epi8(0x80);
+    
+    uint8_t * pInput = p_para->pInput;
+    uint8_t * pOutput = p_para->pOutput;
+
+    int32_t K = p_para->K;
+    int32_t Lwin = K/8;
+    int32_t Nseg = (Lwin + 119)/120;
+    struct turbo_qpp_rows rows;
+
+    int32_t i, r, cnt, pos;
+    __m128i vA70, vB70, vC70, vD70, vE70, vF70, vG70, vH70;
+    __m128i vA701, vB701, vC701, vD701, vE701, vF701, vG701, vH701;
+    __m128i vBA30, vBA74, vDC30, vDC74, vFE30, vFE74, vHG30, vHG74;
+    __m128i vDCBA10, vDCBA32, vDCBA54, vDCBA76, vHGFE10, vHGFE32, vHGFE54, vHGFE76;
+    __m128i vHGFEBCDA0, vHGFEBCDA1, vHGFEBCDA2, vHGFEBCDA3, vHGFEBCDA4, vHGFEBCDA5, vHGFEBCDA6, vHGFEBCDA7;
+    __m128i vtmp0, vtmp1, vtmp2, vtmp3, vtmp4, vtmp5, vtmp6, vtmp7;
+    __m128i vtmp8, vtmp9, vtmpa, vtmpb, vtmpc, vtmpd, vtmpe, vtmpf;
+    __m128i vshuf = _mm_set_epi8 (7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    /* after the shift, bit n of the window j word is the MSB of byte 2j+1 */
+    __m128i vrow = _mm_set_epi8 (14, 12, 10, 8, 6, 4, 2, 0, 15, 13, 11, 9, 7, 5, 3, 1);
 
-    fp = fopen(filename, "rb");
-    if(fp != NULL)
+    /* matrix transpose 1, rows of 120 bits of the 8 windows, window j in the MSB of byte j */
+    cnt = 0;
+    for (i=0; i<Nseg; i++)
     {
-        count = fread(p1, sizeof(int8_t), 1024, fp);
-        for(int l = 0; l < 188; l++)
-             count = fread(p2[l], sizeof(int8_t), 840, fp);
-        for(int l = 0; l < 188; l++)
-             count = fread(p3[l], sizeof(int16_t), 840, fp);
-          
-        count = fread(p4, sizeof(_Turbo_Interleaver_Input_Assistant), 188, fp);
-        fclose(fp);
+        pos = 0*Lwin + i*120;
+        vA701 = _mm_lddqu_si128 ((__m128i const*) (pInput+(pos>>3)));
+        _MM_BR_EPI128(vA701, vA70);        _MM_SLLI_EPI128(vA70, vA70, (pos&7));
+        pos = 1*Lwin + i*120;
+        vB701 = _mm_lddqu_si128 ((__m128i const*) (pInput+(pos>>3)));
+        _MM_BR_EPI128(vB701, vB70);        _MM_SLLI_EPI128(vB70, vB70, (pos&7));
+        pos = 2*Lwin + i*120;
+        vC701 = _mm_lddqu_si128 ((__m128i const*) (pInput+(pos>>3)));
+        _MM_BR_EPI128(vC701, vC70);        _MM_SLLI_EPI128(vC70, vC70, (pos&7));
+        pos = 3*Lwin + i*120;
+        vD701 = _mm_lddqu_si128 ((__m128i const*) (pInput+(pos>>3)));
+        _MM_BR_EPI128(vD701, vD70);        _MM_SLLI_EPI128(vD70, vD70, (pos&7));
+        pos = 4*Lwin + i*120;
+        vE701 = _mm_lddqu_si128 ((__m128i const*) (pInput+(pos>>3)));
+        _MM_BR_EPI128(vE701, vE70);        _MM_SLLI_EPI128(vE70, vE70, (pos&7));
+        pos = 5*Lwin + i*120;
+        vF701 = _mm_lddqu_si128 ((__m128i const*) (pInput+(pos>>3)));
+        _MM_BR_EPI128(vF701, vF70);        _MM_SLLI_EPI128(vF70, vF70, (pos&7));
+        pos = 6*Lwin + i*120;
+        vG701 = _mm_lddqu_si128 ((__m128i const*) (pInput+(pos>>3)));
+        _MM_BR_EPI128(vG701, vG70);        _MM_SLLI_EPI128(vG70, vG70, (pos&7));
+        pos = 7*Lwin + i*120;
+        vH701 = _mm_lddqu_si128 ((__m128i const*) (pInput+(pos>>3)));
+        _MM_BR_EPI128(vH701, vH70);        _MM_SLLI_EPI128(vH70, vH70, (pos&7));
+
+        vBA30 = _mm_unpacklo_epi16 (vA70, vB70); 
+        vBA74 = _mm_unpackhi_epi16 (vA70, vB70);
+        vDC30 = _mm_unpacklo_epi16 (vC70, vD70);
+        vDC74 = _mm_unpackhi_epi16 (vC70, vD70);
+        vFE30 = _mm_unpacklo_epi16 (vE70, vF70);
+        vFE74 = _mm_unpackhi_epi16 (vE70, vF70);
+        vHG30 = _mm_unpacklo_epi16 (vG70, vH70);
+        vHG74 = _mm_unpackhi_epi16 (vG70, vH70);
+        vDCBA10 = _mm_unpacklo_epi32 (vBA30, vDC30); 
+        vDCBA32 = _mm_unpackhi_epi32 (vBA30, vDC30);
+        vDCBA54 = _mm_unpacklo_epi32 (vBA74, vDC74);
+        vDCBA76 = _mm_unpackhi_epi32 (vBA74, vDC74);
+        vHGFE10 = _mm_unpacklo_epi32 (vFE30, vHG30); 
+        vHGFE32 = _mm_unpackhi_epi32 (vFE30, vHG30);
+        vHGFE54 = _mm_unpacklo_epi32 (vFE74, vHG74);
+        vHGFE76 = _mm_unpackhi_epi32 (vFE74, vHG74);
+        vHGFEBCDA0 = _mm_unpacklo_epi64 (vDCBA10, vHGFE10);
+        vHGFEBCDA1 = _mm_unpackhi_epi64 (vDCBA10, vHGFE10);
+        vHGFEBCDA2 = _mm_unpacklo_epi64 (vDCBA32, vHGFE32);
+        vHGFEBCDA3 = _mm_unpackhi_epi64 (vDCBA32, vHGFE32);
+        vHGFEBCDA4 = _mm_unpacklo_epi64 (vDCBA54, vHGFE54);
+        vHGFEBCDA5 = _mm_unpackhi_epi64 (vDCBA54, vHGFE54);
+        vHGFEBCDA6 = _mm_unpacklo_epi64 (vDCBA76, vHGFE76);
+        vHGFEBCDA7 = _mm_unpackhi_epi64 (vDCBA76, vHGFE76);
+        
+        BIT_MATRIX_TRANSPOSE_16BYTEOUT_8Windows_IN_ORDER(vHGFEBCDA0);
+        BIT_MATRIX_TRANSPOSE_16BYTEOUT_8Windows_IN_ORDER(vHGFEBCDA1);
+        BIT_MATRIX_TRANSPOSE_16BYTEOUT_8Windows_IN_ORDER(vHGFEBCDA2);
+        BIT_MATRIX_TRANSPOSE_16BYTEOUT_8Windows_IN_ORDER(vHGFEBCDA3);
+        BIT_MATRIX_TRANSPOSE_16BYTEOUT_8Windows_IN_ORDER(vHGFEBCDA4);
+        BIT_MATRIX_TRANSPOSE_16BYTEOUT_8Windows_IN_ORDER(vHGFEBCDA5);
+        BIT_MATRIX_TRANSPOSE_16BYTEOUT_8Windows_IN_ORDER(vHGFEBCDA6);
+        BIT_MATRIX_TRANSPOSE_8BYTEOUT_8Windows_IN_ORDER(vHGFEBCDA7);
+    }
+
+    /* intra-row and inter-row shuffle: output row r is input row rho, bit j taking window q[j] */
+    if (p_para->rows != NULL)
+    {
+        p_para->rows(tmp_row, tmp_buf, K, p_para->f1, p_para->f2);
     }
     else
     {
-      printf("Cannot open fast interleaver table: %s\n", filename);
-      return ;
+        turbo_qpp_rows_init(&rows, K, p_para->f1, p_para->f2, 8, 0);
+        for (r=0; r<Lwin; r++)
+        {
+            vtmp0 = _mm_loadl_epi64 ((__m128i const*)tmp_row[turbo_qpp_rows_rho(&rows)]);
+            vtmp0 = _mm_shuffle_epi8 (vtmp0, turbo_qpp_rows_q(&rows));
+            tmp_buf[r] = (uint8_t)_mm_movemask_epi8 (vtmp0);
+            turbo_qpp_rows_next(&rows);
+        }
     }
+
+    turbo_interleaver_8windows_concat(tmp_buf, K, pOutput);
 }
 
+/** @fn lte_turbo_interleaver_initTable
+ *  @brief  Interleave table init, computed from the QPP parameters.
+ *          The code block is split in 8 windows of Lwin bits, bit j*Lwin+i being window j of row i.
+ *          Since pi(x+Lwin) = pi(x) mod Lwin, output row r gathers input row pi(r) mod Lwin, with
+ *          its windows permuted by one of the 64 shuffle vectors. Rows are processed 120 at a time.
+ *  @return void
+ */
 void
-bblib_lte_turbo_interleaver_initTable(char* pTabelPath)
+bblib_lte_turbo_interleaver_initTable()
 {
-    /* FastInterleave Table */
-    void *p1, *p4;
-    p1 = (void*)&g_vIntra_row_perm_shuffle_vector[0];
-    p4 = (void*)&g_Turbo_Intx_Input_Assistant_sdk[0];
+    int32_t Kidx, i, j, m, K, Lwin, f1, f2, r, rest;
+    int32_t num_vector = 0;
+    int32_t row_of_rem[768];
+    int16_t pi[6144];
+    uint32_t h, key, vector_key[64];
+    int8_t vector_hash[256];
+    int8_t shuffle[16];
+    _Turbo_Interleaver_Input_Assistant * p_Input_Assistant;
+
+    memset(vector_hash, -1, sizeof(vector_hash));
+    for (Kidx = 0; Kidx < 188; Kidx++)
+    {
+        K = g_TurboQPP_sdk[Kidx][0];
+        f1 = g_TurboQPP_sdk[Kidx][1];
+        f2 = g_TurboQPP_sdk[Kidx][2];
+        Lwin = K / 8;
+        turbo_qpp_table(K, f1, f2, pi);
+
+        /* byte and bit offset of the 120 rows segments in each window */
+        p_Input_Assistant = &g_Turbo_Intx_Input_Assistant_sdk[Kidx];
+        memset(p_Input_Assistant, 0, sizeof(_Turbo_Interleaver_Input_Assistant));
+        p_Input_Assistant->K = K;
+        p_Input_Assistant->Lwin = Lwin;
+        p_Input_Assistant->Nseg = (Lwin + 119) / 120;
+        for (i = 0; i < p_Input_Assistant->Nseg; i++)
+        {
+            for (j = 0; j < 8; j++)
+            {
+                p_Input_Assistant->ByteInAddr[i][j] = (int16_t)((j * Lwin + i * 120) >> 3);
+                p_Input_Assistant->BitLeftShift[i][j] = (int8_t)((j * Lwin + i * 120) & 7);
+            }
+        }
+        rest = Lwin % 120;
+        p_Input_Assistant->nTailByte = rest >> 3;
+        p_Input_Assistant->nTailBit = rest & 7;
+
+        /* rows past Lwin are written to the spare byte of the temp buffer */
+        for (i = 0; i < 840; i++)
+        {
+            g_intra_row_perm_mode_sdk[Kidx][i] = 0;
+            g_inter_row_out_addr_sdk[Kidx][i] = 768;
+        }
+        for (i = 0; i < Lwin; i++)
+        {
+            row_of_rem[pi[i] % Lwin] = i;
+        }
+        for (i = 0; i < Lwin; i++)
+        {
+            /* input row i goes to output row r, bit m of which is window key[3m+2:3m] of row i */
+            r = row_of_rem[i];
+            key = 0;
+            for (m = 0; m < 8; m++)
+            {
+                key |= (uint32_t)(pi[m * Lwin + r] / Lwin) << (3 * m);
+            }
+            h = (key * 0x9E3779B1u) >> 24;
+            while ((vector_hash[h] >= 0) && (vector_key[vector_hash[h]] != key))
+            {
+                h = (h + 1) & 255;
+            }
+            if (vector_hash[h] < 0)
+            {
+                if (num_vector == 64)
+                {
+                    printf("turbo interleaver shuffle vector table is full\n");
+                    return;
+                }
+                vector_hash[h] = (int8_t)num_vector;
+                vector_key[num_vector++] = key;
+            }
+            j = vector_hash[h];
+            g_intra_row_perm_mode_sdk[Kidx][i] = (int8_t)j;
+            g_inter_row_out_addr_sdk[Kidx][i] = (int16_t)r;
+        }
+    }
 
-    initInterleaveTable(pTabelPath, p1, g_intra_row_perm_mode_sdk,g_inter_row_out_addr_sdk,p4);
+    /* after the shift, bit n of the window j word is the MSB of byte 2j+1 */
+    for (j = 0; j < num_vector; j++)
+    {
+        for (m = 0; m < 8; m++)
+        {
+            shuffle[m] = (int8_t)(2 * ((vector_key[j] >> (3 * m)) & 7) + 1);
+            shuffle[m + 8] = shuffle[m] - 1;
+        }
+        g_vIntra_row_perm_shuffle_vector[j] = _mm_loadu_si128((__m128i const*)shuffle);
+    }
 }
 
 int32_t
@@ -441,7 +727,7 @@ bblib_lte_turbo_interleaver_8windows_sse(uint8_t caseId, uint8_t *pInData, uint8
     Turbo_Interleaver_Para.pOutput = pOutData;
 
     Turbo_Interleaver_Para.pvIntra_row_perm_shuffle_vector = &g_vIntra_row_perm_shuffle_vector[0];
-    if(caseId > 0)
+    if((caseId > 0) && (caseId <= 188))
     {
         Turbo_Interleaver_Para.p_intra_row_perm_mode = &g_intra_row_perm_mode_sdk[caseId-1][0];
         Turbo_Interleaver_Para.p_inter_row_out_addr = &g_inter_row_out_addr_sdk[caseId-1][0];
@@ -455,12 +741,46 @@ bblib_lte_turbo_interleaver_8windows_sse(uint8_t caseId, uint8_t *pInData, uint8
         return 0; /* case id is invalid.*/
     }
     
+}
+
+int32_t
+bblib_lte_turbo_interleaver_8windows_rows(uint8_t caseId, uint8_t *pInData, uint8_t* pOutData,
+                                          turbo_interleaver_rows_function rows)
+{
+    _Turbo_Interleaver_Para Turbo_Interleaver_Para;
+
+    Turbo_Interleaver_Para.pInput = pInData;
+    Turbo_Interleaver_Para.pOutput = pOutData;
+    Turbo_Interleaver_Para.rows = rows;
+
+    if((caseId > 0) && (caseId <= 188))
+    {
+        Turbo_Interleaver_Para.K = g_TurboQPP_sdk[caseId-1][0];
+        Turbo_Interleaver_Para.f1 = g_TurboQPP_sdk[caseId-1][1];
+        Turbo_Interleaver_Para.f2 = g_TurboQPP_sdk[caseId-1][2];
+
+        turbo_interleaver_8windows_qpp_sse( &Turbo_Interleaver_Para );
+        return 1;
+    }
+    else
+    {
+        return 0; /* case id is invalid.*/
+    }
+    
 }
 #else
+int32_t
+bblib_lte_turbo_interleaver_8windows_rows(uint8_t caseId, uint8_t *pInData, uint8_t* pOutData,
+                                          turbo_interleaver_rows_function rows)
+{
+    printf("bblib_turbo requires at least SSE4.2 ISA support to run\n");
+    return(-1);
+}
+
 int32_t
 bblib_lte_turbo_interleaver_8windows_sse(uint8_t caseId, uint8_t *pInData, uint8_t* pOutData)
 {
     printf("bblib_turbo requires at least SSE4.2 ISA support to run\n");
     return(-1);
 }
-#endif
\ No newline at end of file
+#endif
@@ -26,8 +26,10 @@
 #define _PHY_TURBO_INTERNAL_H_
 
 #include <stdint.h>
+#include <immintrin.h>
 #include "common_typedef_sdk.h"
 #include "bblib_common_const.h"
+#include "phy_turbo.h"
 
 #define MAX_DATA_LEN_INTERLEAVE (8192)
 
@@ -42,6 +44,152 @@ typedef struct {
 
 extern _TurboInterleaver g_TurboInterleaver;
 
+/* Interleaver rows of one code block for the 16 windows decoders computed on the fly, Lwin = K/16
+   rows. Interleaver row i uses pattern i, deinterleaver row i pattern Lwin+i */
+typedef struct alignas(64) {
+    int8_t pattern[768][16];
+    int32_t inter_row_out_addr_for_interleaver[384];
+    int32_t inter_row_out_addr_for_deinterleaver[384];
+    int32_t intra_row_perm_pattern_for_interleaver[384];
+    int32_t intra_row_perm_pattern_for_deinterleaver[384];
+} _TurboInterleaverRows;
+
+/* Interleaver rows of the code block the 16 windows decoders use, in g_TurboInterleaver or in a
+   _TurboInterleaverRows */
+struct turbo_decoder_interleaver {
+    int8_t *pattern;
+    int32_t *inter_row_out_addr_for_interleaver;
+    int32_t *inter_row_out_addr_for_deinterleaver;
+    int32_t *intra_row_perm_pattern_for_interleaver;
+    int32_t *intra_row_perm_pattern_for_deinterleaver;
+};
+
+/* TS36.212 Table 5.1.3-3, {K, f1, f2} for each Kidx */
+extern const int16_t g_TurboQPP_sdk[188][3];
+
+/* Smallest |LLR| of the code block above which the decoders check the CRC for early termination,
+   INT8_MAX, above any min_dist, when there is no early termination */
+static inline int32_t turbo_early_term_min_dist(int32_t max_iter_num, int32_t early_term_disable)
+{
+    if (max_iter_num == 0)
+        return INT8_MAX;
+    if (early_term_disable == BBLIB_TURBO_EARLY_TERM)
+        return 2;
+    if (early_term_disable == BBLIB_TURBO_EARLY_TERM_FAST)
+        return 0;
+    return INT8_MAX;
+}
+
+/* Turbo code internal interleaver pi(x) = (f1*x + f2*x^2) mod K of TS36.212 section 5.1.3.2.3 for
+   x = 0..K-1, using pi(x+1) = pi(x) + g(x) and g(x+1) = g(x) + 2*f2 mod K */
+static inline void turbo_qpp_table(int32_t K, int32_t f1, int32_t f2, int16_t *pi)
+{
+    const int32_t m = (2 * f2) % K;
+    int32_t p = 0, g = (f1 + f2) % K;
+
+    for (int32_t x = 0; x < K; x++) {
+        pi[x] = (int16_t)p;
+        p += g;
+        p = (p >= K) ? (p - K) : p;
+        g += m;
+        g = (g >= K) ? (g - K) : g;
+    }
+}
+
+/* The same interleaver one row at a time, for a code block split in N windows of L = K/N bits,
+   N = 8 or 16. Bit j*L+r of the interleaved block is input bit pi(j*L+r) = q[j]*L + rho: all the
+   windows of row r come from the same input row rho, in the window order given by the bytes of q.
+   Both follow the recurrence above with g split the same way, the window part taken mod N. */
+struct turbo_qpp_rows
+{
+    __m128i rho, g_rho, g_rho_L, m_rho, m_rho_L, L;  /* row parts, same in all 16 bits lanes */
+    __m128i q, g_q1, m_q1, mask;                     /* window parts, 8 bits lanes */
+};
+
+static inline void turbo_qpp_rows_init(struct turbo_qpp_rows *s, int32_t K, int32_t f1, int32_t f2, int32_t N,
+                                       int32_t r0)
+{
+    const int32_t L = K / N;
+    const int32_t m = (2 * f2) % K;
+    const int32_t p = (int32_t)((f1 * (int64_t)r0 + f2 * (int64_t)r0 * r0) % K);
+    const int32_t g = (f1 + f2 + 2 * f2 * r0) % K;
+    alignas(16) int8_t q[16], g_q1[16];
+
+    /* starting at row r0, pi(j*L+r0) = pi(r0) + L*(f1*j + f2*L*j*j + 2*f2*r0*j) and
+       g(j*L+r0) = g(r0) + 2*f2*j*L */
+    for (int32_t j = 0; j < 16; j++) {
+        q[j] = (int8_t)((p / L + f1 * j + f2 * L * j * j + 2 * f2 * r0 * j) & (N - 1));
+        g_q1[j] = (int8_t)(((g / L + 2 * f2 * j) & (N - 1)) + 1);
+    }
+    s->rho = _mm_set1_epi16((short)(p % L));
+    s->g_rho = _mm_set1_epi16((short)(g % L));
+    s->g_rho_L = _mm_set1_epi16((short)(g % L - L));
+    s->m_rho = _mm_set1_epi16((short)(m % L));
+    s->m_rho_L = _mm_set1_epi16((short)(m % L - L));
+    s->L = _mm_set1_epi16((short)L);
+    s->q = _mm_load_si128((const __m128i *)q);
+    s->g_q1 = _mm_load_si128((const __m128i *)g_q1);
+    s->m_q1 = _mm_set1_epi8((char)(m / L + 1));
+    s->mask = _mm_set1_epi8((char)(N - 1));
+}
+
+/* Input row of the current row */
+static inline int32_t turbo_qpp_rows_rho(const struct turbo_qpp_rows *s)
+{
+    return _mm_cvtsi128_si32(s->rho) & 0xffff;
+}
+
+/* Windows of the current row */
+static inline __m128i turbo_qpp_rows_q(const struct turbo_qpp_rows *s)
+{
+    return _mm_and_si128(s->q, s->mask);
+}
+
+/* Move to the next row. A row part sum a + b is reduced to [0, L) as the unsigned minimum of
+   a + b and a + b - L, and is left unchanged exactly when there is no carry into the window part.
+   The window parts of g are kept plus 1, so adding the all ones no carry mask gives back the
+   carry. They wrap mod 256, a multiple of N, and are reduced mod N only when read. */
+static inline void turbo_qpp_rows_next(struct turbo_qpp_rows *s)
+{
+    __m128i sum, no_carry;
+
+    sum = _mm_add_epi16(s->rho, s->g_rho);
+    s->rho = _mm_min_epu16(sum, _mm_add_epi16(s->rho, s->g_rho_L));
+    no_carry = _mm_cmpeq_epi16(s->rho, sum);
+    s->q = _mm_add_epi8(_mm_add_epi8(s->q, s->g_q1), no_carry);
+
+    sum = _mm_add_epi16(s->g_rho, s->m_rho);
+    s->g_rho = _mm_min_epu16(sum, _mm_add_epi16(s->g_rho, s->m_rho_L));
+    s->g_rho_L = _mm_sub_epi16(s->g_rho, s->L);
+    no_carry = _mm_cmpeq_epi16(s->g_rho, sum);
+    s->g_q1 = _mm_add_epi8(_mm_add_epi8(s->g_q1, s->m_q1), no_carry);
+}
+
+/* 8 steps of the constituent encoder of TS36.212 section 5.1.3.2.1 for each input byte, MSB first,
+   and start state, as (parity byte << 8) | end state, the state holding the register bits from the
+   input side in its LSB */
+struct alignas(64) turbo_output_win_table
+{
+    uint16_t win[256][8];
+
+    constexpr turbo_output_win_table() : win()
+    {
+        for (int32_t byte = 0; byte < 256; byte++) {
+            for (int32_t state = 0; state < 8; state++) {
+                int32_t s = state, parity = 0;
+                for (int32_t i = 7; i >= 0; i--) {
+                    const int32_t fb = ((byte >> i) ^ (s >> 1) ^ (s >> 2)) & 1;
+                    parity = (parity << 1) | ((fb ^ s ^ (s >> 2)) & 1);
+                    s = ((s << 1) | fb) & 7;
+                }
+                win[byte][state] = (uint16_t)((parity << 8) | s);
+            }
+        }
+    }
+};
+
+extern const turbo_output_win_table g_OutputWinTable8_sdk;
+
 /** @fn lte_turbo_interleaver_8windows_sse
  *  @brief  This function implements Turbo internal interleaver defined in TS36.212 section
        5.1.3.2.1. Used in transmitter.
@@ -53,34 +201,57 @@ extern _TurboInterleaver g_TurboInterleaver;
 int32_t
 bblib_lte_turbo_interleaver_8windows_sse(uint8_t caseId, uint8_t *pInData, uint8_t* pOutData);
 
+/* Intra-row and inter-row shuffle of the 8 windows interleaver, from the 8 windows of each input
+   row in tmp_row to the Lwin = K/8 interleaved rows in tmp_buf, which has room for Lwin + 4 */
+typedef void (*turbo_interleaver_rows_function)(int8_t (*tmp_row)[8], uint8_t *tmp_buf, int32_t K,
+                                                int32_t f1, int32_t f2);
+
+/** @fn lte_turbo_interleaver_8windows_rows
+ *  @brief  The same interleaver computed from the QPP parameters instead of the tables, with
+ *          another row shuffle, NULL for the SSE one.
+ */
+int32_t
+bblib_lte_turbo_interleaver_8windows_rows(uint8_t caseId, uint8_t *pInData, uint8_t* pOutData,
+                                          turbo_interleaver_rows_function rows);
+
 /** @fn lte_turbo_decoder_64windows_avx512
- *  @brief This function implements Turbo decoder when CW size is multiple of 64.
+ *  @brief This function implements Turbo decoder when CW size is multiple of 16.
  *  @param[in] p is pointer of TurboDecoder_para
  *  @return 0 successful, -1 is fail.
 */
 int32_t lte_turbo_decoder_64windows_avx512(void *p);
 
 /** @fn lte_turbo_interleaver_initTable
- *  @brief  inintalize interleaver table function
- *  @param [in] pTabelPath the table path.
+ *  @brief  inintalize interleaver table function, computed from the QPP parameters
  *  @return void
  */
 void
-bblib_lte_turbo_interleaver_initTable(char* pTabelPath);
+bblib_lte_turbo_interleaver_initTable();
 
 void
 bblib_print_turbo_version();
 
 void
-init_turbo_decoder_interleaver_table(char *Table_Path, _TurboInterleaver *p);
+init_turbo_decoder_interleaver_table(_TurboInterleaver *p);
 
-void
-get_turbo_buf_addr_table_new(uint16_t *p_table_TurboBufAddr,
-                             int32_t *p_table_TurboBufAddr_Offset,
-                             int32_t (*p_table_Kidx_K_Nmaxrep_shuf)[5]);
+/** @fn turbo_decoder_interleaver_rows
+ *  @brief Interleaver rows of the 16 or 8 windows decoders for one code block, computed on the fly
+ *  @param [in] Kidx index of K in TS36.212 Table 5.1.3-3, from 0
+ *  @param [in] N windows, 16, or 8 with the bytes 8 to 15 of the patterns left in place
+ *  @param [out] p rows for this K
+ *  @return 0 successful, -1 if K is not a multiple of N
+ */
+int32_t
+turbo_decoder_interleaver_rows(int32_t Kidx, int32_t N, _TurboInterleaverRows *p);
 
+/** @fn turbo_decoder_interleaver
+ *  @brief Interleaver rows of the 16 windows decoders for one code block, from g_TurboInterleaver
+ *         or, with BBLIB_TURBO_QPP_ON_THE_FLY in flags, computed in rows
+ *  @return 0 successful, -1 if K is not a multiple of 16
+ */
 int32_t
-init_common_tables(char *pTabelPath);
+turbo_decoder_interleaver(int32_t Kidx, uint32_t flags, _TurboInterleaverRows *rows,
+                          struct turbo_decoder_interleaver *p);
 
 // for softbit mapping
 #define _LOG_P1_P0
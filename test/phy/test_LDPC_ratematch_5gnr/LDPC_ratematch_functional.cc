@@ -82,6 +82,12 @@ TEST_P(LDPCRatematch5GNRCheck, AVX512_Check)
 }
 #endif
 
+#ifdef _BBLIB_AVX2_
+TEST_P(LDPCRatematch5GNRCheck, AVX2_Check)
+{
+    functional(bblib_LDPC_ratematch_5gnr_avx2, "AVX2", &LDPC_ratematch_5gnr_request, &LDPC_ratematch_5gnr_response);
+}
+#endif
 
 TEST_P(LDPCRatematch5GNRCheck, Default_Check)
 {
@@ -90,3 +96,145 @@ TEST_P(LDPCRatematch5GNRCheck, Default_Check)
 
 INSTANTIATE_TEST_CASE_P(UnitTest, LDPCRatematch5GNRCheck,
                         testing::ValuesIn(get_sequence(LDPCRatematch5GNRCheck::get_number_of_cases("functional"))));
+
+class LDPCRatematch5GNRTbCheck : public KernelTests {
+protected:
+    struct bblib_LDPC_ratematch_5gnr_tb_request LDPC_ratematch_5gnr_tb_request{};
+    struct bblib_LDPC_ratematch_5gnr_tb_response LDPC_ratematch_5gnr_tb_response{};
+    uint8_t *reference = nullptr;
+    uint8_t *cb_output = nullptr;
+    const int buffer_len = 1024 * 1024;
+
+    void SetUp() override {
+        init_test("tb_functional");
+
+        LDPC_ratematch_5gnr_tb_request.C = get_input_parameter<int32_t>("C");
+        LDPC_ratematch_5gnr_tb_request.G = get_input_parameter<int32_t>("G");
+        LDPC_ratematch_5gnr_tb_request.nLayers = get_input_parameter<int32_t>("nLayers");
+        LDPC_ratematch_5gnr_tb_request.Qm = get_input_parameter<int32_t>("Qm");
+        LDPC_ratematch_5gnr_tb_request.Ncb = get_input_parameter<int32_t>("Ncb");
+        LDPC_ratematch_5gnr_tb_request.Zc = get_input_parameter<int32_t>("Zc");
+        LDPC_ratematch_5gnr_tb_request.rvidx = get_input_parameter<int32_t>("rvidx");
+        LDPC_ratematch_5gnr_tb_request.baseGraph = get_input_parameter<int32_t>("baseGraph");
+        LDPC_ratematch_5gnr_tb_request.nullIndex = get_input_parameter<int32_t>("nullIndex");
+        LDPC_ratematch_5gnr_tb_request.nLen = get_input_parameter<int32_t>("nLen");
+        if (get_input_parameter<uint8_t>("scrambling"))
+            LDPC_ratematch_5gnr_tb_request.flags |= BBLIB_LDPC_RATEMATCH_SCRAMBLING;
+        LDPC_ratematch_5gnr_tb_request.cInit = get_input_parameter<uint32_t>("cInit");
+        if (get_input_parameter<uint8_t>("symbolOutput"))
+            LDPC_ratematch_5gnr_tb_request.flags |= BBLIB_LDPC_RATEMATCH_SYMBOL_OUTPUT;
+        LDPC_ratematch_5gnr_tb_request.cbStride = (LDPC_ratematch_5gnr_tb_request.Ncb + 511) / 512 * 64;
+        LDPC_ratematch_5gnr_tb_request.input = generate_random_data<uint8_t>(buffer_len, 64);
+
+        LDPC_ratematch_5gnr_tb_response.output = aligned_malloc<uint8_t>(buffer_len, 64);
+        memset(LDPC_ratematch_5gnr_tb_response.output, 0, buffer_len);
+        reference = aligned_malloc<uint8_t>(buffer_len, 64);
+        memset(reference, 0, buffer_len);
+        cb_output = aligned_malloc<uint8_t>(buffer_len, 64);
+    }
+
+    void TearDown() override {
+        aligned_free((void *)LDPC_ratematch_5gnr_tb_request.input);
+        aligned_free(LDPC_ratematch_5gnr_tb_response.output);
+        aligned_free(reference);
+        aligned_free(cb_output);
+    }
+
+    /* Scrambling sequence c(n) bit by bit as written in TS38211 5.2.1 */
+    static std::vector<uint8_t> gold_sequence(const uint32_t c_init, const int32_t length)
+    {
+        const int32_t Nc = 1600;
+        std::vector<uint8_t> x1(Nc + length + 31, 0), x2(Nc + length + 31, 0), c(length);
+        x1[0] = 1;
+        for (int32_t n = 0; n < 31; n++)
+            x2[n] = (c_init >> n) & 1;
+        for (int32_t n = 0; n < Nc + length; n++) {
+            x1[n + 31] = x1[n + 3] ^ x1[n];
+            x2[n + 31] = x2[n + 3] ^ x2[n + 2] ^ x2[n + 1] ^ x2[n];
+        }
+        for (int32_t n = 0; n < length; n++)
+            c[n] = x1[n + Nc] ^ x2[n + Nc];
+        return c;
+    }
+
+    /* Reference is the concatenation of the code blocks rate matched one by one, then scrambled
+       and gathered in modulation symbols */
+    void build_reference()
+    {
+        const auto &tb = LDPC_ratematch_5gnr_tb_request;
+        std::vector<uint8_t> g(tb.G);
+        for (int32_t r = 0; r < tb.C; r++) {
+            int32_t E, offset;
+            ASSERT_EQ(0, bblib_LDPC_ratematch_5gnr_cb_length(&tb, r, &E, &offset));
+
+            struct bblib_LDPC_ratematch_5gnr_request request{tb.Ncb, tb.Zc, E, tb.Qm, tb.rvidx, tb.baseGraph,
+                tb.nullIndex, tb.nLen, (uint8_t *)tb.input + r * tb.cbStride};
+            struct bblib_LDPC_ratematch_5gnr_response response{cb_output};
+            ASSERT_EQ(0, bblib_LDPC_ratematch_5gnr(&request, &response));
+
+            for (int32_t i = 0; i < E; i++)
+                g[offset + i] = (cb_output[i >> 3] >> (i & 7)) & 1;
+        }
+
+        if (tb.flags & BBLIB_LDPC_RATEMATCH_SCRAMBLING) {
+            const auto c = gold_sequence(tb.cInit, tb.G);
+            for (int32_t i = 0; i < tb.G; i++)
+                g[i] ^= c[i];
+        }
+        for (int32_t i = 0; i < tb.G; i++) {
+            if (tb.flags & BBLIB_LDPC_RATEMATCH_SYMBOL_OUTPUT)
+                reference[i / tb.Qm] |= g[i] << (tb.Qm - 1 - i % tb.Qm);
+            else
+                reference[i >> 3] |= g[i] << (i & 7);
+        }
+    }
+
+    int32_t output_bytes() const
+    {
+        const auto &tb = LDPC_ratematch_5gnr_tb_request;
+        return (tb.flags & BBLIB_LDPC_RATEMATCH_SYMBOL_OUTPUT) ? (tb.G / tb.Qm) : ((tb.G + 7) / 8);
+    }
+
+    template <typename F>
+    void functional(F function, const std::string isa)
+    {
+        build_reference();
+
+        /* Whole transport block in one call */
+        ASSERT_EQ(0, function(&LDPC_ratematch_5gnr_tb_request, &LDPC_ratematch_5gnr_tb_response));
+        ASSERT_ARRAY_EQ(LDPC_ratematch_5gnr_tb_response.output, reference, output_bytes());
+
+        /* One call per code block, each starting at an arbitrary bit of the output and of c(n) */
+        memset(LDPC_ratematch_5gnr_tb_response.output, 0, buffer_len);
+        LDPC_ratematch_5gnr_tb_request.cbNum = 1;
+        for (int32_t r = 0; r < LDPC_ratematch_5gnr_tb_request.C; r++) {
+            LDPC_ratematch_5gnr_tb_request.cbStart = r;
+            ASSERT_EQ(0, function(&LDPC_ratematch_5gnr_tb_request, &LDPC_ratematch_5gnr_tb_response));
+        }
+        ASSERT_ARRAY_EQ(LDPC_ratematch_5gnr_tb_response.output, reference, output_bytes());
+
+        print_test_description(isa, module_name);
+    }
+};
+
+#ifdef _BBLIB_AVX512_
+TEST_P(LDPCRatematch5GNRTbCheck, AVX512_Check)
+{
+    functional(bblib_LDPC_ratematch_5gnr_tb_avx512, "AVX512");
+}
+#endif
+
+#ifdef _BBLIB_AVX2_
+TEST_P(LDPCRatematch5GNRTbCheck, AVX2_Check)
+{
+    functional(bblib_LDPC_ratematch_5gnr_tb_avx2, "AVX2");
+}
+#endif
+
+TEST_P(LDPCRatematch5GNRTbCheck, Default_Check)
+{
+    functional(bblib_LDPC_ratematch_5gnr_tb, "Default");
+}
+
+INSTANTIATE_TEST_CASE_P(UnitTest, LDPCRatematch5GNRTbCheck,
+                        testing::ValuesIn(get_sequence(LDPCRatematch5GNRTbCheck::get_number_of_cases("tb_functional"))));
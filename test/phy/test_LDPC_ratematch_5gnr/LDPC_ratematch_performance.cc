@@ -64,5 +64,12 @@ TEST_P(LDPCRatematch5GNRPerf, AVX512_Perf)
 }
 #endif
 
+#ifdef _BBLIB_AVX2_
+TEST_P(LDPCRatematch5GNRPerf, AVX2_Perf)
+{
+    performance("AVX2", module_name, bblib_LDPC_ratematch_5gnr_avx2, &LDPC_ratematch_5gnr_request, &LDPC_ratematch_5gnr_response);
+}
+#endif
+
 INSTANTIATE_TEST_CASE_P(UnitTest, LDPCRatematch5GNRPerf,
                         testing::ValuesIn(get_sequence(LDPCRatematch5GNRPerf::get_number_of_cases("performance"))));
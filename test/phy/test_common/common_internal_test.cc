@@ -24,6 +24,7 @@
 
 #include "common_typedef_simd.hpp"
 #include "sdk_version.h"
+#include "bblib_isa.h"
 
 #include <gtest/gtest.h>
 
@@ -65,6 +66,30 @@ TEST(SDKVersionCheck, BufferTooSmall)
     delete[] output;
 }
 
+TEST(ISACheck, MatchesCpuFeatures)
+{
+    const enum bblib_isa isa = bblib_get_isa();
+
+    ASSERT_GE(isa, BBLIB_ISA_SSE4_2);
+    ASSERT_LE(isa, BBLIB_ISA_SPR);
+
+    /* BBLIB_ISA may cap the level below what the CPU reports */
+    if (getenv("BBLIB_ISA") != nullptr)
+        return;
+
+    ASSERT_EQ(isa >= BBLIB_ISA_AVX2, __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+                                     __builtin_cpu_supports("bmi2"));
+    ASSERT_EQ(isa >= BBLIB_ISA_AVX512, __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+                                       __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512dq") &&
+                                       __builtin_cpu_supports("avx512cd"));
+    if (isa >= BBLIB_ISA_SNC)
+    {
+        ASSERT_TRUE(__builtin_cpu_supports("avx512vbmi2"));
+        ASSERT_TRUE(__builtin_cpu_supports("vpclmulqdq"));
+        ASSERT_TRUE(__builtin_cpu_supports("gfni"));
+    }
+}
+
 #if 0
 
 #ifdef _BBLIB_AVX2_
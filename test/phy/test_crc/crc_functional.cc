@@ -24,8 +24,11 @@
 
 #include "common.hpp"
 #include "phy_crc.h"
+#include "bblib_isa.h"
 
 #include <stdint.h>
+#include <algorithm>
+#include <vector>
 
 
 const std::string module_name = "crc";
@@ -234,6 +237,20 @@ TEST_P(CrcByteLenGenerationCheck, CRC6_SSE)
     functional_chk(bblib_lte_crc6_check_sse, "SSE");
 }
 
+TEST_P(CrcByteLenGenerationCheck, CRC24C_SSE)
+{
+    reference.crc_value = get_reference_parameter<uint32_t>("crc24c_value");
+    functional_gen(bblib_lte_crc24c_gen_sse, "SSE");
+    functional_chk(bblib_lte_crc24c_check_sse, "SSE");
+}
+
+TEST_P(CrcByteLenGenerationCheck, CRC24C_1_SSE)
+{
+    reference.crc_value = get_reference_parameter<uint32_t>("crc24c_1_value");
+    functional_gen(bblib_lte_crc24c_1_gen_sse, "SSE");
+    functional_chk(bblib_lte_crc24c_1_check_sse, "SSE");
+}
+
 #endif
 
 
@@ -394,6 +411,26 @@ TEST_P(CrcBitLenGenerationCheck, CRC24C_1_AVX512)
 #endif
 
 
+/* CRC bit length based, SSE, Generation & Check Tests for the CRC24C kernels built on the streaming CRC */
+#if defined(_BBLIB_SSE4_2_) || defined(_BBLIB_AVX2_) || defined(_BBLIB_AVX512_)||defined(_BBLIB_SNC_)
+
+TEST_P(CrcBitLenGenerationCheck, CRC24C_SSE)
+{
+    reference.crc_value = get_reference_parameter<uint32_t>("crc24c_value");
+    functional_gen(bblib_lte_crc24c_gen_sse, "SSE");
+    functional_chk(bblib_lte_crc24c_check_sse, "SSE");
+}
+
+TEST_P(CrcBitLenGenerationCheck, CRC24C_1_SSE)
+{
+    reference.crc_value = get_reference_parameter<uint32_t>("crc24c_1_value");
+    functional_gen(bblib_lte_crc24c_1_gen_sse, "SSE");
+    functional_chk(bblib_lte_crc24c_1_check_sse, "SSE");
+}
+
+#endif
+
+
 /* Default Tests - Applicable across multiple ISA devices */
 
 /* CRC byte length based, Default ISA, Generation & Check Tests
@@ -457,10 +494,13 @@ TEST_P(CrcByteLenGenerationCheck, CRC24C_1_Default_ISA)
 
 
 /* CRC bit length based, Default ISA, Generation & Check Tests
-   Note, bit length based tests are only supported on avx512 architecture */
+   Note, bit length based tests are only supported on avx512 architecture, the SSE kernels selected
+   with BBLIB_ISA=avx2 or sse4_2 are byte based except CRC24C */
 
 TEST_P(CrcBitLenGenerationCheck, CRC6_Default_ISA)
 {
+    if (bblib_get_isa() < BBLIB_ISA_AVX512)
+        GTEST_SKIP();
     reference.crc_value = get_reference_parameter<uint32_t>("crc6_value");
     functional_gen(bblib_lte_crc6_gen, "Default");
     functional_chk(bblib_lte_crc6_check, "Default");
@@ -468,6 +508,8 @@ TEST_P(CrcBitLenGenerationCheck, CRC6_Default_ISA)
 
 TEST_P(CrcBitLenGenerationCheck, CRC11_Default_ISA)
 {
+    if (bblib_get_isa() < BBLIB_ISA_AVX512)
+        GTEST_SKIP();
     reference.crc_value = get_reference_parameter<uint32_t>("crc11_value");
     functional_gen(bblib_lte_crc11_gen, "Default");
     functional_chk(bblib_lte_crc11_check, "Default");
@@ -475,6 +517,8 @@ TEST_P(CrcBitLenGenerationCheck, CRC11_Default_ISA)
 
 TEST_P(CrcBitLenGenerationCheck, CRC16_Default_ISA)
 {
+    if (bblib_get_isa() < BBLIB_ISA_AVX512)
+        GTEST_SKIP();
     reference.crc_value = get_reference_parameter<uint32_t>("crc16_value");
     functional_gen(bblib_lte_crc16_gen, "Default");
     functional_chk(bblib_lte_crc16_check, "Default");
@@ -482,6 +526,8 @@ TEST_P(CrcBitLenGenerationCheck, CRC16_Default_ISA)
 
 TEST_P(CrcBitLenGenerationCheck, CRC24A_Default_ISA)
 {
+    if (bblib_get_isa() < BBLIB_ISA_AVX512)
+        GTEST_SKIP();
     reference.crc_value = get_reference_parameter<uint32_t>("crc24a_value");
     functional_gen(bblib_lte_crc24a_gen, "Default");
     functional_chk(bblib_lte_crc24a_check, "Default");
@@ -489,6 +535,8 @@ TEST_P(CrcBitLenGenerationCheck, CRC24A_Default_ISA)
 
 TEST_P(CrcBitLenGenerationCheck, CRC24B_Default_ISA)
 {
+    if (bblib_get_isa() < BBLIB_ISA_AVX512)
+        GTEST_SKIP();
     reference.crc_value = get_reference_parameter<uint32_t>("crc24b_value");
     functional_gen(bblib_lte_crc24b_gen, "Default");
     functional_chk(bblib_lte_crc24b_check, "Default");
@@ -510,9 +558,226 @@ TEST_P(CrcBitLenGenerationCheck, CRC24C_1_Default_ISA)
 #endif
 
 
+/* This class of checks computes the CRC of each bit length data stream with the
+ * streaming API, the data being given as a list of chunks of arbitrary bit lengths,
+ * and compares it with the reference crc_value of each CRC type.
+ */
+class CrcStreamCheck : public KernelTests
+{
+protected:
+    std::vector<std::vector<uint8_t>> chunk_data;
+    std::vector<struct bblib_crc_chunk> chunks;
+    uint32_t data_length = 0;
+
+    void SetUp() override
+    {
+        init_test("crc_bit_len_functional");
+
+        data_length = get_input_parameter<uint32_t>("data_length");
+        if (data_length == 0)
+            return;
+        uint8_t *data = get_input_parameter<uint8_t*>("data_in");
+
+        /* Each chunk is copied to the start of its own buffer, so that chunks start and end
+           anywhere in the bytes of the data stream */
+        const uint32_t chunk_lengths[] = {1, 13, 100, 7, 300, 8, 129, 1000};
+        std::vector<uint32_t> lengths;
+        for (uint32_t pos = 0; pos < data_length; pos += lengths.back()) {
+            const uint32_t len = std::min(chunk_lengths[lengths.size() % 8], data_length - pos);
+            std::vector<uint8_t> chunk((len + 7) / 8, 0);
+            for (uint32_t k = 0; k < len; k++) {
+                const uint8_t bit = (data[(pos + k) / 8] >> (7 - (pos + k) % 8)) & 1;
+                chunk[k / 8] |= bit << (7 - k % 8);
+            }
+            chunk_data.push_back(chunk);
+            lengths.push_back(len);
+        }
+        for (uint32_t i = 0; i < chunk_data.size(); i++)
+            chunks.push_back({chunk_data[i].data(), lengths[i]});
+        aligned_free(data);
+    }
+
+    template <typename U, typename F>
+    void functional(U update, F finalize, const std::string isa)
+    {
+        const std::pair<enum bblib_crc_type, const char *> types[] = {
+            {BBLIB_CRC24A, "crc24a_value"}, {BBLIB_CRC24B, "crc24b_value"}, {BBLIB_CRC24C, "crc24c_value"},
+            {BBLIB_CRC24C_1, "crc24c_1_value"}, {BBLIB_CRC16, "crc16_value"}, {BBLIB_CRC11, "crc11_value"},
+            {BBLIB_CRC6, "crc6_value"}};
+
+        for (const auto &type : types) {
+            struct bblib_crc_state state;
+            bblib_crc_init(&state, type.first);
+            for (const auto &chunk : chunks)
+                update(&state, chunk.data, chunk.len);
+            ASSERT_EQ(finalize(&state), get_reference_parameter<uint32_t>(type.second))
+                << "FAIL: Streamed CRC value does not compare with reference for " << type.second;
+
+            /* same chunks in a single call */
+            bblib_crc_init(&state, type.first);
+            bblib_crc_update_chunks(&state, chunks.data(), chunks.size());
+            ASSERT_EQ(finalize(&state), get_reference_parameter<uint32_t>(type.second))
+                << "FAIL: Chunk list CRC value does not compare with reference for " << type.second;
+        }
+        print_test_description(isa, module_name);
+    }
+
+    /* CRC of each chunk alone, initialised with zeros, combined into the CRC of the whole data */
+    void functional_combine()
+    {
+        const std::pair<enum bblib_crc_type, const char *> types[] = {
+            {BBLIB_CRC24A, "crc24a_value"}, {BBLIB_CRC24B, "crc24b_value"}, {BBLIB_CRC24C, "crc24c_value"},
+            {BBLIB_CRC24C_1, "crc24c_1_value"}, {BBLIB_CRC16, "crc16_value"}, {BBLIB_CRC11, "crc11_value"},
+            {BBLIB_CRC6, "crc6_value"}};
+
+        for (const auto &type : types) {
+            struct bblib_crc_state state;
+            bblib_crc_init(&state, type.first);
+            uint32_t crc = bblib_crc_finalize(&state);
+            for (const auto &chunk : chunks) {
+                bblib_crc_init(&state, (type.first == BBLIB_CRC24C_1) ? BBLIB_CRC24C : type.first);
+                bblib_crc_update(&state, chunk.data, chunk.len);
+                crc = bblib_crc_combine(type.first, crc, bblib_crc_finalize(&state), chunk.len);
+            }
+            ASSERT_EQ(crc, get_reference_parameter<uint32_t>(type.second))
+                << "FAIL: Combined CRC value does not compare with reference for " << type.second;
+        }
+        print_test_description("Default", module_name);
+    }
+};
+
+#if defined(_BBLIB_SSE4_2_) || defined(_BBLIB_AVX2_) || defined(_BBLIB_AVX512_)||defined(_BBLIB_SNC_)
+TEST_P(CrcStreamCheck, SSE_Check)
+{
+    functional(bblib_crc_update_sse, bblib_crc_finalize_sse, "SSE");
+}
+#endif
+
+#ifdef _BBLIB_AVX512_
+TEST_P(CrcStreamCheck, AVX512_Check)
+{
+    functional(bblib_crc_update_avx512, bblib_crc_finalize_avx512, "AVX512");
+}
+#endif
+
+TEST_P(CrcStreamCheck, Default_Check)
+{
+    functional(bblib_crc_update, bblib_crc_finalize, "Default");
+}
+
+TEST_P(CrcStreamCheck, Combine_Check)
+{
+    functional_combine();
+}
+
+
+/* This class of checks builds a batch of code blocks from the prefixes of each bit length
+ * data stream, each followed by its CRC24B, corrupts some of them and checks the bitmap
+ * returned by the multi code block CRC24B check. The CRC of the whole stream is the
+ * reference crc24b_value.
+ */
+class Crc24bCheckMultiCheck : public KernelTests
+{
+protected:
+    static constexpr int32_t num_cb = 20;
+    std::vector<std::vector<uint8_t>> cb_data;
+    std::vector<struct bblib_crc_request> cb_request;
+    uint32_t expected = 0;
+
+    static void put_bits(uint8_t *dst, uint32_t pos, uint32_t value, uint32_t num_bits)
+    {
+        for (uint32_t k = 0; k < num_bits; k++, pos++) {
+            const uint8_t bit = (value >> (num_bits - 1 - k)) & 1;
+            dst[pos / 8] = (dst[pos / 8] & ~(0x80 >> (pos % 8))) | (bit << (7 - pos % 8));
+        }
+    }
+
+    void SetUp() override
+    {
+        init_test("crc_bit_len_functional");
+
+        const uint32_t data_length = get_input_parameter<uint32_t>("data_length");
+        if (data_length == 0)
+            return;
+        uint8_t *data = get_input_parameter<uint8_t*>("data_in");
+
+        for (int32_t i = 0; i < num_cb; i++) {
+            const uint32_t len = (i == num_cb - 1) ? data_length : std::max(1u, data_length * (i + 1) / num_cb);
+            std::vector<uint8_t> cb((len + 24 + 7) / 8, 0);
+            std::copy(data, data + (len + 7) / 8, cb.begin());
+            if (len % 8)
+                cb[len / 8] &= 0xFF << (8 - len % 8);
+
+            uint32_t crc = get_reference_parameter<uint32_t>("crc24b_value");
+            if (len != data_length) {
+                struct bblib_crc_state state;
+                bblib_crc_init(&state, BBLIB_CRC24B);
+                bblib_crc_update(&state, cb.data(), len);
+                crc = bblib_crc_finalize(&state);
+            }
+            /* every third code block has a wrong CRC */
+            if (i % 3 == 1)
+                crc ^= 1 << (i % 24);
+            else
+                expected |= 1u << i;
+            put_bits(cb.data(), len, crc, 24);
+
+            cb_data.push_back(cb);
+            cb_request.push_back({nullptr, len});
+        }
+        for (int32_t i = 0; i < num_cb; i++)
+            cb_request[i].data = cb_data[i].data();
+        aligned_free(data);
+    }
+
+    template <typename F>
+    void functional(F function, const std::string isa)
+    {
+        ASSERT_EQ(function(cb_request.data(), (int32_t)cb_request.size()), expected)
+            << "FAIL: CRC check bitmap does not compare with reference";
+        /* batches smaller than the number of code blocks folded together */
+        for (int32_t num = 1; num <= (int32_t)cb_request.size(); num += 3)
+            ASSERT_EQ(function(cb_request.data(), num), expected & ((1ull << num) - 1))
+                << "FAIL: CRC check bitmap does not compare with reference for " << num << " code blocks";
+        print_test_description(isa, module_name);
+    }
+};
+
+#if defined(_BBLIB_SSE4_2_) || defined(_BBLIB_AVX2_) || defined(_BBLIB_AVX512_)||defined(_BBLIB_SNC_)
+TEST_P(Crc24bCheckMultiCheck, SSE_Check)
+{
+    functional(bblib_lte_crc24b_check_multi_sse, "SSE");
+}
+#endif
+
+#ifdef _BBLIB_AVX512_
+TEST_P(Crc24bCheckMultiCheck, AVX512_Check)
+{
+    functional(bblib_lte_crc24b_check_multi_avx512, "AVX512");
+}
+#endif
+
+#ifdef _BBLIB_SNC_
+TEST_P(Crc24bCheckMultiCheck, SNC_Check)
+{
+    functional(bblib_lte_crc24b_check_multi_snc, "SNC");
+}
+#endif
+
+TEST_P(Crc24bCheckMultiCheck, Default_Check)
+{
+    functional(bblib_lte_crc24b_check_multi, "Default");
+}
+
+
 INSTANTIATE_TEST_CASE_P(UnitTest, CrcByteLenGenerationCheck,
                         testing::ValuesIn(get_sequence(CrcByteLenGenerationCheck::get_number_of_cases("crc_byte_len_functional"))));
 
 INSTANTIATE_TEST_CASE_P(UnitTest, CrcBitLenGenerationCheck,
                         testing::ValuesIn(get_sequence(CrcBitLenGenerationCheck::get_number_of_cases("crc_bit_len_functional"))));
 
+INSTANTIATE_TEST_CASE_P(UnitTest, CrcStreamCheck,
+                        testing::ValuesIn(get_sequence(CrcStreamCheck::get_number_of_cases("crc_bit_len_functional"))));
+
+INSTANTIATE_TEST_CASE_P(UnitTest, Crc24bCheckMultiCheck,
+                        testing::ValuesIn(get_sequence(Crc24bCheckMultiCheck::get_number_of_cases("crc_bit_len_functional"))));
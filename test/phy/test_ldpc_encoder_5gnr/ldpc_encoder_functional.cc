@@ -25,6 +25,8 @@
 #include "common.hpp"
 
 #include "phy_ldpc_encoder_5gnr.h"
+#include "phy_crc.h"
+#include "bit_reverse.h"
 
 const std::string module_name = "ldpc_encoder_5gnr";
 
@@ -84,6 +86,13 @@ TEST_P(LDPCEncoder5GNRCheck, AVX512_Check)
 }
 #endif
 
+#ifdef _BBLIB_SNC_
+TEST_P(LDPCEncoder5GNRCheck, SNC_Check)
+{
+    functional(bblib_ldpc_encoder_5gnr_snc, "SNC", &ldpc_encoder_5gnr_request, &ldpc_encoder_5gnr_response);
+}
+#endif
+
 
 TEST_P(LDPCEncoder5GNRCheck, Default_Check)
 {
@@ -92,3 +101,93 @@ TEST_P(LDPCEncoder5GNRCheck, Default_Check)
 
 INSTANTIATE_TEST_CASE_P(UnitTest, LDPCEncoder5GNRCheck,
                         testing::ValuesIn(get_sequence(LDPCEncoder5GNRCheck::get_number_of_cases("functional"))));
+
+class LDPCEncoder5GNRTbCheck : public KernelTests {
+protected:
+    struct bblib_ldpc_encoder_5gnr_tb_request ldpc_encoder_5gnr_tb_request{};
+    struct bblib_ldpc_encoder_5gnr_tb_response ldpc_encoder_5gnr_tb_response{};
+    const int buffer_len = 1024 * 1024;
+
+    void SetUp() override {
+        init_test("tb_functional");
+
+        ldpc_encoder_5gnr_tb_request.tbSize = get_input_parameter<uint32_t>("tbSize");
+        ldpc_encoder_5gnr_tb_request.baseGraph = get_input_parameter<int32_t>("baseGraph");
+        ldpc_encoder_5gnr_tb_request.nRows = get_input_parameter<int32_t>("nRows");
+        ldpc_encoder_5gnr_tb_request.input = generate_random_data<uint8_t>(buffer_len, 64);
+        ldpc_encoder_5gnr_tb_response.output = aligned_malloc<uint8_t>(buffer_len, 64);
+        memset(ldpc_encoder_5gnr_tb_response.output, 0, buffer_len);
+    }
+
+    void TearDown() override {
+        aligned_free(ldpc_encoder_5gnr_tb_request.input);
+        aligned_free(ldpc_encoder_5gnr_tb_response.output);
+    }
+
+    static int get_bit(const uint8_t *data, const uint32_t index) {
+        return (data[index >> 3] >> (7 - (index & 7))) & 1;
+    }
+
+    static int get_bit_lsb(const uint8_t *data, const uint32_t index) {
+        return (data[index >> 3] >> (index & 7)) & 1;
+    }
+
+    static void set_bit(uint8_t *data, const uint32_t index, const int bit) {
+        data[index >> 3] = (data[index >> 3] & ~(0x80 >> (index & 7))) | (bit << (7 - (index & 7)));
+    }
+
+    /* Reference is built code block by code block with the CRC and the single code block encoder */
+    void functional(const std::string isa)
+    {
+        ASSERT_EQ(0, bblib_ldpc_encoder_5gnr_tb(&ldpc_encoder_5gnr_tb_request, &ldpc_encoder_5gnr_tb_response));
+
+        const auto &seg = ldpc_encoder_5gnr_tb_response.seg;
+        const uint32_t payload_len = seg.Kprime - seg.L;
+        const uint32_t parity_len = ldpc_encoder_5gnr_tb_request.nRows * seg.Zc;
+        const uint32_t sys_len = seg.K - 2 * seg.Zc;
+        ASSERT_EQ(sys_len + parity_len, ldpc_encoder_5gnr_tb_response.cbEncLen);
+
+        auto code_block = aligned_malloc<uint8_t>(2048, 64);
+        auto parity = aligned_malloc<int8_t>(8192, 64);
+        for (int r = 0; r < seg.C; r++) {
+            memset(code_block, 0, 2048);
+            for (uint32_t i = 0; i < payload_len; i++)
+                set_bit(code_block, i, get_bit(ldpc_encoder_5gnr_tb_request.input, r * payload_len + i));
+            if (seg.L) {
+                struct bblib_crc_request crc_request{code_block, payload_len};
+                struct bblib_crc_response crc_response{};
+                crc_response.data = code_block;
+                bblib_lte_crc24b_gen(&crc_request, &crc_response);
+            }
+
+            const uint8_t *codeword = ldpc_encoder_5gnr_tb_response.output + r * ldpc_encoder_5gnr_tb_response.cbStride;
+            for (uint32_t i = 0; i < sys_len; i++)
+                ASSERT_EQ(get_bit(code_block, 2 * seg.Zc + i), get_bit_lsb(codeword, i)) << "CB " << r << " bit " << i;
+
+            struct bblib_ldpc_encoder_5gnr_request cb_request{};
+            struct bblib_ldpc_encoder_5gnr_response cb_response{};
+            cb_request.Zc = seg.Zc;
+            cb_request.baseGraph = ldpc_encoder_5gnr_tb_request.baseGraph;
+            cb_request.nRows = ldpc_encoder_5gnr_tb_request.nRows;
+            cb_request.numberCodeblocks = 1;
+            cb_request.input[0] = (int8_t *)code_block;
+            cb_response.output[0] = parity;
+            bblib_bit_reverse((int8_t *)code_block, seg.K);
+            ASSERT_EQ(0, bblib_ldpc_encoder_5gnr(&cb_request, &cb_response));
+            for (uint32_t i = 0; i < parity_len; i++)
+                ASSERT_EQ(get_bit_lsb((uint8_t *)parity, i), get_bit_lsb(codeword, sys_len + i)) << "CB " << r << " bit " << i;
+        }
+        aligned_free(code_block);
+        aligned_free(parity);
+
+        print_test_description(isa, module_name);
+    }
+};
+
+TEST_P(LDPCEncoder5GNRTbCheck, Default_Check)
+{
+    functional("Default");
+}
+
+INSTANTIATE_TEST_CASE_P(UnitTest, LDPCEncoder5GNRTbCheck,
+                        testing::ValuesIn(get_sequence(LDPCEncoder5GNRTbCheck::get_number_of_cases("tb_functional"))));
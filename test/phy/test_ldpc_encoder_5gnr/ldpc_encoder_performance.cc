@@ -65,5 +65,12 @@ TEST_P(LDPCEncoder5GNRPerf, AVX512_Perf)
 }
 #endif
 
+#ifdef _BBLIB_SNC_
+TEST_P(LDPCEncoder5GNRPerf, SNC_Perf)
+{
+    performance("SNC", module_name, bblib_ldpc_encoder_5gnr_snc, &ldpc_encoder_5gnr_request, &ldpc_encoder_5gnr_response);
+}
+#endif
+
 INSTANTIATE_TEST_CASE_P(UnitTest, LDPCEncoder5GNRPerf,
                         testing::ValuesIn(get_sequence(LDPCEncoder5GNRPerf::get_number_of_cases("performance"))));
\ No newline at end of file
@@ -25,6 +25,7 @@
 #include "common.hpp"
 
 #include "phy_rate_dematching_5gnr.h"
+#include "pseudo_random_seq_gen.h"
 
 const std::string module_name = "rate_dematching_5gnr";
 
@@ -34,6 +35,7 @@ protected:
     struct bblib_rate_dematching_5gnr_request request_ref{};
     struct bblib_rate_dematching_5gnr_response response{};
     struct bblib_rate_dematching_5gnr_response reference{};
+    uint8_t *scrambling = nullptr;
 
     void SetUp() override {
         init_test("functional");
@@ -50,6 +52,23 @@ protected:
         request.modulation_order = get_input_parameter<bblib_modulation_order>("mod_q");
         request.base_graph = get_input_parameter<int32_t>("flag_of_bg");
         request.isretx = get_input_parameter<int32_t>("is_retx");
+        if (get_input_parameter<int32_t>("descrambling"))
+            request.flags |= BBLIB_RATE_DEMATCHING_DESCRAMBLING;
+        request.c_init = get_input_parameter<uint32_t>("c_init");
+        request.scrambling_offset = get_input_parameter<uint32_t>("scrambling_offset");
+
+        /* Pre-generated scrambling sequence from the start, the reference generates it from c_init */
+        if (get_input_parameter<int32_t>("scrambling_bitmap")) {
+            struct bblib_prbs_request prbs_request{};
+            struct bblib_prbs_response prbs_response{};
+            prbs_request.c_init = request.c_init;
+            prbs_request.num_bits = (uint16_t) request.e;
+            prbs_request.gold_code_advance = 1600;
+            scrambling = aligned_malloc<uint8_t>(request.e / 8 + 64, 64);
+            prbs_response.bits = scrambling;
+            bblib_prbs_basic(&prbs_request, &prbs_response);
+            request.p_scrambling = scrambling;
+        }
 
 #ifndef WIN32
         request.p_in = generate_random_int_numbers<int8_t>(request.e, 64, -127, 127);
@@ -59,9 +78,17 @@ protected:
 
         request.p_harq = aligned_malloc<int8_t>(harq_buffer, 64);
         std::memset(request.p_harq, 0, harq_buffer);
+        /* A retransmission combines with the LLRs already in the HARQ buffer */
+        if (request.isretx) {
+            auto harq = generate_random_int_numbers<int16_t>(request.ncb, 64, -127, 127);
+            for (int32_t i = 0; i < request.ncb; i++)
+                request.p_harq[i] = (int8_t) harq[i];
+            aligned_free(harq);
+        }
         request_ref = request;
+        request_ref.p_scrambling = nullptr;
         request_ref.p_harq = aligned_malloc<int8_t>(harq_buffer, 64);
-        std::memset(request_ref.p_harq, 0, harq_buffer);
+        std::memcpy(request_ref.p_harq, request.p_harq, harq_buffer);
         /* Generate reference using C code */
         bblib_rate_dematching_5gnr_c(&request_ref, &reference);
 
@@ -71,6 +98,8 @@ protected:
         aligned_free(request.p_in);
         aligned_free(request.p_harq);
         aligned_free(request_ref.p_harq);
+        if (scrambling != nullptr)
+            aligned_free(scrambling);
     }
 
     template <typename F>
@@ -92,6 +121,13 @@ TEST_P(RateDematching5GNRCheck, AVX512_Check)
 }
 #endif
 
+#ifdef _BBLIB_AVX2_
+TEST_P(RateDematching5GNRCheck, AVX2_Check)
+{
+        functional(bblib_rate_dematching_5gnr_avx2, "AVX2");
+}
+#endif
+
 TEST_P(RateDematching5GNRCheck, C_Check)
 {
         functional(bblib_rate_dematching_5gnr_c, "C");
@@ -105,3 +141,239 @@ TEST_P(RateDematching5GNRCheck, default_Check)
 
 INSTANTIATE_TEST_CASE_P(UnitTest, RateDematching5GNRCheck,
                         testing::ValuesIn(get_sequence(RateDematching5GNRCheck::get_number_of_cases("functional"))));
+
+class RateDematching5GNRHarqCheck : public KernelTests {
+protected:
+    struct bblib_rate_dematching_5gnr_request request{};
+    struct bblib_rate_dematching_5gnr_request request_ref{};
+    struct bblib_rate_dematching_5gnr_response response{};
+    struct bblib_rate_dematching_5gnr_response reference{};
+    int8_t *llr = nullptr;
+    int32_t harq_size = 0;
+
+    void SetUp() override {
+        init_test("harq_functional");
+
+        request.ncb = get_input_parameter<int32_t>("ncb");
+        request.start_null_index = get_input_parameter<int32_t>("start_null");
+        request.num_of_null = get_input_parameter<int32_t>("n_null");
+        request.e = get_input_parameter<int32_t>("e");
+        request.rvid = get_input_parameter<int32_t>("rv_id");
+        request.zc = get_input_parameter<int32_t>("z_c");
+        request.modulation_order = get_input_parameter<bblib_modulation_order>("mod_q");
+        request.base_graph = get_input_parameter<int32_t>("flag_of_bg");
+        request.isretx = get_input_parameter<int32_t>("is_retx");
+        request.harq_format = get_input_parameter<bblib_harq_format>("harq_format");
+        harq_size = bblib_rate_dematching_5gnr_harq_size(request.ncb, request.harq_format);
+
+        auto in = generate_random_int_numbers<int16_t>(request.e, 64, -127, 127);
+        request.p_in = aligned_malloc<int8_t>(request.e, 64);
+        for (int32_t i = 0; i < request.e; i++)
+            request.p_in[i] = (int8_t) in[i];
+        aligned_free(in);
+
+        /* Previous transmissions in the compressed format */
+        auto harq = generate_random_int_numbers<int16_t>(request.ncb, 64, -127, 127);
+        llr = aligned_malloc<int8_t>(request.ncb, 64);
+        for (int32_t i = 0; i < request.ncb; i++)
+            llr[i] = (int8_t) harq[i];
+        aligned_free(harq);
+        request.p_harq = aligned_malloc<int8_t>(harq_size, 64);
+        bblib_rate_dematching_5gnr_harq_pack_c(llr, request.p_harq, request.ncb, request.harq_format);
+
+        request_ref = request;
+        request_ref.p_harq = aligned_malloc<int8_t>(harq_size, 64);
+        std::memcpy(request_ref.p_harq, request.p_harq, harq_size);
+        /* Generate reference using C code */
+        bblib_rate_dematching_5gnr_c(&request_ref, &reference);
+    }
+
+    void TearDown() override {
+        aligned_free(request.p_in);
+        aligned_free(request.p_harq);
+        aligned_free(request_ref.p_harq);
+        aligned_free(llr);
+    }
+
+    template <typename F, typename P, typename U>
+    void functional(F function, P pack, U unpack, const std::string isa)
+    {
+        /* Packing and unpacking of the original LLRs */
+        auto packed = aligned_malloc<int8_t>(harq_size, 64);
+        auto packed_ref = aligned_malloc<int8_t>(harq_size, 64);
+        auto unpacked = aligned_malloc<int8_t>(request.ncb, 64);
+        auto unpacked_ref = aligned_malloc<int8_t>(request.ncb, 64);
+        ASSERT_EQ(pack(llr, packed, request.ncb, request.harq_format), 0);
+        bblib_rate_dematching_5gnr_harq_pack_c(llr, packed_ref, request.ncb, request.harq_format);
+        ASSERT_ARRAY_EQ(packed, packed_ref, harq_size);
+        ASSERT_EQ(unpack(packed_ref, unpacked, request.ncb, request.harq_format), 0);
+        bblib_rate_dematching_5gnr_harq_unpack_c(packed_ref, unpacked_ref, request.ncb, request.harq_format);
+        ASSERT_ARRAY_EQ(unpacked, unpacked_ref, request.ncb);
+
+        function(&request, &response);
+        ASSERT_ARRAY_EQ(request.p_harq, request_ref.p_harq, harq_size);
+
+        aligned_free(packed);
+        aligned_free(packed_ref);
+        aligned_free(unpacked);
+        aligned_free(unpacked_ref);
+        print_test_description(isa, module_name);
+    }
+};
+
+#ifdef _BBLIB_AVX512_
+TEST_P(RateDematching5GNRHarqCheck, AVX512_Check)
+{
+        functional(bblib_rate_dematching_5gnr_avx512, bblib_rate_dematching_5gnr_harq_pack_avx512,
+                   bblib_rate_dematching_5gnr_harq_unpack_avx512, "AVX512");
+}
+#endif
+
+#ifdef _BBLIB_AVX2_
+TEST_P(RateDematching5GNRHarqCheck, AVX2_Check)
+{
+        functional(bblib_rate_dematching_5gnr_avx2, bblib_rate_dematching_5gnr_harq_pack_c,
+                   bblib_rate_dematching_5gnr_harq_unpack_c, "AVX2");
+}
+#endif
+
+TEST_P(RateDematching5GNRHarqCheck, C_Check)
+{
+        functional(bblib_rate_dematching_5gnr_c, bblib_rate_dematching_5gnr_harq_pack_c,
+                   bblib_rate_dematching_5gnr_harq_unpack_c, "C");
+}
+
+TEST_P(RateDematching5GNRHarqCheck, default_Check)
+{
+        functional(bblib_rate_dematching_5gnr, bblib_rate_dematching_5gnr_harq_pack,
+                   bblib_rate_dematching_5gnr_harq_unpack, "Default");
+}
+
+INSTANTIATE_TEST_CASE_P(UnitTest, RateDematching5GNRHarqCheck,
+                        testing::ValuesIn(get_sequence(RateDematching5GNRHarqCheck::get_number_of_cases("harq_functional"))));
+
+class RateDematching5GNRMultiCheck : public KernelTests {
+protected:
+    struct bblib_rate_dematching_5gnr_multi_request request{};
+    struct bblib_rate_dematching_5gnr_response response{};
+    struct bblib_rate_dematching_5gnr_response reference{};
+    int8_t *harq_ref = nullptr;
+    int32_t harq_size = 0;
+
+    void SetUp() override {
+        init_test("multi_functional");
+
+        /* Redundancy version sequence of the repetitions as in TS38214 6.1.2.1 */
+        const int32_t rv_sequence[4] = {0, 2, 3, 1};
+        const int32_t rv_id = get_input_parameter<int32_t>("rv_id");
+        const int32_t e = get_input_parameter<int32_t>("e");
+        int32_t rv_index = 0;
+        while (rv_sequence[rv_index] != rv_id)
+            rv_index++;
+
+        request.ncb = get_input_parameter<int32_t>("ncb");
+        request.start_null_index = get_input_parameter<int32_t>("start_null");
+        request.num_of_null = get_input_parameter<int32_t>("n_null");
+        request.zc = get_input_parameter<int32_t>("z_c");
+        request.modulation_order = get_input_parameter<bblib_modulation_order>("mod_q");
+        request.base_graph = get_input_parameter<int32_t>("flag_of_bg");
+        request.isretx = get_input_parameter<int32_t>("is_retx");
+        request.harq_format = get_input_parameter<bblib_harq_format>("harq_format");
+        if (get_input_parameter<int32_t>("descrambling"))
+            request.flags |= BBLIB_RATE_DEMATCHING_DESCRAMBLING;
+        request.c_init = 0x1234567;
+        request.num_tx = get_input_parameter<int32_t>("num_tx");
+        for (int32_t tx = 0; tx < request.num_tx; tx++) {
+            auto in = generate_random_int_numbers<int16_t>(e, 64, -127, 127);
+            request.tx[tx].p_in = aligned_malloc<int8_t>(e, 64);
+            for (int32_t i = 0; i < e; i++)
+                request.tx[tx].p_in[i] = (int8_t) in[i];
+            aligned_free(in);
+            request.tx[tx].e = e;
+            request.tx[tx].rvid = rv_sequence[(rv_index + tx) % 4];
+            request.tx[tx].scrambling_offset = tx * e;
+        }
+
+        /* Previous transmissions */
+        harq_size = bblib_rate_dematching_5gnr_harq_size(request.ncb, request.harq_format);
+        auto llr = aligned_malloc<int8_t>(request.ncb, 64);
+        auto harq = generate_random_int_numbers<int16_t>(request.ncb, 64, -127, 127);
+        for (int32_t i = 0; i < request.ncb; i++)
+            llr[i] = (int8_t) harq[i];
+        aligned_free(harq);
+        request.p_harq = aligned_malloc<int8_t>(harq_size, 64);
+        harq_ref = aligned_malloc<int8_t>(harq_size, 64);
+        if (request.harq_format == BBLIB_HARQ_INT8)
+            std::memcpy(request.p_harq, llr, request.ncb);
+        else
+            bblib_rate_dematching_5gnr_harq_pack_c(llr, request.p_harq, request.ncb, request.harq_format);
+        std::memcpy(harq_ref, request.p_harq, harq_size);
+
+        /* Generate reference using one C call per transmission on the unpacked buffer */
+        if (request.harq_format != BBLIB_HARQ_INT8 && request.isretx)
+            bblib_rate_dematching_5gnr_harq_unpack_c(harq_ref, llr, request.ncb, request.harq_format);
+        for (int32_t tx = 0; tx < request.num_tx; tx++) {
+            struct bblib_rate_dematching_5gnr_request request_ref{};
+            request_ref.p_in = request.tx[tx].p_in;
+            request_ref.p_harq = (request.harq_format == BBLIB_HARQ_INT8) ? harq_ref : llr;
+            request_ref.ncb = request.ncb;
+            request_ref.start_null_index = request.start_null_index;
+            request_ref.num_of_null = request.num_of_null;
+            request_ref.e = request.tx[tx].e;
+            request_ref.rvid = request.tx[tx].rvid;
+            request_ref.zc = request.zc;
+            request_ref.modulation_order = request.modulation_order;
+            request_ref.base_graph = request.base_graph;
+            request_ref.isretx = (tx > 0) ? 1 : request.isretx;
+            request_ref.flags = request.flags;
+            request_ref.c_init = request.c_init;
+            request_ref.scrambling_offset = request.tx[tx].scrambling_offset;
+            bblib_rate_dematching_5gnr_c(&request_ref, &reference);
+        }
+        if (request.harq_format != BBLIB_HARQ_INT8)
+            bblib_rate_dematching_5gnr_harq_pack_c(llr, harq_ref, request.ncb, request.harq_format);
+        aligned_free(llr);
+    }
+
+    void TearDown() override {
+        for (int32_t tx = 0; tx < request.num_tx; tx++)
+            aligned_free(request.tx[tx].p_in);
+        aligned_free(request.p_harq);
+        aligned_free(harq_ref);
+    }
+
+    template <typename F>
+    void functional(F function, const std::string isa)
+    {
+        ASSERT_EQ(function(&request, &response), 0);
+        ASSERT_ARRAY_EQ(request.p_harq, harq_ref, harq_size);
+        print_test_description(isa, module_name);
+    }
+};
+
+#ifdef _BBLIB_AVX512_
+TEST_P(RateDematching5GNRMultiCheck, AVX512_Check)
+{
+        functional(bblib_rate_dematching_5gnr_multi_avx512, "AVX512");
+}
+#endif
+
+#ifdef _BBLIB_AVX2_
+TEST_P(RateDematching5GNRMultiCheck, AVX2_Check)
+{
+        functional(bblib_rate_dematching_5gnr_multi_avx2, "AVX2");
+}
+#endif
+
+TEST_P(RateDematching5GNRMultiCheck, C_Check)
+{
+        functional(bblib_rate_dematching_5gnr_multi_c, "C");
+}
+
+TEST_P(RateDematching5GNRMultiCheck, default_Check)
+{
+        functional(bblib_rate_dematching_5gnr_multi, "Default");
+}
+
+INSTANTIATE_TEST_CASE_P(UnitTest, RateDematching5GNRMultiCheck,
+                        testing::ValuesIn(get_sequence(RateDematching5GNRMultiCheck::get_number_of_cases("multi_functional"))));
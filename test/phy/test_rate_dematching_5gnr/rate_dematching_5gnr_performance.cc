@@ -65,6 +65,13 @@ TEST_P(RateDematching5GNRPerf, AVX512_Perf)
 }
 #endif
 
+#ifdef _BBLIB_AVX2_
+TEST_P(RateDematching5GNRPerf, AVX2_Perf)
+{
+        performance("AVX2", module_name, bblib_rate_dematching_5gnr_avx2, &request, &response);
+}
+#endif
+
 TEST_P(RateDematching5GNRPerf, C_Perf)
 {
 	performance("C", module_name, bblib_rate_dematching_5gnr_c, &request, &response);
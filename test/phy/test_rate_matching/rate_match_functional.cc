@@ -25,6 +25,7 @@
 #include "common.hpp"
 
 #include "phy_rate_match.h"
+#include "phy_turbo.h"
 
 const std::string module_name = "rate_matching";
 
@@ -204,6 +205,285 @@ TEST_P(RateMatchingCheck, SSE4_2_Check)
 }
 #endif
 
+/* TS 36.212 5.1.4.1 rate matching of the turbo encoder streams tin0, tin1 and tin2 (nLen bits each,
+   MSB first), in the order of the spec: sub-block interleaving of y(i), the ND NULL bits followed
+   by d(i), the circular buffer w of v(0) then v(1) and v(2) interleaved, and the e bits read from k0
+   on, skipping the NULL bits and wrapping around at Ncb. Returns the e bits MSB first. */
+static std::vector<uint8_t> rate_match_dl_spec(const struct bblib_rate_match_dl_request &request)
+{
+    static const int P[32] = {0, 16, 8, 24, 4, 20, 12, 28, 2, 18, 10, 26, 6, 22, 14, 30,
+                              1, 17, 9, 25, 5, 21, 13, 29, 3, 19, 11, 27, 7, 23, 15, 31};
+    const int null_bit = -1;
+    const int D = request.nLen;
+    const int R = (D + 31) / 32;
+    const int Kpi = 32 * R;
+    const int ND = Kpi - D;
+    const int Kw = 3 * Kpi;
+    const uint8_t *d[3] = {request.tin0, request.tin1, request.tin2};
+    auto y = [&](const int i, const int k) {
+        return (k < ND) ? null_bit : (d[i][(k - ND) >> 3] >> (7 - ((k - ND) & 7))) & 1;
+    };
+
+    std::vector<int> w(Kw);
+    for (int k = 0; k < Kpi; k++) {
+        const int pi = P[k / R] + 32 * (k % R);
+        w[k] = y(0, pi);
+        w[Kpi + 2 * k] = y(1, pi);
+        w[Kpi + 2 * k + 1] = y(2, (pi + 1) % Kpi);
+    }
+
+    const int NIR = request.Nsoft / (request.KMIMO * std::min(request.MDL_HARQ, 8));
+    const int Ncb = (request.direction == 1) ? std::min(NIR / request.C, Kw) : Kw;
+    const int G_prime = request.G / (request.NL * request.Qm);
+    const int gamma = G_prime % request.C;
+    const int E = request.NL * request.Qm *
+        ((request.r <= request.C - gamma - 1) ? G_prime / request.C : (G_prime + request.C - 1) / request.C);
+    const int k0 = request.bypass_rvidx ? 0 : R * (2 * ((Ncb + 8 * R - 1) / (8 * R)) * request.rvidx + 2);
+
+    std::vector<uint8_t> e((E + 7) / 8, 0);
+    for (int k = 0, j = 0; k < E; j++) {
+        const int bit = w[(k0 + j) % Ncb];
+        if (bit == null_bit)
+            continue;
+        e[k >> 3] |= bit << (7 - (k & 7));
+        k++;
+    }
+    return e;
+}
+
+/* The fused turbo encoding and rate matching has to give the e bits of the spec model from the
+   turbo encoder output, for a random code block of the K of the test and every redundancy version */
+TEST_P(RateMatchingCheck, TurboRateMatch_Check)
+{
+    if (test_type != TestType::DL)
+        return;
+
+    const int K = dl_request.nLen - 4;
+    const int stream_len = K / 8 + 64;
+    uint8_t *input = aligned_malloc<uint8_t>(K / 8 + 64, 64);
+    std::vector<uint8_t *> stream(3);
+
+    std::mt19937 gen(dl_request.Kidx);
+    for (int i = 0; i < K / 8; i++)
+        input[i] = (uint8_t)gen();
+    for (int n = 0; n < 3; n++) {
+        stream[n] = aligned_malloc<uint8_t>(stream_len, 64);
+        memset(stream[n], 0, stream_len);
+    }
+
+    struct bblib_turbo_encoder_request enc_request{};
+    struct bblib_turbo_encoder_response enc_response{};
+    enc_request.length = K / 8;
+    enc_request.case_id = dl_request.Kidx + 1;
+    enc_request.input_win = input;
+    enc_response.output_win_0 = stream[0];
+    enc_response.output_win_1 = stream[1];
+    enc_response.output_win_2 = stream[2];
+    ASSERT_EQ(bblib_turbo_encoder(&enc_request, &enc_response), 0);
+
+    struct bblib_rate_match_dl_request request = dl_request;
+    request.direction = 1;
+    request.tin0 = stream[0];
+    request.tin1 = stream[1];
+    request.tin2 = stream[2];
+
+    struct bblib_turbo_rate_match_dl_request fused_request{};
+    fused_request.r = dl_request.r;
+    fused_request.C = dl_request.C;
+    fused_request.Nsoft = dl_request.Nsoft;
+    fused_request.KMIMO = dl_request.KMIMO;
+    fused_request.MDL_HARQ = dl_request.MDL_HARQ;
+    fused_request.G = dl_request.G;
+    fused_request.NL = dl_request.NL;
+    fused_request.Qm = dl_request.Qm;
+    fused_request.bypass_rvidx = dl_request.bypass_rvidx;
+    fused_request.Kidx = dl_request.Kidx;
+    fused_request.input = input;
+
+    for (int rvidx = 0; rvidx < 4; rvidx++) {
+        request.rvidx = rvidx;
+        const std::vector<uint8_t> reference = rate_match_dl_spec(request);
+        const int len = (int)reference.size();
+
+        dl_response.output[len] = 0x5A;
+        fused_request.rvidx = rvidx;
+        ASSERT_EQ(bblib_turbo_rate_match_dl(&fused_request, &dl_response), 0);
+        ASSERT_ARRAY_EQ(reference.data(), dl_response.output, len);
+        ASSERT_EQ(dl_response.output[len], 0x5A);
+    }
+
+    aligned_free(input);
+    for (int n = 0; n < 3; n++)
+        aligned_free(stream[n]);
+
+    print_test_description("TurboRateMatch", module_name);
+}
+
+/* Every K and redundancy version, with e shorter than Ncb and e wrapping around Ncb several times,
+   not a multiple of 8, and Ncb either Kw or limited by the soft buffer. The SSE DL rate matching of
+   the turbo encoder output and the fused turbo encoding and rate matching have to give the e bits
+   of the spec model. */
+TEST(RateMatchingDlCheck, AllSizes)
+{
+    struct RateMatchCase {
+        int32_t C;
+        int32_t Nsoft;
+    };
+    const RateMatchCase cases[] = {{1, 3667200}, {2, 250368}};
+    const int stream_len = 1024; /* the SSE rate matching of the long code blocks reads 832 bytes */
+    const int output_len = 18444 / 8 + 64;
+    uint8_t *input = aligned_malloc<uint8_t>(6144 / 8 + 64, 64);
+    uint8_t *output = aligned_malloc<uint8_t>(output_len, 64);
+    uint8_t *stream[3];
+    for (int n = 0; n < 3; n++)
+        stream[n] = aligned_malloc<uint8_t>(stream_len, 64);
+
+    std::mt19937 gen(49);
+    for (int32_t Kidx = 0; Kidx < 188; Kidx++) {
+        const int K = (Kidx < 59) ? 40 + 8 * Kidx : (Kidx < 91) ? 512 + 16 * (Kidx - 59) :
+                      (Kidx < 123) ? 1024 + 32 * (Kidx - 91) : 2048 + 64 * (Kidx - 123);
+        const int Kw = 3 * 32 * ((K + 4 + 31) / 32);
+        for (int i = 0; i < K / 8; i++)
+            input[i] = (uint8_t)gen();
+        for (int n = 0; n < 3; n++)
+            memset(stream[n], 0, stream_len);
+
+        struct bblib_turbo_encoder_request enc_request{};
+        struct bblib_turbo_encoder_response enc_response{stream[0], stream[1], stream[2]};
+        enc_request.length = K / 8;
+        enc_request.case_id = Kidx + 1;
+        enc_request.input_win = input;
+        ASSERT_EQ(bblib_turbo_encoder(&enc_request, &enc_response), 0);
+
+        for (const auto &c : cases) {
+            for (const int E : {Kw / 3 / 8 * 8 + 2, std::min(5 * Kw / 2, 18440) / 8 * 8 + 2}) {
+                for (int32_t rvidx = 0; rvidx < 4; rvidx++) {
+                    struct bblib_rate_match_dl_request request{};
+                    request.r = c.C - 1;
+                    request.C = c.C;
+                    request.direction = 1;
+                    request.Nsoft = c.Nsoft;
+                    request.KMIMO = 2;
+                    request.MDL_HARQ = 8;
+                    request.G = c.C * E;
+                    request.NL = 1;
+                    request.Qm = 2;
+                    request.rvidx = rvidx;
+                    request.Kidx = Kidx;
+                    request.nLen = K + 4;
+                    request.tin0 = stream[0];
+                    request.tin1 = stream[1];
+                    request.tin2 = stream[2];
+                    const std::vector<uint8_t> reference = rate_match_dl_spec(request);
+
+                    struct bblib_rate_match_dl_response response{output, 0};
+#if defined(_BBLIB_SSE4_2_)
+                    memset(output, 0, output_len);
+                    bblib_rate_match_dl_sse(&request, &response);
+                    ASSERT_EQ(0, memcmp(reference.data(), output, reference.size()))
+                        << "SSE K " << K << " C " << c.C << " E " << E << " rv " << rvidx;
+#endif
+
+                    struct bblib_turbo_rate_match_dl_request fused_request{};
+                    fused_request.r = request.r;
+                    fused_request.C = request.C;
+                    fused_request.Nsoft = request.Nsoft;
+                    fused_request.KMIMO = request.KMIMO;
+                    fused_request.MDL_HARQ = request.MDL_HARQ;
+                    fused_request.G = request.G;
+                    fused_request.NL = request.NL;
+                    fused_request.Qm = request.Qm;
+                    fused_request.rvidx = rvidx;
+                    fused_request.Kidx = Kidx;
+                    fused_request.input = input;
+                    memset(output, 0, output_len);
+                    ASSERT_EQ(0, bblib_turbo_rate_match_dl(&fused_request, &response));
+                    ASSERT_EQ(0, memcmp(reference.data(), output, reference.size()))
+                        << "fused K " << K << " C " << c.C << " E " << E << " rv " << rvidx;
+                }
+            }
+        }
+    }
+
+    aligned_free(input);
+    aligned_free(output);
+    for (int n = 0; n < 3; n++)
+        aligned_free(stream[n]);
+}
+
+#if defined(_BBLIB_SSE4_2_)
+/* Long code blocks whose e bits wrap around Ncb a second time part way through a 64 bit word, where
+   the SSE bit selection used to drop bits of the word before the wrap. The SSE DL rate matching has
+   to give the e bits of the spec model. */
+TEST(RateMatchingDlCheck, SseWrapAroundNcb)
+{
+    struct WrapCase {
+        int32_t Kidx;
+        int32_t C;
+        int32_t Nsoft;
+        int32_t E;
+        int32_t rvidx;
+    };
+    const WrapCase cases[] = {
+        {93, 2, 3667200, 4032, 3},   /* K 1088 */
+        {95, 2, 3667200, 12096, 2},  /* K 1152 */
+        {134, 2, 250368, 18442, 0},  /* K 2752, Ncb limited by the soft buffer */
+    };
+    const int stream_len = 1024; /* the SSE rate matching of the long code blocks reads 832 bytes */
+    const int output_len = 18444 / 8 + 64;
+    uint8_t *input = aligned_malloc<uint8_t>(6144 / 8 + 64, 64);
+    uint8_t *output = aligned_malloc<uint8_t>(output_len, 64);
+    uint8_t *stream[3];
+    for (int n = 0; n < 3; n++)
+        stream[n] = aligned_malloc<uint8_t>(stream_len, 64);
+
+    std::mt19937 gen(93);
+    for (const auto &c : cases) {
+        const int K = (c.Kidx < 123) ? 1024 + 32 * (c.Kidx - 91) : 2048 + 64 * (c.Kidx - 123);
+        for (int i = 0; i < K / 8; i++)
+            input[i] = (uint8_t)gen();
+        for (int n = 0; n < 3; n++)
+            memset(stream[n], 0, stream_len);
+
+        struct bblib_turbo_encoder_request enc_request{};
+        struct bblib_turbo_encoder_response enc_response{stream[0], stream[1], stream[2]};
+        enc_request.length = K / 8;
+        enc_request.case_id = c.Kidx + 1;
+        enc_request.input_win = input;
+        ASSERT_EQ(bblib_turbo_encoder(&enc_request, &enc_response), 0);
+
+        struct bblib_rate_match_dl_request request{};
+        request.r = c.C - 1;
+        request.C = c.C;
+        request.direction = 1;
+        request.Nsoft = c.Nsoft;
+        request.KMIMO = 2;
+        request.MDL_HARQ = 8;
+        request.G = c.C * c.E;
+        request.NL = 1;
+        request.Qm = 2;
+        request.rvidx = c.rvidx;
+        request.Kidx = c.Kidx;
+        request.nLen = K + 4;
+        request.tin0 = stream[0];
+        request.tin1 = stream[1];
+        request.tin2 = stream[2];
+        const std::vector<uint8_t> reference = rate_match_dl_spec(request);
+
+        struct bblib_rate_match_dl_response response{output, 0};
+        memset(output, 0, output_len);
+        bblib_rate_match_dl_sse(&request, &response);
+        ASSERT_EQ(0, memcmp(reference.data(), output, reference.size()))
+            << "K " << K << " E " << c.E << " rv " << c.rvidx;
+    }
+
+    aligned_free(input);
+    aligned_free(output);
+    for (int n = 0; n < 3; n++)
+        aligned_free(stream[n]);
+}
+#endif
+
 #ifdef _BBLIB_AVX2_
 TEST_P(RateMatchingCheck, AVX2_Check)
 {